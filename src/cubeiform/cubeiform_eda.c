@@ -12,6 +12,8 @@
 #include "../../talmud-main/talmud/sacred/trinity_site/ts_bezier_primitives.h"
 #include "voxel/voxelize_bezier.h"
 #include "voxel/voxelize_gpu.h"
+#include "voxel/sdf_sweep.h"
+#include "voxel/sdf_program.h"
 
 #include <ctype.h>
 #include <math.h>
@@ -739,10 +741,17 @@ static void parse_pcb_block(EParser *p, DC_Array *ops)
  *   expr_stmt   = expr ";"
  *
  *   expr        = pipe ( ("+"|"-"|"&") pipe )*
- *   pipe        = primary ( ">>" transform )*
+ *   pipe        = primary ( ">>" (transform | modifier) )*
  *   primary     = primitive | "(" expr ")" | IDENT (variable ref)
  *   primitive   = ("sphere"|"cube"|"cylinder"|"torus") "(" args ")"
  *   transform   = ("move"|"rotate"|"scale"|"color") "(" args ")"
+ *   modifier    = ("round"|"shell"|"repeat"|"blend") "(" args ")"
+ *
+ *   round(r) grows the shape by r with rounded edges; shell(t) hollows it
+ *   to a wall of thickness t; repeat(dx,dy,dz, nx,ny,nz) lays out nx*ny*nz
+ *   copies dx/dy/dz apart. All three act on the shape as piped so far.
+ *   blend(k) fillets the CSG operator joining this operand to the shapes
+ *   before it (a + b >> blend(2)) with radius k.
  *   args        = arg ("," arg)*
  *   arg         = [IDENT "="] arith_expr
  *
@@ -1076,17 +1085,44 @@ static void parse_vox_primary(EParser *p, VoxParseCtx *ctx, DC_Array *out)
 /* -------------------------------------------------------------------------
  * Pipe transform parser
  * ---------------------------------------------------------------------- */
-static void parse_vox_pipe(EParser *p, VoxParseCtx *ctx, DC_Array *out)
+
+/* Wrap the shape piped so far (scratch, under the nxform transforms
+ * collected for it) as the operand of modifier mod:
+ * MODIFY_BEGIN, transforms, shape, pops, mod. Transforms piped after the
+ * modifier then apply to the modified shape. */
+static void vox_wrap_modifier(DC_Array *scratch, const DC_VoxOp *xforms,
+                              int *nxform, const DC_VoxOp *mod)
+{
+    DC_Array *wrapped = dc_array_new(sizeof(DC_VoxOp));
+    DC_VoxOp begin = { .type = DC_VOX_OP_MODIFY_BEGIN };
+    DC_VoxOp pop = { .type = DC_VOX_OP_POP_TRANSFORM };
+    dc_array_push(wrapped, &begin);
+    for (int i = 0; i < *nxform; i++)
+        dc_array_push(wrapped, &xforms[i]);
+    vox_copy_ops(wrapped, scratch);
+    for (int i = 0; i < *nxform; i++)
+        dc_array_push(wrapped, &pop);
+    dc_array_push(wrapped, mod);
+
+    dc_array_clear(scratch);
+    vox_copy_ops(scratch, wrapped);
+    dc_array_free(wrapped);
+    *nxform = 0;
+}
+
+/* Returns the blend radius set by >> blend(k), 0 for none */
+static double parse_vox_pipe(EParser *p, VoxParseCtx *ctx, DC_Array *out)
 {
     /* Parse primary into scratch buffer */
     DC_Array *scratch = dc_array_new(sizeof(DC_VoxOp));
     parse_vox_primary(p, ctx, scratch);
 
-    if (p->has_error) { dc_array_free(scratch); return; }
+    if (p->has_error) { dc_array_free(scratch); return 0; }
 
     /* Collect >> transforms */
     DC_VoxOp xforms[32];
     int nxform = 0;
+    double blend = 0;
 
     while (p->cur.type == ETOK_PIPE && !p->has_error && nxform < 32) {
         next_token(p); /* skip >> */
@@ -1165,6 +1201,46 @@ static void parse_vox_pipe(EParser *p, VoxParseCtx *ctx, DC_Array *out)
             xforms[nxform++] = tmop;
             break;
 
+        } else if (ident_eq(&p->cur, "round") || ident_eq(&p->cur, "shell")) {
+            int shell = ident_eq(&p->cur, "shell");
+            const char *name = shell ? "t" : "r";
+            next_token(p);
+            VoxArgs args;
+            parse_vox_args(p, ctx, &args);
+            DC_VoxOp op = { .type = shell ? DC_VOX_OP_SHELL : DC_VOX_OP_ROUND };
+            op.radius = vox_arg_has(&args, name) ? vox_arg_find(&args, name, 1)
+                                                 : vox_arg_pos(&args, 0, 1);
+            vox_wrap_modifier(scratch, xforms, &nxform, &op);
+
+        } else if (ident_eq(&p->cur, "repeat")) {
+            /* repeat(dx, dy, dz, nx, ny, nz) or repeat(x=dx, nx=n, ...) */
+            next_token(p);
+            VoxArgs args;
+            parse_vox_args(p, ctx, &args);
+            DC_VoxOp op = { .type = DC_VOX_OP_REPEAT };
+            static const char *const period[3] = { "x", "y", "z" };
+            static const char *const count[3] = { "nx", "ny", "nz" };
+            double v[6];
+            for (int a = 0; a < 3; a++) {
+                v[a] = vox_arg_has(&args, period[a]) ? vox_arg_find(&args, period[a], 0)
+                                                     : vox_arg_pos(&args, a, 0);
+                v[3 + a] = vox_arg_has(&args, count[a]) ? vox_arg_find(&args, count[a], 1)
+                                                        : vox_arg_pos(&args, 3 + a, 1);
+                v[3 + a] = v[3 + a] < 1 ? 1 : floor(v[3 + a]);
+            }
+            op.x = v[0]; op.y = v[1]; op.z = v[2];
+            op.x2 = v[3]; op.y2 = v[4]; op.z2 = v[5];
+            vox_wrap_modifier(scratch, xforms, &nxform, &op);
+
+        } else if (ident_eq(&p->cur, "blend")) {
+            next_token(p);
+            VoxArgs args;
+            parse_vox_args(p, ctx, &args);
+            blend = vox_arg_has(&args, "r") ? vox_arg_find(&args, "r", 1)
+                                            : vox_arg_pos(&args, 0, 1);
+            if (blend < 0) blend = 0;
+            continue; /* applies to the CSG operator, see parse_vox_expr */
+
         } else {
             /* Unknown pipe target — skip */
             next_token(p);
@@ -1206,6 +1282,7 @@ static void parse_vox_pipe(EParser *p, VoxParseCtx *ctx, DC_Array *out)
         dc_array_push(out, to_mesh_op);
 
     dc_array_free(scratch);
+    return blend;
 }
 
 /* -------------------------------------------------------------------------
@@ -1215,6 +1292,8 @@ static void parse_vox_pipe(EParser *p, VoxParseCtx *ctx, DC_Array *out)
  *   >> (pipe)  — tightest, handled inside parse_vox_pipe
  *   &          — precedence 2
  *   + -        — precedence 1 (union/difference)
+ *
+ * A CSG op carries the blend radius of its right operand (op.radius).
  * ---------------------------------------------------------------------- */
 static void parse_vox_expr(EParser *p, VoxParseCtx *ctx, DC_Array *out)
 {
@@ -1238,10 +1317,11 @@ static void parse_vox_expr(EParser *p, VoxParseCtx *ctx, DC_Array *out)
 
         /* Parse right operand (at same or tighter precedence) */
         DC_Array *right = dc_array_new(sizeof(DC_VoxOp));
+        double blend;
 
         if (csg_type == DC_VOX_OP_INTERSECT) {
             /* & binds tighter than +/- so parse only pipe level */
-            parse_vox_pipe(p, ctx, right);
+            blend = parse_vox_pipe(p, ctx, right);
             /* But continue collecting & at this level */
             while (p->cur.type == ETOK_AMP && !p->has_error) {
                 next_token(p);
@@ -1252,7 +1332,7 @@ static void parse_vox_expr(EParser *p, VoxParseCtx *ctx, DC_Array *out)
                 dc_array_push(combined, &gb);
                 vox_copy_ops(combined, left);
                 dc_array_push(combined, &ge);
-                DC_VoxOp csg = { .type = DC_VOX_OP_INTERSECT };
+                DC_VoxOp csg = { .type = DC_VOX_OP_INTERSECT, .radius = blend };
                 dc_array_push(combined, &csg);
                 dc_array_push(combined, &gb);
                 vox_copy_ops(combined, right);
@@ -1261,17 +1341,17 @@ static void parse_vox_expr(EParser *p, VoxParseCtx *ctx, DC_Array *out)
                 dc_array_free(right);
                 left = combined;
                 right = dc_array_new(sizeof(DC_VoxOp));
-                parse_vox_pipe(p, ctx, right);
+                blend = parse_vox_pipe(p, ctx, right);
                 csg_type = DC_VOX_OP_INTERSECT;
             }
         } else {
             /* For +/-, right side may contain & which binds tighter */
-            parse_vox_pipe(p, ctx, right);
+            blend = parse_vox_pipe(p, ctx, right);
             /* Consume any & operators on the right side at higher precedence */
             while (p->cur.type == ETOK_AMP && !p->has_error) {
                 next_token(p);
                 DC_Array *rr = dc_array_new(sizeof(DC_VoxOp));
-                parse_vox_pipe(p, ctx, rr);
+                double rr_blend = parse_vox_pipe(p, ctx, rr);
                 /* Wrap right & rr */
                 DC_Array *combined = dc_array_new(sizeof(DC_VoxOp));
                 DC_VoxOp gb = { .type = DC_VOX_OP_GROUP_BEGIN };
@@ -1279,7 +1359,7 @@ static void parse_vox_expr(EParser *p, VoxParseCtx *ctx, DC_Array *out)
                 dc_array_push(combined, &gb);
                 vox_copy_ops(combined, right);
                 dc_array_push(combined, &ge);
-                DC_VoxOp icsg = { .type = DC_VOX_OP_INTERSECT };
+                DC_VoxOp icsg = { .type = DC_VOX_OP_INTERSECT, .radius = rr_blend };
                 dc_array_push(combined, &icsg);
                 dc_array_push(combined, &gb);
                 vox_copy_ops(combined, rr);
@@ -1299,7 +1379,7 @@ static void parse_vox_expr(EParser *p, VoxParseCtx *ctx, DC_Array *out)
         vox_copy_ops(combined, left);
         dc_array_push(combined, &ge);
 
-        DC_VoxOp csg = { .type = csg_type };
+        DC_VoxOp csg = { .type = csg_type, .radius = blend };
         dc_array_push(combined, &csg);
 
         dc_array_push(combined, &gb);
@@ -2399,11 +2479,161 @@ dc_cubeiform_execute_full(const char *dcad_src,
 /* =========================================================================
  * Apply — voxel operations → DC_VoxelGrid
  * ========================================================================= */
-DC_VoxelGrid *
-dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda, DC_Error *err)
+
+/* Dense grids above this size are built sparse instead */
+#define VOX_SPARSE_ABOVE_BYTES ((size_t)512 * 1024 * 1024)
+
+/* Deepest transform nesting; deeper transforms are ignored */
+#define VOX_XFORM_DEPTH 32
+
+/* Push the transform a TRANSLATE, ROTATE or SCALE op opens onto stack,
+ * or pop one for POP_TRANSFORM. Returns 1 if op was one of these. */
+static int
+vox_xform_step(const DC_VoxOp *op, DC_SdfTransform *stack, int *depth)
+{
+    switch (op->type) {
+    case DC_VOX_OP_TRANSLATE:
+    case DC_VOX_OP_ROTATE:
+    case DC_VOX_OP_SCALE: {
+        if (*depth + 1 >= VOX_XFORM_DEPTH) return 1;
+        (*depth)++;
+        DC_SdfTransform *xf = &stack[*depth];
+        *xf = stack[*depth - 1];
+        if (op->type == DC_VOX_OP_TRANSLATE) {
+            dc_sdf_transform_translate(xf, (float)op->x, (float)op->y, (float)op->z);
+        } else if (op->type == DC_VOX_OP_SCALE) {
+            dc_sdf_transform_scale(xf, (float)op->x, (float)op->y, (float)op->z);
+        } else if (op->radius != 0) {
+            dc_sdf_transform_rotate(xf, (float)op->x, (float)op->y, (float)op->z,
+                                    (float)op->radius);
+        } else {
+            /* Euler angles: rotate Z, then Y, then X */
+            if ((float)op->z != 0) dc_sdf_transform_rotate(xf, 0, 0, 1, (float)op->z);
+            if ((float)op->y != 0) dc_sdf_transform_rotate(xf, 0, 1, 0, (float)op->y);
+            if ((float)op->x != 0) dc_sdf_transform_rotate(xf, 1, 0, 0, (float)op->x);
+        }
+        return 1;
+    }
+    case DC_VOX_OP_POP_TRANSFORM:
+        if (*depth > 0) (*depth)--;
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* Grow bmin..bmax by the world box of primitive op: its local box with
+ * each corner mapped through xf. Returns 0 for ops that are not
+ * primitives. */
+static int
+vox_prim_bbox(const DC_VoxOp *op, const DC_SdfTransform *xf,
+              float bmin[3], float bmax[3])
+{
+    float lo[3], hi[3], r;
+    switch (op->type) {
+    case DC_VOX_OP_SPHERE:
+        r = (float)op->radius;
+        lo[0] = (float)op->x - r; lo[1] = (float)op->y - r; lo[2] = (float)op->z - r;
+        hi[0] = (float)op->x + r; hi[1] = (float)op->y + r; hi[2] = (float)op->z + r;
+        break;
+    case DC_VOX_OP_BOX:
+        lo[0] = (float)op->x;  lo[1] = (float)op->y;  lo[2] = (float)op->z;
+        hi[0] = (float)op->x2; hi[1] = (float)op->y2; hi[2] = (float)op->z2;
+        break;
+    case DC_VOX_OP_CYLINDER:
+        r = (float)op->radius;
+        lo[0] = (float)op->x - r; lo[1] = (float)op->y - r; lo[2] = (float)op->z;
+        hi[0] = (float)op->x + r; hi[1] = (float)op->y + r; hi[2] = (float)op->radius2;
+        break;
+    case DC_VOX_OP_TORUS:
+        r = (float)(op->radius + op->radius2);
+        lo[0] = (float)op->x - r; lo[1] = (float)op->y - r;
+        lo[2] = (float)op->z - (float)op->radius2;
+        hi[0] = (float)op->x + r; hi[1] = (float)op->y + r;
+        hi[2] = (float)op->z + (float)op->radius2;
+        break;
+    default:
+        return 0;
+    }
+    for (int c = 0; c < 8; c++) {
+        float p[3] = { c & 1 ? hi[0] : lo[0], c & 2 ? hi[1] : lo[1],
+                       c & 4 ? hi[2] : lo[2] };
+        for (int a = 0; a < 3; a++) {
+            float w = xf->mat[a] * p[0] + xf->mat[4 + a] * p[1] +
+                      xf->mat[8 + a] * p[2] + xf->mat[12 + a];
+            if (w < bmin[a]) bmin[a] = w;
+            if (w > bmax[a]) bmax[a] = w;
+        }
+    }
+    return 1;
+}
+
+/* Grow the world box of a modifier's operand (bmin..bmax) to the
+ * modified shape: round and shell push the surface out by their radius,
+ * repeat adds the copies. xf is the transform the modifier sits under. */
+static void
+vox_modify_bbox(const DC_VoxOp *op, const DC_SdfTransform *xf,
+                float bmin[3], float bmax[3])
+{
+    if (bmin[0] > bmax[0]) return;  /* empty operand */
+    float grow = 0;
+    if (op->type == DC_VOX_OP_ROUND && op->radius > 0)
+        grow = (float)op->radius * xf->scale;
+    else if (op->type == DC_VOX_OP_SHELL && op->radius > 0)
+        grow = 0.5f * (float)op->radius * xf->scale;
+    for (int a = 0; a < 3; a++) {
+        bmin[a] -= grow;
+        bmax[a] += grow;
+    }
+    if (op->type != DC_VOX_OP_REPEAT) return;
+
+    double period[3] = { op->x, op->y, op->z };
+    double count[3] = { op->x2, op->y2, op->z2 };
+    for (int a = 0; a < 3; a++) {
+        if (period[a] <= 0 || count[a] <= 1) continue;
+        for (int c = 0; c < 3; c++) {
+            /* Column a of the forward matrix maps local axis a */
+            float s = xf->mat[a * 4 + c] * (float)(period[a] * (count[a] - 1));
+            if (s < 0) bmin[c] += s;
+            else bmax[c] += s;
+        }
+    }
+}
+
+/* Allocate the scene grid: dense SoA planes while it is cheap (the SDF
+ * program writes whole rows, and GL takes the planes as-is), sparse
+ * bricks once it would be large. Either way the grid carries a
+ * DC_SDF_BAND_CELLS band, so each cell only runs the primitives near it. */
+static DC_VoxelGrid *
+vox_grid_new(int sx, int sy, int sz, float cell_size)
+{
+    float band = DC_SDF_BAND_CELLS * cell_size;
+    size_t bytes = (size_t)sx * (size_t)sy * (size_t)sz * sizeof(DC_Voxel);
+    if (bytes > VOX_SPARSE_ABOVE_BYTES)
+        return dc_voxel_grid_new_sparse(sx, sy, sz, cell_size, band);
+    DC_VoxelGrid *g = dc_voxel_grid_new_soa(sx, sy, sz, cell_size);
+    if (g) dc_voxel_grid_set_band(g, band);
+    return g;
+}
+
+/* A compiled voxel scene: one SDF program in grid coordinates (world
+ * minus bmin) and the grid it is sized for. */
+typedef struct {
+    DC_SdfProgram *prog;
+    float          bmin[3];     /* world position of the grid origin */
+    float          cell_size;
+    int            size[3];
+    int            resolution;
+    uint8_t        rgb[3];
+} VoxScene;
+
+/* Size the scene grid and compile the voxel ops into sc->prog.
+ * Returns 1 on success, 0 when there is no geometry, -1 on error. */
+static int
+vox_scene_build(DC_CubeiformEda *eda, VoxScene *sc, DC_Error *err)
 {
     if (!eda || !eda->vox_ops || dc_array_length(eda->vox_ops) == 0)
-        return NULL;
+        return 0;
 
     /* Check if there are any actual primitives (not just settings).
      * Without primitives, there's nothing to voxelize — bail early. */
@@ -2416,7 +2646,7 @@ dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda, DC_Error *err)
                 op->type == DC_VOX_OP_CYLINDER || op->type == DC_VOX_OP_TORUS)
                 has_prim = 1;
         }
-        if (!has_prim) return NULL;
+        if (!has_prim) return 0;
     }
 
     int resolution = 64;
@@ -2430,31 +2660,25 @@ dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda, DC_Error *err)
     float bmax[3] = {-1e18f, -1e18f, -1e18f};
 
     /* Transform stack for bounding box pass */
-    #define MAX_XFORM_DEPTH 32
-    DC_SdfTransform xform_stack[MAX_XFORM_DEPTH];
+    DC_SdfTransform xform_stack[VOX_XFORM_DEPTH];
     int xform_depth = 0;
     dc_sdf_transform_identity(&xform_stack[0]);
 
-    /* Helper: transform 8 corners of a local AABB through forward transform,
-     * expand world AABB. Defined as a local macro for code reuse. */
-    #define EXPAND_BBOX_TRANSFORMED(lmin0, lmin1, lmin2, lmax0, lmax1, lmax2) \
-    do { \
-        float corners[8][3] = { \
-            {(lmin0),(lmin1),(lmin2)}, {(lmax0),(lmin1),(lmin2)}, \
-            {(lmin0),(lmax1),(lmin2)}, {(lmax0),(lmax1),(lmin2)}, \
-            {(lmin0),(lmin1),(lmax2)}, {(lmax0),(lmin1),(lmax2)}, \
-            {(lmin0),(lmax1),(lmax2)}, {(lmax0),(lmax1),(lmax2)}, \
-        }; \
-        const DC_SdfTransform *_xf = &xform_stack[xform_depth]; \
-        for (int _ci = 0; _ci < 8; _ci++) { \
-            float _wx = _xf->mat[0]*corners[_ci][0] + _xf->mat[4]*corners[_ci][1] + _xf->mat[8]*corners[_ci][2] + _xf->mat[12]; \
-            float _wy = _xf->mat[1]*corners[_ci][0] + _xf->mat[5]*corners[_ci][1] + _xf->mat[9]*corners[_ci][2] + _xf->mat[13]; \
-            float _wz = _xf->mat[2]*corners[_ci][0] + _xf->mat[6]*corners[_ci][1] + _xf->mat[10]*corners[_ci][2] + _xf->mat[14]; \
-            if (_wx < bmin[0]) { bmin[0] = _wx; } if (_wx > bmax[0]) { bmax[0] = _wx; } \
-            if (_wy < bmin[1]) { bmin[1] = _wy; } if (_wy > bmax[1]) { bmax[1] = _wy; } \
-            if (_wz < bmin[2]) { bmin[2] = _wz; } if (_wz > bmax[2]) { bmax[2] = _wz; } \
-        } \
-    } while (0)
+    /* Modifier operands are boxed on their own: the box so far is saved
+     * at MODIFY_BEGIN and merged back once the operand is grown. */
+    size_t ngroups = 0, nmods = 0;
+    for (size_t i = 0; i < nops; i++) {
+        DC_VoxOp *op = dc_array_get(eda->vox_ops, i);
+        if (op->type == DC_VOX_OP_GROUP_BEGIN) ngroups++;
+        if (op->type == DC_VOX_OP_MODIFY_BEGIN) nmods++;
+    }
+    float (*mod_box)[6] = calloc(nmods + 1, sizeof(*mod_box));
+    if (!mod_box) {
+        DC_SET_ERROR(err, DC_ERROR_MEMORY, "voxel modifiers: out of memory");
+        return -1;
+    }
+    size_t mod_depth = 0;
+    float blend_pad = 0; /* a smooth union reaches k/4 past its operands */
 
     for (size_t i = 0; i < nops; i++) {
         DC_VoxOp *op = dc_array_get(eda->vox_ops, i);
@@ -2462,65 +2686,34 @@ dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda, DC_Error *err)
         if (op->type == DC_VOX_OP_SET_CELL_SIZE) user_cell_size = op->cell_size;
 
         /* Transform stack management */
-        if (op->type == DC_VOX_OP_TRANSLATE && xform_depth + 1 < MAX_XFORM_DEPTH) {
-            xform_depth++;
-            xform_stack[xform_depth] = xform_stack[xform_depth - 1];
-            dc_sdf_transform_translate(&xform_stack[xform_depth],
-                                       (float)op->x, (float)op->y, (float)op->z);
+        if (vox_xform_step(op, xform_stack, &xform_depth)) continue;
+
+        if (op->type == DC_VOX_OP_MODIFY_BEGIN) {
+            memcpy(mod_box[mod_depth], bmin, sizeof(bmin));
+            memcpy(mod_box[mod_depth] + 3, bmax, sizeof(bmax));
+            mod_depth++;
+            for (int a = 0; a < 3; a++) { bmin[a] = 1e18f; bmax[a] = -1e18f; }
             continue;
         }
-        if (op->type == DC_VOX_OP_ROTATE && xform_depth + 1 < MAX_XFORM_DEPTH) {
-            xform_depth++;
-            xform_stack[xform_depth] = xform_stack[xform_depth - 1];
-            if (op->radius != 0) {
-                dc_sdf_transform_rotate(&xform_stack[xform_depth],
-                                        (float)op->x, (float)op->y, (float)op->z, (float)op->radius);
-            } else {
-                /* Euler angles: rotate Z, then Y, then X */
-                if ((float)op->z != 0) dc_sdf_transform_rotate(&xform_stack[xform_depth], 0, 0, 1, (float)op->z);
-                if ((float)op->y != 0) dc_sdf_transform_rotate(&xform_stack[xform_depth], 0, 1, 0, (float)op->y);
-                if ((float)op->x != 0) dc_sdf_transform_rotate(&xform_stack[xform_depth], 1, 0, 0, (float)op->x);
+        if ((op->type == DC_VOX_OP_ROUND || op->type == DC_VOX_OP_SHELL ||
+             op->type == DC_VOX_OP_REPEAT) && mod_depth > 0) {
+            vox_modify_bbox(op, &xform_stack[xform_depth], bmin, bmax);
+            mod_depth--;
+            for (int a = 0; a < 3; a++) {
+                if (mod_box[mod_depth][a] < bmin[a]) bmin[a] = mod_box[mod_depth][a];
+                if (mod_box[mod_depth][3 + a] > bmax[a]) bmax[a] = mod_box[mod_depth][3 + a];
             }
             continue;
         }
-        if (op->type == DC_VOX_OP_SCALE && xform_depth + 1 < MAX_XFORM_DEPTH) {
-            xform_depth++;
-            xform_stack[xform_depth] = xform_stack[xform_depth - 1];
-            dc_sdf_transform_scale(&xform_stack[xform_depth],
-                                   (float)op->x, (float)op->y, (float)op->z);
-            continue;
-        }
-        if (op->type == DC_VOX_OP_POP_TRANSFORM) {
-            if (xform_depth > 0) xform_depth--;
-            continue;
-        }
+        if ((op->type == DC_VOX_OP_UNION || op->type == DC_VOX_OP_SUBTRACT ||
+             op->type == DC_VOX_OP_INTERSECT) &&
+            0.25f * (float)op->radius * xform_stack[xform_depth].scale > blend_pad)
+            blend_pad = 0.25f * (float)op->radius * xform_stack[xform_depth].scale;
 
         /* Accumulate bounding box from primitives (transformed) */
-        float r;
-        switch (op->type) {
-        case DC_VOX_OP_SPHERE:
-            r = (float)op->radius;
-            EXPAND_BBOX_TRANSFORMED((float)op->x - r, (float)op->y - r, (float)op->z - r,
-                                    (float)op->x + r, (float)op->y + r, (float)op->z + r);
-            break;
-        case DC_VOX_OP_BOX:
-            EXPAND_BBOX_TRANSFORMED((float)op->x, (float)op->y, (float)op->z,
-                                    (float)op->x2, (float)op->y2, (float)op->z2);
-            break;
-        case DC_VOX_OP_CYLINDER:
-            r = (float)op->radius;
-            EXPAND_BBOX_TRANSFORMED((float)op->x - r, (float)op->y - r, (float)op->z,
-                                    (float)op->x + r, (float)op->y + r, (float)op->radius2);
-            break;
-        case DC_VOX_OP_TORUS:
-            r = (float)(op->radius + op->radius2);
-            EXPAND_BBOX_TRANSFORMED((float)op->x - r, (float)op->y - r, (float)op->z - (float)op->radius2,
-                                    (float)op->x + r, (float)op->y + r, (float)op->z + (float)op->radius2);
-            break;
-        default: break;
-        }
+        vox_prim_bbox(op, &xform_stack[xform_depth], bmin, bmax);
     }
-    #undef EXPAND_BBOX_TRANSFORMED
+    free(mod_box);
 
     if (resolution < 8) resolution = 8;
     if (resolution > 4096) resolution = 4096;
@@ -2529,7 +2722,7 @@ dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda, DC_Error *err)
      * This happens when vox_ops only contain settings ($vd, $vn, etc.)
      * with no actual geometry (sphere, cube, etc.). */
     if (bmin[0] > bmax[0] || bmin[1] > bmax[1] || bmin[2] > bmax[2])
-        return NULL;
+        return 0;
 
     /* Add padding around bounding box */
     float extent[3] = { bmax[0]-bmin[0], bmax[1]-bmin[1], bmax[2]-bmin[2] };
@@ -2539,6 +2732,7 @@ dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda, DC_Error *err)
     if (max_extent < 0.001f) max_extent = 1.0f;
 
     float pad = max_extent * 0.1f;
+    if (pad < blend_pad) pad = blend_pad;
     for (int a = 0; a < 3; a++) { bmin[a] -= pad; bmax[a] += pad; }
     for (int a = 0; a < 3; a++) extent[a] = bmax[a] - bmin[a];
     max_extent = extent[0];
@@ -2566,21 +2760,6 @@ dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda, DC_Error *err)
     if (sy > 4096) sy = 4096;
     if (sz > 4096) sz = 4096;
 
-    DC_VoxelGrid *grid = dc_voxel_grid_new(sx, sy, sz, cell_size);
-    if (!grid) {
-        double gib = (double)((size_t)sx * (size_t)sy * (size_t)sz *
-                              sizeof(DC_Voxel)) / (1024.0*1024.0*1024.0);
-        DC_SET_ERROR(err, DC_ERROR_MEMORY,
-                     "voxel grid alloc refused: %dx%dx%d cells (%.2f GiB). "
-                     "Lower $vd or shrink scene.",
-                     sx, sy, sz, gib);
-        return NULL;
-    }
-
-    /* Store world-space origin so the renderer can position the grid correctly.
-     * bmin is where grid cell (0,0,0) maps to in world space. */
-    dc_voxel_grid_set_origin(grid, bmin[0], bmin[1], bmin[2]);
-
     dc_log(DC_LOG_INFO, DC_LOG_EVENT_EDA,
            "voxel grid: bmin=(%.2f,%.2f,%.2f) bmax=(%.2f,%.2f,%.2f) "
            "size=%dx%dx%d cell=%.4f",
@@ -2593,24 +2772,32 @@ dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda, DC_Error *err)
     #define OY(v) ((float)(v) - bmin[1])
     #define OZ(v) ((float)(v) - bmin[2])
 
-    /* Grid stack for CSG groups.
+    /* Compile the ops into one SDF program (sdf_program.h), evaluated in
+     * a single pass over the grid, so CSG groups never need a grid each.
      * Op layout: GROUP_BEGIN left GROUP_END CSG_OP GROUP_BEGIN right GROUP_END
-     * - GROUP_BEGIN: push new empty grid
-     * - GROUP_END: if CSG pending AND sp >= 2, pop two, combine, push result
-     * - CSG_OP: set pending flag (between two groups)
-     * - Primitives: render into grid_stack[grid_sp] */
-    #define MAX_GRID_STACK 16
-    DC_VoxelGrid *grid_stack[MAX_GRID_STACK];
-    int grid_sp = 0;
+     * - GROUP_BEGIN: open a new level, empty so far
+     * - GROUP_END: if CSG pending AND level >= 2, combine the top two levels
+     * - CSG_OP: set pending flag (between two groups), and blend radius
+     * - Primitives: union into the top level
+     * - MODIFY_BEGIN: open a level of its own, setting the pending CSG
+     *   aside; the modifier closing it unions its open levels, modifies
+     *   the result and unions that into the level below
+     * A level holds at most one value on the program stack; has_value marks
+     * the levels that do. An empty level acts as +INF, as an empty grid. */
+    DC_SdfProgram *prog = dc_sdf_program_new();
+    uint8_t *has_value = calloc(ngroups + nmods + 1, 1);
+    struct { size_t level; int csg; float blend; } *mods =
+        calloc(nmods + 1, sizeof(*mods));
+    size_t level = 0, nmod = 0;
     int csg_pending_type = 0; /* 0=none, 1=subtract, 2=intersect, 3=union */
-
-    grid_stack[0] = grid;
+    float csg_pending_blend = 0;
+    int rc = prog && has_value && mods ? 0 : -1;
 
     /* Reset transform stack for second pass */
     xform_depth = 0;
     dc_sdf_transform_identity(&xform_stack[0]);
 
-    for (size_t i = 0; i < nops; i++) {
+    for (size_t i = 0; i < nops && rc == 0; i++) {
         DC_VoxOp *op = dc_array_get(eda->vox_ops, i);
 
         switch (op->type) {
@@ -2619,72 +2806,93 @@ dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda, DC_Error *err)
             break;
 
         case DC_VOX_OP_GROUP_BEGIN:
-            if (grid_sp + 1 < MAX_GRID_STACK) {
-                grid_sp++;
-                grid_stack[grid_sp] = dc_voxel_grid_new(sx, sy, sz, cell_size);
-            }
+            has_value[++level] = 0;
             break;
 
         case DC_VOX_OP_GROUP_END:
-            /* If CSG pending and we have at least 2 grids, combine */
-            if (csg_pending_type && grid_sp >= 2) {
-                DC_VoxelGrid *right_g = grid_stack[grid_sp];
-                grid_sp--;
-                DC_VoxelGrid *left_g = grid_stack[grid_sp];
-
-                DC_VoxelGrid *out = dc_voxel_grid_new(sx, sy, sz, cell_size);
-                if (out) {
-                    if (csg_pending_type == 1) dc_sdf_subtract(left_g, right_g, out);
-                    else if (csg_pending_type == 2) dc_sdf_intersect(left_g, right_g, out);
-                    else dc_sdf_union(left_g, right_g, out);
-                    dc_voxel_grid_free(left_g);
-                    grid_stack[grid_sp] = out;
+            /* If CSG pending and we have at least 2 levels, combine */
+            if (csg_pending_type && level >= 2) {
+                int left = has_value[level - 1], right = has_value[level];
+                float k = csg_pending_blend;
+                if (left && right) {
+                    if (csg_pending_type == 1) rc |= dc_sdf_program_smooth_subtract(prog, k);
+                    else if (csg_pending_type == 2) rc |= dc_sdf_program_smooth_intersect(prog, k);
+                    else rc |= dc_sdf_program_smooth_union(prog, k);
+                } else if ((left || right) &&
+                           (csg_pending_type == 2 ||
+                            (csg_pending_type == 1 && right))) {
+                    /* Intersecting with, or subtracting from, an empty
+                     * level leaves nothing */
+                    rc |= dc_sdf_program_empty(prog);
+                    rc |= dc_sdf_program_intersect(prog);
                 }
-                dc_voxel_grid_free(right_g);
+                has_value[level - 1] = (uint8_t)(left || right);
+                level--;
                 csg_pending_type = 0;
             }
             break;
 
-        case DC_VOX_OP_SUBTRACT:  csg_pending_type = 1; break;
-        case DC_VOX_OP_INTERSECT: csg_pending_type = 2; break;
-        case DC_VOX_OP_UNION:     csg_pending_type = 3; break;
+        case DC_VOX_OP_SUBTRACT:
+        case DC_VOX_OP_INTERSECT:
+        case DC_VOX_OP_UNION:
+            csg_pending_type = op->type == DC_VOX_OP_SUBTRACT ? 1 :
+                               op->type == DC_VOX_OP_INTERSECT ? 2 : 3;
+            csg_pending_blend = (float)op->radius * xform_stack[xform_depth].scale;
+            break;
+
+        case DC_VOX_OP_MODIFY_BEGIN:
+            mods[nmod].level = ++level;
+            mods[nmod].csg = csg_pending_type;
+            mods[nmod].blend = csg_pending_blend;
+            nmod++;
+            has_value[level] = 0;
+            csg_pending_type = 0;
+            break;
+
+        case DC_VOX_OP_ROUND:
+        case DC_VOX_OP_SHELL:
+        case DC_VOX_OP_REPEAT: {
+            if (nmod == 0) break;
+            nmod--;
+            for (; level > mods[nmod].level; level--) {
+                if (has_value[level] && has_value[level - 1])
+                    rc |= dc_sdf_program_union(prog);
+                has_value[level - 1] |= has_value[level];
+            }
+            /* Radii and periods are in the modifier's frame */
+            const DC_SdfTransform *xf = &xform_stack[xform_depth];
+            if (has_value[level] && op->type == DC_VOX_OP_ROUND) {
+                rc |= dc_sdf_program_round(prog, (float)op->radius * xf->scale);
+            } else if (has_value[level] && op->type == DC_VOX_OP_SHELL) {
+                rc |= dc_sdf_program_shell(prog, (float)op->radius * xf->scale);
+            } else if (has_value[level]) {
+                DC_SdfTransform full, composed;
+                dc_sdf_transform_identity(&full);
+                dc_sdf_transform_translate(&full, -bmin[0], -bmin[1], -bmin[2]);
+                dc_sdf_transform_compose(&full, xf, &composed);
+                float period[3] = { (float)op->x, (float)op->y, (float)op->z };
+                int count[3] = { (int)op->x2, (int)op->y2, (int)op->z2 };
+                rc |= dc_sdf_program_repeat(prog, period, count,
+                                            xform_depth > 0 ? &composed : NULL);
+            }
+            csg_pending_type = mods[nmod].csg;
+            csg_pending_blend = mods[nmod].blend;
+            if (has_value[level] && has_value[level - 1])
+                rc |= dc_sdf_program_union(prog);
+            has_value[level - 1] |= has_value[level];
+            level--;
+            break;
+        }
 
         case DC_VOX_OP_COLOR:
             cr = op->r; cg = op->g; cb = op->b;
             break;
 
         case DC_VOX_OP_TRANSLATE:
-            if (xform_depth + 1 < MAX_XFORM_DEPTH) {
-                xform_depth++;
-                xform_stack[xform_depth] = xform_stack[xform_depth - 1];
-                dc_sdf_transform_translate(&xform_stack[xform_depth],
-                                           (float)op->x, (float)op->y, (float)op->z);
-            }
-            break;
         case DC_VOX_OP_ROTATE:
-            if (xform_depth + 1 < MAX_XFORM_DEPTH) {
-                xform_depth++;
-                xform_stack[xform_depth] = xform_stack[xform_depth - 1];
-                if (op->radius != 0) {
-                    dc_sdf_transform_rotate(&xform_stack[xform_depth],
-                                            (float)op->x, (float)op->y, (float)op->z, (float)op->radius);
-                } else {
-                    if ((float)op->z != 0) dc_sdf_transform_rotate(&xform_stack[xform_depth], 0, 0, 1, (float)op->z);
-                    if ((float)op->y != 0) dc_sdf_transform_rotate(&xform_stack[xform_depth], 0, 1, 0, (float)op->y);
-                    if ((float)op->x != 0) dc_sdf_transform_rotate(&xform_stack[xform_depth], 1, 0, 0, (float)op->x);
-                }
-            }
-            break;
         case DC_VOX_OP_SCALE:
-            if (xform_depth + 1 < MAX_XFORM_DEPTH) {
-                xform_depth++;
-                xform_stack[xform_depth] = xform_stack[xform_depth - 1];
-                dc_sdf_transform_scale(&xform_stack[xform_depth],
-                                       (float)op->x, (float)op->y, (float)op->z);
-            }
-            break;
         case DC_VOX_OP_POP_TRANSFORM:
-            if (xform_depth > 0) xform_depth--;
+            vox_xform_step(op, xform_stack, &xform_depth);
             break;
 
         case DC_VOX_OP_TO_MESH:
@@ -2695,8 +2903,6 @@ dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda, DC_Error *err)
         case DC_VOX_OP_BOX:
         case DC_VOX_OP_CYLINDER:
         case DC_VOX_OP_TORUS: {
-            DC_VoxelGrid *target = grid_stack[grid_sp];
-
             /* Build the full transform: grid offset (bmin shift) + user transform. */
             DC_SdfTransform full;
             dc_sdf_transform_identity(&full);
@@ -2704,74 +2910,453 @@ dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda, DC_Error *err)
             DC_SdfTransform composed;
             dc_sdf_transform_compose(&full, &xform_stack[xform_depth], &composed);
 
-            int has_xform = xform_depth > 0;
+            const DC_SdfTransform *t = xform_depth > 0 ? &composed : NULL;
 
             if (op->type == DC_VOX_OP_SPHERE) {
-                if (has_xform)
-                    dc_sdf_sphere_t(target, (float)op->x, (float)op->y, (float)op->z,
-                                    (float)op->radius, &composed);
+                if (t)
+                    rc |= dc_sdf_program_sphere(prog, (float)op->x, (float)op->y, (float)op->z,
+                                                (float)op->radius, t);
                 else
-                    dc_sdf_sphere(target, OX(op->x), OY(op->y), OZ(op->z), (float)op->radius);
+                    rc |= dc_sdf_program_sphere(prog, OX(op->x), OY(op->y), OZ(op->z),
+                                                (float)op->radius, NULL);
             } else if (op->type == DC_VOX_OP_BOX) {
-                if (has_xform)
-                    dc_sdf_box_t(target, (float)op->x, (float)op->y, (float)op->z,
-                                 (float)op->x2, (float)op->y2, (float)op->z2, &composed);
+                if (t)
+                    rc |= dc_sdf_program_box(prog, (float)op->x, (float)op->y, (float)op->z,
+                                             (float)op->x2, (float)op->y2, (float)op->z2, t);
                 else
-                    dc_sdf_box(target, OX(op->x), OY(op->y), OZ(op->z),
-                                       OX(op->x2), OY(op->y2), OZ(op->z2));
+                    rc |= dc_sdf_program_box(prog, OX(op->x), OY(op->y), OZ(op->z),
+                                             OX(op->x2), OY(op->y2), OZ(op->z2), NULL);
             } else if (op->type == DC_VOX_OP_CYLINDER) {
-                if (has_xform)
-                    dc_sdf_cylinder_t(target, (float)op->x, (float)op->y, (float)op->radius,
-                                      (float)op->z, (float)op->radius2, &composed);
+                if (t)
+                    rc |= dc_sdf_program_cylinder(prog, (float)op->x, (float)op->y, (float)op->radius,
+                                                  (float)op->z, (float)op->radius2, t);
                 else
-                    dc_sdf_cylinder(target, OX(op->x), OY(op->y), (float)op->radius,
-                                            OZ(op->z), OZ(op->radius2));
-            } else if (op->type == DC_VOX_OP_TORUS) {
-                if (has_xform)
-                    dc_sdf_torus_t(target, (float)op->x, (float)op->y, (float)op->z,
-                                   (float)op->radius, (float)op->radius2, &composed);
+                    rc |= dc_sdf_program_cylinder(prog, OX(op->x), OY(op->y), (float)op->radius,
+                                                  OZ(op->z), OZ(op->radius2), NULL);
+            } else {
+                if (t)
+                    rc |= dc_sdf_program_torus(prog, (float)op->x, (float)op->y, (float)op->z,
+                                               (float)op->radius, (float)op->radius2, t);
                 else
-                    dc_sdf_torus(target, OX(op->x), OY(op->y), OZ(op->z),
-                                         (float)op->radius, (float)op->radius2);
+                    rc |= dc_sdf_program_torus(prog, OX(op->x), OY(op->y), OZ(op->z),
+                                               (float)op->radius, (float)op->radius2, NULL);
             }
+            if (has_value[level]) rc |= dc_sdf_program_union(prog);
+            has_value[level] = 1;
             break;
         }
         }
     }
 
-    /* Collapse remaining grid stack — merge into base grid */
-    while (grid_sp > 0) {
-        DC_VoxelGrid *top = grid_stack[grid_sp];
-        grid_sp--;
-        /* Union remaining grids into base */
-        dc_sdf_union(grid_stack[grid_sp], top, grid_stack[grid_sp]);
-        dc_voxel_grid_free(top);
+    /* Collapse remaining levels — union into the base level */
+    for (; level > 0 && rc == 0; level--) {
+        if (has_value[level] && has_value[level - 1])
+            rc |= dc_sdf_program_union(prog);
+        has_value[level - 1] |= has_value[level];
     }
+    free(has_value);
+    free(mods);
+
+    if (rc != 0) {
+        dc_sdf_program_free(prog);
+        DC_SET_ERROR(err, DC_ERROR_MEMORY, "voxel SDF program: out of memory");
+        return -1;
+    }
+    dc_log(DC_LOG_INFO, DC_LOG_EVENT_EDA,
+           "Cubeiform voxel: %zu-instruction SDF program", dc_sdf_program_length(prog));
 
-    grid = grid_stack[0];
     #undef OX
     #undef OY
     #undef OZ
-    #undef MAX_XFORM_DEPTH
+
+    sc->prog = prog;
+    memcpy(sc->bmin, bmin, sizeof(sc->bmin));
+    sc->cell_size = cell_size;
+    sc->size[0] = sx;
+    sc->size[1] = sy;
+    sc->size[2] = sz;
+    sc->resolution = resolution;
+    sc->rgb[0] = cr;
+    sc->rgb[1] = cg;
+    sc->rgb[2] = cb;
+    return 1;
+}
+
+DC_VoxelGrid *
+dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda, DC_Error *err)
+{
+    VoxScene sc;
+    if (vox_scene_build(eda, &sc, err) <= 0) return NULL;
+    int sx = sc.size[0], sy = sc.size[1], sz = sc.size[2];
+    float cell_size = sc.cell_size;
+
+    DC_VoxelGrid *grid = vox_grid_new(sx, sy, sz, cell_size);
+    if (!grid) {
+        double gib = (double)((size_t)sx * (size_t)sy * (size_t)sz *
+                              sizeof(DC_Voxel)) / (1024.0*1024.0*1024.0);
+        dc_sdf_program_free(sc.prog);
+        DC_SET_ERROR(err, DC_ERROR_MEMORY,
+                     "voxel grid alloc refused: %dx%dx%d cells (%.2f GiB). "
+                     "Lower $vd or shrink the scene to view it; "
+                     "Export STL still works (streams Z-slabs).",
+                     sx, sy, sz, gib);
+        return NULL;
+    }
+
+    /* Store world-space origin so the renderer can position the grid correctly.
+     * bmin is where grid cell (0,0,0) maps to in world space. */
+    dc_voxel_grid_set_origin(grid, sc.bmin[0], sc.bmin[1], sc.bmin[2]);
+
+    int rc = dc_sdf_program_eval(sc.prog, grid);
+    dc_sdf_program_free(sc.prog);
+    if (rc != 0) {
+        dc_voxel_grid_free(grid);
+        DC_SET_ERROR(err, DC_ERROR_MEMORY, "voxel SDF program: out of memory");
+        return NULL;
+    }
 
     /* Activate voxels and fill ALL cells with the solid color.
      * The SDF texture determines the surface boundary — color must
      * be present everywhere so trilinear interpolation doesn't blend
-     * with black at the zero-crossing. */
+     * with black at the zero-crossing. Cells no primitive reached still
+     * hold +INF; clamping to the band keeps GL filtering finite. */
+    dc_sdf_clamp(grid, DC_SDF_BAND_CELLS * cell_size);
     dc_sdf_activate(grid);
-    {
-        for (int iz = 0; iz < sz; iz++)
-        for (int iy = 0; iy < sy; iy++)
-        for (int ix = 0; ix < sx; ix++) {
-            DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
-            if (v) { v->r = cr; v->g = cg; v->b = cb; }
-        }
+    dc_voxel_grid_fill_color(grid, sc.rgb[0], sc.rgb[1], sc.rgb[2]);
+
+    if (dc_voxel_grid_is_sparse(grid)) {
+        size_t pruned = dc_voxel_grid_prune(grid);
+        dc_log(DC_LOG_INFO, DC_LOG_EVENT_EDA,
+               "Cubeiform voxel: sparse, %zu bricks (%zu pruned), %.1f MiB",
+               dc_voxel_grid_brick_count(grid), pruned,
+               (double)dc_voxel_grid_memory_bytes(grid) / (1024.0*1024.0));
     }
 
     dc_log(DC_LOG_INFO, DC_LOG_EVENT_EDA,
            "Cubeiform voxel: %dx%dx%d grid, %zu active",
-           resolution, resolution, resolution,
+           sc.resolution, sc.resolution, sc.resolution,
            dc_voxel_grid_active_count(grid));
 
     return grid;
 }
+
+/* =========================================================================
+ * Incremental update — re-evaluate only what an edit reaches
+ * ========================================================================= */
+
+/* Where one voxel op acts: the world box of a primitive, of a modifier's
+ * result or of a CSG op's two operands (empty, lo > hi, for other ops;
+ * unbounded until both operands of a CSG op are seen), the transform it
+ * sits under, and for a modifier the index of its MODIFY_BEGIN. */
+typedef struct {
+    float  lo[3], hi[3];
+    float  mat[16];
+    size_t open;
+} VoxOpExtent;
+
+static void
+vox_box_union(float lo[3], float hi[3], const float lo2[3], const float hi2[3])
+{
+    for (int a = 0; a < 3; a++) {
+        if (lo2[a] < lo[a]) lo[a] = lo2[a];
+        if (hi2[a] > hi[a]) hi[a] = hi2[a];
+    }
+}
+
+/* Extents of all n voxel ops of eda into ext; *reach receives how far a
+ * change can show beyond them through smooth CSG (each blend moves the
+ * surface up to k/4 and reaches k further). Returns -1 if out of memory. */
+static int
+vox_op_extents(const DC_CubeiformEda *eda, VoxOpExtent *ext, float *reach)
+{
+    size_t n = dc_array_length(eda->vox_ops);
+    /* Open GROUP_BEGIN/MODIFY_BEGIN levels: index and the box so far */
+    size_t *open = malloc((n + 1) * sizeof(*open));
+    float (*saved)[6] = malloc((n + 1) * sizeof(*saved));
+    if (!open || !saved) {
+        free(open);
+        free(saved);
+        return -1;
+    }
+    size_t depth = 0;
+    float lo[3] = { 1e18f, 1e18f, 1e18f }, hi[3] = { -1e18f, -1e18f, -1e18f };
+    DC_SdfTransform xform_stack[VOX_XFORM_DEPTH];
+    int xform_depth = 0;
+    dc_sdf_transform_identity(&xform_stack[0]);
+    *reach = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const DC_VoxOp *op = dc_array_get(eda->vox_ops, i);
+        VoxOpExtent *e = &ext[i];
+        const DC_SdfTransform *xf = &xform_stack[xform_depth];
+        memcpy(e->mat, xf->mat, sizeof(e->mat));
+        e->open = i;
+        for (int a = 0; a < 3; a++) { e->lo[a] = 1e18f; e->hi[a] = -1e18f; }
+        if (vox_xform_step(op, xform_stack, &xform_depth)) continue;
+
+        switch (op->type) {
+        case DC_VOX_OP_GROUP_BEGIN:
+        case DC_VOX_OP_MODIFY_BEGIN:
+            open[depth] = i;
+            memcpy(saved[depth], lo, sizeof(lo));
+            memcpy(saved[depth] + 3, hi, sizeof(hi));
+            depth++;
+            for (int a = 0; a < 3; a++) { lo[a] = 1e18f; hi[a] = -1e18f; }
+            break;
+
+        case DC_VOX_OP_GROUP_END:
+        case DC_VOX_OP_ROUND:
+        case DC_VOX_OP_SHELL:
+        case DC_VOX_OP_REPEAT: {
+            if (depth == 0) break;
+            if (op->type != DC_VOX_OP_GROUP_END) vox_modify_bbox(op, xf, lo, hi);
+            memcpy(e->lo, lo, sizeof(lo));
+            memcpy(e->hi, hi, sizeof(hi));
+            e->open = open[--depth];
+            /* GROUP_BEGIN l GROUP_END csg GROUP_BEGIN r GROUP_END */
+            size_t o = e->open;
+            if (op->type == DC_VOX_OP_GROUP_END && o >= 2) {
+                const DC_VoxOp *csg = dc_array_get(eda->vox_ops, o - 1);
+                if (csg->type == DC_VOX_OP_SUBTRACT || csg->type == DC_VOX_OP_INTERSECT ||
+                    csg->type == DC_VOX_OP_UNION) {
+                    VoxOpExtent *c = &ext[o - 1];
+                    memcpy(c->lo, ext[o - 2].lo, sizeof(c->lo));
+                    memcpy(c->hi, ext[o - 2].hi, sizeof(c->hi));
+                    vox_box_union(c->lo, c->hi, lo, hi);
+                }
+            }
+            vox_box_union(lo, hi, saved[depth], saved[depth] + 3);
+            break;
+        }
+
+        case DC_VOX_OP_SUBTRACT:
+        case DC_VOX_OP_INTERSECT:
+        case DC_VOX_OP_UNION:
+            for (int a = 0; a < 3; a++) { e->lo[a] = -1e18f; e->hi[a] = 1e18f; }
+            *reach += 1.25f * (float)fabs(op->radius) * xf->scale;
+            break;
+
+        default:
+            if (vox_prim_bbox(op, xf, e->lo, e->hi))
+                vox_box_union(lo, hi, e->lo, e->hi);
+            break;
+        }
+    }
+    free(open);
+    free(saved);
+    return 0;
+}
+
+static int
+vox_op_equal(const DC_VoxOp *a, const DC_VoxOp *b)
+{
+    return a->type == b->type &&
+           a->x == b->x && a->y == b->y && a->z == b->z &&
+           a->x2 == b->x2 && a->y2 == b->y2 && a->z2 == b->z2 &&
+           a->radius == b->radius && a->radius2 == b->radius2 &&
+           a->resolution == b->resolution && a->cell_size == b->cell_size &&
+           a->r == b->r && a->g == b->g && a->b == b->b;
+}
+
+int
+dc_cubeiform_eda_patch_voxel(DC_CubeiformEda *eda, const DC_CubeiformEda *prev,
+                             DC_VoxelGrid *grid, int lo[3], int hi[3],
+                             DC_Error *err)
+{
+    if (!eda || !prev || !grid || !lo || !hi) {
+        DC_SET_ERROR(err, DC_ERROR_INVALID_ARG, "NULL argument");
+        return -1;
+    }
+    for (int a = 0; a < 3; a++) lo[a] = hi[a] = 0;
+
+    /* Only the same ops with other parameters can be patched */
+    size_t n = dc_array_length(eda->vox_ops);
+    if (n == 0 || n != dc_array_length(prev->vox_ops)) return 0;
+    for (size_t i = 0; i < n; i++) {
+        const DC_VoxOp *a = dc_array_get(eda->vox_ops, i);
+        const DC_VoxOp *b = dc_array_get(prev->vox_ops, i);
+        if (a->type != b->type) return 0;
+        /* Resolution and color reach every cell */
+        if ((a->type == DC_VOX_OP_SET_RESOLUTION || a->type == DC_VOX_OP_SET_CELL_SIZE ||
+             a->type == DC_VOX_OP_COLOR) && !vox_op_equal(a, b))
+            return 0;
+    }
+
+    /* ...and only while the scene keeps the grid's box and cells */
+    VoxScene sc;
+    int built = vox_scene_build(eda, &sc, err);
+    if (built <= 0) return built;
+    float ox, oy, oz;
+    dc_voxel_grid_get_origin(grid, &ox, &oy, &oz);
+    if (sc.size[0] != dc_voxel_grid_size_x(grid) ||
+        sc.size[1] != dc_voxel_grid_size_y(grid) ||
+        sc.size[2] != dc_voxel_grid_size_z(grid) ||
+        sc.cell_size != dc_voxel_grid_cell_size(grid) ||
+        sc.bmin[0] != ox || sc.bmin[1] != oy || sc.bmin[2] != oz) {
+        dc_sdf_program_free(sc.prog);
+        return 0;
+    }
+
+    VoxOpExtent *now = malloc(n * sizeof(*now));
+    VoxOpExtent *was = malloc(n * sizeof(*was));
+    size_t *changed = malloc((n + 1) * sizeof(*changed));
+    float reach_now = 0, reach_was = 0;
+    if (!now || !was || !changed ||
+        vox_op_extents(eda, now, &reach_now) != 0 ||
+        vox_op_extents(prev, was, &reach_was) != 0) {
+        free(now);
+        free(was);
+        free(changed);
+        dc_sdf_program_free(sc.prog);
+        DC_SET_ERROR(err, DC_ERROR_MEMORY, "voxel patch: out of memory");
+        return -1;
+    }
+
+    /* Changed ops, by parameter or by the transform above them, as a
+     * running count; then the union of their boxes before and after. A
+     * change inside a modifier reaches the whole modified shape (every
+     * copy of a repeat). */
+    changed[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        int c = !vox_op_equal(dc_array_get(eda->vox_ops, i),
+                              dc_array_get(prev->vox_ops, i)) ||
+                memcmp(now[i].mat, was[i].mat, sizeof(now[i].mat)) != 0;
+        changed[i + 1] = changed[i] + (size_t)c;
+    }
+    float dlo[3] = { 1e18f, 1e18f, 1e18f }, dhi[3] = { -1e18f, -1e18f, -1e18f };
+    for (size_t i = 0; i < n; i++) {
+        const DC_VoxOp *op = dc_array_get(eda->vox_ops, i);
+        int modifier = (op->type == DC_VOX_OP_ROUND || op->type == DC_VOX_OP_SHELL ||
+                        op->type == DC_VOX_OP_REPEAT) && now[i].open < i;
+        size_t from = modifier ? now[i].open : i;
+        if (changed[i + 1] == changed[from]) continue;
+        vox_box_union(dlo, dhi, now[i].lo, now[i].hi);
+        vox_box_union(dlo, dhi, was[i].lo, was[i].hi);
+    }
+    int any = changed[n] > 0;
+    free(now);
+    free(was);
+    free(changed);
+
+    /* Cells whose clamped value can change: those within the band, the
+     * blends' reach and half a cell of rounding of the changed boxes.
+     * Rows start on a tile column so the values match a full build. */
+    float cs = sc.cell_size, band = DC_SDF_BAND_CELLS * cs;
+    float pad = band + (reach_now > reach_was ? reach_now : reach_was) + cs;
+    int c0[3], c1[3];
+    for (int a = 0; a < 3 && any; a++) {
+        float l = (dlo[a] - pad - sc.bmin[a]) / cs - 0.5f;
+        float h = (dhi[a] + pad - sc.bmin[a]) / cs - 0.5f;
+        c0[a] = l <= 0.0f ? 0 : l >= (float)sc.size[a] ? sc.size[a] : (int)floorf(l);
+        c1[a] = h < 0.0f ? 0 : h >= (float)(sc.size[a] - 1) ? sc.size[a]
+                                                          : (int)ceilf(h) + 1;
+        if (c0[a] >= c1[a]) any = 0;
+    }
+    if (!any) {
+        dc_sdf_program_free(sc.prog);
+        return 1;
+    }
+    c0[0] -= c0[0] % DC_VOXEL_BRICK;
+
+    int nx = c1[0] - c0[0], ny = c1[1] - c0[1], nz = c1[2] - c0[2];
+    DC_VoxelGrid *part = dc_voxel_grid_new_soa(nx, ny, nz, cs);
+    int rc = part ? dc_voxel_grid_set_band(part, band) : -1;
+    if (rc == 0) rc = dc_sdf_program_eval_region(sc.prog, part, c0);
+    dc_sdf_program_free(sc.prog);
+    if (rc != 0) {
+        dc_voxel_grid_free(part);
+        DC_SET_ERROR(err, DC_ERROR_MEMORY, "voxel patch: out of memory");
+        return -1;
+    }
+    dc_sdf_clamp(part, band);
+
+    /* Write the box back as dc_cubeiform_eda_apply_voxel leaves cells:
+     * active inside, color untouched */
+    const float *src = dc_voxel_grid_distances_const(part);
+    float *plane = dc_voxel_grid_distances(grid);
+    uint8_t *act = plane ? dc_voxel_grid_active_plane(grid) : NULL;
+    int gx = sc.size[0], gy = sc.size[1];
+    for (int iz = 0; iz < nz; iz++)
+    for (int iy = 0; iy < ny; iy++) {
+        const float *row = src + ((size_t)iz * ny + iy) * nx;
+        size_t at = ((size_t)(c0[2] + iz) * gy + (c0[1] + iy)) * gx + c0[0];
+        if (plane && act) {
+            memcpy(plane + at, row, (size_t)nx * sizeof(float));
+            for (int ix = 0; ix < nx; ix++) act[at + ix] = row[ix] <= 0.0f;
+            continue;
+        }
+        for (int ix = 0; ix < nx; ix++) {
+            DC_Voxel v;
+            if (dc_voxel_grid_load(grid, c0[0] + ix, c0[1] + iy, c0[2] + iz, &v) != 0)
+                continue;
+            v.distance = row[ix];
+            v.active = row[ix] <= 0.0f;
+            dc_voxel_grid_set(grid, c0[0] + ix, c0[1] + iy, c0[2] + iz, v);
+        }
+    }
+    dc_voxel_grid_free(part);
+
+    for (int a = 0; a < 3; a++) { lo[a] = c0[a]; hi[a] = c1[a]; }
+    dc_log(DC_LOG_INFO, DC_LOG_EVENT_EDA,
+           "Cubeiform voxel: patched %dx%dx%d of %dx%dx%d cells",
+           nx, ny, nz, sc.size[0], sc.size[1], sc.size[2]);
+    return 1;
+}
+
+/* Fill one Z-slab of the scene grid, banded and clamped as
+ * dc_cubeiform_eda_apply_voxel leaves its grid. */
+static int
+vox_scene_fill_slab(void *ctx, DC_VoxelGrid *slab, int z0)
+{
+    const VoxScene *sc = ctx;
+    float band = DC_SDF_BAND_CELLS * sc->cell_size;
+    dc_voxel_grid_set_band(slab, band);
+    if (dc_sdf_program_eval_slab(sc->prog, slab, z0) != 0) return -1;
+    dc_sdf_clamp(slab, band);
+    return 0;
+}
+
+int
+dc_cubeiform_eda_export_stl(DC_CubeiformEda *eda, const char *path,
+                            const DC_MarchingCubesOpts *opts,
+                            size_t *tri_count, DC_Error *err)
+{
+    if (tri_count) *tri_count = 0;
+    if (!path) {
+        DC_SET_ERROR(err, DC_ERROR_INVALID_ARG, "NULL path");
+        return -1;
+    }
+
+    VoxScene sc;
+    int built = vox_scene_build(eda, &sc, err);
+    if (built < 0) return -1;
+    if (built == 0) {
+        DC_SET_ERROR(err, DC_ERROR_INVALID_ARG, "no voxel geometry to export");
+        return -1;
+    }
+
+    DC_McSource src = {
+        .size = { sc.size[0], sc.size[1], sc.size[2] },
+        .cell_size = sc.cell_size,
+        .origin = { sc.bmin[0], sc.bmin[1], sc.bmin[2] },
+        .fill = vox_scene_fill_slab,
+        .ctx = &sc,
+    };
+    size_t ntri = 0;
+    int rc = dc_marching_cubes_stream_stl(&src, 0.0f, opts, path, &ntri);
+    dc_sdf_program_free(sc.prog);
+
+    if (rc < 0) {
+        DC_SET_ERROR(err, DC_ERROR_IO,
+                     "streaming STL export of %dx%dx%d cells to %s failed",
+                     sc.size[0], sc.size[1], sc.size[2], path);
+        return -1;
+    }
+    if (rc == 0) {
+        dc_log(DC_LOG_INFO, DC_LOG_EVENT_EDA,
+               "Cubeiform voxel: streamed %dx%dx%d grid to %s, %zu tris",
+               sc.size[0], sc.size[1], sc.size[2], path, ntri);
+        if (tri_count) *tri_count = ntri;
+    }
+    return rc;
+}
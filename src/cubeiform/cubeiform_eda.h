@@ -25,6 +25,7 @@
 #include "eda/eda_library.h"
 #include "voxel/voxel.h"
 #include "voxel/sdf.h"
+#include "voxel/marching_cubes.h"
 
 /* -------------------------------------------------------------------------
  * EDA operation types
@@ -90,13 +91,17 @@ typedef enum {
     DC_VOX_OP_GROUP_BEGIN,   /* start of CSG operand group */
     DC_VOX_OP_GROUP_END,     /* end of CSG operand group */
     DC_VOX_OP_TO_MESH,       /* >> to_mesh([rows], [cols]) — SDF → bezier mesh */
+    DC_VOX_OP_MODIFY_BEGIN,  /* start of the shape the next ROUND/SHELL/REPEAT modifies */
+    DC_VOX_OP_ROUND,         /* >> round(r) — grow by radius, round the edges */
+    DC_VOX_OP_SHELL,         /* >> shell(t) — hollow wall, radius = thickness */
+    DC_VOX_OP_REPEAT,        /* >> repeat(...) — x,y,z = period, x2,y2,z2 = count */
 } DC_VoxOpType;
 
 typedef struct {
     DC_VoxOpType type;
     double x, y, z;         /* center / min corner */
     double x2, y2, z2;      /* max corner (for box) */
-    double radius;           /* sphere/cylinder radius */
+    double radius;           /* sphere/cylinder radius; CSG: blend radius (0 = sharp) */
     double radius2;          /* torus minor radius, cylinder z1 */
     int    resolution;       /* grid resolution */
     float  cell_size;        /* cell size */
@@ -192,6 +197,35 @@ int dc_cubeiform_execute_full(const char *dcad_src,
 DC_VoxelGrid *dc_cubeiform_eda_apply_voxel(DC_CubeiformEda *eda,
                                               DC_Error *err);
 
+/* Bring grid, built by dc_cubeiform_eda_apply_voxel from the voxel ops of
+ * prev, up to date with the voxel ops of eda without rebuilding it. The
+ * two op lists are compared op by op; only the cells within the band of
+ * the world boxes of the changed ops (before and after the edit) are
+ * evaluated again and written back, so moving or resizing one primitive
+ * costs its neighbourhood, not the grid.
+ *
+ * Returns 1 if grid was patched, with cells [lo, hi) rewritten (an empty
+ * box when nothing changed); 0 if the edit changes more than op
+ * parameters within the same grid box (ops added or removed, resolution,
+ * color, scene bounds), leaving grid untouched for a full
+ * dc_cubeiform_eda_apply_voxel; -1 on error. */
+int dc_cubeiform_eda_patch_voxel(DC_CubeiformEda *eda,
+                                 const DC_CubeiformEda *prev,
+                                 DC_VoxelGrid *grid, int lo[3], int hi[3],
+                                 DC_Error *err);
+
+/* Export the voxel operations' surface as a binary STL at path without
+ * building the grid: the SDF is evaluated a Z-slab at a time and each
+ * slab goes straight through marching cubes to the file (see
+ * dc_marching_cubes_stream_stl), so scenes too large for
+ * dc_cubeiform_eda_apply_voxel still export. Vertices are in world
+ * coordinates. opts may be NULL.
+ * Returns 0 on success (*tri_count, if given, receives the triangle
+ * count), 1 if cancelled, -1 on error. */
+int dc_cubeiform_eda_export_stl(DC_CubeiformEda *eda, const char *path,
+                                const DC_MarchingCubesOpts *opts,
+                                size_t *tri_count, DC_Error *err);
+
 /* Get counts of parsed operations. */
 size_t dc_cubeiform_eda_sch_op_count(const DC_CubeiformEda *eda);
 size_t dc_cubeiform_eda_pcb_op_count(const DC_CubeiformEda *eda);
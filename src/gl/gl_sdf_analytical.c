@@ -48,6 +48,10 @@ static const char *FRAG_SRC =
     "uniform vec3 uPrimSize[64];\n"
     "uniform float uPrimExtra[64];\n"
     "uniform vec3 uPrimColor[64];\n"
+    /* Modifiers: (blend, round, shell), repeat period and count */
+    "uniform vec3 uPrimMod[64];\n"
+    "uniform vec3 uPrimRep[64];\n"
+    "uniform vec3 uPrimRepN[64];\n"
     "\n"
     /* AABB intersection for ray clipping */
     "vec2 intersectAABB(vec3 ro, vec3 rd, vec3 bmin, vec3 bmax) {\n"
@@ -77,23 +81,40 @@ static const char *FRAG_SRC =
     "    return length(d) - r;\n"
     "}\n"
     "\n"
+    /* Polynomial smooth min: a fillet of radius ~k where a and b meet */
+    "float smin(float a, float b, float k) {\n"
+    "    float h = clamp(0.5 + 0.5*(b - a)/k, 0.0, 1.0);\n"
+    "    return mix(b, a, h) - k*h*(1.0 - h);\n"
+    "}\n"
+    /* Repeat domain: fold p onto the nearest copy c + i*per, i in [0, n) */
+    "vec3 repeatDomain(vec3 p, vec3 c, vec3 per, vec3 n) {\n"
+    "    vec3 i = round((p - c) / max(per, vec3(1e-6)));\n"
+    "    i = mix(i, clamp(i, vec3(0.0), n - 1.0), step(vec3(0.5), n));\n"
+    "    return p - i*per;\n"
+    "}\n"
+    "\n"
     /* Evaluate the full SDF scene */
     "float evalSDF(vec3 p, out vec3 col) {\n"
     "    float d = 1e10;\n"
     "    col = vec3(0.7);\n"
     "    for (int i = 0; i < uPrimCount; i++) {\n"
     "        float pd;\n"
-    "        if (uPrimType[i] == 1) pd = sdSphere(p, uPrimPos[i], uPrimSize[i].x);\n"
-    "        else if (uPrimType[i] == 2) pd = sdBox(p, uPrimPos[i], uPrimSize[i]);\n"
-    "        else if (uPrimType[i] == 3) pd = sdCylinder(p, uPrimPos[i], uPrimSize[i].x, uPrimExtra[i]);\n"
-    "        else if (uPrimType[i] == 4) pd = sdTorus(p, uPrimPos[i], uPrimSize[i].x, uPrimExtra[i]);\n"
+    "        vec3 pp = repeatDomain(p, uPrimPos[i], uPrimRep[i], uPrimRepN[i]);\n"
+    "        if (uPrimType[i] == 1) pd = sdSphere(pp, uPrimPos[i], uPrimSize[i].x);\n"
+    "        else if (uPrimType[i] == 2) pd = sdBox(pp, uPrimPos[i], uPrimSize[i]);\n"
+    "        else if (uPrimType[i] == 3) pd = sdCylinder(pp, uPrimPos[i], uPrimSize[i].x, uPrimExtra[i]);\n"
+    "        else if (uPrimType[i] == 4) pd = sdTorus(pp, uPrimPos[i], uPrimSize[i].x, uPrimExtra[i]);\n"
     "        else continue;\n"
+    "        vec3 m = uPrimMod[i];\n"
+    "        pd -= m.y;\n"  /* round */
+    "        if (m.z > 0.0) pd = abs(pd) - 0.5*m.z;\n"  /* shell */
     "        if (uPrimCSG[i] == 1) {\n"
-    "            d = max(d, -pd);\n"  /* subtract: carve away */
+    "            d = m.x > 0.0 ? -smin(-d, pd, m.x) : max(d, -pd);\n"  /* subtract: carve away */
     "        } else if (uPrimCSG[i] == 2) {\n"
-    "            d = max(d, pd);\n"  /* intersect */
+    "            d = m.x > 0.0 ? -smin(-d, -pd, m.x) : max(d, pd);\n"  /* intersect */
     "        } else {\n"
-    "            if (pd < d) { d = pd; col = uPrimColor[i]; }\n"  /* union */
+    "            if (pd < d) col = uPrimColor[i];\n"  /* union */
+    "            d = m.x > 0.0 ? smin(d, pd, m.x) : min(d, pd);\n"
     "        }\n"
     "    }\n"
     "    return d;\n"
@@ -280,6 +301,43 @@ dc_gl_sdf_scene_set_csg(DC_GlSdfScene *s, int csg_op)
     s->prims[s->count - 1].csg_op = csg_op;
 }
 
+void
+dc_gl_sdf_scene_set_blend(DC_GlSdfScene *s, float k)
+{
+    if (!s || s->count <= 0) return;
+    s->prims[s->count - 1].blend = k > 0.0f ? k : 0.0f;
+}
+
+void
+dc_gl_sdf_scene_round(DC_GlSdfScene *s, int first, float r)
+{
+    if (!s || first < 0) return;
+    for (int i = first; i < s->count; i++)
+        s->prims[i].rounding += r;
+}
+
+void
+dc_gl_sdf_scene_shell(DC_GlSdfScene *s, int first, float thickness)
+{
+    if (!s || first < 0 || thickness <= 0.0f) return;
+    for (int i = first; i < s->count; i++)
+        s->prims[i].shell = thickness;
+}
+
+void
+dc_gl_sdf_scene_repeat(DC_GlSdfScene *s, int first,
+                         const float period[3], const int count[3])
+{
+    if (!s || first < 0 || !period || !count) return;
+    for (int i = first; i < s->count; i++) {
+        for (int a = 0; a < 3; a++) {
+            if (period[a] <= 0.0f || count[a] == 1) continue;
+            s->prims[i].rep_period[a] = period[a];
+            s->prims[i].rep_count[a] = count[a] > 0 ? count[a] : 0;
+        }
+    }
+}
+
 void
 dc_gl_sdf_scene_compute_bbox(DC_GlSdfScene *s)
 {
@@ -290,38 +348,42 @@ dc_gl_sdf_scene_compute_bbox(DC_GlSdfScene *s)
     for (int i = 0; i < s->count; i++) {
         DC_SdfPrim *p = &s->prims[i];
         if (p->csg_op == DC_SDF_SUBTRACT) continue; /* subtracted prims don't expand bbox */
-        float r;
+        float ext[3];
         switch (p->type) {
         case DC_SDF_SPHERE:
-            r = p->size[0];
-            for (int a = 0; a < 3; a++) {
-                if (p->pos[a] - r < s->bbox_min[a]) s->bbox_min[a] = p->pos[a] - r;
-                if (p->pos[a] + r > s->bbox_max[a]) s->bbox_max[a] = p->pos[a] + r;
-            }
+            ext[0] = ext[1] = ext[2] = p->size[0];
             break;
         case DC_SDF_BOX:
-            for (int a = 0; a < 3; a++) {
-                if (p->pos[a] - p->size[a] < s->bbox_min[a]) s->bbox_min[a] = p->pos[a] - p->size[a];
-                if (p->pos[a] + p->size[a] > s->bbox_max[a]) s->bbox_max[a] = p->pos[a] + p->size[a];
-            }
+            ext[0] = p->size[0]; ext[1] = p->size[1]; ext[2] = p->size[2];
             break;
         case DC_SDF_CYLINDER:
-            r = p->size[0];
-            if (p->pos[0] - r < s->bbox_min[0]) s->bbox_min[0] = p->pos[0] - r;
-            if (p->pos[0] + r > s->bbox_max[0]) s->bbox_max[0] = p->pos[0] + r;
-            if (p->pos[1] - p->extra < s->bbox_min[1]) s->bbox_min[1] = p->pos[1] - p->extra;
-            if (p->pos[1] + p->extra > s->bbox_max[1]) s->bbox_max[1] = p->pos[1] + p->extra;
-            if (p->pos[2] - r < s->bbox_min[2]) s->bbox_min[2] = p->pos[2] - r;
-            if (p->pos[2] + r > s->bbox_max[2]) s->bbox_max[2] = p->pos[2] + r;
+            ext[0] = ext[2] = p->size[0];
+            ext[1] = p->extra;
             break;
         case DC_SDF_TORUS:
-            r = p->size[0] + p->extra;
-            for (int a = 0; a < 3; a++) {
-                float er = (a == 1) ? p->extra : r;
-                if (p->pos[a] - er < s->bbox_min[a]) s->bbox_min[a] = p->pos[a] - er;
-                if (p->pos[a] + er > s->bbox_max[a]) s->bbox_max[a] = p->pos[a] + er;
-            }
+            ext[0] = ext[2] = p->size[0] + p->extra;
+            ext[1] = p->extra;
             break;
+        default:
+            continue;
+        }
+
+        /* Round and shell move the surface out by rounding + shell/2; a
+         * repeat spans all its copies (unbounded repeats are capped) */
+        float grow = p->rounding + 0.5f * p->shell;
+        for (int a = 0; a < 3; a++) {
+            float lo = p->pos[a] - ext[a] - grow;
+            float hi = p->pos[a] + ext[a] + grow;
+            if (p->rep_period[a] > 0.0f) {
+                if (p->rep_count[a] > 0) {
+                    hi += p->rep_period[a] * (float)(p->rep_count[a] - 1);
+                } else {
+                    lo -= 1e4f;
+                    hi += 1e4f;
+                }
+            }
+            if (lo < s->bbox_min[a]) s->bbox_min[a] = lo;
+            if (hi > s->bbox_max[a]) s->bbox_max[a] = hi;
         }
     }
 
@@ -383,6 +445,9 @@ dc_gl_sdf_draw(DC_GlSdfScene *s,
     float sizes[DC_SDF_MAX_PRIMS * 3];
     float extras[DC_SDF_MAX_PRIMS];
     float colors[DC_SDF_MAX_PRIMS * 3];
+    float mods[DC_SDF_MAX_PRIMS * 3];
+    float reps[DC_SDF_MAX_PRIMS * 3];
+    float rep_n[DC_SDF_MAX_PRIMS * 3];
 
     for (int i = 0; i < s->count; i++) {
         types[i] = s->prims[i].type;
@@ -397,6 +462,13 @@ dc_gl_sdf_draw(DC_GlSdfScene *s,
         colors[i*3+0] = s->prims[i].color[0];
         colors[i*3+1] = s->prims[i].color[1];
         colors[i*3+2] = s->prims[i].color[2];
+        mods[i*3+0] = s->prims[i].blend;
+        mods[i*3+1] = s->prims[i].rounding;
+        mods[i*3+2] = s->prims[i].shell;
+        for (int a = 0; a < 3; a++) {
+            reps[i*3+a] = s->prims[i].rep_period[a];
+            rep_n[i*3+a] = (float)s->prims[i].rep_count[a];
+        }
     }
 
     for (int di = 0; di < s->count; di++) {
@@ -412,6 +484,9 @@ dc_gl_sdf_draw(DC_GlSdfScene *s,
     glUniform3fv(glGetUniformLocation(s->prog, "uPrimSize"), s->count, sizes);
     glUniform1fv(glGetUniformLocation(s->prog, "uPrimExtra"), s->count, extras);
     glUniform3fv(glGetUniformLocation(s->prog, "uPrimColor"), s->count, colors);
+    glUniform3fv(glGetUniformLocation(s->prog, "uPrimMod"), s->count, mods);
+    glUniform3fv(glGetUniformLocation(s->prog, "uPrimRep"), s->count, reps);
+    glUniform3fv(glGetUniformLocation(s->prog, "uPrimRepN"), s->count, rep_n);
 
     glBindVertexArray(s->quad_vao);
     glDrawArrays(GL_TRIANGLES, 0, 6);
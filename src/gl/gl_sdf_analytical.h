@@ -12,6 +12,11 @@
  * The primitive tree is passed as shader uniforms. The shader walks
  * the tree per-pixel, evaluating exact SDF math.
  *
+ * Each primitive may carry modifiers: a smooth blend radius for its CSG
+ * operation, a rounding radius, a shell thickness and a repeat domain.
+ * A repeat folds the sample point onto the nearest copy, so a lattice
+ * of copies costs one primitive evaluation.
+ *
  * Usage:
  *   DC_GlSdfScene scene = {0};
  *   dc_gl_sdf_scene_add_sphere(&scene, cx,cy,cz, r);
@@ -40,6 +45,11 @@ typedef struct {
     float size[3];      /* half-extents (box), radius (sphere), etc. */
     float extra;        /* minor radius (torus), height (cylinder) */
     float color[3];     /* RGB 0-1 */
+    float blend;        /* smooth CSG radius (0 = sharp) */
+    float rounding;     /* rounding radius: distance - rounding */
+    float shell;        /* wall thickness (0 = solid) */
+    float rep_period[3];/* repeat spacing per axis (0 = none) */
+    int   rep_count[3]; /* copies per axis (0 = unbounded) */
 } DC_SdfPrim;
 
 /* Scene: list of primitives */
@@ -80,6 +90,20 @@ void dc_gl_sdf_scene_add_torus(DC_GlSdfScene *s,
 /* Set CSG operation for the last added primitive */
 void dc_gl_sdf_scene_set_csg(DC_GlSdfScene *s, int csg_op);
 
+/* Set the smooth blend radius of the last added primitive's CSG
+ * operation (0 = sharp) */
+void dc_gl_sdf_scene_set_blend(DC_GlSdfScene *s, float k);
+
+/* Modifiers: apply to each primitive from index first to the last added.
+ * A modifier over several primitives is applied to each one in turn,
+ * which matches the modified union where the primitives do not overlap.
+ * Repeat copies start at the primitive and step +period[a] along axis a;
+ * count 1 or period <= 0 leaves an axis unchanged. */
+void dc_gl_sdf_scene_round(DC_GlSdfScene *s, int first, float r);
+void dc_gl_sdf_scene_shell(DC_GlSdfScene *s, int first, float thickness);
+void dc_gl_sdf_scene_repeat(DC_GlSdfScene *s, int first,
+                              const float period[3], const int count[3]);
+
 /* Compute bounding box from primitives */
 void dc_gl_sdf_scene_compute_bbox(DC_GlSdfScene *s);
 
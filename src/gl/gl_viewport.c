@@ -319,6 +319,8 @@ struct DC_GlViewport {
     DC_GlVoxelBuf *voxel_buf;     /* NULL if no voxels loaded */
     int             voxel_pending; /* 1 if grid needs upload on next frame */
     const DC_VoxelGrid *voxel_grid_pending; /* grid to upload */
+    int             voxel_region_pending; /* 1 if only cells lo..hi changed */
+    int             voxel_region_lo[3], voxel_region_hi[3];
     int             voxel_blocky_default; /* stored for when buf is created */
 
     /* Analytical SDF rendering (the Infinite Surface) */
@@ -1039,6 +1041,12 @@ on_render(GtkGLArea *area, GdkGLContext *ctx, gpointer data)
                    dc_gl_voxel_buf_instance_count(vp->voxel_buf));
         }
         vp->voxel_pending = 0;
+        vp->voxel_region_pending = 0;
+        vp->voxel_grid_pending = NULL;
+    } else if (vp->voxel_region_pending && vp->voxel_grid_pending && vp->voxel_buf) {
+        dc_gl_voxel_buf_upload_region(vp->voxel_buf, vp->voxel_grid_pending,
+                                      vp->voxel_region_lo, vp->voxel_region_hi);
+        vp->voxel_region_pending = 0;
         vp->voxel_grid_pending = NULL;
     }
     /* Upload bezier ray mesh if pending */
@@ -2879,6 +2887,7 @@ dc_gl_viewport_set_voxel_grid(DC_GlViewport *vp, const DC_VoxelGrid *grid)
         dc_gl_voxel_buf_free(vp->voxel_buf);
         vp->voxel_buf = NULL;
         vp->voxel_pending = 0;
+        vp->voxel_region_pending = 0;
         vp->voxel_grid_pending = NULL;
         gtk_widget_queue_draw(vp->gl_area);
         return;
@@ -2889,6 +2898,30 @@ dc_gl_viewport_set_voxel_grid(DC_GlViewport *vp, const DC_VoxelGrid *grid)
     gtk_widget_queue_draw(vp->gl_area);
 }
 
+void
+dc_gl_viewport_update_voxel_region(DC_GlViewport *vp, const DC_VoxelGrid *grid,
+                                   const int lo[3], const int hi[3])
+{
+    if (!vp || !grid || !lo || !hi) return;
+    if (hi[0] <= lo[0] || hi[1] <= lo[1] || hi[2] <= lo[2]) return;
+    /* Nothing on the GPU yet, or a full upload already queued */
+    if (!vp->voxel_buf || vp->voxel_pending ||
+        (vp->voxel_grid_pending && vp->voxel_grid_pending != grid)) {
+        dc_gl_viewport_set_voxel_grid(vp, grid);
+        return;
+    }
+    /* Edits between two frames upload the box around all of them */
+    for (int a = 0; a < 3; a++) {
+        if (!vp->voxel_region_pending || lo[a] < vp->voxel_region_lo[a])
+            vp->voxel_region_lo[a] = lo[a];
+        if (!vp->voxel_region_pending || hi[a] > vp->voxel_region_hi[a])
+            vp->voxel_region_hi[a] = hi[a];
+    }
+    vp->voxel_grid_pending = grid;
+    vp->voxel_region_pending = 1;
+    gtk_widget_queue_draw(vp->gl_area);
+}
+
 void
 dc_gl_viewport_set_bezier_ray_mesh(DC_GlViewport *vp, const void *mesh_ptr)
 {
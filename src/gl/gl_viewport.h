@@ -190,6 +190,12 @@ struct DC_VoxelGrid;
 void dc_gl_viewport_set_voxel_grid(DC_GlViewport *vp,
                                      const struct DC_VoxelGrid *grid);
 
+/* The grid on screen was patched in place: re-upload only cells [lo, hi)
+ * on the next frame (a full upload if none happened yet). */
+void dc_gl_viewport_update_voxel_region(DC_GlViewport *vp,
+                                          const struct DC_VoxelGrid *grid,
+                                          const int lo[3], const int hi[3]);
+
 /* Set bezier mesh for direct surface raytracing (smooth mode). */
 void dc_gl_viewport_set_bezier_ray_mesh(DC_GlViewport *vp, const void *mesh_ptr);
 
@@ -43,6 +43,7 @@ static const char *FRAG_SRC =
     "uniform vec3 uLightDir;\n"
     "uniform mat4 uInvVP;\n"
     "uniform float uCellSize;\n"
+    "uniform float uDistScale;\n"
     "uniform int uBlocky;\n"
     "\n"
     "vec2 intersectAABB(vec3 ro, vec3 rd, vec3 bmin, vec3 bmax) {\n"
@@ -58,7 +59,9 @@ static const char *FRAG_SRC =
     "}\n"
     /* Tricubic (smoothstep-weighted) SDF interpolation.
      * Hardware texture() gives trilinear (C0) — visible terracing.
-     * Smoothstep weights give C1 continuity — smooth zero-crossing. */
+     * Smoothstep weights give C1 continuity — smooth zero-crossing.
+     * uDistScale dequantizes an R8_SNORM texture (1 otherwise); the
+     * sign tests and normals below do not need it. */
     "float sdf(vec3 uvw) {\n"
     "    vec3 sz = vec3(textureSize(uSDF, 0));\n"
     "    vec3 tc = uvw * sz - 0.5;\n"
@@ -76,7 +79,7 @@ static const char *FRAG_SRC =
                       "texelFetch(uSDF,ivec3(i1.x,i0.y,i1.z),0).r,w.x);\n"
     "    float d11=mix(texelFetch(uSDF,ivec3(i0.x,i1.y,i1.z),0).r,"
                       "texelFetch(uSDF,ivec3(i1.x,i1.y,i1.z),0).r,w.x);\n"
-    "    return mix(mix(d00,d10,w.y), mix(d01,d11,w.y), w.z);\n"
+    "    return mix(mix(d00,d10,w.y), mix(d01,d11,w.y), w.z) * uDistScale;\n"
     "}\n"
     /* Smooth-mode normals: multi-sample SDF gradient.
      * Average gradients at two radii to suppress noise while
@@ -202,6 +205,9 @@ struct DC_GlVoxelBuf {
     int     uploaded;
     int     active_count;
     float   cell_size;
+    float   dist_scale;     /* world units per texel value (int8: range) */
+    int     size[3];        /* cells of the last full upload */
+    int     dist_format;    /* its DC_VoxelDistFormat */
     float   bbox_min[3];
     float   bbox_max[3];
     int     blocky;
@@ -299,25 +305,59 @@ dc_gl_voxel_buf_upload(DC_GlVoxelBuf *b, const DC_VoxelGrid *grid)
     b->bbox_min[0] = ox; b->bbox_min[1] = oy; b->bbox_min[2] = oz;
     b->bbox_max[0] = ox + sx * cs; b->bbox_max[1] = oy + sy * cs; b->bbox_max[2] = oz + sz * cs;
     b->active_count = (int)dc_voxel_grid_active_count(grid);
+    b->size[0] = sx; b->size[1] = sy; b->size[2] = sz;
+    b->dist_format = dc_voxel_grid_dist_format(grid);
 
     /* --- 3D textures: SDF + color --- */
     size_t total = (size_t)sx * sy * sz;
-    unsigned char *rgb = malloc(total * 3);
-    float *sdf = malloc(total * sizeof(float));
-    if (!rgb || !sdf) { free(rgb); free(sdf); b->uploaded = 1; return 0; }
-
-    for (int iz = 0; iz < sz; iz++)
-    for (int iy = 0; iy < sy; iy++)
-    for (int ix = 0; ix < sx; ix++) {
-        size_t idx = ((size_t)iz * sy + iy) * sx + ix;
-        const DC_Voxel *v = dc_voxel_grid_get_const(grid, ix, iy, iz);
-        if (v) {
-            rgb[idx*3+0] = v->r; rgb[idx*3+1] = v->g; rgb[idx*3+2] = v->b;
-            sdf[idx] = v->distance;
-        } else {
-            rgb[idx*3+0] = rgb[idx*3+1] = rgb[idx*3+2] = 0;
-            sdf[idx] = 1e6f;
+    unsigned char *rgb = NULL;
+    float *sdf = NULL;
+    const unsigned char *rgb_src;
+    const void *sdf_src = dc_voxel_grid_dist_plane(grid, &b->dist_scale);
+
+    /* Quantized grids upload their plane as it is: half floats as R16F,
+     * int8 codes as R8_SNORM (texel value * range = distance) */
+    GLint sdf_ifmt = GL_R32F;
+    GLenum sdf_type = GL_FLOAT;
+    switch (dc_voxel_grid_dist_format(grid)) {
+    case DC_VOXEL_DIST_F32: b->dist_scale = 1.0f; break;
+    case DC_VOXEL_DIST_F16:
+        sdf_ifmt = GL_R16F; sdf_type = GL_HALF_FLOAT; b->dist_scale = 1.0f;
+        break;
+    case DC_VOXEL_DIST_I8:
+        sdf_ifmt = GL_R8_SNORM; sdf_type = GL_BYTE;
+        break;
+    }
+
+    if (sdf_src) {
+        /* SoA grid: the planes are already in texture layout. Only a grid
+         * that never had color needs a (black) color array. */
+        rgb_src = dc_voxel_grid_color_plane_const(grid);
+        if (!rgb_src) {
+            rgb = calloc(total, 3);
+            if (!rgb) { b->uploaded = 1; return 0; }
+            rgb_src = rgb;
+        }
+    } else {
+        rgb = malloc(total * 3);
+        sdf = malloc(total * sizeof(float));
+        if (!rgb || !sdf) { free(rgb); free(sdf); b->uploaded = 1; return 0; }
+
+        for (int iz = 0; iz < sz; iz++)
+        for (int iy = 0; iy < sy; iy++)
+        for (int ix = 0; ix < sx; ix++) {
+            size_t idx = ((size_t)iz * sy + iy) * sx + ix;
+            DC_Voxel v;
+            if (dc_voxel_grid_load(grid, ix, iy, iz, &v) == 0) {
+                rgb[idx*3+0] = v.r; rgb[idx*3+1] = v.g; rgb[idx*3+2] = v.b;
+                sdf[idx] = v.distance;
+            } else {
+                rgb[idx*3+0] = rgb[idx*3+1] = rgb[idx*3+2] = 0;
+                sdf[idx] = 1e6f;
+            }
         }
+        rgb_src = rgb;
+        sdf_src = sdf;
     }
 
     /* Texture filter depends on blocky flag */
@@ -329,7 +369,7 @@ dc_gl_voxel_buf_upload(DC_GlVoxelBuf *b, const DC_VoxelGrid *grid)
 
     if (!b->color_tex) glGenTextures(1, &b->color_tex);
     glBindTexture(GL_TEXTURE_3D, b->color_tex);
-    glTexImage3D(GL_TEXTURE_3D, 0, GL_RGB8, sx, sy, sz, 0, GL_RGB, GL_UNSIGNED_BYTE, rgb);
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_RGB8, sx, sy, sz, 0, GL_RGB, GL_UNSIGNED_BYTE, rgb_src);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, filter);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, filter);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -338,7 +378,7 @@ dc_gl_voxel_buf_upload(DC_GlVoxelBuf *b, const DC_VoxelGrid *grid)
 
     if (!b->sdf_tex) glGenTextures(1, &b->sdf_tex);
     glBindTexture(GL_TEXTURE_3D, b->sdf_tex);
-    glTexImage3D(GL_TEXTURE_3D, 0, GL_R32F, sx, sy, sz, 0, GL_RED, GL_FLOAT, sdf);
+    glTexImage3D(GL_TEXTURE_3D, 0, sdf_ifmt, sx, sy, sz, 0, GL_RED, sdf_type, sdf_src);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, filter);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, filter);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -378,6 +418,79 @@ dc_gl_voxel_buf_upload(DC_GlVoxelBuf *b, const DC_VoxelGrid *grid)
     return 0;
 }
 
+int
+dc_gl_voxel_buf_upload_region(DC_GlVoxelBuf *b, const DC_VoxelGrid *grid,
+                              const int lo[3], const int hi[3])
+{
+    if (!b || !grid || !lo || !hi) return -1;
+
+    int size[3] = { dc_voxel_grid_size_x(grid), dc_voxel_grid_size_y(grid),
+                    dc_voxel_grid_size_z(grid) };
+    float range = 0.0f;
+    const void *plane = dc_voxel_grid_dist_plane(grid, &range);
+    int fmt = dc_voxel_grid_dist_format(grid);
+    /* The texture must still fit the grid as it is */
+    if (!b->uploaded || !b->sdf_tex || fmt != b->dist_format ||
+        (fmt == DC_VOXEL_DIST_I8 && range != b->dist_scale) ||
+        size[0] != b->size[0] || size[1] != b->size[1] || size[2] != b->size[2])
+        return dc_gl_voxel_buf_upload(b, grid);
+
+    int c0[3], n[3];
+    for (int a = 0; a < 3; a++) {
+        c0[a] = lo[a] < 0 ? 0 : lo[a];
+        int c1 = hi[a] > size[a] ? size[a] : hi[a];
+        n[a] = c1 - c0[a];
+        if (n[a] <= 0) return 0;
+    }
+
+    GLenum type = fmt == DC_VOXEL_DIST_F16 ? GL_HALF_FLOAT
+                : fmt == DC_VOXEL_DIST_I8  ? GL_BYTE : GL_FLOAT;
+    float *sdf = NULL;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (plane) {
+        /* Send the box straight out of the plane */
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, size[0]);
+        glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, size[1]);
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, c0[0]);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, c0[1]);
+        glPixelStorei(GL_UNPACK_SKIP_IMAGES, c0[2]);
+    } else {
+        sdf = malloc((size_t)n[0] * n[1] * n[2] * sizeof(float));
+        if (!sdf) {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            return -1;
+        }
+        size_t idx = 0;
+        for (int iz = 0; iz < n[2]; iz++)
+        for (int iy = 0; iy < n[1]; iy++)
+        for (int ix = 0; ix < n[0]; ix++) {
+            DC_Voxel v;
+            sdf[idx++] = dc_voxel_grid_load(grid, c0[0] + ix, c0[1] + iy,
+                                            c0[2] + iz, &v) == 0 ? v.distance : 1e6f;
+        }
+        plane = sdf;
+    }
+
+    glBindTexture(GL_TEXTURE_3D, b->sdf_tex);
+    glTexSubImage3D(GL_TEXTURE_3D, 0, c0[0], c0[1], c0[2], n[0], n[1], n[2],
+                    GL_RED, type, plane);
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    /* restore defaults */
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_IMAGES, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    free(sdf);
+
+    /* A scene that was empty may not be any more */
+    if (b->active_count == 0)
+        b->active_count = (int)dc_voxel_grid_active_count(grid);
+    return 0;
+}
+
 /* =========================================================================
  * Draw — ONE path. SDF raymarching. Always.
  * ========================================================================= */
@@ -401,6 +514,7 @@ dc_gl_voxel_buf_draw(const DC_GlVoxelBuf *b,
     glUniform3fv(glGetUniformLocation(b->ray_prog, "uBBoxMin"), 1, b->bbox_min);
     glUniform3fv(glGetUniformLocation(b->ray_prog, "uBBoxMax"), 1, b->bbox_max);
     glUniform1f(glGetUniformLocation(b->ray_prog, "uCellSize"), b->cell_size);
+    glUniform1f(glGetUniformLocation(b->ray_prog, "uDistScale"), b->dist_scale);
     glUniform1i(glGetUniformLocation(b->ray_prog, "uBlocky"), b->blocky);
 
     glActiveTexture(GL_TEXTURE0);
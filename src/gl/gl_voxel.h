@@ -34,6 +34,15 @@ void dc_gl_voxel_buf_free(DC_GlVoxelBuf *buf);
 int dc_gl_voxel_buf_upload(DC_GlVoxelBuf *buf,
                              const struct DC_VoxelGrid *grid);
 
+/* Re-send the distances of cells [lo, hi) of grid after an edit
+ * patched them in place (dc_cubeiform_eda_patch_voxel), with
+ * glTexSubImage3D. Colors are kept. Falls back to a full upload when
+ * the grid no longer matches the texture (size or distance format).
+ * Must be called from GL context. */
+int dc_gl_voxel_buf_upload_region(DC_GlVoxelBuf *buf,
+                                    const struct DC_VoxelGrid *grid,
+                                    const int lo[3], const int hi[3]);
+
 /* Get active voxel count (from last upload). */
 int dc_gl_voxel_buf_instance_count(const DC_GlVoxelBuf *buf);
 
@@ -25,7 +25,9 @@
 #include "voxel/voxelize_stl.h"
 #include "voxel/voxelize_bezier.h"
 #include "voxel/marching_cubes.h"
+#include "voxel/dual_contour.h"
 #include "voxel/sdf_to_bezier.h"
+#include "voxel/voxel_cache.h"
 
 /* Trinity Site bezier headers — pure math, header-only */
 #include "../../talmud-main/talmud/sacred/trinity_site/ts_vec.h"
@@ -59,7 +61,7 @@ static DC_VoxelGrid    *s_voxel_grid = NULL;
  *   1 = inspect-owned (allocated by voxel_sphere/box/csg/etc. — we free it).
  *   0 = borrowed from scad_preview via dc_inspect_set_voxel_grid()
  *       — preview owns the lifetime; we must not free it.
- * The voxel_state and marching_cubes commands read s_voxel_grid in
+ * The voxel_state, marching_cubes and dual_contour commands read s_voxel_grid in
  * either mode; only writes care about ownership. */
 static int              s_voxel_grid_owned = 0;
 
@@ -3115,15 +3117,18 @@ static char *cmd_debug_render_mesh(const char *args) {
 
 /* marching_cubes [path.stl] — extract isosurface from current voxel grid.
  * If path given, writes STL. If no path, writes to /tmp/duncad_mc.stl
- * and loads into viewport. */
-static char *cmd_marching_cubes(const char *args) {
+ * and loads into viewport.
+ * dual_contour [path.stl] — same, with the adaptive extractor. */
+static char *extract_isosurface(const char *args, int adaptive) {
     if (!s_voxel_grid) return strdup("{\"error\":\"no voxel grid\"}\n");
 
     ts_mesh mesh = ts_mesh_init();
-    int rc = dc_marching_cubes(s_voxel_grid, 0.0f, &mesh);
+    int rc = adaptive ? dc_dual_contour(s_voxel_grid, 0.0f, NULL, &mesh)
+                      : dc_marching_cubes(s_voxel_grid, 0.0f, &mesh);
     if (rc != 0) {
         ts_mesh_free(&mesh);
-        return strdup("{\"error\":\"marching cubes failed\"}\n");
+        return strdup(adaptive ? "{\"error\":\"dual contouring failed\"}\n"
+                               : "{\"error\":\"marching cubes failed\"}\n");
     }
 
     const char *path = (args && *args) ? args : "/tmp/duncad_mc.stl";
@@ -3154,6 +3159,14 @@ static char *cmd_marching_cubes(const char *args) {
     return resp;
 }
 
+static char *cmd_marching_cubes(const char *args) {
+    return extract_isosurface(args, 0);
+}
+
+static char *cmd_dual_contour(const char *args) {
+    return extract_isosurface(args, 1);
+}
+
 /* voxel_clear — remove voxels from viewport */
 static char *cmd_voxel_clear(void) {
     DC_GlViewport *vp = get_viewport();
@@ -3184,7 +3197,126 @@ static char *cmd_voxel_resolution(const char *args) {
     return resp;
 }
 
-/* voxel_state — info about current voxel grid */
+/* voxel_threads [n] — get or set STL voxelizer worker count (0 = auto) */
+static char *cmd_voxel_threads(const char *args) {
+    DC_ScadPreview *pv = get_preview();
+    if (!pv) return strdup("{\"error\":\"no scad preview\"}\n");
+
+    if (args && *args) {
+        int n = atoi(args);
+        if (n >= 0 && n <= 256) {
+            dc_scad_preview_set_voxel_threads(pv, n);
+            char *resp = malloc(128);
+            snprintf(resp, 128, "{\"ok\":true,\"threads\":%d}\n", n);
+            return resp;
+        }
+        return strdup("{\"error\":\"threads must be 0-256 (0 = one per CPU)\"}\n");
+    }
+
+    int n = dc_scad_preview_get_voxel_threads(pv);
+    char *resp = malloc(128);
+    snprintf(resp, 128, "{\"threads\":%d}\n", n);
+    return resp;
+}
+
+/* voxel_sign [parity|winding] — get or set STL voxelizer inside/outside test */
+static char *cmd_voxel_sign(const char *args) {
+    DC_ScadPreview *pv = get_preview();
+    if (!pv) return strdup("{\"error\":\"no scad preview\"}\n");
+
+    if (args && *args) {
+        if (strncmp(args, "parity", 6) == 0 || strncmp(args, "winding", 7) == 0) {
+            int winding = args[0] == 'w';
+            dc_scad_preview_set_voxel_winding(pv, winding);
+            char *resp = malloc(128);
+            snprintf(resp, 128, "{\"ok\":true,\"sign\":\"%s\"}\n",
+                     winding ? "winding" : "parity");
+            return resp;
+        }
+        return strdup("{\"error\":\"sign must be parity or winding\"}\n");
+    }
+
+    char *resp = malloc(128);
+    snprintf(resp, 128, "{\"sign\":\"%s\"}\n",
+             dc_scad_preview_get_voxel_winding(pv) ? "winding" : "parity");
+    return resp;
+}
+
+/* voxel_save <path.dcvox> [f32|f16|i8] — write current grid to a cache file */
+static char *cmd_voxel_save(const char *args) {
+    if (!s_voxel_grid) return strdup("{\"error\":\"no voxel grid\"}\n");
+    char path[1024], enc[8] = "f32";
+    if (!args || sscanf(args, "%1023s %7s", path, enc) < 1)
+        return strdup("{\"error\":\"usage: voxel_save <path> [f32|f16|i8]\"}\n");
+
+    DC_VoxelCacheOpts opts = {0};
+    if (strcmp(enc, "f16") == 0)      opts.encoding = DC_VOXEL_DIST_F16;
+    else if (strcmp(enc, "i8") == 0)  opts.encoding = DC_VOXEL_DIST_I8;
+    else if (strcmp(enc, "f32") != 0)
+        return strdup("{\"error\":\"encoding must be f32, f16 or i8\"}\n");
+
+    DC_Error err = {0};
+    char *resp = malloc(1536);
+    if (dc_voxel_cache_save(s_voxel_grid, path, 0, &opts, &err) != 0)
+        snprintf(resp, 1536, "{\"error\":\"%s\"}\n", err.message);
+    else
+        snprintf(resp, 1536, "{\"ok\":true,\"path\":\"%s\",\"encoding\":\"%s\"}\n",
+                 path, enc);
+    return resp;
+}
+
+/* voxel_load <path.dcvox> — map a cache file as the current grid */
+static char *cmd_voxel_load(const char *args) {
+    if (!args || !*args)
+        return strdup("{\"error\":\"usage: voxel_load <path>\"}\n");
+    DC_Error err = {0};
+    DC_VoxelGrid *g = dc_voxel_cache_load(args, 0, &err);
+    if (!g) {
+        char *resp = malloc(1024);
+        snprintf(resp, 1024, "{\"error\":\"%s\"}\n", err.message);
+        return resp;
+    }
+    inspect_grid_take_owned(g);
+    DC_GlViewport *vp = get_viewport();
+    if (vp) dc_gl_viewport_set_voxel_grid(vp, s_voxel_grid);
+
+    char *resp = malloc(256);
+    snprintf(resp, 256, "{\"ok\":true,\"size\":[%d,%d,%d],\"mapped\":%s}\n",
+             dc_voxel_grid_size_x(g), dc_voxel_grid_size_y(g),
+             dc_voxel_grid_size_z(g),
+             dc_voxel_grid_is_wrapped(g) ? "true" : "false");
+    return resp;
+}
+
+/* voxel_quantize <f32|f16|i8> — re-encode the current grid's distances
+ * (an inspect-owned copy if the grid is borrowed) and re-upload it */
+static char *cmd_voxel_quantize(const char *args) {
+    if (!s_voxel_grid) return strdup("{\"error\":\"no voxel grid\"}\n");
+    DC_VoxelDistFormat fmt;
+    if (args && strcmp(args, "f32") == 0)      fmt = DC_VOXEL_DIST_F32;
+    else if (args && strcmp(args, "f16") == 0) fmt = DC_VOXEL_DIST_F16;
+    else if (args && strcmp(args, "i8") == 0)  fmt = DC_VOXEL_DIST_I8;
+    else return strdup("{\"error\":\"usage: voxel_quantize <f32|f16|i8>\"}\n");
+
+    DC_VoxelGrid *g = s_voxel_grid_owned ? s_voxel_grid
+                                         : dc_voxel_grid_copy(s_voxel_grid);
+    if (!g) return strdup("{\"error\":\"grid copy failed\"}\n");
+    if (dc_voxel_grid_quantize(g, fmt) != 0) {
+        if (g != s_voxel_grid) dc_voxel_grid_free(g);
+        return strdup("{\"error\":\"quantize needs an SoA grid (and a band for i8)\"}\n");
+    }
+    if (g != s_voxel_grid) inspect_grid_take_owned(g);
+    DC_GlViewport *vp = get_viewport();
+    if (vp) dc_gl_viewport_set_voxel_grid(vp, s_voxel_grid);
+
+    char *resp = malloc(128);
+    snprintf(resp, 128, "{\"ok\":true,\"format\":\"%s\",\"bytes\":%zu}\n",
+             args, dc_voxel_grid_memory_bytes(s_voxel_grid));
+    return resp;
+}
+
+/* voxel_state — info about current voxel grid. "mapped" is true for a
+ * grid served straight from a voxel cache file. */
 static char *cmd_voxel_state(void) {
     if (!s_voxel_grid) return strdup("{\"loaded\":false}\n");
     int sx = dc_voxel_grid_size_x(s_voxel_grid);
@@ -3195,8 +3327,9 @@ static char *cmd_voxel_state(void) {
     char *resp = malloc(256);
     snprintf(resp, 256,
              "{\"loaded\":true,\"size\":[%d,%d,%d],\"cell_size\":%.3f,"
-             "\"active\":%zu,\"total\":%d}\n",
-             sx, sy, sz, cs, active, sx*sy*sz);
+             "\"active\":%zu,\"total\":%d,\"mapped\":%s}\n",
+             sx, sy, sz, cs, active, sx*sy*sz,
+             dc_voxel_grid_is_wrapped(s_voxel_grid) ? "true" : "false");
     return resp;
 }
 
@@ -3495,9 +3628,15 @@ dispatch(const char *cmd)
     if (strcmp(name, "voxel_csg")          == 0) return cmd_voxel_csg(args);
     if (strcmp(name, "voxel_clear")        == 0) return cmd_voxel_clear();
     if (strcmp(name, "marching_cubes")    == 0) return cmd_marching_cubes(args);
+    if (strcmp(name, "dual_contour")      == 0) return cmd_dual_contour(args);
     if (strcmp(name, "debug_render_mesh") == 0) return cmd_debug_render_mesh(args);
     if (strcmp(name, "voxel_state")        == 0) return cmd_voxel_state();
+    if (strcmp(name, "voxel_save")         == 0) return cmd_voxel_save(args);
+    if (strcmp(name, "voxel_load")         == 0) return cmd_voxel_load(args);
+    if (strcmp(name, "voxel_quantize")     == 0) return cmd_voxel_quantize(args);
     if (strcmp(name, "voxel_resolution")   == 0) return cmd_voxel_resolution(args);
+    if (strcmp(name, "voxel_threads")      == 0) return cmd_voxel_threads(args);
+    if (strcmp(name, "voxel_sign")         == 0) return cmd_voxel_sign(args);
 
     /* Meta */
     if (strcmp(name, "help") == 0) return cmd_help();
@@ -18,6 +18,7 @@
 #include "../../talmud-main/talmud/sacred/trinity_site/ts_bezier_mesh.h"
 #include "voxel/voxelize_bezier.h"
 #include "voxel/marching_cubes.h"
+#include "voxel/voxel_cache.h"
 #include "../../talmud-main/talmud/sacred/trinity_site/ts_mesh.h"
 
 #include <stdio.h>
@@ -26,6 +27,7 @@
 #include <unistd.h>
 #include <time.h>
 #include <ctype.h>
+#include <limits.h>
 
 /* -------------------------------------------------------------------------
  * Internal structure
@@ -56,12 +58,21 @@ struct DC_ScadPreview {
     volatile int    hq_cancel;      /* cooperative cancel flag for HQ task */
     int             hq_running;     /* is HQ task in flight? */
     ts_progress     progress;       /* shared progress — worker writes, UI reads */
+    volatile int    mesh_cancel;    /* cooperative cancel flag for STL export */
+    int             mesh_running;   /* is an STL export in flight? */
     int             camera_fitted;  /* 1 after first fit — skip auto-fit on re-renders */
     int             render_pending; /* 1 = re-render queued (dropped while busy) */
 
     /* Voxel rendering — THE PURE PATH */
     int             voxel_resolution; /* cells per longest axis (default 64) */
+    int             voxel_threads;    /* STL voxelizer workers, 0 = one per CPU */
+    int             voxel_sign;       /* DC_VoxelizeSign for STL inside/outside */
     DC_VoxelGrid   *voxel_grid;      /* owned — last voxelized scene */
+    DC_CubeiformEda *voxel_eda;      /* owned — voxel ops voxel_grid was built
+                                      * from, NULL if it came from elsewhere */
+    guint           vox_cache_id;    /* timer source for the pending cache
+                                      * write of voxel_grid, 0 if none */
+    uint64_t        vox_cache_hash;  /* source hash that write is keyed by */
 
     /* Tricanvas: render mode and sibling */
     int             render_mode;     /* 0=all (legacy), 1=solid only, 2=mesh only */
@@ -93,9 +104,10 @@ poll_progress(gpointer data)
 }
 
 static void
-__attribute__((unused))
 progress_start(DC_ScadPreview *pv)
 {
+    if (pv->progress_id)
+        g_source_remove(pv->progress_id);
     pv->progress.done  = 0;
     pv->progress.total = 0;
     gtk_widget_set_visible(pv->progress_bar, TRUE);
@@ -198,6 +210,9 @@ typedef struct {
     unsigned int    gen;
     int             is_hq;
     int             total_tris;
+    DC_VoxelGrid   *grid;       /* first object, voxelized on the worker */
+    int             vox_res;
+    DC_Error        vox_err;
 } RenderResult;
 
 static void
@@ -207,6 +222,7 @@ render_result_free(RenderResult *res)
     for (int i = 0; i < res->obj_count; i++)
         free(res->objs[i].stl_path);
     free(res->objs);
+    dc_voxel_grid_free(res->grid);
     free(res);
 }
 
@@ -216,6 +232,9 @@ typedef struct {
     int             is_hq;          /* 0=preview, 1=high-quality */
     volatile int   *cancel;         /* points to pv->hq_cancel (HQ only) */
     ts_progress    *progress;       /* shared progress tracker */
+    int             vox_res;        /* voxel resolution for the result */
+    int             vox_threads;    /* STL voxelizer workers (0 = auto) */
+    int             vox_sign;       /* DC_VoxelizeSign */
 } RenderTaskData;
 
 static void
@@ -308,6 +327,8 @@ render_thread_func(GTask *task, gpointer source_obj,
         opts.fs_override = 0.4;
         opts.force_quality = 0;
         opts.cancel = td->cancel;
+        opts.threads = (int)g_get_num_processors();
+        opts.boolean_union = 1;
     } else {
         opts.fn_override = 12;
         opts.fa_override = 12;
@@ -358,6 +379,23 @@ render_thread_func(GTask *task, gpointer source_obj,
     }
     res->obj_count = obj_idx;
 
+    /* Voxelize the first object here rather than on the main thread, so
+     * the UI stays live and the progress bar tracks the Z-slabs.
+     * TODO: union multiple objects via SDF composition. */
+    if (obj_idx > 0 && !(td->cancel && *td->cancel)) {
+        DC_VoxelizeStlOpts vopts = {0};
+        vopts.threads = td->vox_threads;
+        vopts.sign    = (DC_VoxelizeSign)td->vox_sign;
+        if (td->progress) {
+            vopts.progress_done  = &td->progress->done;
+            vopts.progress_total = &td->progress->total;
+        }
+        res->vox_res = td->vox_res;
+        res->grid = dc_voxelize_stl_ex(res->objs[0].stl_path, td->vox_res,
+                                       &vopts, &res->vox_err);
+        unlink(res->objs[0].stl_path);
+    }
+
     clock_gettime(CLOCK_MONOTONIC, &t1);
     res->elapsed = (double)(t1.tv_sec - t0.tv_sec)
                  + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
@@ -378,6 +416,7 @@ render_thread_func(GTask *task, gpointer source_obj,
 static void launch_hq_render(DC_ScadPreview *pv, const char *source);
 static void do_render(DC_ScadPreview *pv);
 static void log_append(DC_ScadPreview *pv, const char *msg);
+static void voxel_cache_cancel(DC_ScadPreview *pv);
 
 /* Main thread callback for BOTH preview and HQ results */
 static void
@@ -431,34 +470,29 @@ render_done_cb(GObject *source_obj, GAsyncResult *result, gpointer userdata)
     dc_gl_viewport_clear_objects(pv->viewport);
     dc_gl_viewport_clear_mesh(pv->viewport);
 
-    /* Merge all STL objects by voxelizing the first one.
-     * TODO: union multiple objects via SDF composition. */
+    /* The worker voxelized the first object (see render_thread_func). */
     int voxelized = 0;
-    int vox_res = pv->voxel_resolution > 0 ? pv->voxel_resolution : 64;
-
-    for (int i = 0; i < res->obj_count; i++) {
-        if (!res->objs[i].stl_path) continue;
-
-        DC_Error verr = {0};
-        DC_VoxelGrid *grid = dc_voxelize_stl(res->objs[i].stl_path, vox_res, &verr);
-        unlink(res->objs[i].stl_path);
-
-        if (grid) {
-            /* Drop inspect's borrow before freeing the old grid; publish the
-             * new one so marching_cubes/voxel_state see the same truth. */
-            dc_inspect_set_voxel_grid(NULL);
-            dc_voxel_grid_free(pv->voxel_grid);
-            pv->voxel_grid = grid;
-            dc_inspect_set_voxel_grid(grid);
-            dc_gl_viewport_set_voxel_grid(pv->viewport, grid);
-            voxelized++;
-            DC_LOG_INFO_APP("voxelized object %d: %zu active voxels (res=%d)",
-                             i, dc_voxel_grid_active_count(grid), vox_res);
-        } else {
-            DC_LOG_INFO_APP("voxelize failed for object %d: %s", i, verr.message);
-        }
-
-        break; /* First object only for now — TODO: SDF union of multiple */
+    int vox_res = res->vox_res;
+
+    if (res->grid) {
+        DC_VoxelGrid *grid = res->grid;
+        res->grid = NULL; /* ownership transferred to pv */
+
+        /* Drop inspect's borrow before freeing the old grid; publish the
+         * new one so marching_cubes/voxel_state see the same truth. */
+        voxel_cache_cancel(pv);
+        dc_inspect_set_voxel_grid(NULL);
+        dc_voxel_grid_free(pv->voxel_grid);
+        dc_cubeiform_eda_free(pv->voxel_eda);
+        pv->voxel_grid = grid;
+        pv->voxel_eda = NULL;
+        dc_inspect_set_voxel_grid(grid);
+        dc_gl_viewport_set_voxel_grid(pv->viewport, grid);
+        voxelized++;
+        DC_LOG_INFO_APP("voxelized object 0: %zu active voxels (res=%d)",
+                         dc_voxel_grid_active_count(grid), vox_res);
+    } else {
+        DC_LOG_INFO_APP("voxelize failed for object 0: %s", res->vox_err.message);
     }
 
     if (voxelized > 0) {
@@ -529,9 +563,11 @@ launch_hq_render(DC_ScadPreview *pv, const char *source)
      * Old HQ results are discarded by generation counter anyway. */
     pv->hq_cancel = 1;
 
-    /* Reset progress for HQ pass */
-    pv->progress.done  = 0;
-    pv->progress.total = 0;
+    /* The progress bar is shared with STL export — stop any export */
+    pv->mesh_cancel = 1;
+
+    /* Reset progress for HQ pass and start polling it */
+    progress_start(pv);
 
     RenderTaskData *td = calloc(1, sizeof(*td));
     td->source   = strdup(source);
@@ -539,6 +575,9 @@ launch_hq_render(DC_ScadPreview *pv, const char *source)
     td->is_hq    = 1;
     td->cancel   = &pv->hq_cancel;
     td->progress = &pv->progress;
+    td->vox_res  = pv->voxel_resolution > 0 ? pv->voxel_resolution : 64;
+    td->vox_threads = pv->voxel_threads;
+    td->vox_sign = pv->voxel_sign;
 
     pv->hq_running = 1;
 
@@ -652,6 +691,139 @@ static void on_to_solid_clicked(GtkButton *b, gpointer d)
     dc_scad_preview_render_refit(pv);
 }
 
+/* Cache file for the grid of one source text:
+ * $XDG_CACHE_HOME/duncad/voxels/<hash>.dcvox. Returns a g_free'd path,
+ * or NULL if the directory cannot be created. */
+static char *
+voxel_cache_path(uint64_t hash)
+{
+    char *dir = g_build_filename(g_get_user_cache_dir(), "duncad", "voxels",
+                                 NULL);
+    char name[40];
+    snprintf(name, sizeof(name), "%016llx" DC_VOXEL_CACHE_EXT,
+             (unsigned long long)hash);
+    char *path = g_mkdir_with_parents(dir, 0700) == 0
+               ? g_build_filename(dir, name, NULL) : NULL;
+    g_free(dir);
+    return path;
+}
+
+/* A freshly evaluated grid goes into the cache only once its source has
+ * been left alone for VOXEL_CACHE_DELAY_MS; any re-render before that
+ * cancels the write, so typing does not leave a file per keystroke.
+ * The write runs on a worker with its own copy of the grid, at half
+ * precision, then trims the cache to VOXEL_CACHE_MAX_BYTES oldest
+ * first. Grids over a quarter of the cap are not cached at all. */
+#define VOXEL_CACHE_MAX_BYTES ((uint64_t)2 << 30)
+#define VOXEL_CACHE_DELAY_MS  2000
+
+typedef struct {
+    DC_VoxelGrid *grid;     /* owned copy */
+    char         *path;     /* g_free'd */
+    uint64_t      hash;
+} VoxelCacheWrite;
+
+/* Saves go through a per-process temp file, so two canvases writing the
+ * same source must not overlap. */
+G_LOCK_DEFINE_STATIC(voxel_cache_write);
+
+static void
+voxel_cache_write_free(gpointer data)
+{
+    VoxelCacheWrite *w = data;
+    dc_voxel_grid_free(w->grid);
+    g_free(w->path);
+    g_free(w);
+}
+
+static void
+voxel_cache_write_thread(GTask *task, gpointer source_obj,
+                         gpointer task_data, GCancellable *cancel)
+{
+    (void)source_obj; (void)cancel;
+    VoxelCacheWrite *w = task_data;
+    DC_VoxelCacheOpts opts = { .encoding = DC_VOXEL_DIST_F16 };
+    DC_Error err = {0};
+
+    G_LOCK(voxel_cache_write);
+    if (dc_voxel_cache_save(w->grid, w->path, w->hash, &opts, &err) != 0) {
+        dc_log(DC_LOG_WARN, DC_LOG_EVENT_APP,
+               "voxel cache: %s", err.message);
+    } else {
+        char *dir = g_path_get_dirname(w->path);
+        int n = dc_voxel_cache_evict(dir, VOXEL_CACHE_MAX_BYTES, w->path);
+        if (n > 0)
+            dc_log(DC_LOG_DEBUG, DC_LOG_EVENT_APP,
+                   "voxel cache: evicted %d file(s)", n);
+        g_free(dir);
+    }
+    G_UNLOCK(voxel_cache_write);
+    g_task_return_boolean(task, TRUE);
+}
+
+static void
+voxel_cache_cancel(DC_ScadPreview *pv)
+{
+    if (pv->vox_cache_id) {
+        g_source_remove(pv->vox_cache_id);
+        pv->vox_cache_id = 0;
+    }
+}
+
+static gboolean
+voxel_cache_write_due(gpointer data)
+{
+    DC_ScadPreview *pv = data;
+    pv->vox_cache_id = 0;
+
+    char *path = pv->voxel_grid ? voxel_cache_path(pv->vox_cache_hash)
+                                : NULL;
+    DC_VoxelGrid *copy = path ? dc_voxel_grid_copy(pv->voxel_grid) : NULL;
+    if (!copy) {
+        g_free(path);
+        return G_SOURCE_REMOVE;
+    }
+
+    VoxelCacheWrite *w = g_new0(VoxelCacheWrite, 1);
+    w->grid = copy;
+    w->path = path;
+    w->hash = pv->vox_cache_hash;
+    GTask *task = g_task_new(NULL, NULL, NULL, NULL);
+    g_task_set_task_data(task, w, voxel_cache_write_free);
+    g_task_run_in_thread(task, voxel_cache_write_thread);
+    g_object_unref(task);
+    return G_SOURCE_REMOVE;
+}
+
+/* Queue pv->voxel_grid, just evaluated from source with this hash, for
+ * a cache write. */
+static void
+voxel_cache_schedule(DC_ScadPreview *pv, uint64_t hash)
+{
+    voxel_cache_cancel(pv);
+    if (!pv->voxel_grid ||
+        dc_voxel_grid_memory_bytes(pv->voxel_grid) > VOXEL_CACHE_MAX_BYTES / 4)
+        return;
+    pv->vox_cache_hash = hash;
+    pv->vox_cache_id = g_timeout_add(VOXEL_CACHE_DELAY_MS,
+                                     voxel_cache_write_due, pv);
+}
+
+/* Source as rendered: if it already has $vd, use it as-is, otherwise
+ * prepend the UI density setting. Consumes text. */
+static char *
+source_with_density(DC_ScadPreview *pv, char *text)
+{
+    if (strstr(text, "$vd")) return text;
+    int ui_vd = pv->voxel_resolution > 0 ? pv->voxel_resolution : 3;
+    size_t tlen = strlen(text);
+    char *full_src = malloc(tlen + 32);
+    if (!full_src) return text;
+    int hlen = snprintf(full_src, 32, "$vd = %d;\n", ui_vd);
+    memcpy(full_src + hlen, text, tlen + 1);
+    free(text);
+    return full_src;
+}
 
 static void
 do_render(DC_ScadPreview *pv)
@@ -667,6 +839,10 @@ do_render(DC_ScadPreview *pv)
         return;
     }
 
+    /* Whatever grid this render leaves behind, the pending cache write
+     * was for the old one. */
+    voxel_cache_cancel(pv);
+
     char *text = dc_code_editor_get_text(pv->code_ed);
     if (!text || !*text) {
         gtk_label_set_text(GTK_LABEL(pv->status_label), "Nothing to render");
@@ -682,27 +858,56 @@ do_render(DC_ScadPreview *pv)
         /* SDF RENDERING — the only path */
         gtk_label_set_text(GTK_LABEL(pv->status_label), "Rendering SDF...");
 
-        /* If source already has $vd, use it as-is.
-         * Otherwise prepend the UI density setting. */
-        char *full_src = text;
-        if (!strstr(text, "$vd")) {
-            int ui_vd = pv->voxel_resolution > 0 ? pv->voxel_resolution : 3;
-            size_t tlen = strlen(text);
-            full_src = malloc(tlen + 32);
-            if (full_src) {
-                int hlen = snprintf(full_src, 32, "$vd = %d;\n", ui_vd);
-                memcpy(full_src + hlen, text, tlen + 1);
-                free(text);
-            } else {
-                full_src = text;
-            }
-        }
+        char *full_src = source_with_density(pv, text);
 
+        /* An edit that only changes op parameters patches the grid on
+         * screen: just the cells around the changed ops are evaluated
+         * and re-uploaded. */
         DC_Error err = {0};
         DC_VoxelGrid *grid = NULL;
         void *bmesh = NULL;
-        dc_cubeiform_execute_full(full_src, NULL, NULL, &grid, &bmesh, NULL, &err);
+        DC_CubeiformEda *eda_now = pv->render_mode != DC_RENDER_MESH
+                                 ? dc_cubeiform_parse_eda(full_src, NULL) : NULL;
+        if (eda_now && dc_cubeiform_eda_bmesh_op_count(eda_now) > 0) {
+            /* to_solid grids do not come from the voxel ops */
+            dc_cubeiform_eda_free(eda_now);
+            eda_now = NULL;
+        }
+        int lo[3], hi[3];
+        int patched = eda_now && pv->voxel_grid && pv->voxel_eda &&
+                      dc_cubeiform_eda_patch_voxel(eda_now, pv->voxel_eda,
+                                                   pv->voxel_grid, lo, hi, NULL) == 1;
+        if (patched) {
+            dc_gl_viewport_update_voxel_region(pv->viewport, pv->voxel_grid, lo, hi);
+            dc_cubeiform_eda_free(pv->voxel_eda);
+            pv->voxel_eda = eda_now;
+            eda_now = NULL;
+        }
+
+        /* Reopening a source we have voxelized before maps its grid
+         * from the cache instead of evaluating it again. The mesh
+         * canvas never uses the grid, so it skips the cache; patched
+         * grids are not written back, so edits stay fast. A miss is
+         * written later, off this thread (voxel_cache_schedule). */
+        uint64_t src_hash = dc_voxel_cache_hash(full_src, strlen(full_src));
+        char *cache_path = pv->render_mode != DC_RENDER_MESH && !patched
+                         ? voxel_cache_path(src_hash) : NULL;
+        DC_VoxelGrid *cached = cache_path
+                             ? dc_voxel_cache_load(cache_path, src_hash, NULL)
+                             : NULL;
+        dc_cubeiform_execute_full(full_src, NULL, NULL,
+                                  cached || patched ? NULL : &grid, &bmesh,
+                                  NULL, &err);
         free(full_src);
+        if (patched) {
+            grid = pv->voxel_grid;
+        } else if (cached) {
+            grid = cached;
+            dc_log(DC_LOG_INFO, DC_LOG_EVENT_APP,
+                   "voxel cache hit: %s", cache_path);
+        }
+        int cache_miss = grid && cache_path && !cached;
+        g_free(cache_path);
 
         int got_something = 0;
 
@@ -767,6 +972,9 @@ do_render(DC_ScadPreview *pv)
                 size_t nops = dc_cubeiform_eda_vox_op_count(eda);
                 float cr = 0.7f, cg = 0.7f, cb = 0.7f; /* default grey */
                 int pending_csg = DC_SDF_UNION; /* CSG op for next primitive */
+                float pending_blend = 0.0f;     /* its smooth blend radius */
+                int mod_first[16];  /* first primitive of each open modifier */
+                int nmod = 0;
                 for (size_t oi = 0; oi < nops; oi++) {
                     const DC_VoxOp *op = dc_cubeiform_eda_get_vox_op(eda, oi);
                     if (!op) continue;
@@ -776,9 +984,40 @@ do_render(DC_ScadPreview *pv)
                         continue;
                     }
                     /* CSG ops set pending state for the next primitive */
-                    if (op->type == DC_VOX_OP_SUBTRACT)  { pending_csg = DC_SDF_SUBTRACT;  continue; }
-                    if (op->type == DC_VOX_OP_INTERSECT) { pending_csg = DC_SDF_INTERSECT; continue; }
-                    if (op->type == DC_VOX_OP_UNION)     { pending_csg = DC_SDF_UNION;     continue; }
+                    if (op->type == DC_VOX_OP_SUBTRACT ||
+                        op->type == DC_VOX_OP_INTERSECT ||
+                        op->type == DC_VOX_OP_UNION) {
+                        pending_csg = op->type == DC_VOX_OP_SUBTRACT ? DC_SDF_SUBTRACT
+                                    : op->type == DC_VOX_OP_INTERSECT ? DC_SDF_INTERSECT
+                                    : DC_SDF_UNION;
+                        pending_blend = (float)op->radius;
+                        continue;
+                    }
+                    /* Modifiers apply to the primitives added since their
+                     * MODIFY_BEGIN */
+                    if (op->type == DC_VOX_OP_MODIFY_BEGIN) {
+                        if (nmod < 16) mod_first[nmod] = pv->sdf_scene.count;
+                        nmod++;
+                        continue;
+                    }
+                    if (op->type == DC_VOX_OP_ROUND ||
+                        op->type == DC_VOX_OP_SHELL ||
+                        op->type == DC_VOX_OP_REPEAT) {
+                        if (nmod <= 0) continue;
+                        nmod--;
+                        if (nmod >= 16) continue;
+                        int first = mod_first[nmod];
+                        if (op->type == DC_VOX_OP_ROUND) {
+                            dc_gl_sdf_scene_round(&pv->sdf_scene, first, (float)op->radius);
+                        } else if (op->type == DC_VOX_OP_SHELL) {
+                            dc_gl_sdf_scene_shell(&pv->sdf_scene, first, (float)op->radius);
+                        } else {
+                            float period[3] = { (float)op->x, (float)op->y, (float)op->z };
+                            int count[3] = { (int)op->x2, (int)op->y2, (int)op->z2 };
+                            dc_gl_sdf_scene_repeat(&pv->sdf_scene, first, period, count);
+                        }
+                        continue;
+                    }
                     /* Skip group markers */
                     if (op->type == DC_VOX_OP_GROUP_BEGIN || op->type == DC_VOX_OP_GROUP_END) continue;
                     /* Use op color if set, otherwise use current color */
@@ -820,6 +1059,10 @@ do_render(DC_ScadPreview *pv)
                         dc_gl_sdf_scene_set_csg(&pv->sdf_scene, pending_csg);
                         pending_csg = DC_SDF_UNION;
                     }
+                    if (pending_blend > 0.0f) {
+                        dc_gl_sdf_scene_set_blend(&pv->sdf_scene, pending_blend);
+                        pending_blend = 0.0f;
+                    }
                 }
                 dc_gl_sdf_scene_compute_bbox(&pv->sdf_scene);
                 dc_gl_viewport_set_sdf_scene(pv->viewport, &pv->sdf_scene);
@@ -833,11 +1076,17 @@ do_render(DC_ScadPreview *pv)
             dc_gl_viewport_clear_mesh(pv->viewport);
             /* Drop inspect's borrow before freeing the old grid; publish the
              * new one so marching_cubes / voxel_state read the same truth. */
-            dc_inspect_set_voxel_grid(NULL);
-            dc_voxel_grid_free(pv->voxel_grid);
-            pv->voxel_grid = grid;
-            dc_inspect_set_voxel_grid(grid);
-            dc_gl_viewport_set_voxel_grid(pv->viewport, grid);
+            if (grid != pv->voxel_grid) {
+                dc_inspect_set_voxel_grid(NULL);
+                dc_voxel_grid_free(pv->voxel_grid);
+                dc_cubeiform_eda_free(pv->voxel_eda);
+                pv->voxel_grid = grid;
+                pv->voxel_eda = eda_now;
+                eda_now = NULL;
+                dc_inspect_set_voxel_grid(grid);
+                dc_gl_viewport_set_voxel_grid(pv->viewport, grid);
+                if (cache_miss) voxel_cache_schedule(pv, src_hash);
+            }
 
             /* If source bezier mesh is available, set up direct
              * surface raytracing for smooth mode. */
@@ -883,6 +1132,7 @@ do_render(DC_ScadPreview *pv)
             /* Mesh mode — discard voxel output */
             dc_voxel_grid_free(grid);
         }
+        dc_cubeiform_eda_free(eda_now);
 
         if (!got_something) {
             /* Clear viewport when there's nothing for this canvas */
@@ -893,7 +1143,9 @@ do_render(DC_ScadPreview *pv)
                 /* Drop inspect's borrow before freeing the underlying grid. */
                 dc_inspect_set_voxel_grid(NULL);
                 dc_voxel_grid_free(pv->voxel_grid);
+                dc_cubeiform_eda_free(pv->voxel_eda);
                 pv->voxel_grid = NULL;
+                pv->voxel_eda = NULL;
             } else if (pv->render_mode == DC_RENDER_MESH) {
                 dc_gl_viewport_set_bezier_mesh(pv->viewport, NULL);
             }
@@ -1241,16 +1493,20 @@ dc_scad_preview_free(DC_ScadPreview *pv)
 {
     if (!pv) return;
     pv->hq_cancel = 1;  /* signal any in-flight HQ to stop */
+    pv->mesh_cancel = 1;
 
-    /* Wait for the render thread to finish before freeing anything
-     * it may be using.  Timeout after 2s to avoid hanging forever. */
-    for (int i = 0; i < 200 && pv->hq_running; i++)
+    /* Wait for the render and export threads to finish before freeing
+     * anything they may be using.  Timeout after 2s to avoid hanging
+     * forever. */
+    for (int i = 0; i < 200 && (pv->hq_running || pv->mesh_running); i++)
         g_usleep(10000); /* 10ms */
 
     progress_stop(pv);
+    voxel_cache_cancel(pv);
     /* Drop inspect's borrow before freeing pv->voxel_grid. */
     dc_inspect_set_voxel_grid(NULL);
     dc_voxel_grid_free(pv->voxel_grid);
+    dc_cubeiform_eda_free(pv->voxel_eda);
     dc_transform_panel_free(pv->transform);
     dc_gl_viewport_free(pv->viewport);
     dc_log(DC_LOG_DEBUG, DC_LOG_EVENT_APP, "scad preview freed");
@@ -1327,6 +1583,37 @@ dc_scad_preview_get_voxel_resolution(DC_ScadPreview *pv)
     return pv ? pv->voxel_resolution : 64;
 }
 
+void
+dc_scad_preview_set_voxel_threads(DC_ScadPreview *pv, int threads)
+{
+    if (!pv) return;
+    if (threads < 0) threads = 0;
+    pv->voxel_threads = threads;
+    dc_log(DC_LOG_INFO, DC_LOG_EVENT_APP, "voxel threads set to %d%s",
+           threads, threads == 0 ? " (auto)" : "");
+}
+
+int
+dc_scad_preview_get_voxel_threads(DC_ScadPreview *pv)
+{
+    return pv ? pv->voxel_threads : 0;
+}
+
+void
+dc_scad_preview_set_voxel_winding(DC_ScadPreview *pv, int winding)
+{
+    if (!pv) return;
+    pv->voxel_sign = winding ? DC_VOXELIZE_SIGN_WINDING : DC_VOXELIZE_SIGN_PARITY;
+    dc_log(DC_LOG_INFO, DC_LOG_EVENT_APP, "voxel sign mode set to %s",
+           winding ? "winding" : "parity");
+}
+
+int
+dc_scad_preview_get_voxel_winding(DC_ScadPreview *pv)
+{
+    return pv ? pv->voxel_sign == DC_VOXELIZE_SIGN_WINDING : 0;
+}
+
 void
 dc_scad_preview_set_status(DC_ScadPreview *pv, const char *text)
 {
@@ -1346,6 +1633,140 @@ dc_scad_preview_set_sibling(DC_ScadPreview *pv, DC_ScadPreview *sibling)
     if (pv) pv->sibling = sibling;
 }
 
+/* -------------------------------------------------------------------------
+ * STL export — marching cubes on a worker thread
+ *
+ * The worker meshes its own copy of the voxel grid, so a re-render may
+ * replace pv->voxel_grid meanwhile. Progress goes through pv->progress
+ * (one tick per MC slab); a new HQ render cancels the export.
+ * ---------------------------------------------------------------------- */
+typedef struct {
+    DC_VoxelGrid   *grid;           /* owned copy of pv->voxel_grid */
+    DC_CubeiformEda *eda;           /* owned — voxel ops to stream when
+                                     * there is no grid, else NULL */
+    char           *path;           /* owned */
+    int             threads;        /* MC pool threads (0 = auto) */
+    volatile int   *cancel;         /* points to pv->mesh_cancel */
+    ts_progress    *progress;       /* shared progress tracker */
+} ExportTaskData;
+
+typedef struct {
+    int   rc;                       /* 0 ok, 1 cancelled, -1 failed */
+    int   verts, tris;
+    char  msg[512];
+} ExportResult;
+
+static void
+export_task_data_free(gpointer p)
+{
+    ExportTaskData *td = p;
+    dc_voxel_grid_free(td->grid);
+    dc_cubeiform_eda_free(td->eda);
+    free(td->path);
+    free(td);
+}
+
+static void
+export_thread_func(GTask *task, gpointer source_obj,
+                   gpointer task_data, GCancellable *cancellable)
+{
+    (void)source_obj;
+    (void)cancellable;
+    ExportTaskData *td = task_data;
+    ExportResult *res = calloc(1, sizeof(*res));
+
+    DC_MarchingCubesOpts opts = {0};
+    opts.threads = td->threads;
+    opts.cancel = td->cancel;
+    opts.progress_done = &td->progress->done;
+    opts.progress_total = &td->progress->total;
+
+    if (td->eda) {
+        DC_Error err = {0};
+        size_t ntri = 0;
+        res->rc = dc_cubeiform_eda_export_stl(td->eda, td->path, &opts,
+                                              &ntri, &err);
+        if (res->rc < 0)
+            snprintf(res->msg, sizeof(res->msg), "%s", err.message);
+        res->tris = (int)(ntri < INT_MAX ? ntri : INT_MAX);
+        g_task_return_pointer(task, res, free);
+        return;
+    }
+
+    ts_mesh mesh = ts_mesh_init();
+    res->rc = dc_marching_cubes_ex(td->grid, 0.0f, &opts, &mesh);
+    if (res->rc < 0) {
+        snprintf(res->msg, sizeof(res->msg), "Marching cubes extraction failed");
+    } else if (res->rc == 0 && mesh.tri_count == 0) {
+        res->rc = -1;
+        snprintf(res->msg, sizeof(res->msg), "Marching cubes produced no triangles");
+    } else if (res->rc == 0 && ts_mesh_write_stl(&mesh, td->path) != 0) {
+        res->rc = -1;
+        snprintf(res->msg, sizeof(res->msg), "Failed to write STL to %s",
+                 td->path);
+    }
+    res->verts = mesh.vert_count;
+    res->tris = mesh.tri_count;
+    ts_mesh_free(&mesh);
+
+    g_task_return_pointer(task, res, free);
+}
+
+static void
+export_done_cb(GObject *source_obj, GAsyncResult *result, gpointer userdata)
+{
+    (void)source_obj;
+    DC_ScadPreview *pv = userdata;
+    ExportTaskData *td = g_task_get_task_data(G_TASK(result));
+    ExportResult *res = g_task_propagate_pointer(G_TASK(result), NULL);
+
+    pv->mesh_running = 0;
+    if (!pv->hq_running) progress_stop(pv);
+    if (!res) return;
+
+    char msg[600];
+    if (res->rc == 0 && td->eda) {
+        dc_log(DC_LOG_INFO, DC_LOG_EVENT_APP,
+               "exported STL: %s (%d tris, streamed)", td->path, res->tris);
+        snprintf(msg, sizeof(msg), "Exported STL (%d tris)", res->tris);
+    } else if (res->rc == 0) {
+        dc_log(DC_LOG_INFO, DC_LOG_EVENT_APP,
+               "exported STL: %s (%d verts, %d tris)",
+               td->path, res->verts, res->tris);
+        snprintf(msg, sizeof(msg), "Exported STL (%d tris)", res->tris);
+    } else if (res->rc == 1) {
+        snprintf(msg, sizeof(msg), "STL export cancelled");
+    } else {
+        dc_log(DC_LOG_ERROR, DC_LOG_EVENT_APP, "STL export failed: %s",
+               res->msg);
+        snprintf(msg, sizeof(msg), "STL export failed: %.500s", res->msg);
+    }
+    gtk_label_set_text(GTK_LABEL(pv->status_label), msg);
+    log_append(pv, msg);
+    free(res);
+}
+
+/* Voxel ops of the editor's source as do_render would build them, or
+ * NULL if it has none (to_solid grids do not come from voxel ops). */
+static DC_CubeiformEda *
+export_source_eda(DC_ScadPreview *pv)
+{
+    char *text = pv->code_ed ? dc_code_editor_get_text(pv->code_ed) : NULL;
+    if (!text || !*text) {
+        free(text);
+        return NULL;
+    }
+    char *full_src = source_with_density(pv, text);
+    DC_CubeiformEda *eda = dc_cubeiform_parse_eda(full_src, NULL);
+    free(full_src);
+    if (eda && (dc_cubeiform_eda_vox_op_count(eda) == 0 ||
+                dc_cubeiform_eda_bmesh_op_count(eda) > 0)) {
+        dc_cubeiform_eda_free(eda);
+        eda = NULL;
+    }
+    return eda;
+}
+
 int
 dc_scad_preview_export_stl(DC_ScadPreview *pv, const char *path,
                            char **err_msg)
@@ -1355,40 +1776,46 @@ dc_scad_preview_export_stl(DC_ScadPreview *pv, const char *path,
         return -1;
     }
 
-    if (!pv->voxel_grid) {
-        if (err_msg) *err_msg = strdup("No voxel grid — render a solid first (use to_solid)");
+    if (pv->mesh_running || pv->hq_running) {
+        if (err_msg) *err_msg = strdup("Busy — wait for the current render or export to finish");
         return -1;
     }
 
-    ts_mesh mesh = ts_mesh_init();
-    int rc = dc_marching_cubes(pv->voxel_grid, 0.0f, &mesh);
-    if (rc != 0) {
-        ts_mesh_free(&mesh);
-        if (err_msg) *err_msg = strdup("Marching cubes extraction failed");
+    /* No grid on screen, e.g. because it was too large to build: the
+     * voxel ops of the source can still be streamed to the file a
+     * Z-slab at a time. */
+    DC_CubeiformEda *eda = pv->voxel_grid ? NULL : export_source_eda(pv);
+    if (!pv->voxel_grid && !eda) {
+        if (err_msg) *err_msg = strdup("No voxel grid — render a solid first (use to_solid)");
         return -1;
     }
 
-    if (mesh.tri_count == 0) {
-        ts_mesh_free(&mesh);
-        if (err_msg) *err_msg = strdup("Marching cubes produced no triangles");
+    ExportTaskData *td = calloc(1, sizeof(*td));
+    if (!td) {
+        dc_cubeiform_eda_free(eda);
+        if (err_msg) *err_msg = strdup("Out of memory");
         return -1;
     }
-
-    int wrc = ts_mesh_write_stl(&mesh, path);
-    if (wrc != 0) {
-        ts_mesh_free(&mesh);
-        if (err_msg) {
-            char buf[512];
-            snprintf(buf, sizeof(buf), "Failed to write STL to %s", path);
-            *err_msg = strdup(buf);
-        }
+    td->eda  = eda;
+    td->grid = eda ? NULL : dc_voxel_grid_copy(pv->voxel_grid);
+    td->path = strdup(path);
+    if ((!td->grid && !td->eda) || !td->path) {
+        export_task_data_free(td);
+        if (err_msg) *err_msg = strdup("Out of memory copying the voxel grid");
         return -1;
     }
+    td->threads  = pv->voxel_threads;
+    td->cancel   = &pv->mesh_cancel;
+    td->progress = &pv->progress;
 
-    dc_log(DC_LOG_INFO, DC_LOG_EVENT_APP,
-           "exported STL: %s (%d verts, %d tris)",
-           path, mesh.vert_count, mesh.tri_count);
+    progress_start(pv);
+    pv->mesh_cancel = 0;
+    pv->mesh_running = 1;
+    gtk_label_set_text(GTK_LABEL(pv->status_label), "Exporting STL...");
 
-    ts_mesh_free(&mesh);
+    GTask *task = g_task_new(NULL, NULL, export_done_cb, pv);
+    g_task_set_task_data(task, td, export_task_data_free);
+    g_task_run_in_thread(task, export_thread_func);
+    g_object_unref(task);
     return 0;
 }
@@ -55,8 +55,20 @@ int dc_scad_preview_is_rendering(DC_ScadPreview *pv);
 void dc_scad_preview_set_voxel_resolution(DC_ScadPreview *pv, int resolution);
 int  dc_scad_preview_get_voxel_resolution(DC_ScadPreview *pv);
 
-/* Export the current voxel grid as STL via marching cubes.
- * Returns 0 on success, -1 on error (no grid, MC failure, write failure).
+/* STL voxelizer worker threads. 0 (default) = one per CPU, 1 = serial. */
+void dc_scad_preview_set_voxel_threads(DC_ScadPreview *pv, int threads);
+int  dc_scad_preview_get_voxel_threads(DC_ScadPreview *pv);
+
+/* STL voxelizer sign test. 0 (default) = +X ray parity, 1 = generalized
+ * winding number, for meshes with holes or non-manifold edges. */
+void dc_scad_preview_set_voxel_winding(DC_ScadPreview *pv, int winding);
+int  dc_scad_preview_get_voxel_winding(DC_ScadPreview *pv);
+
+/* Export the current voxel grid as STL via marching cubes, on a worker
+ * thread with the progress bar running. A new HQ render cancels it.
+ * Returns 0 once the export has started, -1 if it could not start (no
+ * grid, busy, out of memory); completion, MC and write failures are
+ * reported in the status label and log.
  * If err_msg is non-NULL, it receives a malloc'd error string on failure. */
 int dc_scad_preview_export_stl(DC_ScadPreview *pv, const char *path,
                                char **err_msg);
@@ -0,0 +1,713 @@
+/*
+ * dual_contour.c — Adaptive (octree) dual contouring.
+ *
+ * The grid is walked a tile (DC_VOXEL_BRICK^3 cells) at a time, each tile
+ * the root of a small octree.
+ *
+ * Pass 1 loads a tile's samples and builds a min/max pyramid over its
+ * cells. A tile, or any node below it, whose samples all lie on one side
+ * of iso_level is dropped without visiting its cells. Leaf cells get a
+ * QEF from the tangent planes at their crossing edges; a parent whose
+ * eight children are all leaves becomes a leaf itself when the merge
+ * passes the topology test and the merged QEF still fits. Every leaf left
+ * standing emits one vertex and stamps its index into the tile's cell
+ * map.
+ *
+ * Pass 2 walks the crossing edges and joins the cell-map vertices of the
+ * four cells around each one. An edge inside a merged cell maps all four
+ * cells to one vertex and emits nothing; an edge on its boundary emits a
+ * triangle or a quad.
+ */
+
+#include "voxel/dual_contour.h"
+#include "voxel/voxel.h"
+#include "../../talmud-main/talmud/sacred/trinity_site/ts_mesh.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DCT_LEVELS 3                  /* tree levels above a cell */
+#define DCT_B      DC_VOXEL_BRICK     /* cells per tile side */
+#define DCT_NS     (DCT_B + 1)        /* samples per tile side */
+
+#if DC_VOXEL_BRICK != (1 << DCT_LEVELS)
+#error "dual_contour.c: DCT_LEVELS must match DC_VOXEL_BRICK"
+#endif
+
+/* Eigenvalues below this fraction of the largest are treated as zero
+ * when solving a QEF: the planes leave x free along those directions and
+ * the mass point fills in. */
+#define DCT_SVD_CUTOFF 0.05
+
+/* Quadric error function: sum over tangent planes of (n.x - n.p)^2 */
+typedef struct {
+    double ata[6];      /* xx xy xz yy yz zz */
+    double atb[3];
+    double btb;
+    double mass[3];     /* sum of the crossing points */
+    double nsum[3];     /* sum of the plane normals (vertex normal) */
+    int    n;
+} Qef;
+
+typedef enum { NODE_EMPTY, NODE_LEAF, NODE_SPLIT } NodeState;
+
+typedef struct {
+    NodeState state;
+    int       simple;   /* surface in the cell is a single sheet */
+    Qef       q;
+    float     v[3];
+} Node;
+
+typedef struct {
+    const DC_VoxelGrid *grid;
+    const float *plane; /* SoA distance plane, NULL for cell storage */
+    int      sparse;
+    ts_mesh *out;
+    float    iso, cs;
+    double   tol2;      /* max mean squared error, < 0 = never merge */
+    int      nx, ny, nz;            /* cells per axis */
+    int      x0, y0, z0;            /* tile origin, in cells */
+    /* samples [z][y][x] from one before the tile origin to DCT_NS after
+     * it, clamped to the grid; read through S() */
+    float    s[DCT_NS + 2][DCT_NS + 2][DCT_NS + 2];
+    float    mn[DCT_LEVELS + 1][DCT_B * DCT_B * DCT_B];
+    float    mx[DCT_LEVELS + 1][DCT_B * DCT_B * DCT_B];
+    int     *map;       /* DCT_B^3 cells -> vertex index, -1 = none */
+    int      fail;
+} Tile;
+
+/* Corner c of a cell: bit 0 = +x, bit 1 = +y, bit 2 = +z */
+#define S(t, x, y, z) ((t)->s[(z) + 1][(y) + 1][(x) + 1])
+
+static const int CELL_EDGES[12][2] = {
+    {0, 1}, {2, 3}, {4, 5}, {6, 7},     /* x */
+    {0, 2}, {1, 3}, {4, 6}, {5, 7},     /* y */
+    {0, 4}, {1, 5}, {2, 6}, {3, 7},     /* z */
+};
+
+/* =========================================================================
+ * QEF
+ * ========================================================================= */
+
+static void qef_add(Qef *q, const double p[3], const double n[3])
+{
+    double d = n[0]*p[0] + n[1]*p[1] + n[2]*p[2];
+    q->ata[0] += n[0]*n[0]; q->ata[1] += n[0]*n[1]; q->ata[2] += n[0]*n[2];
+    q->ata[3] += n[1]*n[1]; q->ata[4] += n[1]*n[2]; q->ata[5] += n[2]*n[2];
+    for (int a = 0; a < 3; a++) {
+        q->atb[a]  += n[a] * d;
+        q->mass[a] += p[a];
+        q->nsum[a] += n[a];
+    }
+    q->btb += d * d;
+    q->n++;
+}
+
+static void qef_merge(Qef *q, const Qef *o)
+{
+    for (int i = 0; i < 6; i++) q->ata[i] += o->ata[i];
+    for (int a = 0; a < 3; a++) {
+        q->atb[a]  += o->atb[a];
+        q->mass[a] += o->mass[a];
+        q->nsum[a] += o->nsum[a];
+    }
+    q->btb += o->btb;
+    q->n   += o->n;
+}
+
+static double qef_error(const Qef *q, const double x[3])
+{
+    const double *m = q->ata;
+    double ax0 = m[0]*x[0] + m[1]*x[1] + m[2]*x[2];
+    double ax1 = m[1]*x[0] + m[3]*x[1] + m[4]*x[2];
+    double ax2 = m[2]*x[0] + m[4]*x[1] + m[5]*x[2];
+    double e = x[0]*ax0 + x[1]*ax1 + x[2]*ax2
+             - 2.0 * (x[0]*q->atb[0] + x[1]*q->atb[1] + x[2]*q->atb[2])
+             + q->btb;
+    return e > 0.0 ? e : 0.0;
+}
+
+/* Eigen-decomposition of a symmetric 3x3 matrix by cyclic Jacobi:
+ * a = V diag(w) V^T, eigenvectors in the columns of v. */
+static void sym3_eigen(const double s[6], double w[3], double v[3][3])
+{
+    double a[3][3] = {
+        { s[0], s[1], s[2] },
+        { s[1], s[3], s[4] },
+        { s[2], s[4], s[5] },
+    };
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            v[i][j] = (i == j) ? 1.0 : 0.0;
+
+    for (int sweep = 0; sweep < 12; sweep++) {
+        double off = a[0][1]*a[0][1] + a[0][2]*a[0][2] + a[1][2]*a[1][2];
+        if (off < 1e-24) break;
+        for (int p = 0; p < 2; p++) {
+            for (int r = p + 1; r < 3; r++) {
+                if (fabs(a[p][r]) < 1e-30) continue;
+                double theta = (a[r][r] - a[p][p]) / (2.0 * a[p][r]);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) /
+                           (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0), sn = t * c;
+                for (int k = 0; k < 3; k++) {
+                    double akp = a[k][p], akr = a[k][r];
+                    a[k][p] = c * akp - sn * akr;
+                    a[k][r] = sn * akp + c * akr;
+                }
+                for (int k = 0; k < 3; k++) {
+                    double apk = a[p][k], ark = a[r][k];
+                    a[p][k] = c * apk - sn * ark;
+                    a[r][k] = sn * apk + c * ark;
+                }
+                for (int k = 0; k < 3; k++) {
+                    double vkp = v[k][p], vkr = v[k][r];
+                    v[k][p] = c * vkp - sn * vkr;
+                    v[k][r] = sn * vkp + c * vkr;
+                }
+            }
+        }
+    }
+    w[0] = a[0][0]; w[1] = a[1][1]; w[2] = a[2][2];
+}
+
+/* Minimise the QEF inside [lo, hi] (grown by a small tolerance). Solves
+ * about the mass point with a truncated pseudo-inverse; a minimum outside
+ * the box falls back to the mass point. Returns the error at x. */
+static double qef_solve(const Qef *q, const double lo[3], const double hi[3],
+                        double x[3])
+{
+    double m[3];
+    for (int a = 0; a < 3; a++) m[a] = q->mass[a] / (double)q->n;
+
+    const double *A = q->ata;
+    double r[3] = {
+        q->atb[0] - (A[0]*m[0] + A[1]*m[1] + A[2]*m[2]),
+        q->atb[1] - (A[1]*m[0] + A[3]*m[1] + A[4]*m[2]),
+        q->atb[2] - (A[2]*m[0] + A[4]*m[1] + A[5]*m[2]),
+    };
+
+    double w[3], v[3][3];
+    sym3_eigen(A, w, v);
+    double wmax = fmax(fabs(w[0]), fmax(fabs(w[1]), fabs(w[2])));
+
+    for (int a = 0; a < 3; a++) x[a] = m[a];
+    for (int k = 0; k < 3; k++) {
+        if (wmax <= 0.0 || fabs(w[k]) < DCT_SVD_CUTOFF * wmax) continue;
+        double c = (v[0][k]*r[0] + v[1][k]*r[1] + v[2][k]*r[2]) / w[k];
+        for (int a = 0; a < 3; a++) x[a] += c * v[a][k];
+    }
+
+    for (int a = 0; a < 3; a++) {
+        double slack = 1e-3 * (hi[a] - lo[a]);
+        if (x[a] < lo[a] - slack || x[a] > hi[a] + slack) {
+            for (int b = 0; b < 3; b++) x[b] = m[b];
+            break;
+        }
+    }
+    return qef_error(q, x);
+}
+
+/* =========================================================================
+ * Tile octree
+ * ========================================================================= */
+
+static inline int inside(const Tile *t, float d) { return d < t->iso; }
+
+/* A cell with corner sign mask `mask` holds a single sheet of surface:
+ * its inside corners are edge-connected, and so are its outside ones. */
+static int single_sheet(int mask)
+{
+    int out = ~mask & 0xff;
+    int in_seen = mask & -mask, out_seen = out & -out;
+    for (int pass = 0; pass < 3; pass++) {
+        for (int e = 0; e < 12; e++) {
+            int b0 = 1 << CELL_EDGES[e][0], b1 = 1 << CELL_EDGES[e][1];
+            if ((mask & b0) && (mask & b1) && (in_seen & (b0 | b1)))
+                in_seen |= b0 | b1;
+            if ((out & b0) && (out & b1) && (out_seen & (b0 | b1)))
+                out_seen |= b0 | b1;
+        }
+    }
+    return in_seen == mask && out_seen == out;
+}
+
+/* Cells around a grid edge along axis a, counter-clockwise about a:
+ * offsets along axes (a+1)%3 and (a+2)%3 from the edge's lower sample */
+static const int EDGE_RING[4][2] = { {-1, -1}, {0, -1}, {0, 0}, {-1, 0} };
+
+/* Unit normal at the crossing u along the edge on axis a from tile-local
+ * sample e: the gradient of the trilinear interpolant, taken in whichever
+ * of the four cells around the edge is closest to linear. An SDF is
+ * smooth away from its creases, so next to an edge or corner at least
+ * one of these cells usually lies on the crossing's side of it and gives
+ * the true tangent plane. Returns 0 if no cell has a usable gradient. */
+static int edge_normal(const Tile *t, const int e[3], int a, double u,
+                       double n[3])
+{
+    int a1 = (a + 1) % 3, a2 = (a + 2) % 3;
+    int org[3] = { t->x0, t->y0, t->z0 };
+    int lim[3] = { t->nx, t->ny, t->nz };
+    double best = INFINITY, len2 = 0.0;
+
+    for (int r = 0; r < 4; r++) {
+        int c[3] = { e[0], e[1], e[2] };
+        c[a1] += EDGE_RING[r][0];
+        c[a2] += EDGE_RING[r][1];
+        if (org[a] + c[a] >= lim[a] || org[a1] + c[a1] < 0 ||
+            org[a1] + c[a1] >= lim[a1] || org[a2] + c[a2] < 0 ||
+            org[a2] + c[a2] >= lim[a2])
+            continue;
+
+        double v[8];
+        for (int k = 0; k < 8; k++)
+            v[k] = S(t, c[0] + (k & 1), c[1] + ((k >> 1) & 1), c[2] + (k >> 2));
+        double bend = fabs(v[0] - v[1] - v[2] + v[3]) + fabs(v[4] - v[5] - v[6] + v[7])
+                    + fabs(v[0] - v[1] - v[4] + v[5]) + fabs(v[2] - v[3] - v[6] + v[7])
+                    + fabs(v[0] - v[2] - v[4] + v[6]) + fabs(v[1] - v[3] - v[5] + v[7]);
+        if (bend >= best) continue;
+
+        double f[3];
+        f[a] = u;
+        f[a1] = (double)-EDGE_RING[r][0];
+        f[a2] = (double)-EDGE_RING[r][1];
+        double g[3] = { 0.0, 0.0, 0.0 };
+        for (int k = 0; k < 8; k++) {
+            double w[3], s[3];
+            for (int b = 0; b < 3; b++) {
+                int hi = (k >> b) & 1;
+                w[b] = hi ? f[b] : 1.0 - f[b];
+                s[b] = hi ? 1.0 : -1.0;
+            }
+            g[0] += v[k] * s[0] * w[1] * w[2];
+            g[1] += v[k] * s[1] * w[0] * w[2];
+            g[2] += v[k] * s[2] * w[0] * w[1];
+        }
+        double l2 = g[0]*g[0] + g[1]*g[1] + g[2]*g[2];
+        if (l2 < 1e-24) continue;
+        best = bend;
+        len2 = l2;
+        for (int b = 0; b < 3; b++) n[b] = g[b];
+    }
+    if (len2 <= 0.0) return 0;
+    double len = sqrt(len2);
+    for (int b = 0; b < 3; b++) n[b] /= len;
+    return 1;
+}
+
+/* Leaf cell at tile-local (lx,ly,lz) */
+static void build_cell(Tile *t, int lx, int ly, int lz, Node *node)
+{
+    node->state = NODE_EMPTY;
+    int gx = t->x0 + lx, gy = t->y0 + ly, gz = t->z0 + lz;
+    if (gx >= t->nx || gy >= t->ny || gz >= t->nz) return;
+
+    float val[8];
+    int mask = 0;
+    for (int c = 0; c < 8; c++) {
+        val[c] = S(t, lx + (c & 1), ly + ((c >> 1) & 1), lz + (c >> 2));
+        if (inside(t, val[c])) mask |= 1 << c;
+    }
+    if (mask == 0 || mask == 0xff) return;
+
+    memset(&node->q, 0, sizeof(node->q));
+    for (int e = 0; e < 12; e++) {
+        int c0 = CELL_EDGES[e][0], c1 = CELL_EDGES[e][1];
+        if (((mask >> c0) & 1) == ((mask >> c1) & 1)) continue;
+
+        double dd = (double)val[c1] - (double)val[c0];
+        double u = fabs(dd) < 1e-20 ? 0.5 : ((double)t->iso - val[c0]) / dd;
+        if (u < 0.0) u = 0.0;
+        if (u > 1.0) u = 1.0;
+
+        int axis = e / 4;
+        int le[3] = { lx + (c0 & 1), ly + ((c0 >> 1) & 1), lz + (c0 >> 2) };
+        double p[3], n[3];
+        if (!edge_normal(t, le, axis, u, n)) continue;
+        int org[3] = { t->x0, t->y0, t->z0 };
+        for (int a = 0; a < 3; a++)
+            p[a] = ((double)(org[a] + le[a]) + (a == axis ? u : 0.0) + 0.5) *
+                   (double)t->cs;
+        qef_add(&node->q, p, n);
+    }
+    if (node->q.n == 0) return;
+
+    node->simple = single_sheet(mask);
+
+    double lo[3] = { (gx + 0.5) * (double)t->cs, (gy + 0.5) * (double)t->cs,
+                     (gz + 0.5) * (double)t->cs };
+    double hi[3] = { lo[0] + t->cs, lo[1] + t->cs, lo[2] + t->cs };
+    double x[3];
+    qef_solve(&node->q, lo, hi, x);
+    for (int a = 0; a < 3; a++) node->v[a] = (float)x[a];
+    node->state = NODE_LEAF;
+}
+
+/* Emit a leaf's vertex and stamp it over the cells it covers */
+static void emit_leaf(Tile *t, const Node *node, int level,
+                      int lx, int ly, int lz)
+{
+    if (node->state != NODE_LEAF || t->fail) return;
+    if (!t->map) {
+        t->map = malloc(sizeof(int) * DCT_B * DCT_B * DCT_B);
+        if (!t->map) { t->fail = 1; return; }
+        for (int i = 0; i < DCT_B * DCT_B * DCT_B; i++) t->map[i] = -1;
+    }
+
+    double nl = sqrt(node->q.nsum[0]*node->q.nsum[0] +
+                     node->q.nsum[1]*node->q.nsum[1] +
+                     node->q.nsum[2]*node->q.nsum[2]);
+    if (nl < 1e-20) nl = 1.0;
+    int vi = ts_mesh_add_vertex(t->out, node->v[0], node->v[1], node->v[2],
+                                node->q.nsum[0] / nl, node->q.nsum[1] / nl,
+                                node->q.nsum[2] / nl);
+    if (vi < 0) { t->fail = 1; return; }
+
+    int size = 1 << level;
+    for (int z = lz; z < lz + size; z++)
+        for (int y = ly; y < ly + size; y++)
+            for (int x = lx; x < lx + size; x++)
+                t->map[(z * DCT_B + y) * DCT_B + x] = vi;
+}
+
+/* Topology test for merging a node of side 2h at (lx,ly,lz): its corner
+ * signs must describe a single sheet, and every child corner on an edge,
+ * face or the centre of the node must share its sign with at least one
+ * of the node corners spanning that feature (Ju et al., "Dual Contouring
+ * of Hermite Data"). */
+static int merge_safe(const Tile *t, int lx, int ly, int lz, int h)
+{
+    int lat[3][3][3];
+    for (int k = 0; k < 3; k++)
+        for (int j = 0; j < 3; j++)
+            for (int i = 0; i < 3; i++)
+                lat[k][j][i] = inside(t, S(t, lx + i*h, ly + j*h, lz + k*h));
+
+    int mask = 0;
+    for (int c = 0; c < 8; c++)
+        if (lat[(c >> 2) * 2][((c >> 1) & 1) * 2][(c & 1) * 2]) mask |= 1 << c;
+    if (!single_sheet(mask)) return 0;
+
+    for (int k = 0; k < 3; k++)
+    for (int j = 0; j < 3; j++)
+    for (int i = 0; i < 3; i++) {
+        if (i != 1 && j != 1 && k != 1) continue;   /* a node corner */
+        int any_in = 0, any_out = 0;
+        for (int c = 0; c < 8; c++) {
+            int ci = (c & 1) * 2, cj = ((c >> 1) & 1) * 2, ck = (c >> 2) * 2;
+            if ((i != 1 && ci != i) || (j != 1 && cj != j) ||
+                (k != 1 && ck != k)) continue;
+            if (lat[ck][cj][ci]) any_in = 1; else any_out = 1;
+        }
+        if (lat[k][j][i] ? !any_in : !any_out) return 0;
+    }
+    return 1;
+}
+
+static void build_node(Tile *t, int level, int lx, int ly, int lz, Node *node)
+{
+    int size = 1 << level;
+    int pi = ((lz >> level) * (DCT_B >> level) + (ly >> level)) *
+             (DCT_B >> level) + (lx >> level);
+    if (t->mn[level][pi] >= t->iso || t->mx[level][pi] < t->iso) {
+        node->state = NODE_EMPTY;
+        return;
+    }
+    if (level == 0) {
+        build_cell(t, lx, ly, lz, node);
+        return;
+    }
+
+    int h = size >> 1;
+    Node kids[8];
+    int split = 0, leaves = 0;
+    for (int c = 0; c < 8; c++) {
+        build_node(t, level - 1, lx + (c & 1) * h, ly + ((c >> 1) & 1) * h,
+                   lz + (c >> 2) * h, &kids[c]);
+        if (kids[c].state == NODE_SPLIT) split = 1;
+        else if (kids[c].state == NODE_LEAF) {
+            leaves++;
+            if (!kids[c].simple) split = 1;
+        }
+    }
+    if (!split && leaves == 0) {
+        node->state = NODE_EMPTY;
+        return;
+    }
+
+    /* Merge only whole nodes that the topology test allows */
+    if (!split) {
+        split = t->tol2 < 0.0 ||
+                t->x0 + lx + size > t->nx || t->y0 + ly + size > t->ny ||
+                t->z0 + lz + size > t->nz ||
+                !merge_safe(t, lx, ly, lz, h);
+    }
+    if (!split) {
+        memset(&node->q, 0, sizeof(node->q));
+        for (int c = 0; c < 8; c++)
+            if (kids[c].state == NODE_LEAF) qef_merge(&node->q, &kids[c].q);
+        double lo[3] = {
+            (t->x0 + lx + 0.5) * (double)t->cs,
+            (t->y0 + ly + 0.5) * (double)t->cs,
+            (t->z0 + lz + 0.5) * (double)t->cs,
+        };
+        double hi[3] = { lo[0] + size * (double)t->cs,
+                         lo[1] + size * (double)t->cs,
+                         lo[2] + size * (double)t->cs };
+        double x[3];
+        double err = qef_solve(&node->q, lo, hi, x);
+        if (err <= t->tol2 * (double)node->q.n) {
+            for (int a = 0; a < 3; a++) node->v[a] = (float)x[a];
+            node->state = NODE_LEAF;
+            node->simple = 1;
+            return;
+        }
+    }
+
+    for (int c = 0; c < 8; c++)
+        emit_leaf(t, &kids[c], level - 1, lx + (c & 1) * h,
+                  ly + ((c >> 1) & 1) * h, lz + (c >> 2) * h);
+    node->state = NODE_SPLIT;
+}
+
+/* dst[i] = distance at (x + i, y, z) for i in [0, n), read a tile row
+ * at a time (rows are contiguous in every storage mode, voxel.h) */
+static void read_row(const Tile *t, int x, int n, int y, int z, float *dst)
+{
+    if (t->plane) {
+        memcpy(dst, t->plane + ((size_t)z * (t->ny + 1) + y) * (t->nx + 1) + x,
+               (size_t)n * sizeof(float));
+        return;
+    }
+    while (n > 0) {
+        int seg = DC_VOXEL_BRICK - x % DC_VOXEL_BRICK;
+        if (seg > n) seg = n;
+        DC_Voxel c;
+        const DC_Voxel *v = NULL;
+        int konst = t->sparse && dc_voxel_grid_tile_constant(t->grid,
+                x / DC_VOXEL_BRICK, y / DC_VOXEL_BRICK, z / DC_VOXEL_BRICK, &c);
+        if (!konst)
+            v = dc_voxel_grid_get_const(t->grid, x, y, z);
+        /* Neither: a quantized SoA grid, decoded per cell */
+        for (int i = 0; i < seg; i++)
+            dst[i] = v ? v[i].distance : konst ? c.distance
+                   : dc_voxel_grid_distance(t->grid, x + i, y, z);
+        x += seg;
+        dst += seg;
+        n -= seg;
+    }
+}
+
+/* Load the tile's samples and min/max pyramid. Returns 0 when every
+ * sample lies on one side of iso_level. */
+static int load_tile(Tile *t)
+{
+    int sx = t->nx + 1, sy = t->ny + 1, sz = t->nz + 1;
+    /* Grid columns covered by samples -1 .. DCT_NS, clamped */
+    int gx0 = t->x0 > 0 ? t->x0 - 1 : 0;
+    int gx1 = t->x0 + DCT_NS < sx ? t->x0 + DCT_NS : sx - 1;
+    int below = 0, above = 0;
+    for (int z = -1; z <= DCT_NS; z++) {
+        int gz = t->z0 + z;
+        gz = gz < 0 ? 0 : gz < sz ? gz : sz - 1;
+        for (int y = -1; y <= DCT_NS; y++) {
+            int gy = t->y0 + y;
+            gy = gy < 0 ? 0 : gy < sy ? gy : sy - 1;
+            float *row = &S(t, gx0 - t->x0, y, z);
+            read_row(t, gx0, gx1 - gx0 + 1, gy, gz, row);
+            for (int x = -1; x < gx0 - t->x0; x++) S(t, x, y, z) = row[0];
+            for (int x = gx1 - t->x0 + 1; x <= DCT_NS; x++)
+                S(t, x, y, z) = row[gx1 - gx0];
+            if (y < 0 || y >= DCT_NS || z < 0 || z >= DCT_NS) continue;
+            for (int x = 0; x < DCT_NS; x++) {
+                if (S(t, x, y, z) < t->iso) below = 1;
+                else above = 1;
+            }
+        }
+    }
+    if (!(below && above)) return 0;
+
+    for (int z = 0; z < DCT_B; z++)
+    for (int y = 0; y < DCT_B; y++)
+    for (int x = 0; x < DCT_B; x++) {
+        float lo = S(t, x, y, z), hi = lo;
+        for (int c = 1; c < 8; c++) {
+            float v = S(t, x + (c & 1), y + ((c >> 1) & 1), z + (c >> 2));
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+        }
+        t->mn[0][(z * DCT_B + y) * DCT_B + x] = lo;
+        t->mx[0][(z * DCT_B + y) * DCT_B + x] = hi;
+    }
+    for (int l = 1; l <= DCT_LEVELS; l++) {
+        int n = DCT_B >> l, cn = n * 2;
+        for (int z = 0; z < n; z++)
+        for (int y = 0; y < n; y++)
+        for (int x = 0; x < n; x++) {
+            float lo = INFINITY, hi = -INFINITY;
+            for (int c = 0; c < 8; c++) {
+                int ci = ((2*z + (c >> 2)) * cn + 2*y + ((c >> 1) & 1)) * cn +
+                         2*x + (c & 1);
+                if (t->mn[l - 1][ci] < lo) lo = t->mn[l - 1][ci];
+                if (t->mx[l - 1][ci] > hi) hi = t->mx[l - 1][ci];
+            }
+            t->mn[l][(z * n + y) * n + x] = lo;
+            t->mx[l][(z * n + y) * n + x] = hi;
+        }
+    }
+    return 1;
+}
+
+/* Sparse grids: a tile whose cells only read constant tiles on one side
+ * of iso_level holds no surface (as in marching_cubes.c) */
+static int tile_constant_side(const DC_VoxelGrid *grid, float iso,
+                              int tx, int ty, int tz,
+                              int ntx, int nty, int ntz)
+{
+    int below = 0, above = 0;
+    for (int dz = 0; dz < 2; dz++)
+    for (int dy = 0; dy < 2; dy++)
+    for (int dx = 0; dx < 2; dx++) {
+        int nx = tx + dx < ntx ? tx + dx : ntx - 1;
+        int ny = ty + dy < nty ? ty + dy : nty - 1;
+        int nz = tz + dz < ntz ? tz + dz : ntz - 1;
+        DC_Voxel v;
+        if (!dc_voxel_grid_tile_constant(grid, nx, ny, nz, &v)) return 0;
+        if (v.distance < iso) below = 1; else above = 1;
+    }
+    return !(below && above);
+}
+
+/* =========================================================================
+ * Public API
+ * ========================================================================= */
+
+DC_DualContourOpts dc_dual_contour_defaults(const DC_VoxelGrid *grid)
+{
+    DC_DualContourOpts o;
+    o.max_error = grid ? 0.05f * dc_voxel_grid_cell_size(grid) : 0.0f;
+    return o;
+}
+
+int dc_dual_contour(const DC_VoxelGrid *grid, float iso_level,
+                    const DC_DualContourOpts *opts, void *out_ptr)
+{
+    if (!grid || !out_ptr) return -1;
+    ts_mesh *out = (ts_mesh *)out_ptr;
+
+    DC_DualContourOpts o = opts ? *opts : dc_dual_contour_defaults(grid);
+    int sx = dc_voxel_grid_size_x(grid);
+    int sy = dc_voxel_grid_size_y(grid);
+    int sz = dc_voxel_grid_size_z(grid);
+    if (sx < 2 || sy < 2 || sz < 2) return 0;
+
+    int ntx = (sx - 1 + DCT_B - 1) / DCT_B;
+    int nty = (sy - 1 + DCT_B - 1) / DCT_B;
+    int ntz = (sz - 1 + DCT_B - 1) / DCT_B;
+    size_t ntiles = (size_t)ntx * nty * ntz;
+    int **maps = calloc(ntiles, sizeof(int *));
+    Tile *t = malloc(sizeof(Tile));
+    if (!maps || !t) {
+        free(maps);
+        free(t);
+        return -1;
+    }
+
+    int sparse = dc_voxel_grid_is_sparse(grid);
+    int gtx, gty, gtz;
+    dc_voxel_grid_tile_dims(grid, &gtx, &gty, &gtz);
+
+    memset(t, 0, sizeof(*t));
+    t->grid = grid;
+    t->plane = dc_voxel_grid_is_soa(grid) ? dc_voxel_grid_distances_const(grid)
+                                          : NULL;
+    t->sparse = sparse;
+    t->out = out;
+    t->iso = iso_level;
+    t->cs = dc_voxel_grid_cell_size(grid);
+    t->tol2 = o.max_error < 0.0f ? -1.0
+            : (double)o.max_error * (double)o.max_error;
+    t->nx = sx - 1; t->ny = sy - 1; t->nz = sz - 1;
+
+    /* Pass 1: vertices, tile by tile */
+    int rc = 0;
+    for (int tz = 0; tz < ntz && !rc; tz++)
+    for (int ty = 0; ty < nty && !rc; ty++)
+    for (int tx = 0; tx < ntx && !rc; tx++) {
+        if (sparse && tile_constant_side(grid, iso_level, tx, ty, tz,
+                                         gtx, gty, gtz))
+            continue;
+        t->x0 = tx * DCT_B; t->y0 = ty * DCT_B; t->z0 = tz * DCT_B;
+        if (!load_tile(t)) continue;
+
+        Node root;
+        t->map = NULL;
+        build_node(t, DCT_LEVELS, 0, 0, 0, &root);
+        emit_leaf(t, &root, DCT_LEVELS, 0, 0, 0);
+        maps[((size_t)tz * nty + ty) * ntx + tx] = t->map;
+        if (t->fail) rc = -1;
+    }
+
+    /* Pass 2: one quad per crossing edge, joining the four cells around
+     * it in counter-clockwise order seen from the outside */
+    for (int tz = 0; tz < ntz && !rc; tz++)
+    for (int ty = 0; ty < nty && !rc; ty++)
+    for (int tx = 0; tx < ntx && !rc; tx++) {
+        if (!maps[((size_t)tz * nty + ty) * ntx + tx]) continue;
+        int x1 = (tx + 1) * DCT_B < sx ? (tx + 1) * DCT_B : sx;
+        int y1 = (ty + 1) * DCT_B < sy ? (ty + 1) * DCT_B : sy;
+        int z1 = (tz + 1) * DCT_B < sz ? (tz + 1) * DCT_B : sz;
+        for (int z = tz * DCT_B; z < z1; z++)
+        for (int y = ty * DCT_B; y < y1; y++)
+        for (int x = tx * DCT_B; x < x1; x++) {
+            int p[3] = { x, y, z };
+            int lim[3] = { sx - 1, sy - 1, sz - 1 };
+            int in0 = dc_voxel_grid_distance(grid, x, y, z) < iso_level;
+            for (int a = 0; a < 3; a++) {
+                if (p[a] >= lim[a]) continue;
+                int q[3] = { x, y, z };
+                q[a]++;
+                int in1 = dc_voxel_grid_distance(grid, q[0], q[1], q[2])
+                          < iso_level;
+                if (in0 == in1) continue;
+
+                int u = (a + 1) % 3, v = (a + 2) % 3;
+                int vi[4], ok = 1;
+                for (int r = 0; r < 4 && ok; r++) {
+                    int c[3] = { x, y, z };
+                    c[u] += EDGE_RING[r][0];
+                    c[v] += EDGE_RING[r][1];
+                    if (c[u] < 0 || c[v] < 0 || c[u] >= lim[u] ||
+                        c[v] >= lim[v]) { ok = 0; break; }
+                    const int *m = maps[((size_t)(c[2] / DCT_B) * nty +
+                                         c[1] / DCT_B) * ntx + c[0] / DCT_B];
+                    vi[r] = m ? m[((c[2] % DCT_B) * DCT_B + c[1] % DCT_B) *
+                                  DCT_B + c[0] % DCT_B] : -1;
+                    if (vi[r] < 0) ok = 0;
+                }
+                if (!ok) continue;
+                if (!in0) {
+                    int tmp = vi[1]; vi[1] = vi[3]; vi[3] = tmp;
+                }
+
+                /* Drop repeated vertices from merged cells */
+                int ring[4], n = 0;
+                for (int r = 0; r < 4; r++)
+                    if (n == 0 || (vi[r] != ring[n - 1] && vi[r] != ring[0]))
+                        ring[n++] = vi[r];
+                if (n < 3) continue;
+                if (ts_mesh_add_triangle(out, ring[0], ring[1], ring[2]) < 0)
+                    rc = -1;
+                if (n == 4 && ring[3] != ring[1] &&
+                    ts_mesh_add_triangle(out, ring[0], ring[2], ring[3]) < 0)
+                    rc = -1;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < ntiles; i++) free(maps[i]);
+    free(maps);
+    free(t);
+    return rc;
+}
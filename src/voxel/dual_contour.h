@@ -0,0 +1,50 @@
+#ifndef DC_DUAL_CONTOUR_H
+#define DC_DUAL_CONTOUR_H
+
+/*
+ * dual_contour.h — Adaptive isosurface extraction from SDF voxel grids.
+ *
+ * Octree dual contouring: every grid cell the surface crosses gets one
+ * vertex, placed by minimising the squared distance to the tangent planes
+ * at its edge crossings (a QEF; normals come from the SDF gradient). On
+ * flat faces and straight edges those planes fit a larger cell just as
+ * well, so cells are merged bottom-up, 2x2x2 at a time, up to one tile
+ * (DC_VOXEL_BRICK cells) per side, while the merged QEF error stays
+ * below a tolerance and the merge cannot change the surface topology.
+ * Tiles whose samples are all on one side of the surface are skipped
+ * without visiting their cells.
+ *
+ * Each surface-crossing grid edge emits a quad joining the vertices of
+ * the four cells around it, so vertices are shared by every triangle
+ * that uses them and corners and creases of the SDF stay sharp.
+ *
+ * Output is an indexed ts_mesh in the same coordinates as
+ * dc_marching_cubes() (marching_cubes.h).
+ *
+ * No GTK dependency.
+ */
+
+#include "voxel/voxel.h"
+
+typedef struct {
+    /* RMS distance, in world units, from a merged vertex to the tangent
+     * planes of its cell. 0 merges only exact fits; < 0 disables
+     * merging (uniform dual contouring). */
+    float max_error;
+} DC_DualContourOpts;
+
+/* Default options: max_error = 5% of the cell size. */
+DC_DualContourOpts dc_dual_contour_defaults(const DC_VoxelGrid *grid);
+
+/*
+ * Extract the isosurface at iso_level from an SDF grid into out (a
+ * ts_mesh initialized with ts_mesh_init; triangles are appended).
+ * opts may be NULL for dc_dual_contour_defaults().
+ *
+ * Returns 0 on success, -1 on error (NULL grid or out, allocation
+ * failure).
+ */
+int dc_dual_contour(const DC_VoxelGrid *grid, float iso_level,
+                    const DC_DualContourOpts *opts, void *out);
+
+#endif /* DC_DUAL_CONTOUR_H */
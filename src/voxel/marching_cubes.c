@@ -7,9 +7,12 @@
 
 #include "voxel/marching_cubes.h"
 #include "voxel/voxel.h"
+#include "voxel/voxel_pool.h"
 #include "../../talmud-main/talmud/sacred/trinity_site/ts_mesh.h"
 
+#include <glib.h>
 #include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -344,6 +347,67 @@ static const int VERT_OFS[8][3] = {
     {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}
 };
 
+/* =========================================================================
+ * Edge cache
+ *
+ * Cubes are visited one z-slice at a time, so every cube edge is either
+ * an x or y edge on the slice's lower or upper sample layer, or a z edge
+ * between them. The cache holds the mesh vertex index of each such grid
+ * edge (-1 = not yet interpolated); neighbouring cubes reuse it instead
+ * of emitting their own copy. After a slice the upper layer becomes the
+ * lower one.
+ *
+ * EDGE_SLOT[e] = { axis, layer, dx, dy } locates MC edge e relative to
+ * the cube's (ix, iy).
+ * ========================================================================= */
+static const int EDGE_SLOT[12][4] = {
+    {0, 0, 0, 0}, {1, 0, 1, 0}, {0, 0, 0, 1}, {1, 0, 0, 0},
+    {0, 1, 0, 0}, {1, 1, 1, 0}, {0, 1, 0, 1}, {1, 1, 0, 0},
+    {2, 0, 0, 0}, {2, 0, 1, 0}, {2, 0, 1, 1}, {2, 0, 0, 1}
+};
+
+typedef struct {
+    int sx;            /* samples per row */
+    size_t plane;      /* sx * sy */
+    int *x[2], *y[2];  /* x/y edges on the lower and upper layer */
+    int *z;            /* z edges between the layers */
+    int *mem;
+} EdgeCache;
+
+static int edge_cache_init(EdgeCache *c, int sx, int sy)
+{
+    c->sx = sx;
+    c->plane = (size_t)sx * (size_t)sy;
+    c->mem = malloc(c->plane * 5 * sizeof(int));
+    if (!c->mem) return -1;
+    memset(c->mem, 0xff, c->plane * 5 * sizeof(int));
+    c->x[0] = c->mem;
+    c->x[1] = c->mem + c->plane;
+    c->y[0] = c->mem + c->plane * 2;
+    c->y[1] = c->mem + c->plane * 3;
+    c->z    = c->mem + c->plane * 4;
+    return 0;
+}
+
+/* Move on to the next slice: the upper layer becomes the lower one. */
+static void edge_cache_next_slice(EdgeCache *c)
+{
+    int *t = c->x[0]; c->x[0] = c->x[1]; c->x[1] = t;
+    t = c->y[0]; c->y[0] = c->y[1]; c->y[1] = t;
+    memset(c->x[1], 0xff, c->plane * sizeof(int));
+    memset(c->y[1], 0xff, c->plane * sizeof(int));
+    memset(c->z, 0xff, c->plane * sizeof(int));
+}
+
+static inline int *edge_cache_slot(EdgeCache *c, int e, int ix, int iy)
+{
+    const int *s = EDGE_SLOT[e];
+    size_t i = (size_t)(ix + s[2]) + (size_t)(iy + s[3]) * (size_t)c->sx;
+    if (s[0] == 0) return &c->x[s[1]][i];
+    if (s[0] == 1) return &c->y[s[1]][i];
+    return &c->z[i];
+}
+
 /* =========================================================================
  * Linear interpolation of vertex along edge
  * ========================================================================= */
@@ -379,16 +443,12 @@ static void sdf_gradient(const DC_VoxelGrid *grid, int ix, int iy, int iz,
     int zm = (iz > 0)      ? iz - 1 : 0;
     int zp = (iz < sz - 1) ? iz + 1 : sz - 1;
 
-    const DC_Voxel *vxm = dc_voxel_grid_get_const(grid, xm, iy, iz);
-    const DC_Voxel *vxp = dc_voxel_grid_get_const(grid, xp, iy, iz);
-    const DC_Voxel *vym = dc_voxel_grid_get_const(grid, ix, ym, iz);
-    const DC_Voxel *vyp = dc_voxel_grid_get_const(grid, ix, yp, iz);
-    const DC_Voxel *vzm = dc_voxel_grid_get_const(grid, ix, iy, zm);
-    const DC_Voxel *vzp = dc_voxel_grid_get_const(grid, ix, iy, zp);
-
-    *nx = (vxp ? vxp->distance : 0.0f) - (vxm ? vxm->distance : 0.0f);
-    *ny = (vyp ? vyp->distance : 0.0f) - (vym ? vym->distance : 0.0f);
-    *nz = (vzp ? vzp->distance : 0.0f) - (vzm ? vzm->distance : 0.0f);
+    *nx = dc_voxel_grid_distance(grid, xp, iy, iz) -
+          dc_voxel_grid_distance(grid, xm, iy, iz);
+    *ny = dc_voxel_grid_distance(grid, ix, yp, iz) -
+          dc_voxel_grid_distance(grid, ix, ym, iz);
+    *nz = dc_voxel_grid_distance(grid, ix, iy, zp) -
+          dc_voxel_grid_distance(grid, ix, iy, zm);
 
     float len = sqrtf((*nx)*(*nx) + (*ny)*(*ny) + (*nz)*(*nz));
     if (len > 1e-10f) {
@@ -396,133 +456,506 @@ static void sdf_gradient(const DC_VoxelGrid *grid, int ix, int iy, int iz,
     }
 }
 
+/* =========================================================================
+ * Interpolate the vertex on cube edge e and add it to the mesh. Positions
+ * are those of layer iz + z_base, so a slab of a taller grid yields the
+ * same vertices as the full grid would.
+ * ========================================================================= */
+static int mc_edge_vertex(const DC_VoxelGrid *grid, float iso_level, float cs,
+                          int ix, int iy, int iz, int z_base, int e,
+                          const float val[8], ts_mesh *out)
+{
+    int v0 = EDGE_VERTS[e][0], v1 = EDGE_VERTS[e][1];
+
+    /* Corner positions (matching SDF cell_center coords) */
+    int org[3] = { ix, iy, iz + z_base };
+    float pos[2][3];
+    for (int a = 0; a < 3; a++) {
+        pos[0][a] = ((float)(org[a] + VERT_OFS[v0][a]) + 0.5f) * cs;
+        pos[1][a] = ((float)(org[a] + VERT_OFS[v1][a]) + 0.5f) * cs;
+    }
+    float p[3];
+    interp_vertex(iso_level, pos[0], val[v0], pos[1], val[v1], p);
+
+    /* Normal: interpolate SDF gradients at the two endpoints */
+    float n0[3], n1[3];
+    sdf_gradient(grid,
+                 ix + VERT_OFS[v0][0],
+                 iy + VERT_OFS[v0][1],
+                 iz + VERT_OFS[v0][2],
+                 &n0[0], &n0[1], &n0[2]);
+    sdf_gradient(grid,
+                 ix + VERT_OFS[v1][0],
+                 iy + VERT_OFS[v1][1],
+                 iz + VERT_OFS[v1][2],
+                 &n1[0], &n1[1], &n1[2]);
+
+    float denom = val[v1] - val[v0];
+    float t = (fabsf(denom) < 1e-10f) ? 0.5f
+              : (iso_level - val[v0]) / denom;
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+
+    float n[3];
+    for (int a = 0; a < 3; a++) n[a] = n0[a] + t * (n1[a] - n0[a]);
+    float len = sqrtf(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+    if (len > 1e-10f) {
+        n[0] /= len; n[1] /= len; n[2] /= len;
+    }
+
+    return ts_mesh_add_vertex(out, (double)p[0], (double)p[1], (double)p[2],
+                              (double)n[0], (double)n[1], (double)n[2]);
+}
+
+/* =========================================================================
+ * Polygonize one cube: voxel corners (ix..ix+1, iy..iy+1, iz..iz+1)
+ * ========================================================================= */
+static void mc_cube(const DC_VoxelGrid *grid, float iso_level, float cs,
+                    int ix, int iy, int iz, int z_base, EdgeCache *cache,
+                    ts_mesh *out)
+{
+    /* Get SDF values at 8 corners of this cell (always in bounds) */
+    float val[8];
+    for (int v = 0; v < 8; v++) {
+        val[v] = dc_voxel_grid_distance(grid, ix + VERT_OFS[v][0],
+                                        iy + VERT_OFS[v][1],
+                                        iz + VERT_OFS[v][2]);
+    }
+
+    /* Build case index from SDF sign at each corner */
+    int cube_index = 0;
+    for (int v = 0; v < 8; v++) {
+        if (val[v] < iso_level) cube_index |= (1 << v);
+    }
+
+    /* Skip if entirely inside or outside */
+    int edges = MC_EDGE_TABLE[cube_index];
+    if (edges == 0) return;
+
+    /* Mesh vertex on each intersected edge, interpolated once per grid
+     * edge and shared with the neighbouring cubes through the cache */
+    int edge_vert[12];
+    for (int e = 0; e < 12; e++) {
+        if (!(edges & (1 << e))) continue;
+        int *slot = edge_cache_slot(cache, e, ix, iy);
+        if (*slot < 0) *slot = mc_edge_vertex(grid, iso_level, cs, ix, iy, iz,
+                                              z_base, e, val, out);
+        edge_vert[e] = *slot;
+    }
+
+    /* Emit triangles from the triangle table */
+    const int *tri = MC_TRI_TABLE[cube_index];
+    for (int t = 0; tri[t] != -1; t += 3)
+        ts_mesh_add_triangle(out, edge_vert[tri[t]], edge_vert[tri[t+1]],
+                             edge_vert[tri[t+2]]);
+}
+
+/* =========================================================================
+ * Z-slabs
+ *
+ * The grid is cut into slabs one tile layer (DC_VOXEL_BRICK cube slices)
+ * thick, each polygonized into its own mesh with its own edge cache on
+ * the shared worker pool. Adjacent slabs both interpolate the x/y edges
+ * on the sample layer between them, so each slab records the vertices it
+ * made on its bottom and top layers as (edge key, local index) pairs,
+ * key = 2 * (ix + iy * sx) + axis. The merge drops a slab's bottom copies
+ * in favour of the previous slab's top ones, which gives exactly the
+ * serial walk's vertices and triangles in the serial order.
+ * ========================================================================= */
+typedef struct {
+    ts_mesh  mesh;
+    int     *bottom, n_bottom;   /* seam pairs on the first sample layer */
+    int     *top, n_top;         /* seam pairs on the last sample layer */
+    int      failed;             /* allocation failure */
+    int      stopped;            /* saw the cancel flag part-way */
+} McSlab;
+
+typedef struct {
+    const DC_VoxelGrid *grid;
+    float               iso_level;
+    float               cs;
+    int                 sx, sy, sz;
+    int                 z_base;        /* grid layer 0 is this layer */
+    int                 sparse;
+    McSlab             *slabs;
+    int                 n_slabs;
+    volatile int       *cancel;
+    gint                slabs_done;    /* atomic: completed slabs */
+    volatile int       *progress_done; /* optional mirror of slabs_done */
+} McCtx;
+
+/* Record the cached x/y edge vertices of one layer as seam pairs. */
+static int collect_seam(const EdgeCache *c, int layer, int **pairs, int *n)
+{
+    int count = 0;
+    for (size_t i = 0; i < c->plane; i++)
+        count += (c->x[layer][i] >= 0) + (c->y[layer][i] >= 0);
+    *n = 0;
+    *pairs = NULL;
+    if (count == 0) return 0;
+    int *p = malloc((size_t)count * 2 * sizeof(int));
+    if (!p) return -1;
+    for (size_t i = 0; i < c->plane; i++) {
+        if (c->x[layer][i] >= 0) {
+            p[*n * 2] = (int)(i * 2);
+            p[*n * 2 + 1] = c->x[layer][i];
+            (*n)++;
+        }
+        if (c->y[layer][i] >= 0) {
+            p[*n * 2] = (int)(i * 2 + 1);
+            p[*n * 2 + 1] = c->y[layer][i];
+            (*n)++;
+        }
+    }
+    *pairs = p;
+    return 0;
+}
+
+/* Sparse grids: a tile whose cubes only read constant tiles on one side
+ * of iso_level holds no surface. Cubes starting in a tile reach one cell
+ * into the next, so its +x/+y/+z neighbours count too. */
+static int tile_has_surface(const DC_VoxelGrid *grid, float iso_level,
+                            int tx, int ty, int tz, int ntx, int nty, int ntz)
+{
+    int below = 0, above = 0;
+    for (int dz = 0; dz < 2; dz++)
+    for (int dy = 0; dy < 2; dy++)
+    for (int dx = 0; dx < 2; dx++) {
+        int nx = tx + dx < ntx ? tx + dx : ntx - 1;
+        int ny = ty + dy < nty ? ty + dy : nty - 1;
+        int nz = tz + dz < ntz ? tz + dz : ntz - 1;
+        DC_Voxel v;
+        if (!dc_voxel_grid_tile_constant(grid, nx, ny, nz, &v)) return 1;
+        if (v.distance < iso_level) below = 1;
+        else above = 1;
+    }
+    return below && above;
+}
+
+/* Polygonize slab s: cube slices [s * DC_VOXEL_BRICK, ...) of tile
+ * layer s. Sparse grids skip tiles without surface. */
+static void mc_slab(const McCtx *c, McSlab *slab, int s)
+{
+    int ntx = 1, nty = 1, ntz = 1;
+    unsigned char *active = NULL;
+    int any = 1;
+    if (c->sparse) {
+        dc_voxel_grid_tile_dims(c->grid, &ntx, &nty, &ntz);
+        active = malloc((size_t)ntx * (size_t)nty);
+        if (!active) { slab->failed = 1; return; }
+        any = 0;
+        for (int ty = 0; ty < nty; ty++)
+        for (int tx = 0; tx < ntx; tx++) {
+            active[tx + ty * ntx] = (unsigned char)tile_has_surface(
+                c->grid, c->iso_level, tx, ty, s, ntx, nty, ntz);
+            any |= active[tx + ty * ntx];
+        }
+    }
+
+    int z0 = s * DC_VOXEL_BRICK;
+    int z1 = z0 + DC_VOXEL_BRICK < c->sz - 1 ? z0 + DC_VOXEL_BRICK : c->sz - 1;
+    if (!any) { free(active); return; }
+
+    EdgeCache cache;
+    if (edge_cache_init(&cache, c->sx, c->sy) != 0) {
+        free(active);
+        slab->failed = 1;
+        return;
+    }
+
+    for (int iz = z0; iz < z1; iz++) {
+        if (c->cancel && g_atomic_int_get(c->cancel)) {
+            slab->stopped = 1;
+            break;
+        }
+        if (!c->sparse) {
+            for (int iy = 0; iy < c->sy - 1; iy++)
+            for (int ix = 0; ix < c->sx - 1; ix++)
+                mc_cube(c->grid, c->iso_level, c->cs, ix, iy, iz, c->z_base,
+                        &cache, &slab->mesh);
+        } else {
+            for (int ty = 0; ty < nty; ty++)
+            for (int tx = 0; tx < ntx; tx++) {
+                if (!active[tx + ty * ntx]) continue;
+                int x0 = tx * DC_VOXEL_BRICK, y0 = ty * DC_VOXEL_BRICK;
+                int x1 = x0 + DC_VOXEL_BRICK < c->sx - 1 ? x0 + DC_VOXEL_BRICK : c->sx - 1;
+                int y1 = y0 + DC_VOXEL_BRICK < c->sy - 1 ? y0 + DC_VOXEL_BRICK : c->sy - 1;
+                for (int iy = y0; iy < y1; iy++)
+                for (int ix = x0; ix < x1; ix++)
+                    mc_cube(c->grid, c->iso_level, c->cs, ix, iy, iz,
+                            c->z_base, &cache, &slab->mesh);
+            }
+        }
+
+        /* The first slice's lower layer is shared with the slab below,
+         * the last slice's upper layer with the slab above */
+        if (iz == z0 && z0 > 0 &&
+            collect_seam(&cache, 0, &slab->bottom, &slab->n_bottom) != 0)
+            slab->failed = 1;
+        if (iz == z1 - 1 && z1 < c->sz - 1 &&
+            collect_seam(&cache, 1, &slab->top, &slab->n_top) != 0)
+            slab->failed = 1;
+        edge_cache_next_slice(&cache);
+    }
+
+    free(cache.mem);
+    free(active);
+}
+
+static void mc_slab_item(void *data, int s)
+{
+    McCtx *c = data;
+    mc_slab(c, &c->slabs[s], s);
+
+    int done = g_atomic_int_add(&c->slabs_done, 1) + 1;
+    if (c->progress_done) g_atomic_int_set(c->progress_done, done);
+}
+
+/* Append the slabs to out in z order, welding each slab's bottom seam
+ * to the previous slab's top seam. */
+static int mc_merge(McSlab *slabs, int n_slabs, int sx, int sy, ts_mesh *out)
+{
+    size_t plane = (size_t)sx * (size_t)sy;
+    int nv = 0, nt = 0, max_nv = 0;
+    for (int s = 0; s < n_slabs; s++) {
+        nv += slabs[s].mesh.vert_count;
+        nt += slabs[s].mesh.tri_count;
+        if (slabs[s].mesh.vert_count > max_nv) max_nv = slabs[s].mesh.vert_count;
+    }
+    if (nt == 0) return 0;
+
+    int *seam = malloc(plane * 2 * sizeof(int));
+    int *remap = malloc((size_t)(max_nv ? max_nv : 1) * sizeof(int));
+    if (!seam || !remap ||
+        ts_mesh_reserve(out, out->vert_count + nv, out->tri_count + nt) != 0) {
+        free(seam);
+        free(remap);
+        return -1;
+    }
+    memset(seam, 0xff, plane * 2 * sizeof(int));
+
+    for (int s = 0; s < n_slabs; s++) {
+        McSlab *sl = &slabs[s];
+        memset(remap, 0xff, (size_t)sl->mesh.vert_count * sizeof(int));
+        for (int i = 0; i < sl->n_bottom; i++)
+            remap[sl->bottom[i * 2 + 1]] = seam[sl->bottom[i * 2]];
+        if (s > 0) {
+            const McSlab *prev = &slabs[s - 1];
+            for (int i = 0; i < prev->n_top; i++) seam[prev->top[i * 2]] = -1;
+        }
+
+        for (int v = 0; v < sl->mesh.vert_count; v++) {
+            if (remap[v] >= 0) continue;
+            remap[v] = out->vert_count;
+            out->verts[out->vert_count++] = sl->mesh.verts[v];
+        }
+        for (int t = 0; t < sl->mesh.tri_count; t++) {
+            const int *idx = sl->mesh.tris[t].idx;
+            ts_mesh_add_triangle(out, remap[idx[0]], remap[idx[1]],
+                                 remap[idx[2]]);
+        }
+        for (int i = 0; i < sl->n_top; i++)
+            seam[sl->top[i * 2]] = remap[sl->top[i * 2 + 1]];
+    }
+
+    free(seam);
+    free(remap);
+    return 0;
+}
+
 /* =========================================================================
  * Main marching cubes implementation
  * ========================================================================= */
-int dc_marching_cubes(const DC_VoxelGrid *grid, float iso_level, void *out_ptr)
+
+/* Extract grid into out as layers z_base.. of a taller grid. Progress
+ * goes to opts only when report is set. */
+static int mc_extract(const DC_VoxelGrid *grid, float iso_level,
+                      const DC_MarchingCubesOpts *opts, int report,
+                      int z_base, ts_mesh *out)
+{
+    /* Note: SDF functions use dc_voxel_grid_cell_center() which computes
+     * positions as (ix+0.5)*cs WITHOUT origin offset. MC vertex positions
+     * must match this coordinate system for correct isosurface placement. */
+    McCtx ctx = {0};
+    ctx.grid = grid;
+    ctx.iso_level = iso_level;
+    ctx.cs = dc_voxel_grid_cell_size(grid);
+    ctx.sx = dc_voxel_grid_size_x(grid);
+    ctx.sy = dc_voxel_grid_size_y(grid);
+    ctx.sz = dc_voxel_grid_size_z(grid);
+    ctx.z_base = z_base;
+    ctx.sparse = dc_voxel_grid_is_sparse(grid);
+    ctx.n_slabs = ctx.sz > 1 ? (ctx.sz - 2) / DC_VOXEL_BRICK + 1 : 0;
+    ctx.cancel = opts ? opts->cancel : NULL;
+    if (report && opts) {
+        ctx.progress_done = opts->progress_done;
+        if (opts->progress_done) *opts->progress_done = 0;
+        if (opts->progress_total) *opts->progress_total = ctx.n_slabs;
+    }
+    if (ctx.n_slabs == 0) return 0;
+
+    ctx.slabs = calloc((size_t)ctx.n_slabs, sizeof(McSlab));
+    if (!ctx.slabs) return -1;
+    for (int s = 0; s < ctx.n_slabs; s++) ctx.slabs[s].mesh = ts_mesh_init();
+
+    int stopped = dc_voxel_pool_run(mc_slab_item, &ctx, ctx.n_slabs,
+                                    opts ? opts->threads : 0, ctx.cancel);
+    int failed = 0;
+    for (int s = 0; s < ctx.n_slabs; s++) {
+        stopped |= ctx.slabs[s].stopped;
+        failed |= ctx.slabs[s].failed;
+    }
+
+    int rc = stopped ? 1 : failed ? -1
+           : mc_merge(ctx.slabs, ctx.n_slabs, ctx.sx, ctx.sy, out);
+
+    for (int s = 0; s < ctx.n_slabs; s++) {
+        ts_mesh_free(&ctx.slabs[s].mesh);
+        free(ctx.slabs[s].bottom);
+        free(ctx.slabs[s].top);
+    }
+    free(ctx.slabs);
+    return rc;
+}
+
+int dc_marching_cubes_ex(const DC_VoxelGrid *grid, float iso_level,
+                         const DC_MarchingCubesOpts *opts, void *out_ptr)
 {
     if (!grid || !out_ptr) return -1;
 
     /* Cast out_ptr to ts_mesh* — we use void* in the header to avoid
      * requiring ts_mesh.h in the public header. */
-    ts_mesh *out = (ts_mesh *)out_ptr;
+    return mc_extract(grid, iso_level, opts, 1, 0, (ts_mesh *)out_ptr);
+}
 
-    int sx = dc_voxel_grid_size_x(grid);
-    int sy = dc_voxel_grid_size_y(grid);
-    int sz = dc_voxel_grid_size_z(grid);
-    float cs = dc_voxel_grid_cell_size(grid);
+int dc_marching_cubes(const DC_VoxelGrid *grid, float iso_level, void *out_ptr)
+{
+    return dc_marching_cubes_ex(grid, iso_level, NULL, out_ptr);
+}
 
-    /* Note: SDF functions use dc_voxel_grid_cell_center() which computes
-     * positions as (ix+0.5)*cs WITHOUT origin offset. MC vertex positions
-     * must match this coordinate system for correct isosurface placement. */
+/* =========================================================================
+ * Streaming extraction to binary STL
+ *
+ * One dense slab grid of MC_STREAM_BYTES or so (at least DC_VOXEL_BRICK
+ * cube slices) is filled, polygonized on the pool and its triangles
+ * written out before the next slab is filled. Slabs overlap by one
+ * sample layer; the fill callback evaluates it again, bit-identically,
+ * and MC places vertices by global layer, so the seams match exactly.
+ * ========================================================================= */
+#define MC_STREAM_BYTES ((size_t)256 << 20)
 
-    /* Estimate output size: typically ~2 tris per surface cell */
-    int est_tris = sx * sy * 2;
-    ts_mesh_reserve(out, out->vert_count + est_tris * 3,
-                    out->tri_count + est_tris);
-
-    /* Walk all cells (each cell is a 2×2×2 cube of voxels) */
-    for (int iz = 0; iz < sz - 1; iz++) {
-        for (int iy = 0; iy < sy - 1; iy++) {
-            for (int ix = 0; ix < sx - 1; ix++) {
-
-                /* Get SDF values at 8 corners of this cell */
-                float val[8];
-                int valid = 1;
-                for (int v = 0; v < 8; v++) {
-                    int cx = ix + VERT_OFS[v][0];
-                    int cy = iy + VERT_OFS[v][1];
-                    int cz = iz + VERT_OFS[v][2];
-                    const DC_Voxel *vox = dc_voxel_grid_get_const(grid, cx, cy, cz);
-                    if (!vox) { valid = 0; break; }
-                    val[v] = vox->distance;
-                }
-                if (!valid) continue;
-
-                /* Build case index from SDF sign at each corner */
-                int cube_index = 0;
-                for (int v = 0; v < 8; v++) {
-                    if (val[v] < iso_level) cube_index |= (1 << v);
-                }
-
-                /* Skip if entirely inside or outside */
-                int edges = MC_EDGE_TABLE[cube_index];
-                if (edges == 0) continue;
-
-                /* Compute positions of 8 corners (matching SDF cell_center coords) */
-                float pos[8][3];
-                for (int v = 0; v < 8; v++) {
-                    pos[v][0] = ((float)(ix + VERT_OFS[v][0]) + 0.5f) * cs;
-                    pos[v][1] = ((float)(iy + VERT_OFS[v][1]) + 0.5f) * cs;
-                    pos[v][2] = ((float)(iz + VERT_OFS[v][2]) + 0.5f) * cs;
-                }
-
-                /* Interpolate vertices on intersected edges */
-                float edge_verts[12][3];
-                float edge_norms[12][3];
-                for (int e = 0; e < 12; e++) {
-                    if (!(edges & (1 << e))) continue;
-                    int v0 = EDGE_VERTS[e][0], v1 = EDGE_VERTS[e][1];
-                    interp_vertex(iso_level, pos[v0], val[v0],
-                                  pos[v1], val[v1], edge_verts[e]);
-
-                    /* Normal: interpolate SDF gradients at the two endpoints */
-                    float n0[3], n1[3];
-                    sdf_gradient(grid,
-                                 ix + VERT_OFS[v0][0],
-                                 iy + VERT_OFS[v0][1],
-                                 iz + VERT_OFS[v0][2],
-                                 &n0[0], &n0[1], &n0[2]);
-                    sdf_gradient(grid,
-                                 ix + VERT_OFS[v1][0],
-                                 iy + VERT_OFS[v1][1],
-                                 iz + VERT_OFS[v1][2],
-                                 &n1[0], &n1[1], &n1[2]);
-
-                    float denom = val[v1] - val[v0];
-                    float t = (fabsf(denom) < 1e-10f) ? 0.5f
-                              : (iso_level - val[v0]) / denom;
-                    if (t < 0.0f) t = 0.0f;
-                    if (t > 1.0f) t = 1.0f;
-
-                    edge_norms[e][0] = n0[0] + t * (n1[0] - n0[0]);
-                    edge_norms[e][1] = n0[1] + t * (n1[1] - n0[1]);
-                    edge_norms[e][2] = n0[2] + t * (n1[2] - n0[2]);
-
-                    float len = sqrtf(edge_norms[e][0]*edge_norms[e][0] +
-                                      edge_norms[e][1]*edge_norms[e][1] +
-                                      edge_norms[e][2]*edge_norms[e][2]);
-                    if (len > 1e-10f) {
-                        edge_norms[e][0] /= len;
-                        edge_norms[e][1] /= len;
-                        edge_norms[e][2] /= len;
-                    }
-                }
-
-                /* Emit triangles from the triangle table */
-                const int *tri = MC_TRI_TABLE[cube_index];
-                for (int t = 0; tri[t] != -1; t += 3) {
-                    int e0 = tri[t], e1 = tri[t+1], e2 = tri[t+2];
-                    int a = ts_mesh_add_vertex(out,
-                        (double)edge_verts[e0][0], (double)edge_verts[e0][1],
-                        (double)edge_verts[e0][2],
-                        (double)edge_norms[e0][0], (double)edge_norms[e0][1],
-                        (double)edge_norms[e0][2]);
-                    int b = ts_mesh_add_vertex(out,
-                        (double)edge_verts[e1][0], (double)edge_verts[e1][1],
-                        (double)edge_verts[e1][2],
-                        (double)edge_norms[e1][0], (double)edge_norms[e1][1],
-                        (double)edge_norms[e1][2]);
-                    int c = ts_mesh_add_vertex(out,
-                        (double)edge_verts[e2][0], (double)edge_verts[e2][1],
-                        (double)edge_verts[e2][2],
-                        (double)edge_norms[e2][0], (double)edge_norms[e2][1],
-                        (double)edge_norms[e2][2]);
-                    ts_mesh_add_triangle(out, a, b, c);
-                }
-            }
+/* Append m's triangles, moved by origin, in ts_mesh_write_stl's format */
+static int stl_write_tris(FILE *fp, const ts_mesh *m, const double origin[3])
+{
+    for (int i = 0; i < m->tri_count; i++) {
+        double p[3][3];
+        for (int k = 0; k < 3; k++)
+            for (int j = 0; j < 3; j++)
+                p[k][j] = origin[j] + m->verts[m->tris[i].idx[k]].pos[j];
+
+        double e1[3], e2[3], fn[3];
+        for (int j = 0; j < 3; j++) {
+            e1[j] = p[1][j] - p[0][j];
+            e2[j] = p[2][j] - p[0][j];
+        }
+        fn[0] = e1[1]*e2[2] - e1[2]*e2[1];
+        fn[1] = e1[2]*e2[0] - e1[0]*e2[2];
+        fn[2] = e1[0]*e2[1] - e1[1]*e2[0];
+        double len = sqrt(fn[0]*fn[0] + fn[1]*fn[1] + fn[2]*fn[2]);
+        if (len > 1e-15) { fn[0] /= len; fn[1] /= len; fn[2] /= len; }
+
+        float rec[12];
+        for (int j = 0; j < 3; j++) {
+            rec[j] = (float)fn[j];
+            rec[3 + j] = (float)p[0][j];
+            rec[6 + j] = (float)p[1][j];
+            rec[9 + j] = (float)p[2][j];
+        }
+        unsigned short attr = 0;
+        if (fwrite(rec, sizeof(float), 12, fp) != 12 ||
+            fwrite(&attr, sizeof(attr), 1, fp) != 1)
+            return -1;
+    }
+    return 0;
+}
+
+int dc_marching_cubes_stream_stl(const DC_McSource *src, float iso_level,
+                                 const DC_MarchingCubesOpts *opts,
+                                 const char *path, size_t *tri_count)
+{
+    if (tri_count) *tri_count = 0;
+    if (!src || !src->fill || !path || src->size[0] < 1 || src->size[1] < 1 ||
+        src->size[2] < 1 || !(src->cell_size > 0.0f))
+        return -1;
+
+    int sx = src->size[0], sy = src->size[1], sz = src->size[2];
+    size_t plane_bytes = (size_t)sx * (size_t)sy * sizeof(float);
+    int slices = src->slab_slices;
+    if (slices <= 0) {
+        slices = (int)(MC_STREAM_BYTES / plane_bytes) / DC_VOXEL_BRICK * DC_VOXEL_BRICK;
+        if (slices < DC_VOXEL_BRICK) slices = DC_VOXEL_BRICK;
+    }
+    if (slices > sz - 1) slices = sz > 1 ? sz - 1 : 1;
+    int n_slabs = sz > 1 ? (sz - 2) / slices + 1 : 0;
+
+    volatile int *done = opts ? opts->progress_done : NULL;
+    if (done) *done = 0;
+    if (opts && opts->progress_total) *opts->progress_total = n_slabs;
+
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return -1;
+    char header[80];
+    memset(header, 0, sizeof(header));
+    snprintf(header, sizeof(header), "Trinity Site STL");
+    unsigned int ntri = 0;
+    int rc = fwrite(header, 1, 80, fp) == 80 &&
+             fwrite(&ntri, sizeof(ntri), 1, fp) == 1 ? 0 : -1;
+
+    DC_VoxelGrid *slab = NULL;
+    if (rc == 0 && n_slabs > 0) {
+        slab = dc_voxel_grid_new_soa(sx, sy, slices + 1, src->cell_size);
+        if (!slab) rc = -1;
+    }
+
+    double origin[3] = { src->origin[0], src->origin[1], src->origin[2] };
+    size_t total = 0;
+    ts_mesh mesh = ts_mesh_init();
+    for (int s = 0; s < n_slabs && rc == 0; s++) {
+        int z0 = s * slices;
+        int layers = z0 + slices + 1 <= sz ? slices + 1 : sz - z0;
+        if (layers != dc_voxel_grid_size_z(slab)) {
+            /* Last slab is shorter */
+            dc_voxel_grid_free(slab);
+            slab = dc_voxel_grid_new_soa(sx, sy, layers, src->cell_size);
+            if (!slab) { rc = -1; break; }
+        } else {
+            dc_voxel_grid_clear(slab);
         }
+
+        if (src->fill(src->ctx, slab, z0) != 0) { rc = -1; break; }
+        if (opts && opts->cancel && g_atomic_int_get(opts->cancel)) { rc = 1; break; }
+
+        mesh.vert_count = mesh.tri_count = 0;
+        rc = mc_extract(slab, iso_level, opts, 0, z0, &mesh);
+        if (rc == 0 && stl_write_tris(fp, &mesh, origin) != 0) rc = -1;
+        total += (size_t)mesh.tri_count;
+        if (done) g_atomic_int_set(done, s + 1);
     }
+    ts_mesh_free(&mesh);
+    dc_voxel_grid_free(slab);
 
+    if (rc == 0 && total > 0xffffffffu) rc = -1;
+    if (rc == 0) {
+        ntri = (unsigned int)total;
+        if (fseek(fp, 80, SEEK_SET) != 0 ||
+            fwrite(&ntri, sizeof(ntri), 1, fp) != 1)
+            rc = -1;
+    }
+    if (fclose(fp) != 0 && rc == 0) rc = -1;
+    if (rc != 0) {
+        remove(path);
+        return rc;
+    }
+    if (tri_count) *tri_count = total;
     return 0;
 }
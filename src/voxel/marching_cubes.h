@@ -8,13 +8,17 @@
  * builds a case index from SDF signs, looks up edge/triangle tables,
  * interpolates vertex positions, computes normals from SDF gradient.
  *
- * Output is a ts_mesh (triangle mesh with normals).
+ * Output is an indexed ts_mesh (triangle mesh with normals). Each grid
+ * edge the surface crosses yields one vertex, shared by every triangle
+ * of the neighbouring cubes via a slice-to-slice edge cache.
  *
  * No GTK dependency — pure C, testable from CLI.
  */
 
 #include "voxel/voxel.h"
 
+#include <stddef.h>
+
 /* Forward declare ts_mesh to avoid pulling in the full header here.
  * Callers must include ts_mesh.h before calling dc_marching_cubes(). */
 struct ts_mesh_tag;  /* not used — ts_mesh is a typedef'd struct, not a tag */
@@ -25,14 +29,83 @@ struct ts_mesh_tag;  /* not used — ts_mesh is a typedef'd struct, not a tag */
  * The SDF is stored in each voxel's `distance` field.
  * Vertices are placed at the iso_level crossing via linear interpolation.
  * Normals are computed from SDF gradient (central differences).
+ * The grid is cut into Z-slabs one tile layer thick, polygonized on the
+ * shared worker pool (voxel_pool.h) and merged in z order with the seam
+ * vertices welded; the result is identical for any thread count.
+ * Sparse grids skip tiles whose cubes only read constant tiles on one
+ * side of iso_level.
  *
  * Parameters:
  *   grid      - SDF voxel grid (read-only)
  *   iso_level - distance value of the isosurface (typically 0.0)
  *   out       - output triangle mesh (must be initialized with ts_mesh_init)
  *
- * Returns 0 on success, -1 on error (NULL grid).
+ * Returns 0 on success, -1 on error (NULL grid, allocation failure).
  */
 int dc_marching_cubes(const DC_VoxelGrid *grid, float iso_level, void *out);
 
+/* Options for dc_marching_cubes_ex. Zero-initialized (or NULL) opts give
+ * the defaults.
+ *
+ * threads: threads on the shared pool. 0 = the whole pool, 1 = serial.
+ *
+ * cancel: optional flag polled between cube slices. Once nonzero the call
+ * stops early, returns 1 and leaves out untouched.
+ *
+ * progress_done / progress_total: optional. *progress_total receives the
+ * number of Z-slabs and *progress_done counts finished slabs while the
+ * extraction runs (safe to poll from another thread). Matches the layout
+ * of ts_progress so callers can point at its fields. */
+typedef struct {
+    int           threads;
+    volatile int *cancel;
+    volatile int *progress_done;
+    volatile int *progress_total;
+} DC_MarchingCubesOpts;
+
+/* dc_marching_cubes with options. Returns 0 on success, 1 if cancelled,
+ * -1 on error. */
+int dc_marching_cubes_ex(const DC_VoxelGrid *grid, float iso_level,
+                         const DC_MarchingCubesOpts *opts, void *out);
+
+/* =========================================================================
+ * Streaming extraction — for grids too large to hold in memory
+ * ========================================================================= */
+
+/* Fill slab with layers z0 .. z0 + size_z(slab) - 1 of the full grid.
+ * slab is a dense grid of the full grid's x/y size, cleared to +INF.
+ * Return 0, or -1 to abort the extraction. */
+typedef int (*DC_McSlabFn)(void *ctx, DC_VoxelGrid *slab, int z0);
+
+typedef struct {
+    int          size[3];     /* full grid, samples per axis */
+    float        cell_size;
+    float        origin[3];   /* added to every vertex written */
+    int          slab_slices; /* cube slices per slab, 0 = auto */
+    DC_McSlabFn  fill;
+    void        *ctx;
+} DC_McSource;
+
+/*
+ * Marching cubes over a grid produced a Z-slab at a time by src->fill,
+ * writing the triangles straight to a binary STL file at path. Only one
+ * slab (by default about 256 MiB of samples, at least DC_VOXEL_BRICK
+ * cube slices) and its triangles are in memory at once. Slabs share their boundary
+ * sample layer; provided fill gives it the same values both times (as
+ * dc_sdf_program_eval_slab does), the triangles are exactly those of
+ * dc_marching_cubes() on the full grid, moved by src->origin, so the
+ * mesh is as watertight as the in-memory one.
+ *
+ * opts: threads and cancel as for dc_marching_cubes_ex; the progress
+ * counters count slabs written.
+ *
+ * Returns 0 on success (*tri_count, if given, receives the number of
+ * triangles), 1 if cancelled, -1 on error (fill failure, allocation, I/O,
+ * more than 2^32 - 1 triangles). The file is removed unless 0 is
+ * returned.
+ */
+int dc_marching_cubes_stream_stl(const DC_McSource *src, float iso_level,
+                                 const DC_MarchingCubesOpts *opts,
+                                 const char *path, size_t *tri_count);
+
 #endif /* DC_MARCHING_CUBES_H */
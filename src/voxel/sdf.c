@@ -4,6 +4,7 @@
  */
 
 #include "voxel/sdf.h"
+#include "voxel/sdf_kernels.h"
 
 #include <math.h>
 
@@ -224,204 +225,266 @@ dc_sdf_transform_inv_point(const DC_SdfTransform *t,
 }
 
 /* =========================================================================
- * SDF primitives
+ * Primitive evaluation
+ *
+ * Primitives are evaluated a tile row at a time by the row kernels in
+ * sdf_kernels.c. All of them are exact or 1-Lipschitz.
  * ========================================================================= */
-void
-dc_sdf_sphere(DC_VoxelGrid *grid,
-                float cx, float cy, float cz, float radius)
-{
-    if (!grid || radius <= 0) return;
-    int sx = dc_voxel_grid_size_x(grid);
-    int sy = dc_voxel_grid_size_y(grid);
-    int sz = dc_voxel_grid_size_z(grid);
-
-    for (int iz = 0; iz < sz; iz++)
-    for (int iy = 0; iy < sy; iy++)
-    for (int ix = 0; ix < sx; ix++) {
-        float wx, wy, wz;
-        dc_voxel_grid_cell_center(grid, ix, iy, iz, &wx, &wy, &wz);
-        float dx = wx - cx, dy = wy - cy, dz = wz - cz;
-        float dist = sqrtf(dx*dx + dy*dy + dz*dz) - radius;
 
-        DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
-        if (v) v->distance = minf(v->distance, dist);
+/* Upper bound on how fast a transformed primitive's distance can change
+ * per world unit: scale * ||inv||, with the spectral norm bounded by the
+ * largest absolute row sum of inv^T inv. Exact for rotation + uniform
+ * scale. */
+static float
+transform_lipschitz(const DC_SdfTransform *t)
+{
+    if (!t) return 1.0f;
+    float ata[3][3];
+    for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) {
+        ata[i][j] = 0.0f;
+        for (int k = 0; k < 3; k++)
+            ata[i][j] += M(t->inv,k,i) * M(t->inv,k,j);
     }
+    float rowmax = 0.0f;
+    for (int i = 0; i < 3; i++)
+        rowmax = maxf(rowmax, absf(ata[i][0]) + absf(ata[i][1]) + absf(ata[i][2]));
+    return t->scale * sqrtf(rowmax);
 }
 
+/* Local-space start and per-cell step of the grid row starting at cell
+ * (ix,iy,iz): the inverse transform is applied once, then each cell along
+ * X adds the transformed X axis scaled by the cell size. */
 void
-dc_sdf_box(DC_VoxelGrid *grid,
-              float x0, float y0, float z0,
-              float x1, float y1, float z1)
+dc_sdf_row_setup(const DC_VoxelGrid *grid, const DC_SdfTransform *t,
+                 int ix, int iy, int iz, float p0[3], float d[3])
 {
-    if (!grid) return;
-    if (x0 > x1) { float t = x0; x0 = x1; x1 = t; }
-    if (y0 > y1) { float t = y0; y0 = y1; y1 = t; }
-    if (z0 > z1) { float t = z0; z0 = z1; z1 = t; }
-
-    int sx = dc_voxel_grid_size_x(grid);
-    int sy = dc_voxel_grid_size_y(grid);
-    int sz = dc_voxel_grid_size_z(grid);
-
-    for (int iz = 0; iz < sz; iz++)
-    for (int iy = 0; iy < sy; iy++)
-    for (int ix = 0; ix < sx; ix++) {
-        float wx, wy, wz;
-        dc_voxel_grid_cell_center(grid, ix, iy, iz, &wx, &wy, &wz);
-
-        float dx = maxf(x0 - wx, wx - x1);
-        float dy = maxf(y0 - wy, wy - y1);
-        float dz = maxf(z0 - wz, wz - z1);
-        float outside = sqrtf(maxf(dx,0)*maxf(dx,0) +
-                                maxf(dy,0)*maxf(dy,0) +
-                                maxf(dz,0)*maxf(dz,0));
-        float inside = minf(maxf(dx, maxf(dy, dz)), 0.0f);
-        float dist = outside + inside;
-
-        DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
-        if (v) v->distance = minf(v->distance, dist);
+    float cs = dc_voxel_grid_cell_size(grid);
+    float wx, wy, wz;
+    dc_voxel_grid_cell_center(grid, ix, iy, iz, &wx, &wy, &wz);
+    dc_sdf_transform_inv_point(t, wx, wy, wz, &p0[0], &p0[1], &p0[2]);
+    if (t) {
+        d[0] = M(t->inv,0,0) * cs;
+        d[1] = M(t->inv,1,0) * cs;
+        d[2] = M(t->inv,2,0) * cs;
+    } else {
+        d[0] = cs; d[1] = 0.0f; d[2] = 0.0f;
     }
 }
 
+/* Local box of each primitive, mapped corner by corner through t */
 void
-dc_sdf_cylinder(DC_VoxelGrid *grid,
-                  float cx, float cy, float radius,
-                  float z0, float z1)
+dc_sdf_prim_bounds(DC_SdfPrim prim, const float *prm,
+                   const DC_SdfTransform *t, float lo[3], float hi[3])
 {
-    if (!grid || radius <= 0) return;
-    if (z0 > z1) { float t = z0; z0 = z1; z1 = t; }
-
-    int sx = dc_voxel_grid_size_x(grid);
-    int sy = dc_voxel_grid_size_y(grid);
-    int sz = dc_voxel_grid_size_z(grid);
-
-    for (int iz = 0; iz < sz; iz++)
-    for (int iy = 0; iy < sy; iy++)
-    for (int ix = 0; ix < sx; ix++) {
-        float wx, wy, wz;
-        dc_voxel_grid_cell_center(grid, ix, iy, iz, &wx, &wy, &wz);
-
-        /* Radial distance in XY */
-        float dx = wx - cx, dy = wy - cy;
-        float d_radial = sqrtf(dx*dx + dy*dy) - radius;
-
-        /* Axial distance along Z */
-        float d_axial = maxf(z0 - wz, wz - z1);
+    float blo[3], bhi[3];
+    switch (prim) {
+    case DC_SDF_PRIM_SPHERE:
+        for (int a = 0; a < 3; a++) {
+            blo[a] = prm[a] - prm[3];
+            bhi[a] = prm[a] + prm[3];
+        }
+        break;
+    case DC_SDF_PRIM_BOX:
+        for (int a = 0; a < 3; a++) {
+            blo[a] = prm[a];
+            bhi[a] = prm[3 + a];
+        }
+        break;
+    case DC_SDF_PRIM_CYLINDER:
+        blo[0] = prm[0] - prm[2]; bhi[0] = prm[0] + prm[2];
+        blo[1] = prm[1] - prm[2]; bhi[1] = prm[1] + prm[2];
+        blo[2] = prm[3];          bhi[2] = prm[4];
+        break;
+    default: {  /* torus */
+        float reach = prm[3] + prm[4];
+        blo[0] = prm[0] - reach; bhi[0] = prm[0] + reach;
+        blo[1] = prm[1] - reach; bhi[1] = prm[1] + reach;
+        blo[2] = prm[2] - prm[4]; bhi[2] = prm[2] + prm[4];
+        break;
+    }
+    }
 
-        /* SDF: intersection of infinite cylinder and Z slab */
-        float dist = maxf(d_radial, d_axial);
+    for (int a = 0; a < 3; a++) {
+        lo[a] = HUGE_VALF;
+        hi[a] = -HUGE_VALF;
+    }
+    for (int c = 0; c < 8; c++) {
+        float p[3] = { (c & 1) ? bhi[0] : blo[0],
+                       (c & 2) ? bhi[1] : blo[1],
+                       (c & 4) ? bhi[2] : blo[2] };
+        for (int a = 0; a < 3; a++) {
+            float w = t ? M(t->mat,a,0)*p[0] + M(t->mat,a,1)*p[1] +
+                          M(t->mat,a,2)*p[2] + M(t->mat,a,3)
+                        : p[a];
+            lo[a] = minf(lo[a], w);
+            hi[a] = maxf(hi[a], w);
+        }
+    }
+}
 
-        DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
-        if (v) v->distance = minf(v->distance, dist);
+/* Cells [lo, hi) per axis whose centres lie within band of the world box
+ * wlo..whi, with half a cell to spare for rounding. Returns 0 if there
+ * are none. */
+static int
+prim_region(const DC_VoxelGrid *grid, const float wlo[3], const float whi[3],
+            float band, int lo[3], int hi[3])
+{
+    float cs = dc_voxel_grid_cell_size(grid);
+    int size[3] = { dc_voxel_grid_size_x(grid), dc_voxel_grid_size_y(grid),
+                    dc_voxel_grid_size_z(grid) };
+    for (int a = 0; a < 3; a++) {
+        /* Cell i is centred at (i + 0.5) * cs */
+        float l = (wlo[a] - band) / cs - 1.0f;
+        float h = (whi[a] + band) / cs;
+        if (!(h >= 0.0f) || !(l <= (float)(size[a] - 1))) return 0;
+        lo[a] = l <= 0.0f ? 0 : (int)ceilf(l);
+        hi[a] = h >= (float)(size[a] - 1) ? size[a] : (int)floorf(h) + 1;
+        if (lo[a] >= hi[a]) return 0;
     }
+    return 1;
 }
 
-void
-dc_sdf_torus(DC_VoxelGrid *grid,
-               float cx, float cy, float cz,
-               float major_r, float minor_r)
+/* MIN a primitive into the grid (CSG union with existing content).
+ *
+ * On a grid with a band (voxel.h) only cells within the band of the
+ * primitive's bounds (dc_sdf_prim_bounds) are visited: every other cell
+ * is farther than the band from the surface and outside it, so it may
+ * keep its value. Without a band every cell is visited.
+ *
+ * The cells are walked tile by tile (voxel.h). A constant tile of a
+ * sparse grid whose cells the primitive keeps beyond the band on one side
+ * stays constant, taking the bound closest to the surface. Other tiles
+ * are evaluated row by row; SoA rows are handed to the kernel in place,
+ * others go through a row buffer. */
+static void
+sdf_min_into(DC_VoxelGrid *grid, DC_SdfPrim prim, const float *prm,
+             const DC_SdfTransform *t)
 {
-    if (!grid || major_r <= 0 || minor_r <= 0) return;
+    DC_SdfRowFn row = dc_sdf_kernels()->row[prim];
+    float sc = t ? t->scale : 1.0f;
+    float cs = dc_voxel_grid_cell_size(grid);
+    float band = dc_voxel_grid_band(grid);
+    int sparse = dc_voxel_grid_is_sparse(grid);
+    float *plane = dc_voxel_grid_distances(grid);
 
-    int sx = dc_voxel_grid_size_x(grid);
-    int sy = dc_voxel_grid_size_y(grid);
-    int sz = dc_voxel_grid_size_z(grid);
+    /* Every cell centre of a tile lies within this of the tile centre */
+    float half_diag = 0.5f * (float)(DC_VOXEL_BRICK - 1) * cs * sqrtf(3.0f);
+    float reach = half_diag * transform_lipschitz(t);
 
-    for (int iz = 0; iz < sz; iz++)
-    for (int iy = 0; iy < sy; iy++)
-    for (int ix = 0; ix < sx; ix++) {
-        float wx, wy, wz;
-        dc_voxel_grid_cell_center(grid, ix, iy, iz, &wx, &wy, &wz);
+    int gsx = dc_voxel_grid_size_x(grid);
+    int gsy = dc_voxel_grid_size_y(grid);
+    int gsz = dc_voxel_grid_size_z(grid);
+
+    int lo[3] = { 0, 0, 0 }, hi[3] = { gsx, gsy, gsz };
+    if (band > 0.0f) {
+        float wlo[3], whi[3];
+        dc_sdf_prim_bounds(prim, prm, t, wlo, whi);
+        if (!prim_region(grid, wlo, whi, band, lo, hi)) return;
+    }
 
-        float dx = wx - cx, dy = wy - cy, dz = wz - cz;
-        float q = sqrtf(dx*dx + dy*dy) - major_r;
-        float dist = sqrtf(q*q + dz*dz) - minor_r;
+    for (int tz = lo[2] / DC_VOXEL_BRICK; tz <= (hi[2] - 1) / DC_VOXEL_BRICK; tz++)
+    for (int ty = lo[1] / DC_VOXEL_BRICK; ty <= (hi[1] - 1) / DC_VOXEL_BRICK; ty++)
+    for (int tx = lo[0] / DC_VOXEL_BRICK; tx <= (hi[0] - 1) / DC_VOXEL_BRICK; tx++) {
+        int x0 = tx * DC_VOXEL_BRICK, y0 = ty * DC_VOXEL_BRICK, z0 = tz * DC_VOXEL_BRICK;
+
+        DC_Voxel tv;
+        if (sparse && dc_voxel_grid_tile_constant(grid, tx, ty, tz, &tv)) {
+            float off = 0.5f * (float)(DC_VOXEL_BRICK - 1) + 0.5f;
+            float wx = ((float)x0 + off) * cs;
+            float wy = ((float)y0 + off) * cs;
+            float wz = ((float)z0 + off) * cs;
+            float p[3], still[3] = { 0.0f, 0.0f, 0.0f };
+            dc_sdf_transform_inv_point(t, wx, wy, wz, &p[0], &p[1], &p[2]);
+            float d = HUGE_VALF;
+            row(prm, p, still, sc, &d, 1);
+            if (d - reach > band || d + reach < -band) {
+                tv.distance = minf(tv.distance, d > 0.0f ? d - reach : d + reach);
+                dc_voxel_grid_tile_fill(grid, tx, ty, tz, tv);
+                continue;
+            }
+        }
 
-        DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
-        if (v) v->distance = minf(v->distance, dist);
+        /* Rows of the tile inside the region. Rows are not clipped: they
+         * start at the tile edge, like an unbounded pass, so every cell
+         * comes out bit-identical to one. */
+        int x1 = x0 + DC_VOXEL_BRICK < gsx ? x0 + DC_VOXEL_BRICK : gsx;
+        int y1 = y0 + DC_VOXEL_BRICK < hi[1] ? y0 + DC_VOXEL_BRICK : hi[1];
+        int z1 = z0 + DC_VOXEL_BRICK < hi[2] ? z0 + DC_VOXEL_BRICK : hi[2];
+        if (y0 < lo[1]) y0 = lo[1];
+        if (z0 < lo[2]) z0 = lo[2];
+        int n = x1 - x0;
+        for (int iz = z0; iz < z1; iz++)
+        for (int iy = y0; iy < y1; iy++) {
+            float p0[3], step[3];
+            dc_sdf_row_setup(grid, t, x0, iy, iz, p0, step);
+
+            if (plane) {
+                size_t base = (size_t)x0 + (size_t)iy * gsx + (size_t)iz * gsx * gsy;
+                row(prm, p0, step, sc, plane + base, n);
+                continue;
+            }
+
+            /* Tile rows are consecutive DC_Voxels (voxel.h) */
+            DC_Voxel *v = dc_voxel_grid_get(grid, x0, iy, iz);
+            if (!v) continue;
+            float buf[DC_VOXEL_BRICK];
+            for (int k = 0; k < n; k++) buf[k] = v[k].distance;
+            row(prm, p0, step, sc, buf, n);
+            for (int k = 0; k < n; k++) v[k].distance = buf[k];
+        }
     }
 }
 
 /* =========================================================================
- * SDF primitives with transforms
- *
- * These MIN the new distance into each cell, composing with existing
- * SDF content. This enables building complex shapes on a single grid.
+ * SDF primitives
  * ========================================================================= */
-
-/* Helper: evaluate sphere SDF at a local-space point */
-static inline float
-sdf_sphere_eval(float px, float py, float pz,
+void
+dc_sdf_sphere(DC_VoxelGrid *grid,
                 float cx, float cy, float cz, float radius)
 {
-    float dx = px - cx, dy = py - cy, dz = pz - cz;
-    return sqrtf(dx*dx + dy*dy + dz*dz) - radius;
+    dc_sdf_sphere_t(grid, cx, cy, cz, radius, NULL);
 }
 
-/* Helper: evaluate box SDF at a local-space point */
-static inline float
-sdf_box_eval(float px, float py, float pz,
-             float x0, float y0, float z0,
-             float x1, float y1, float z1)
+void
+dc_sdf_box(DC_VoxelGrid *grid,
+              float x0, float y0, float z0,
+              float x1, float y1, float z1)
 {
-    float dx = maxf(x0 - px, px - x1);
-    float dy = maxf(y0 - py, py - y1);
-    float dz = maxf(z0 - pz, pz - z1);
-    float outside = sqrtf(maxf(dx,0)*maxf(dx,0) +
-                           maxf(dy,0)*maxf(dy,0) +
-                           maxf(dz,0)*maxf(dz,0));
-    float inside = minf(maxf(dx, maxf(dy, dz)), 0.0f);
-    return outside + inside;
+    dc_sdf_box_t(grid, x0, y0, z0, x1, y1, z1, NULL);
 }
 
-/* Helper: evaluate cylinder SDF at a local-space point */
-static inline float
-sdf_cylinder_eval(float px, float py, float pz,
+void
+dc_sdf_cylinder(DC_VoxelGrid *grid,
                   float cx, float cy, float radius,
                   float z0, float z1)
 {
-    float dx = px - cx, dy = py - cy;
-    float d_radial = sqrtf(dx*dx + dy*dy) - radius;
-    float d_axial = maxf(z0 - pz, pz - z1);
-    return maxf(d_radial, d_axial);
+    dc_sdf_cylinder_t(grid, cx, cy, radius, z0, z1, NULL);
 }
 
-/* Helper: evaluate torus SDF at a local-space point */
-static inline float
-sdf_torus_eval(float px, float py, float pz,
+void
+dc_sdf_torus(DC_VoxelGrid *grid,
                float cx, float cy, float cz,
                float major_r, float minor_r)
 {
-    float dx = px - cx, dy = py - cy, dz = pz - cz;
-    float q = sqrtf(dx*dx + dy*dy) - major_r;
-    return sqrtf(q*q + dz*dz) - minor_r;
+    dc_sdf_torus_t(grid, cx, cy, cz, major_r, minor_r, NULL);
 }
 
+/* =========================================================================
+ * SDF primitives with transforms
+ *
+ * These MIN the new distance into each cell, composing with existing
+ * SDF content. This enables building complex shapes on a single grid.
+ * ========================================================================= */
+
 void
 dc_sdf_sphere_t(DC_VoxelGrid *grid,
                   float cx, float cy, float cz, float radius,
                   const DC_SdfTransform *t)
 {
     if (!grid || radius <= 0) return;
-    int gsx = dc_voxel_grid_size_x(grid);
-    int gsy = dc_voxel_grid_size_y(grid);
-    int gsz = dc_voxel_grid_size_z(grid);
-    float sc = t ? t->scale : 1.0f;
-
-    for (int iz = 0; iz < gsz; iz++)
-    for (int iy = 0; iy < gsy; iy++)
-    for (int ix = 0; ix < gsx; ix++) {
-        float wx, wy, wz;
-        dc_voxel_grid_cell_center(grid, ix, iy, iz, &wx, &wy, &wz);
-
-        float lx, ly, lz;
-        if (t) dc_sdf_transform_inv_point(t, wx, wy, wz, &lx, &ly, &lz);
-        else { lx = wx; ly = wy; lz = wz; }
-
-        float dist = sdf_sphere_eval(lx, ly, lz, cx, cy, cz, radius) * sc;
-
-        DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
-        if (v) v->distance = minf(v->distance, dist);
-    }
+    float prm[4] = { cx, cy, cz, radius };
+    sdf_min_into(grid, DC_SDF_PRIM_SPHERE, prm, t);
 }
 
 void
@@ -434,27 +497,8 @@ dc_sdf_box_t(DC_VoxelGrid *grid,
     if (x0 > x1) { float tmp = x0; x0 = x1; x1 = tmp; }
     if (y0 > y1) { float tmp = y0; y0 = y1; y1 = tmp; }
     if (z0 > z1) { float tmp = z0; z0 = z1; z1 = tmp; }
-
-    int gsx = dc_voxel_grid_size_x(grid);
-    int gsy = dc_voxel_grid_size_y(grid);
-    int gsz = dc_voxel_grid_size_z(grid);
-    float sc = t ? t->scale : 1.0f;
-
-    for (int iz = 0; iz < gsz; iz++)
-    for (int iy = 0; iy < gsy; iy++)
-    for (int ix = 0; ix < gsx; ix++) {
-        float wx, wy, wz;
-        dc_voxel_grid_cell_center(grid, ix, iy, iz, &wx, &wy, &wz);
-
-        float lx, ly, lz;
-        if (t) dc_sdf_transform_inv_point(t, wx, wy, wz, &lx, &ly, &lz);
-        else { lx = wx; ly = wy; lz = wz; }
-
-        float dist = sdf_box_eval(lx, ly, lz, x0, y0, z0, x1, y1, z1) * sc;
-
-        DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
-        if (v) v->distance = minf(v->distance, dist);
-    }
+    float prm[6] = { x0, y0, z0, x1, y1, z1 };
+    sdf_min_into(grid, DC_SDF_PRIM_BOX, prm, t);
 }
 
 void
@@ -465,27 +509,8 @@ dc_sdf_cylinder_t(DC_VoxelGrid *grid,
 {
     if (!grid || radius <= 0) return;
     if (z0 > z1) { float tmp = z0; z0 = z1; z1 = tmp; }
-
-    int gsx = dc_voxel_grid_size_x(grid);
-    int gsy = dc_voxel_grid_size_y(grid);
-    int gsz = dc_voxel_grid_size_z(grid);
-    float sc = t ? t->scale : 1.0f;
-
-    for (int iz = 0; iz < gsz; iz++)
-    for (int iy = 0; iy < gsy; iy++)
-    for (int ix = 0; ix < gsx; ix++) {
-        float wx, wy, wz;
-        dc_voxel_grid_cell_center(grid, ix, iy, iz, &wx, &wy, &wz);
-
-        float lx, ly, lz;
-        if (t) dc_sdf_transform_inv_point(t, wx, wy, wz, &lx, &ly, &lz);
-        else { lx = wx; ly = wy; lz = wz; }
-
-        float dist = sdf_cylinder_eval(lx, ly, lz, cx, cy, radius, z0, z1) * sc;
-
-        DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
-        if (v) v->distance = minf(v->distance, dist);
-    }
+    float prm[5] = { cx, cy, radius, z0, z1 };
+    sdf_min_into(grid, DC_SDF_PRIM_CYLINDER, prm, t);
 }
 
 void
@@ -495,27 +520,8 @@ dc_sdf_torus_t(DC_VoxelGrid *grid,
                  const DC_SdfTransform *t)
 {
     if (!grid || major_r <= 0 || minor_r <= 0) return;
-
-    int gsx = dc_voxel_grid_size_x(grid);
-    int gsy = dc_voxel_grid_size_y(grid);
-    int gsz = dc_voxel_grid_size_z(grid);
-    float sc = t ? t->scale : 1.0f;
-
-    for (int iz = 0; iz < gsz; iz++)
-    for (int iy = 0; iy < gsy; iy++)
-    for (int ix = 0; ix < gsx; ix++) {
-        float wx, wy, wz;
-        dc_voxel_grid_cell_center(grid, ix, iy, iz, &wx, &wy, &wz);
-
-        float lx, ly, lz;
-        if (t) dc_sdf_transform_inv_point(t, wx, wy, wz, &lx, &ly, &lz);
-        else { lx = wx; ly = wy; lz = wz; }
-
-        float dist = sdf_torus_eval(lx, ly, lz, cx, cy, cz, major_r, minor_r) * sc;
-
-        DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
-        if (v) v->distance = minf(v->distance, dist);
-    }
+    float prm[5] = { cx, cy, cz, major_r, minor_r };
+    sdf_min_into(grid, DC_SDF_PRIM_TORUS, prm, t);
 }
 
 /* =========================================================================
@@ -529,9 +535,28 @@ grids_match(const DC_VoxelGrid *a, const DC_VoxelGrid *b)
            dc_voxel_grid_size_z(a) == dc_voxel_grid_size_z(b);
 }
 
-int
-dc_sdf_union(const DC_VoxelGrid *a, const DC_VoxelGrid *b,
-               DC_VoxelGrid *out)
+static float csg_union_op(float a, float b)     { return minf(a, b); }
+static float csg_intersect_op(float a, float b) { return maxf(a, b); }
+static float csg_subtract_op(float a, float b)  { return maxf(a, -b); }
+
+/* SoA operands: one flat pass per operator over the distance planes,
+ * with the vector combiners from sdf_kernels.c. out may alias a or b. */
+static void
+csg_planes(const float *a, const float *b, float *out, size_t n,
+           float (*op)(float, float))
+{
+    const DC_SdfKernels *k = dc_sdf_kernels();
+    if (op == csg_union_op)          k->plane_union(a, b, out, n);
+    else if (op == csg_intersect_op) k->plane_intersect(a, b, out, n);
+    else                             k->plane_subtract(a, b, out, n);
+}
+
+/* out[i] = op(a[i], b[i]) by tile. Where a, b and out are all constant
+ * tiles the result is one value: min and max are monotone, so combining
+ * conservative tile values gives a conservative value. */
+static int
+csg_apply(const DC_VoxelGrid *a, const DC_VoxelGrid *b, DC_VoxelGrid *out,
+          float (*op)(float, float))
 {
     if (!a || !b || !out) return -1;
     if (!grids_match(a, b) || !grids_match(a, out)) return -1;
@@ -540,103 +565,325 @@ dc_sdf_union(const DC_VoxelGrid *a, const DC_VoxelGrid *b,
     int sy = dc_voxel_grid_size_y(a);
     int sz = dc_voxel_grid_size_z(a);
 
-    for (int iz = 0; iz < sz; iz++)
-    for (int iy = 0; iy < sy; iy++)
-    for (int ix = 0; ix < sx; ix++) {
-        const DC_Voxel *va = dc_voxel_grid_get_const(a, ix, iy, iz);
-        const DC_Voxel *vb = dc_voxel_grid_get_const(b, ix, iy, iz);
-        DC_Voxel *vo = dc_voxel_grid_get(out, ix, iy, iz);
-        if (!va || !vb || !vo) continue;
-        vo->distance = minf(va->distance, vb->distance);
+    const float *pa = dc_voxel_grid_distances_const(a);
+    const float *pb = dc_voxel_grid_distances_const(b);
+    float *po = dc_voxel_grid_distances(out);
+    if (pa && pb && po) {
+        csg_planes(pa, pb, po, (size_t)sx * (size_t)sy * (size_t)sz, op);
+        return 0;
+    }
+
+    int ntx, nty, ntz;
+    dc_voxel_grid_tile_dims(a, &ntx, &nty, &ntz);
+
+    for (int tz = 0; tz < ntz; tz++)
+    for (int ty = 0; ty < nty; ty++)
+    for (int tx = 0; tx < ntx; tx++) {
+        DC_Voxel ta, tb, to;
+        if (dc_voxel_grid_tile_constant(a, tx, ty, tz, &ta) &&
+            dc_voxel_grid_tile_constant(b, tx, ty, tz, &tb) &&
+            dc_voxel_grid_tile_constant(out, tx, ty, tz, &to)) {
+            to.distance = op(ta.distance, tb.distance);
+            dc_voxel_grid_tile_fill(out, tx, ty, tz, to);
+            continue;
+        }
+
+        int x0 = tx * DC_VOXEL_BRICK, y0 = ty * DC_VOXEL_BRICK, z0 = tz * DC_VOXEL_BRICK;
+        int x1 = x0 + DC_VOXEL_BRICK < sx ? x0 + DC_VOXEL_BRICK : sx;
+        int y1 = y0 + DC_VOXEL_BRICK < sy ? y0 + DC_VOXEL_BRICK : sy;
+        int z1 = z0 + DC_VOXEL_BRICK < sz ? z0 + DC_VOXEL_BRICK : sz;
+        for (int iz = z0; iz < z1; iz++)
+        for (int iy = y0; iy < y1; iy++)
+        for (int ix = x0; ix < x1; ix++) {
+            float d = op(dc_voxel_grid_distance(a, ix, iy, iz),
+                         dc_voxel_grid_distance(b, ix, iy, iz));
+            float *o = dc_voxel_grid_distance_ref(out, ix, iy, iz);
+            if (o) *o = d;
+        }
     }
     return 0;
 }
 
+int
+dc_sdf_union(const DC_VoxelGrid *a, const DC_VoxelGrid *b,
+               DC_VoxelGrid *out)
+{
+    return csg_apply(a, b, out, csg_union_op);
+}
+
 int
 dc_sdf_intersect(const DC_VoxelGrid *a, const DC_VoxelGrid *b,
                    DC_VoxelGrid *out)
 {
-    if (!a || !b || !out) return -1;
-    if (!grids_match(a, b) || !grids_match(a, out)) return -1;
-
-    int sx = dc_voxel_grid_size_x(a);
-    int sy = dc_voxel_grid_size_y(a);
-    int sz = dc_voxel_grid_size_z(a);
-
-    for (int iz = 0; iz < sz; iz++)
-    for (int iy = 0; iy < sy; iy++)
-    for (int ix = 0; ix < sx; ix++) {
-        const DC_Voxel *va = dc_voxel_grid_get_const(a, ix, iy, iz);
-        const DC_Voxel *vb = dc_voxel_grid_get_const(b, ix, iy, iz);
-        DC_Voxel *vo = dc_voxel_grid_get(out, ix, iy, iz);
-        if (!va || !vb || !vo) continue;
-        vo->distance = maxf(va->distance, vb->distance);
-    }
-    return 0;
+    return csg_apply(a, b, out, csg_intersect_op);
 }
 
 int
 dc_sdf_subtract(const DC_VoxelGrid *a, const DC_VoxelGrid *b,
                   DC_VoxelGrid *out)
 {
-    if (!a || !b || !out) return -1;
-    if (!grids_match(a, b) || !grids_match(a, out)) return -1;
+    return csg_apply(a, b, out, csg_subtract_op);
+}
 
-    int sx = dc_voxel_grid_size_x(a);
-    int sy = dc_voxel_grid_size_y(a);
-    int sz = dc_voxel_grid_size_z(a);
+/* =========================================================================
+ * Offset CSG
+ * ========================================================================= */
 
-    for (int iz = 0; iz < sz; iz++)
-    for (int iy = 0; iy < sy; iy++)
-    for (int ix = 0; ix < sx; ix++) {
-        const DC_Voxel *va = dc_voxel_grid_get_const(a, ix, iy, iz);
-        const DC_Voxel *vb = dc_voxel_grid_get_const(b, ix, iy, iz);
-        DC_Voxel *vo = dc_voxel_grid_get(out, ix, iy, iz);
-        if (!va || !vb || !vo) continue;
-        vo->distance = maxf(va->distance, -vb->distance);
+/* Distances of lattice cells [x, x+n) of row (y, z) from g placed at off;
+ * +INF where g does not reach. */
+static void
+load_row(const DC_VoxelGrid *g, const int off[3], int x, int y, int z,
+         int n, float *dst)
+{
+    int sx = dc_voxel_grid_size_x(g);
+    int gy = y - off[1], gz = z - off[2];
+    int k0 = off[0] - x, k1 = off[0] + sx - x;
+    if (k0 < 0) k0 = 0;
+    if (k1 > n) k1 = n;
+    if (gy < 0 || gy >= dc_voxel_grid_size_y(g) ||
+        gz < 0 || gz >= dc_voxel_grid_size_z(g) || k0 >= k1) {
+        for (int k = 0; k < n; k++) dst[k] = HUGE_VALF;
+        return;
     }
+    for (int k = 0; k < k0; k++) dst[k] = HUGE_VALF;
+    for (int k = k1; k < n; k++) dst[k] = HUGE_VALF;
+
+    int gx = x + k0 - off[0];
+    const float *plane = dc_voxel_grid_distances_const(g);
+    if (plane) {
+        size_t base = (size_t)gx + (size_t)gy * sx +
+                      (size_t)gz * sx * dc_voxel_grid_size_y(g);
+        memcpy(dst + k0, plane + base, (size_t)(k1 - k0) * sizeof(float));
+        return;
+    }
+    for (int k = k0; k < k1; k++)
+        dst[k] = dc_voxel_grid_distance(g, gx + k - k0, gy, gz);
+}
+
+/* Store n distances into row (gy, gz) of g from cell gx. A sparse grid
+ * keeps its value where old and new both lie beyond the band on the same
+ * side, so far tiles stay constant. */
+static void
+store_row(DC_VoxelGrid *g, int gx, int gy, int gz, int n, const float *src)
+{
+    int sx = dc_voxel_grid_size_x(g);
+    float *plane = dc_voxel_grid_distances(g);
+    if (plane) {
+        size_t base = (size_t)gx + (size_t)gy * sx +
+                      (size_t)gz * sx * dc_voxel_grid_size_y(g);
+        memcpy(plane + base, src, (size_t)n * sizeof(float));
+        return;
+    }
+    float band = dc_voxel_grid_is_sparse(g) ? dc_voxel_grid_band(g) : 0.0f;
+    for (int k = 0; k < n; k++) {
+        float v = src[k];
+        if (band > 0.0f) {
+            float cur = dc_voxel_grid_distance(g, gx + k, gy, gz);
+            if (absf(cur) >= band && absf(v) >= band && (cur < 0.0f) == (v < 0.0f))
+                continue;
+        }
+        float *d = dc_voxel_grid_distance_ref(g, gx + k, gy, gz);
+        if (d) *d = v;
+    }
+}
+
+/* out = op(a, b) over out's cells, all three placed on one lattice. When
+ * out is a at the same offset and op leaves a unchanged where b is +INF
+ * (union, subtract), only the cells b covers are visited. */
+static int
+csg_apply_at(const DC_VoxelGrid *a, const int a_off[3],
+             const DC_VoxelGrid *b, const int b_off[3],
+             DC_VoxelGrid *out, const int out_off[3],
+             float (*op)(float, float))
+{
+    if (!a || !b || !out || !a_off || !b_off || !out_off) return -1;
+    float cs = dc_voxel_grid_cell_size(out);
+    if (dc_voxel_grid_cell_size(a) != cs || dc_voxel_grid_cell_size(b) != cs)
+        return -1;
+    int same_a = memcmp(a_off, out_off, 3 * sizeof(int)) == 0;
+    int same_b = memcmp(b_off, out_off, 3 * sizeof(int)) == 0;
+    if ((out == a && !same_a) || (out == b && !same_b)) return -1;
+
+    /* Lattice box to visit */
+    int size[3] = { dc_voxel_grid_size_x(out), dc_voxel_grid_size_y(out),
+                    dc_voxel_grid_size_z(out) };
+    int bsize[3] = { dc_voxel_grid_size_x(b), dc_voxel_grid_size_y(b),
+                     dc_voxel_grid_size_z(b) };
+    int lo[3], hi[3];
+    int b_only = out == a && op != csg_intersect_op;
+    for (int i = 0; i < 3; i++) {
+        lo[i] = out_off[i];
+        hi[i] = out_off[i] + size[i];
+        if (b_only) {
+            if (lo[i] < b_off[i]) lo[i] = b_off[i];
+            if (hi[i] > b_off[i] + bsize[i]) hi[i] = b_off[i] + bsize[i];
+        }
+        if (lo[i] >= hi[i]) return 0;
+    }
+
+    int n = hi[0] - lo[0];
+    float *ra = malloc(2 * (size_t)n * sizeof(float));
+    if (!ra) return -1;
+    float *rb = ra + n;
+
+    for (int z = lo[2]; z < hi[2]; z++)
+    for (int y = lo[1]; y < hi[1]; y++) {
+        load_row(a, a_off, lo[0], y, z, n, ra);
+        load_row(b, b_off, lo[0], y, z, n, rb);
+        csg_planes(ra, rb, ra, (size_t)n, op);
+        store_row(out, lo[0] - out_off[0], y - out_off[1], z - out_off[2], n, ra);
+    }
+    free(ra);
     return 0;
 }
 
+int
+dc_sdf_union_at(const DC_VoxelGrid *a, const int a_off[3],
+                  const DC_VoxelGrid *b, const int b_off[3],
+                  DC_VoxelGrid *out, const int out_off[3])
+{
+    return csg_apply_at(a, a_off, b, b_off, out, out_off, csg_union_op);
+}
+
+int
+dc_sdf_intersect_at(const DC_VoxelGrid *a, const int a_off[3],
+                      const DC_VoxelGrid *b, const int b_off[3],
+                      DC_VoxelGrid *out, const int out_off[3])
+{
+    return csg_apply_at(a, a_off, b, b_off, out, out_off, csg_intersect_op);
+}
+
+int
+dc_sdf_subtract_at(const DC_VoxelGrid *a, const int a_off[3],
+                     const DC_VoxelGrid *b, const int b_off[3],
+                     DC_VoxelGrid *out, const int out_off[3])
+{
+    return csg_apply_at(a, a_off, b, b_off, out, out_off, csg_subtract_op);
+}
+
 /* =========================================================================
- * Activation
+ * Band clamp
  * ========================================================================= */
 void
-dc_sdf_activate(DC_VoxelGrid *grid)
+dc_sdf_clamp(DC_VoxelGrid *grid, float limit)
 {
-    if (!grid) return;
+    if (!grid || !(limit > 0.0f)) return;
     int sx = dc_voxel_grid_size_x(grid);
     int sy = dc_voxel_grid_size_y(grid);
     int sz = dc_voxel_grid_size_z(grid);
 
-    for (int iz = 0; iz < sz; iz++)
-    for (int iy = 0; iy < sy; iy++)
-    for (int ix = 0; ix < sx; ix++) {
-        DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
-        if (v) v->active = (v->distance <= 0.0f) ? 1 : 0;
+    float *dist = dc_voxel_grid_distances(grid);
+    if (dist) {
+        size_t n = (size_t)sx * (size_t)sy * (size_t)sz;
+        for (size_t i = 0; i < n; i++)
+            dist[i] = maxf(-limit, minf(dist[i], limit));
+        return;
+    }
+
+    int ntx, nty, ntz;
+    dc_voxel_grid_tile_dims(grid, &ntx, &nty, &ntz);
+
+    for (int tz = 0; tz < ntz; tz++)
+    for (int ty = 0; ty < nty; ty++)
+    for (int tx = 0; tx < ntx; tx++) {
+        DC_Voxel tv;
+        if (dc_voxel_grid_tile_constant(grid, tx, ty, tz, &tv)) {
+            tv.distance = maxf(-limit, minf(tv.distance, limit));
+            dc_voxel_grid_tile_fill(grid, tx, ty, tz, tv);
+            continue;
+        }
+
+        int x0 = tx * DC_VOXEL_BRICK, y0 = ty * DC_VOXEL_BRICK, z0 = tz * DC_VOXEL_BRICK;
+        int x1 = x0 + DC_VOXEL_BRICK < sx ? x0 + DC_VOXEL_BRICK : sx;
+        int y1 = y0 + DC_VOXEL_BRICK < sy ? y0 + DC_VOXEL_BRICK : sy;
+        int z1 = z0 + DC_VOXEL_BRICK < sz ? z0 + DC_VOXEL_BRICK : sz;
+        for (int iz = z0; iz < z1; iz++)
+        for (int iy = y0; iy < y1; iy++)
+        for (int ix = x0; ix < x1; ix++) {
+            DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
+            if (v) v->distance = maxf(-limit, minf(v->distance, limit));
+        }
     }
 }
 
-void
-dc_sdf_activate_color(DC_VoxelGrid *grid, uint8_t r, uint8_t g, uint8_t b)
+/* =========================================================================
+ * Activation
+ * ========================================================================= */
+/* Set active flags from the sign, optionally recoloring active cells.
+ * Constant tiles are updated as one value. */
+static void
+activate_tiles(DC_VoxelGrid *grid, int recolor, uint8_t r, uint8_t g, uint8_t b)
 {
-    if (!grid) return;
     int sx = dc_voxel_grid_size_x(grid);
     int sy = dc_voxel_grid_size_y(grid);
     int sz = dc_voxel_grid_size_z(grid);
 
-    for (int iz = 0; iz < sz; iz++)
-    for (int iy = 0; iy < sy; iy++)
-    for (int ix = 0; ix < sx; ix++) {
-        DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
-        if (!v) continue;
-        if (v->distance <= 0.0f) {
-            v->active = 1;
-            v->r = r; v->g = g; v->b = b;
+    if (dc_voxel_grid_is_soa(grid)) {
+        size_t n = (size_t)sx * (size_t)sy * (size_t)sz;
+        const float *dist = dc_voxel_grid_distances_const(grid);
+        uint8_t *act = dc_voxel_grid_active_plane(grid);
+        uint8_t *rgb = recolor ? dc_voxel_grid_color_plane(grid) : NULL;
+        if (!act || (recolor && !rgb)) return;
+        if (dist) {
+            for (size_t i = 0; i < n; i++)
+                act[i] = dist[i] <= 0.0f;
         } else {
-            v->active = 0;
+            /* Quantized plane: decode through the cell API */
+            size_t i = 0;
+            for (int iz = 0; iz < sz; iz++)
+            for (int iy = 0; iy < sy; iy++)
+            for (int ix = 0; ix < sx; ix++)
+                act[i++] = dc_voxel_grid_distance(grid, ix, iy, iz) <= 0.0f;
+        }
+        if (!recolor) return;
+        for (size_t i = 0; i < n; i++) {
+            if (!act[i]) continue;
+            rgb[i*3+0] = r; rgb[i*3+1] = g; rgb[i*3+2] = b;
         }
+        return;
     }
+
+    int ntx, nty, ntz;
+    dc_voxel_grid_tile_dims(grid, &ntx, &nty, &ntz);
+
+    for (int tz = 0; tz < ntz; tz++)
+    for (int ty = 0; ty < nty; ty++)
+    for (int tx = 0; tx < ntx; tx++) {
+        DC_Voxel tv;
+        if (dc_voxel_grid_tile_constant(grid, tx, ty, tz, &tv)) {
+            tv.active = (tv.distance <= 0.0f) ? 1 : 0;
+            if (recolor && tv.active) { tv.r = r; tv.g = g; tv.b = b; }
+            dc_voxel_grid_tile_fill(grid, tx, ty, tz, tv);
+            continue;
+        }
+
+        int x0 = tx * DC_VOXEL_BRICK, y0 = ty * DC_VOXEL_BRICK, z0 = tz * DC_VOXEL_BRICK;
+        int x1 = x0 + DC_VOXEL_BRICK < sx ? x0 + DC_VOXEL_BRICK : sx;
+        int y1 = y0 + DC_VOXEL_BRICK < sy ? y0 + DC_VOXEL_BRICK : sy;
+        int z1 = z0 + DC_VOXEL_BRICK < sz ? z0 + DC_VOXEL_BRICK : sz;
+        for (int iz = z0; iz < z1; iz++)
+        for (int iy = y0; iy < y1; iy++)
+        for (int ix = x0; ix < x1; ix++) {
+            DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
+            if (!v) continue;
+            v->active = (v->distance <= 0.0f) ? 1 : 0;
+            if (recolor && v->active) { v->r = r; v->g = g; v->b = b; }
+        }
+    }
+}
+
+void
+dc_sdf_activate(DC_VoxelGrid *grid)
+{
+    if (!grid) return;
+    activate_tiles(grid, 0, 0, 0, 0);
+}
+
+void
+dc_sdf_activate_color(DC_VoxelGrid *grid, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (!grid) return;
+    activate_tiles(grid, 1, r, g, b);
 }
 
 void
@@ -650,30 +897,30 @@ dc_sdf_color_by_normal(DC_VoxelGrid *grid)
     for (int iz = 0; iz < sz; iz++)
     for (int iy = 0; iy < sy; iy++)
     for (int ix = 0; ix < sx; ix++) {
-        DC_Voxel *v = dc_voxel_grid_get(grid, ix, iy, iz);
-        if (!v || !v->active) continue;
+        DC_Voxel v;
+        if (dc_voxel_grid_load(grid, ix, iy, iz, &v) != 0 || !v.active)
+            continue;
 
         /* Approximate gradient (normal) via central differences */
-        const DC_Voxel *xp = dc_voxel_grid_get_const(grid, ix+1, iy, iz);
-        const DC_Voxel *xm = dc_voxel_grid_get_const(grid, ix-1, iy, iz);
-        const DC_Voxel *yp = dc_voxel_grid_get_const(grid, ix, iy+1, iz);
-        const DC_Voxel *ym = dc_voxel_grid_get_const(grid, ix, iy-1, iz);
-        const DC_Voxel *zp = dc_voxel_grid_get_const(grid, ix, iy, iz+1);
-        const DC_Voxel *zm = dc_voxel_grid_get_const(grid, ix, iy, iz-1);
-
-        float gx = (xp ? xp->distance : v->distance) -
-                    (xm ? xm->distance : v->distance);
-        float gy = (yp ? yp->distance : v->distance) -
-                    (ym ? ym->distance : v->distance);
-        float gz = (zp ? zp->distance : v->distance) -
-                    (zm ? zm->distance : v->distance);
+        float d = v.distance;
+        float xp = ix + 1 < sx ? dc_voxel_grid_distance(grid, ix+1, iy, iz) : d;
+        float xm = ix > 0      ? dc_voxel_grid_distance(grid, ix-1, iy, iz) : d;
+        float yp = iy + 1 < sy ? dc_voxel_grid_distance(grid, ix, iy+1, iz) : d;
+        float ym = iy > 0      ? dc_voxel_grid_distance(grid, ix, iy-1, iz) : d;
+        float zp = iz + 1 < sz ? dc_voxel_grid_distance(grid, ix, iy, iz+1) : d;
+        float zm = iz > 0      ? dc_voxel_grid_distance(grid, ix, iy, iz-1) : d;
+
+        float gx = xp - xm;
+        float gy = yp - ym;
+        float gz = zp - zm;
 
         float len = sqrtf(gx*gx + gy*gy + gz*gz);
         if (len > 1e-6f) { gx /= len; gy /= len; gz /= len; }
 
         /* Map normal to color: [-1,1] → [0,255] */
-        v->r = (uint8_t)((gx * 0.5f + 0.5f) * 255);
-        v->g = (uint8_t)((gy * 0.5f + 0.5f) * 255);
-        v->b = (uint8_t)((gz * 0.5f + 0.5f) * 255);
+        v.r = (uint8_t)((gx * 0.5f + 0.5f) * 255);
+        v.g = (uint8_t)((gy * 0.5f + 0.5f) * 255);
+        v.b = (uint8_t)((gz * 0.5f + 0.5f) * 255);
+        dc_voxel_grid_set(grid, ix, iy, iz, v);
     }
 }
@@ -11,6 +11,13 @@
  * After SDF operations, call dc_sdf_activate() to set active flags
  * based on distance < 0 (inside surface).
  *
+ * On a grid with a narrow band (voxel.h) primitives only visit the cells
+ * within the band of their transformed bounding box, so their cost
+ * follows their footprint rather than the grid volume. On sparse grids
+ * primitives, CSG and activation also keep tiles that stay beyond the
+ * band constant, and only fill bricks near the surface. CSG operands and
+ * output must share a storage mode, except for the offset CSG below.
+ *
  * No GTK dependency.
  */
 
@@ -52,6 +59,29 @@ void dc_sdf_transform_inv_point(const DC_SdfTransform *t,
                                   float wx, float wy, float wz,
                                   float *lx, float *ly, float *lz);
 
+/* =========================================================================
+ * Kernel selection
+ *
+ * Primitives and SoA CSG run on row kernels built for several instruction
+ * sets; the best one the CPU supports is used by default. All sets give
+ * bit-identical results.
+ * ========================================================================= */
+
+typedef enum {
+    DC_SDF_SIMD_AUTO = 0,   /* best available */
+    DC_SDF_SIMD_SCALAR,
+    DC_SDF_SIMD_SSE2,
+    DC_SDF_SIMD_AVX2,
+} DC_SdfSimd;
+
+/* Cap the kernel set (for benchmarks and tests). Levels the CPU or the
+ * build lacks fall back to the best lower one. Returns the level now in
+ * use. Not thread-safe: call while no SDF evaluation is running. */
+DC_SdfSimd dc_sdf_simd_select(DC_SdfSimd level);
+
+/* Level currently in use. */
+DC_SdfSimd dc_sdf_simd_level(void);
+
 /* =========================================================================
  * SDF primitives — fill grid with signed distance values
  * ========================================================================= */
@@ -120,6 +150,35 @@ int dc_sdf_intersect(const DC_VoxelGrid *a, const DC_VoxelGrid *b,
 int dc_sdf_subtract(const DC_VoxelGrid *a, const DC_VoxelGrid *b,
                       DC_VoxelGrid *out);
 
+/* =========================================================================
+ * Offset CSG — operands covering different parts of one lattice
+ *
+ * Each grid is placed by a cell offset: its cell (ix,iy,iz) is lattice
+ * cell (ix+off[0], iy+off[1], iz+off[2]). All grids must share a cell
+ * size; storage modes may differ. out[c] = op(a[c], b[c]) for every cell
+ * of out, with +INF (empty) where a or b does not reach. out may alias a
+ * or b only at the same offset. For union and subtract with out == a
+ * only the cells b covers are visited, so a small b costs little.
+ * Returns 0 on success, -1 on bad arguments or allocation failure.
+ * ========================================================================= */
+
+int dc_sdf_union_at(const DC_VoxelGrid *a, const int a_off[3],
+                      const DC_VoxelGrid *b, const int b_off[3],
+                      DC_VoxelGrid *out, const int out_off[3]);
+
+int dc_sdf_intersect_at(const DC_VoxelGrid *a, const int a_off[3],
+                          const DC_VoxelGrid *b, const int b_off[3],
+                          DC_VoxelGrid *out, const int out_off[3]);
+
+int dc_sdf_subtract_at(const DC_VoxelGrid *a, const int a_off[3],
+                         const DC_VoxelGrid *b, const int b_off[3],
+                         DC_VoxelGrid *out, const int out_off[3]);
+
+/* Clamp every distance to [-limit, limit]. With limit >= band this keeps
+ * a banded grid valid while replacing the +INF left in cells nothing
+ * reached by a finite value (for GL filtering and tile pruning). */
+void dc_sdf_clamp(DC_VoxelGrid *grid, float limit);
+
 /* =========================================================================
  * Activation — set active flags from SDF distance values
  * ========================================================================= */
@@ -0,0 +1,192 @@
+/*
+ * sdf_kernels.c — Scalar, SSE2 and AVX2 builds of the SDF row kernels.
+ *
+ * The kernels themselves live in sdf_kernels_body.h and are instantiated
+ * here once per instruction set. The SSE2 and AVX2 sets are compiled with
+ * per-function target attributes, so the library as a whole still runs on
+ * any x86-64; the AVX2 set is only chosen when the CPU reports it. Other
+ * architectures get the scalar set.
+ */
+
+#include "voxel/sdf_kernels.h"
+
+#include <math.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SDF_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+/* =========================================================================
+ * Scalar
+ * ========================================================================= */
+#define KN(name)        scalar_##name
+#define KATTR
+#define VT              float
+#define VW              1
+#define V_SET1(x)       ((float)(x))
+#define V_LANES         0.0f
+#define V_LOAD(p)       (*(p))
+#define V_STORE(p, v)   (*(p) = (v))
+#define V_ADD(a, b)     ((a) + (b))
+#define V_SUB(a, b)     ((a) - (b))
+#define V_MUL(a, b)     ((a) * (b))
+#define V_MIN(a, b)     ((a) < (b) ? (a) : (b))
+#define V_MAX(a, b)     ((a) > (b) ? (a) : (b))
+#define V_SQRT(a)       sqrtf(a)
+#define V_NEG(a, m)     ((void)(m), -(a))
+#include "voxel/sdf_kernels_body.h"
+#undef KN
+#undef KATTR
+#undef VT
+#undef VW
+#undef V_SET1
+#undef V_LANES
+#undef V_LOAD
+#undef V_STORE
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_MIN
+#undef V_MAX
+#undef V_SQRT
+#undef V_NEG
+
+static const DC_SdfKernels s_scalar = {
+    .level = DC_SDF_SIMD_SCALAR,
+    .row = { scalar_sphere, scalar_box, scalar_cylinder, scalar_torus },
+    .plane_union = scalar_plane_union,
+    .plane_intersect = scalar_plane_intersect,
+    .plane_subtract = scalar_plane_subtract,
+};
+
+#ifdef SDF_KERNELS_X86
+
+/* =========================================================================
+ * SSE2 — 4 cells per step
+ * ========================================================================= */
+#define KN(name)        sse2_##name
+#define KATTR           __attribute__((target("sse2")))
+#define VT              __m128
+#define VW              4
+#define V_SET1(x)       _mm_set1_ps(x)
+#define V_LANES         _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)
+#define V_LOAD(p)       _mm_loadu_ps(p)
+#define V_STORE(p, v)   _mm_storeu_ps((p), (v))
+#define V_ADD(a, b)     _mm_add_ps((a), (b))
+#define V_SUB(a, b)     _mm_sub_ps((a), (b))
+#define V_MUL(a, b)     _mm_mul_ps((a), (b))
+#define V_MIN(a, b)     _mm_min_ps((a), (b))
+#define V_MAX(a, b)     _mm_max_ps((a), (b))
+#define V_SQRT(a)       _mm_sqrt_ps(a)
+#define V_NEG(a, m)     _mm_xor_ps((a), (m))
+#include "voxel/sdf_kernels_body.h"
+#undef KN
+#undef KATTR
+#undef VT
+#undef VW
+#undef V_SET1
+#undef V_LANES
+#undef V_LOAD
+#undef V_STORE
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_MIN
+#undef V_MAX
+#undef V_SQRT
+#undef V_NEG
+
+static const DC_SdfKernels s_sse2 = {
+    .level = DC_SDF_SIMD_SSE2,
+    .row = { sse2_sphere, sse2_box, sse2_cylinder, sse2_torus },
+    .plane_union = sse2_plane_union,
+    .plane_intersect = sse2_plane_intersect,
+    .plane_subtract = sse2_plane_subtract,
+};
+
+/* =========================================================================
+ * AVX2 — 8 cells per step, one tile row (DC_VOXEL_BRICK) at a time
+ * ========================================================================= */
+#define KN(name)        avx2_##name
+#define KATTR           __attribute__((target("avx2")))
+#define VT              __m256
+#define VW              8
+#define V_SET1(x)       _mm256_set1_ps(x)
+#define V_LANES         _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f)
+#define V_LOAD(p)       _mm256_loadu_ps(p)
+#define V_STORE(p, v)   _mm256_storeu_ps((p), (v))
+#define V_ADD(a, b)     _mm256_add_ps((a), (b))
+#define V_SUB(a, b)     _mm256_sub_ps((a), (b))
+#define V_MUL(a, b)     _mm256_mul_ps((a), (b))
+#define V_MIN(a, b)     _mm256_min_ps((a), (b))
+#define V_MAX(a, b)     _mm256_max_ps((a), (b))
+#define V_SQRT(a)       _mm256_sqrt_ps(a)
+#define V_NEG(a, m)     _mm256_xor_ps((a), (m))
+#include "voxel/sdf_kernels_body.h"
+#undef KN
+#undef KATTR
+#undef VT
+#undef VW
+#undef V_SET1
+#undef V_LANES
+#undef V_LOAD
+#undef V_STORE
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_MIN
+#undef V_MAX
+#undef V_SQRT
+#undef V_NEG
+
+static const DC_SdfKernels s_avx2 = {
+    .level = DC_SDF_SIMD_AVX2,
+    .row = { avx2_sphere, avx2_box, avx2_cylinder, avx2_torus },
+    .plane_union = avx2_plane_union,
+    .plane_intersect = avx2_plane_intersect,
+    .plane_subtract = avx2_plane_subtract,
+};
+
+#endif /* SDF_KERNELS_X86 */
+
+/* =========================================================================
+ * Selection
+ * ========================================================================= */
+
+/* Set by dc_sdf_simd_select(); DC_SDF_SIMD_AUTO until then */
+static DC_SdfSimd s_requested = DC_SDF_SIMD_AUTO;
+
+static const DC_SdfKernels *
+kernels_for(DC_SdfSimd want)
+{
+#ifdef SDF_KERNELS_X86
+    if (want == DC_SDF_SIMD_AUTO) want = DC_SDF_SIMD_AVX2;
+    if (want >= DC_SDF_SIMD_AVX2 && __builtin_cpu_supports("avx2"))
+        return &s_avx2;
+    if (want >= DC_SDF_SIMD_SSE2 && __builtin_cpu_supports("sse2"))
+        return &s_sse2;
+#else
+    (void)want;
+#endif
+    return &s_scalar;
+}
+
+const DC_SdfKernels *
+dc_sdf_kernels(void)
+{
+    return kernels_for(s_requested);
+}
+
+DC_SdfSimd
+dc_sdf_simd_select(DC_SdfSimd level)
+{
+    s_requested = level;
+    return kernels_for(level)->level;
+}
+
+DC_SdfSimd
+dc_sdf_simd_level(void)
+{
+    return dc_sdf_kernels()->level;
+}
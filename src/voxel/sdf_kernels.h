@@ -0,0 +1,68 @@
+#ifndef DC_SDF_KERNELS_H
+#define DC_SDF_KERNELS_H
+
+/*
+ * sdf_kernels.h — Row kernels behind the SDF primitives and CSG.
+ *
+ * Internal to src/voxel. A row kernel evaluates one primitive at n cells
+ * spaced evenly along a line in local space (the grid's X axis, mapped by
+ * the inverse transform) and MINs the result into dst. The inverse
+ * transform is applied once per row; each cell only adds a delta.
+ *
+ * One kernel set is built per instruction set (scalar, SSE2, AVX2) from
+ * the same source; every set performs the same float operations in the
+ * same order, so all of them produce bit-identical results.
+ *
+ * No GTK dependency.
+ */
+
+#include "voxel/sdf.h"
+
+#include <stddef.h>
+
+/* dst[i] = min(dst[i], sc * f(prm, p0 + i*d)) for i in [0, n) */
+typedef void (*DC_SdfRowFn)(const float *prm, const float *p0,
+                            const float *d, float sc, float *dst, int n);
+
+/* out[i] = op(a[i], b[i]); out may alias a or b */
+typedef void (*DC_SdfPlaneFn)(const float *a, const float *b, float *out,
+                              size_t n);
+
+/* Primitive parameter blocks (prm):
+ *   sphere    cx, cy, cz, radius
+ *   box       x0, y0, z0, x1, y1, z1 (ordered)
+ *   cylinder  cx, cy, radius, z0, z1 (ordered)
+ *   torus     cx, cy, cz, major_r, minor_r */
+typedef enum {
+    DC_SDF_PRIM_SPHERE,
+    DC_SDF_PRIM_BOX,
+    DC_SDF_PRIM_CYLINDER,
+    DC_SDF_PRIM_TORUS,
+    DC_SDF_PRIM_COUNT
+} DC_SdfPrim;
+
+typedef struct {
+    DC_SdfSimd    level;
+    DC_SdfRowFn   row[DC_SDF_PRIM_COUNT];
+    DC_SdfPlaneFn plane_union;
+    DC_SdfPlaneFn plane_intersect;
+    DC_SdfPlaneFn plane_subtract;
+} DC_SdfKernels;
+
+/* Kernel set selected by dc_sdf_simd_select() (best available by
+ * default). */
+const DC_SdfKernels *dc_sdf_kernels(void);
+
+/* Row helpers shared by sdf.c and sdf_program.c (defined in sdf.c) */
+
+/* Local-space point p0 of cell (ix,iy,iz) and per-cell step d along the
+ * grid row, ready for a row kernel. t may be NULL (identity). */
+void dc_sdf_row_setup(const DC_VoxelGrid *grid, const DC_SdfTransform *t,
+                      int ix, int iy, int iz, float p0[3], float d[3]);
+
+/* Grid-space bounding box of a primitive's surface: its local box mapped
+ * through t. */
+void dc_sdf_prim_bounds(DC_SdfPrim prim, const float *prm,
+                        const DC_SdfTransform *t, float lo[3], float hi[3]);
+
+#endif /* DC_SDF_KERNELS_H */
@@ -0,0 +1,141 @@
+/*
+ * sdf_kernels_body.h — Kernel bodies, instantiated per instruction set.
+ *
+ * Included only by sdf_kernels.c, once per kernel set, with these defined:
+ *   KN(name)   function name for this set
+ *   KATTR      function attributes (target ISA)
+ *   VT, VW     vector type and lane count
+ *   V_SET1, V_LANES, V_LOAD, V_STORE, V_ADD, V_SUB, V_MUL, V_MIN, V_MAX,
+ *   V_SQRT, V_NEG
+ *              lane-wise operations; V_MIN/V_MAX follow minf/maxf
+ *              ((a < b) ? a : b), matching MINPS/MAXPS; V_NEG(v, m) flips
+ *              the sign bit with m = V_SET1(-0.0f)
+ *
+ * No include guard: the file is meant to be included repeatedly.
+ */
+
+/* Row loop shared by all primitives. The body computes `VT v` from the local
+ * point (px, py, pz). A short tail runs through a padded lane buffer so
+ * every cell takes the same vector path. */
+#define KERNEL_ROW_LOOP(...)                                                \
+    VT ox = V_SET1(p0[0]), oy = V_SET1(p0[1]), oz = V_SET1(p0[2]);          \
+    VT sx = V_SET1(d[0]),  sy = V_SET1(d[1]),  sz = V_SET1(d[2]);           \
+    VT scale = V_SET1(sc);                                                  \
+    for (int i = 0; i < n; i += VW) {                                       \
+        float pad[VW];                                                      \
+        float *out = dst + i;                                               \
+        int m = n - i < VW ? n - i : VW;                                    \
+        if (m < VW) {                                                       \
+            for (int k = 0; k < VW; k++) pad[k] = k < m ? dst[i + k] : 0.0f;\
+            out = pad;                                                      \
+        }                                                                   \
+        VT t = V_ADD(V_SET1((float)i), V_LANES);                            \
+        VT px = V_ADD(ox, V_MUL(t, sx));                                    \
+        VT py = V_ADD(oy, V_MUL(t, sy));                                    \
+        VT pz = V_ADD(oz, V_MUL(t, sz));                                    \
+        VT v;                                                               \
+        __VA_ARGS__                                                         \
+        V_STORE(out, V_MIN(V_LOAD(out), V_MUL(v, scale)));                  \
+        if (m < VW)                                                         \
+            for (int k = 0; k < m; k++) dst[i + k] = pad[k];                \
+    }
+
+KATTR static void
+KN(sphere)(const float *prm, const float *p0, const float *d, float sc,
+           float *dst, int n)
+{
+    VT cx = V_SET1(prm[0]), cy = V_SET1(prm[1]), cz = V_SET1(prm[2]);
+    VT r = V_SET1(prm[3]);
+    KERNEL_ROW_LOOP(
+        VT dx = V_SUB(px, cx);
+        VT dy = V_SUB(py, cy);
+        VT dz = V_SUB(pz, cz);
+        v = V_SUB(V_SQRT(V_ADD(V_ADD(V_MUL(dx, dx), V_MUL(dy, dy)),
+                               V_MUL(dz, dz))), r);
+    )
+}
+
+KATTR static void
+KN(box)(const float *prm, const float *p0, const float *d, float sc,
+        float *dst, int n)
+{
+    VT x0 = V_SET1(prm[0]), y0 = V_SET1(prm[1]), z0 = V_SET1(prm[2]);
+    VT x1 = V_SET1(prm[3]), y1 = V_SET1(prm[4]), z1 = V_SET1(prm[5]);
+    VT zero = V_SET1(0.0f);
+    KERNEL_ROW_LOOP(
+        VT dx = V_MAX(V_SUB(x0, px), V_SUB(px, x1));
+        VT dy = V_MAX(V_SUB(y0, py), V_SUB(py, y1));
+        VT dz = V_MAX(V_SUB(z0, pz), V_SUB(pz, z1));
+        VT ex = V_MAX(dx, zero), ey = V_MAX(dy, zero), ez = V_MAX(dz, zero);
+        VT outside = V_SQRT(V_ADD(V_ADD(V_MUL(ex, ex), V_MUL(ey, ey)),
+                                  V_MUL(ez, ez)));
+        VT inside = V_MIN(V_MAX(dx, V_MAX(dy, dz)), zero);
+        v = V_ADD(outside, inside);
+    )
+}
+
+KATTR static void
+KN(cylinder)(const float *prm, const float *p0, const float *d, float sc,
+             float *dst, int n)
+{
+    VT cx = V_SET1(prm[0]), cy = V_SET1(prm[1]), r = V_SET1(prm[2]);
+    VT z0 = V_SET1(prm[3]), z1 = V_SET1(prm[4]);
+    KERNEL_ROW_LOOP(
+        VT dx = V_SUB(px, cx);
+        VT dy = V_SUB(py, cy);
+        VT radial = V_SUB(V_SQRT(V_ADD(V_MUL(dx, dx), V_MUL(dy, dy))), r);
+        VT axial = V_MAX(V_SUB(z0, pz), V_SUB(pz, z1));
+        v = V_MAX(radial, axial);
+    )
+}
+
+KATTR static void
+KN(torus)(const float *prm, const float *p0, const float *d, float sc,
+          float *dst, int n)
+{
+    VT cx = V_SET1(prm[0]), cy = V_SET1(prm[1]), cz = V_SET1(prm[2]);
+    VT big = V_SET1(prm[3]), small = V_SET1(prm[4]);
+    KERNEL_ROW_LOOP(
+        VT dx = V_SUB(px, cx);
+        VT dy = V_SUB(py, cy);
+        VT dz = V_SUB(pz, cz);
+        VT q = V_SUB(V_SQRT(V_ADD(V_MUL(dx, dx), V_MUL(dy, dy))), big);
+        v = V_SUB(V_SQRT(V_ADD(V_MUL(q, q), V_MUL(dz, dz))), small);
+    )
+}
+
+#undef KERNEL_ROW_LOOP
+
+/* Plane combiners. Tails finish lane by lane with the scalar form of the
+ * same operation (exact for min/max). */
+#define KERNEL_PLANE_LOOP(VEXPR, SEXPR)                                     \
+    size_t i = 0;                                                           \
+    for (; i + VW <= n; i += VW) {                                          \
+        VT va = V_LOAD(a + i), vb = V_LOAD(b + i);                          \
+        V_STORE(out + i, VEXPR);                                            \
+    }                                                                       \
+    for (; i < n; i++) {                                                    \
+        float sa = a[i], sb = b[i];                                         \
+        out[i] = SEXPR;                                                     \
+    }
+
+KATTR static void
+KN(plane_union)(const float *a, const float *b, float *out, size_t n)
+{
+    KERNEL_PLANE_LOOP(V_MIN(va, vb), sa < sb ? sa : sb)
+}
+
+KATTR static void
+KN(plane_intersect)(const float *a, const float *b, float *out, size_t n)
+{
+    KERNEL_PLANE_LOOP(V_MAX(va, vb), sa > sb ? sa : sb)
+}
+
+KATTR static void
+KN(plane_subtract)(const float *a, const float *b, float *out, size_t n)
+{
+    VT neg = V_SET1(-0.0f);
+    KERNEL_PLANE_LOOP(V_MAX(va, V_NEG(vb, neg)), sa > -sb ? sa : -sb)
+}
+
+#undef KERNEL_PLANE_LOOP
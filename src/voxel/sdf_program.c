@@ -0,0 +1,922 @@
+/*
+ * sdf_program.c — Compiled SDF expressions, evaluated in one grid pass.
+ *
+ * Instructions are stored in postfix order, so every operator follows
+ * both of its operands and the last instruction is the root. Evaluation
+ * walks the grid in blocks of PROG_BLOCK^3 tiles. Each block, then each
+ * of its tiles, narrows the instruction list to the nodes that can reach
+ * it (cull()); the surviving list then runs once per tile row on a stack
+ * of row buffers, using the same row and plane kernels as sdf.c.
+ *
+ * Repeats are not nodes: dc_sdf_program_repeat() tags every primitive of
+ * the repeated subtree with a modulo domain, and widens the subtree's
+ * boxes to all copies. A tagged primitive folds each cell onto its copy
+ * before evaluating; cells of a row that fold onto the same copy run
+ * through the row kernel together.
+ */
+
+#include "voxel/sdf_program.h"
+#include "voxel/sdf_kernels.h"
+#include "voxel/voxel_pool.h"
+
+#include <glib.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Tiles per block axis for the coarse culling level */
+#define PROG_BLOCK 4
+
+/* Column-major 4x4 element, as in sdf.c */
+#define M(m, r, c) ((m)[(c)*4 + (r)])
+
+typedef enum {
+    PROG_PRIM,
+    PROG_EMPTY,
+    PROG_UNION,             /* binary operators, from here on */
+    PROG_INTERSECT,
+    PROG_SUBTRACT,
+    PROG_SMOOTH_UNION,      /* prm[0]: blend radius k */
+    PROG_SMOOTH_INTERSECT,
+    PROG_SMOOTH_SUBTRACT,
+    PROG_ROUND,             /* unary operators, from here on; prm[0]: r */
+    PROG_SHELL,             /* prm[0]: half the wall thickness */
+} ProgOp;
+
+typedef struct {
+    uint8_t         op;         /* ProgOp */
+    uint8_t         prim;       /* DC_SdfPrim (PROG_PRIM) */
+    uint8_t         has_xf;
+    int             a, b;       /* operand instructions (operators) */
+    int             rep;        /* repeat domain + 1 (PROG_PRIM), 0: none */
+    float           prm[6];
+    float           lo[3], hi[3];   /* grid-space bounds, see sdf_program.h */
+    DC_SdfTransform xf;
+} ProgInstr;
+
+/* A modulo domain (dc_sdf_program_repeat). A cell is folded by the
+ * enclosing domain first, then by this one. */
+typedef struct {
+    float           period[3];
+    int             count[3];
+    float           centre[3];      /* local-space centre of the original */
+    float           step[3][3];     /* grid-space offset between copies, per axis */
+    int             parent;         /* enclosing domain, -1 for none */
+    uint8_t         has_xf;
+    DC_SdfTransform xf;
+} ProgRepeat;
+
+struct DC_SdfProgram {
+    ProgInstr  *ins;
+    size_t      len, cap;
+    int        *roots;          /* value stack: root instruction per value */
+    int         nroots, roots_cap;
+    int         max_depth;
+    ProgRepeat *reps;
+    int         nreps, reps_cap;
+};
+
+static inline float
+minf(float a, float b) { return a < b ? a : b; }
+
+static inline float
+maxf(float a, float b) { return a > b ? a : b; }
+
+static inline int
+op_unary(int op) { return op >= PROG_ROUND; }
+
+/* How far beyond the band an operator's operands can still change its
+ * value within the band */
+static inline float
+op_margin(const ProgInstr *ins)
+{
+    switch (ins->op) {
+    case PROG_SMOOTH_UNION:
+    case PROG_SMOOTH_INTERSECT:
+    case PROG_SMOOTH_SUBTRACT:
+    case PROG_SHELL:
+        return ins->prm[0];
+    case PROG_ROUND:
+        return fabsf(ins->prm[0]);
+    default:
+        return 0.0f;
+    }
+}
+
+/* =========================================================================
+ * Building
+ * ========================================================================= */
+
+DC_SdfProgram *
+dc_sdf_program_new(void)
+{
+    return calloc(1, sizeof(DC_SdfProgram));
+}
+
+void
+dc_sdf_program_free(DC_SdfProgram *prog)
+{
+    if (!prog) return;
+    free(prog->ins);
+    free(prog->roots);
+    free(prog->reps);
+    free(prog);
+}
+
+/* Append ins and make it the top value (after operators popped theirs). */
+static int
+emit(DC_SdfProgram *prog, const ProgInstr *ins)
+{
+    if (!prog) return -1;
+    if (prog->len == prog->cap) {
+        size_t cap = prog->cap ? prog->cap * 2 : 32;
+        ProgInstr *grown = realloc(prog->ins, cap * sizeof(ProgInstr));
+        if (!grown) return -1;
+        prog->ins = grown;
+        prog->cap = cap;
+    }
+    if (prog->nroots == prog->roots_cap) {
+        int cap = prog->roots_cap ? prog->roots_cap * 2 : 16;
+        int *grown = realloc(prog->roots, (size_t)cap * sizeof(int));
+        if (!grown) return -1;
+        prog->roots = grown;
+        prog->roots_cap = cap;
+    }
+    prog->ins[prog->len] = *ins;
+    prog->roots[prog->nroots++] = (int)prog->len++;
+    if (prog->nroots > prog->max_depth) prog->max_depth = prog->nroots;
+    return 0;
+}
+
+int
+dc_sdf_program_empty(DC_SdfProgram *prog)
+{
+    ProgInstr ins = { .op = PROG_EMPTY };
+    for (int a = 0; a < 3; a++) {
+        ins.lo[a] = HUGE_VALF;
+        ins.hi[a] = -HUGE_VALF;
+    }
+    return emit(prog, &ins);
+}
+
+static int
+emit_prim(DC_SdfProgram *prog, DC_SdfPrim prim, const float *prm, int nprm,
+          const DC_SdfTransform *t)
+{
+    ProgInstr ins = { .op = PROG_PRIM, .prim = (uint8_t)prim };
+    memcpy(ins.prm, prm, (size_t)nprm * sizeof(float));
+    if (t) {
+        ins.xf = *t;
+        ins.has_xf = 1;
+    }
+    dc_sdf_prim_bounds(prim, ins.prm, t, ins.lo, ins.hi);
+    return emit(prog, &ins);
+}
+
+int
+dc_sdf_program_sphere(DC_SdfProgram *prog,
+                      float cx, float cy, float cz, float radius,
+                      const DC_SdfTransform *t)
+{
+    if (radius <= 0) return dc_sdf_program_empty(prog);
+    float prm[4] = { cx, cy, cz, radius };
+    return emit_prim(prog, DC_SDF_PRIM_SPHERE, prm, 4, t);
+}
+
+int
+dc_sdf_program_box(DC_SdfProgram *prog,
+                   float x0, float y0, float z0,
+                   float x1, float y1, float z1,
+                   const DC_SdfTransform *t)
+{
+    if (x0 > x1) { float tmp = x0; x0 = x1; x1 = tmp; }
+    if (y0 > y1) { float tmp = y0; y0 = y1; y1 = tmp; }
+    if (z0 > z1) { float tmp = z0; z0 = z1; z1 = tmp; }
+    float prm[6] = { x0, y0, z0, x1, y1, z1 };
+    return emit_prim(prog, DC_SDF_PRIM_BOX, prm, 6, t);
+}
+
+int
+dc_sdf_program_cylinder(DC_SdfProgram *prog,
+                        float cx, float cy, float radius,
+                        float z0, float z1,
+                        const DC_SdfTransform *t)
+{
+    if (radius <= 0) return dc_sdf_program_empty(prog);
+    if (z0 > z1) { float tmp = z0; z0 = z1; z1 = tmp; }
+    float prm[5] = { cx, cy, radius, z0, z1 };
+    return emit_prim(prog, DC_SDF_PRIM_CYLINDER, prm, 5, t);
+}
+
+int
+dc_sdf_program_torus(DC_SdfProgram *prog,
+                     float cx, float cy, float cz,
+                     float major_r, float minor_r,
+                     const DC_SdfTransform *t)
+{
+    if (major_r <= 0 || minor_r <= 0) return dc_sdf_program_empty(prog);
+    float prm[5] = { cx, cy, cz, major_r, minor_r };
+    return emit_prim(prog, DC_SDF_PRIM_TORUS, prm, 5, t);
+}
+
+/* Pop two values and push op(a, b). The node's box bounds where its
+ * value can drop below the band (sdf_program.h): union covers both
+ * operands, intersect only their overlap (left inverted when they miss
+ * each other), subtract never reaches past its left operand. A smooth
+ * union lies at most k/4 below the plain one; smooth intersect and
+ * subtract only ever lie above theirs. */
+static int
+emit_op(DC_SdfProgram *prog, ProgOp op, float k)
+{
+    if (!prog || prog->nroots < 2) return -1;
+    int b = prog->roots[--prog->nroots];
+    int a = prog->roots[--prog->nroots];
+    const ProgInstr *ia = &prog->ins[a], *ib = &prog->ins[b];
+
+    ProgInstr ins = { .op = (uint8_t)op, .a = a, .b = b, .prm = { k } };
+    for (int c = 0; c < 3; c++) {
+        switch (op) {
+        case PROG_UNION:
+        case PROG_SMOOTH_UNION:
+            ins.lo[c] = minf(ia->lo[c], ib->lo[c]) - 0.25f * k;
+            ins.hi[c] = maxf(ia->hi[c], ib->hi[c]) + 0.25f * k;
+            break;
+        case PROG_INTERSECT:
+        case PROG_SMOOTH_INTERSECT:
+            ins.lo[c] = maxf(ia->lo[c], ib->lo[c]);
+            ins.hi[c] = minf(ia->hi[c], ib->hi[c]);
+            break;
+        default:
+            ins.lo[c] = ia->lo[c];
+            ins.hi[c] = ia->hi[c];
+            break;
+        }
+    }
+    if (emit(prog, &ins) != 0) {
+        /* Leave the stack as it was */
+        prog->nroots += 2;
+        return -1;
+    }
+    return 0;
+}
+
+int dc_sdf_program_union(DC_SdfProgram *prog)     { return emit_op(prog, PROG_UNION, 0.0f); }
+int dc_sdf_program_intersect(DC_SdfProgram *prog) { return emit_op(prog, PROG_INTERSECT, 0.0f); }
+int dc_sdf_program_subtract(DC_SdfProgram *prog)  { return emit_op(prog, PROG_SUBTRACT, 0.0f); }
+
+int
+dc_sdf_program_smooth_union(DC_SdfProgram *prog, float k)
+{
+    return k > 0.0f ? emit_op(prog, PROG_SMOOTH_UNION, k) : emit_op(prog, PROG_UNION, 0.0f);
+}
+
+int
+dc_sdf_program_smooth_intersect(DC_SdfProgram *prog, float k)
+{
+    return k > 0.0f ? emit_op(prog, PROG_SMOOTH_INTERSECT, k)
+                    : emit_op(prog, PROG_INTERSECT, 0.0f);
+}
+
+int
+dc_sdf_program_smooth_subtract(DC_SdfProgram *prog, float k)
+{
+    return k > 0.0f ? emit_op(prog, PROG_SMOOTH_SUBTRACT, k)
+                    : emit_op(prog, PROG_SUBTRACT, 0.0f);
+}
+
+/* Pop one value and push op(a) with parameter v, its box grown by grow */
+static int
+emit_unary(DC_SdfProgram *prog, ProgOp op, float v, float grow)
+{
+    if (!prog || prog->nroots < 1) return -1;
+    int a = prog->roots[--prog->nroots];
+    const ProgInstr *ia = &prog->ins[a];
+
+    ProgInstr ins = { .op = (uint8_t)op, .a = a, .b = -1, .prm = { v } };
+    for (int c = 0; c < 3; c++) {
+        ins.lo[c] = ia->lo[c] - grow;
+        ins.hi[c] = ia->hi[c] + grow;
+    }
+    if (emit(prog, &ins) != 0) {
+        prog->nroots++;
+        return -1;
+    }
+    return 0;
+}
+
+int
+dc_sdf_program_round(DC_SdfProgram *prog, float r)
+{
+    if (!prog || prog->nroots < 1) return -1;
+    if (r == 0.0f) return 0;
+    return emit_unary(prog, PROG_ROUND, r, maxf(r, 0.0f));
+}
+
+int
+dc_sdf_program_shell(DC_SdfProgram *prog, float thickness)
+{
+    float half = maxf(0.5f * thickness, 0.0f);
+    return emit_unary(prog, PROG_SHELL, half, half);
+}
+
+/* Widen a box to cover every copy of domain rp. Empty boxes stay empty. */
+static void
+repeat_box(const ProgRepeat *rp, float lo[3], float hi[3])
+{
+    for (int c = 0; c < 3; c++)
+        if (!(lo[c] <= hi[c])) return;
+    for (int a = 0; a < 3; a++) {
+        if (rp->count[a] == 1) continue;
+        for (int c = 0; c < 3; c++) {
+            float s = rp->step[a][c];
+            if (s == 0.0f) continue;
+            if (rp->count[a] == 0) {
+                lo[c] = -HUGE_VALF;
+                hi[c] = HUGE_VALF;
+            } else if (s < 0.0f) {
+                lo[c] += s * (float)(rp->count[a] - 1);
+            } else {
+                hi[c] += s * (float)(rp->count[a] - 1);
+            }
+        }
+    }
+}
+
+int
+dc_sdf_program_repeat(DC_SdfProgram *prog, const float period[3],
+                      const int count[3], const DC_SdfTransform *t)
+{
+    if (!prog || prog->nroots < 1 || !period || !count) return -1;
+
+    ProgRepeat rp = { .parent = -1 };
+    int any = 0;
+    for (int a = 0; a < 3; a++) {
+        rp.period[a] = period[a];
+        rp.count[a] = period[a] > 0.0f && count[a] >= 0 ? count[a] : 1;
+        if (rp.count[a] != 1) any = 1;
+        for (int c = 0; c < 3; c++)
+            rp.step[a][c] = t ? M(t->mat, c, a) * period[a] : (c == a ? period[a] : 0.0f);
+    }
+    if (t) {
+        rp.xf = *t;
+        rp.has_xf = 1;
+    }
+
+    /* The subtree of the top value: its instructions run from the first
+     * leaf (down the left operands) to the root */
+    int root = prog->roots[prog->nroots - 1];
+    int first = root;
+    while (prog->ins[first].op >= PROG_UNION) first = prog->ins[first].a;
+
+    const ProgInstr *ir = &prog->ins[root];
+    for (int c = 0; c < 3; c++)
+        if (!(ir->lo[c] <= ir->hi[c])) any = 0;    /* nothing to repeat */
+    if (!any) return 0;
+    float mid[3];
+    for (int c = 0; c < 3; c++)
+        mid[c] = isfinite(ir->lo[c] + ir->hi[c]) ? 0.5f * (ir->lo[c] + ir->hi[c]) : 0.0f;
+    dc_sdf_transform_inv_point(t, mid[0], mid[1], mid[2],
+                               &rp.centre[0], &rp.centre[1], &rp.centre[2]);
+
+    if (prog->nreps == prog->reps_cap) {
+        int cap = prog->reps_cap ? prog->reps_cap * 2 : 4;
+        ProgRepeat *grown = realloc(prog->reps, (size_t)cap * sizeof(ProgRepeat));
+        if (!grown) return -1;
+        prog->reps = grown;
+        prog->reps_cap = cap;
+    }
+    int q = prog->nreps++;
+    prog->reps[q] = rp;
+
+    for (int i = first; i <= root; i++) {
+        ProgInstr *ins = &prog->ins[i];
+        if (ins->op == PROG_PRIM) {
+            if (!ins->rep) {
+                ins->rep = q + 1;
+            } else {
+                /* Already repeated: this domain encloses its outermost one */
+                int r = ins->rep - 1;
+                while (prog->reps[r].parent >= 0 && prog->reps[r].parent != q)
+                    r = prog->reps[r].parent;
+                prog->reps[r].parent = q;
+            }
+        }
+        repeat_box(&rp, ins->lo, ins->hi);
+    }
+    return 0;
+}
+
+size_t
+dc_sdf_program_length(const DC_SdfProgram *prog)
+{
+    return prog ? prog->len : 0;
+}
+
+int
+dc_sdf_program_values(const DC_SdfProgram *prog)
+{
+    return prog ? prog->nroots : 0;
+}
+
+/* =========================================================================
+ * Culling
+ *
+ * A list holds instruction indices in program order, root last. An entry
+ * marked dead stands for its whole subtree and evaluates as +INF; its
+ * operands are not in the list.
+ * ========================================================================= */
+
+#define ENTRY_DEAD(i)   (-1 - (i))
+#define ENTRY_IS_DEAD(e) ((e) < 0)
+#define ENTRY_INDEX(e)  ((e) < 0 ? -1 - (e) : (e))
+
+/* Whether node ins can come within reach of the cell-centre box lo..hi */
+static int
+box_reaches(const ProgInstr *ins, const float lo[3], const float hi[3],
+            float reach)
+{
+    for (int a = 0; a < 3; a++) {
+        if (hi[a] < ins->lo[a] - reach || lo[a] > ins->hi[a] + reach)
+            return 0;
+    }
+    return 1;
+}
+
+/* Narrow list `in` (n entries) to the cells lo..hi, writing the result to
+ * out. A node is live if its box, grown by reach and its margin, reaches
+ * the cells and its operands allow a value below the band there: a union
+ * needs either operand, an intersect both, a subtract or a unary operator
+ * its left one. Only the operands of live operators are kept.
+ *
+ * With flatten set, a union with one live operand, or a subtract whose
+ * right operand is dead, is replaced by its live operand, so a long
+ * union chain costs only the members that reach the cells. The result
+ * then no longer matches the operand indices and must not be culled
+ * again. live and need are scratch, indexed by instruction. Returns the
+ * entries written, 0 if the root is dead. */
+static int
+cull(const DC_SdfProgram *prog, const int *in, int n,
+     const float lo[3], const float hi[3], float reach, const float *margin,
+     int flatten, uint8_t *live, uint8_t *need, int *out)
+{
+    for (int k = 0; k < n; k++) {
+        int i = ENTRY_INDEX(in[k]);
+        const ProgInstr *ins = &prog->ins[i];
+        int l = !ENTRY_IS_DEAD(in[k]) && box_reaches(ins, lo, hi, reach + margin[i]);
+        if (l) {
+            switch (ins->op) {
+            case PROG_PRIM:
+                break;
+            case PROG_EMPTY:
+                l = 0;
+                break;
+            case PROG_UNION:
+            case PROG_SMOOTH_UNION:
+                l = live[ins->a] || live[ins->b];
+                break;
+            case PROG_INTERSECT:
+            case PROG_SMOOTH_INTERSECT:
+                l = live[ins->a] && live[ins->b];
+                break;
+            default:
+                l = live[ins->a];
+                break;
+            }
+        }
+        live[i] = (uint8_t)l;
+        need[i] = 0;
+    }
+
+    int root = ENTRY_INDEX(in[n - 1]);
+    if (!live[root]) return 0;
+    /* need: 1 = emit, 2 = replaced by its live operand */
+    need[root] = 1;
+    for (int k = n - 1; k >= 0; k--) {
+        int i = ENTRY_INDEX(in[k]);
+        const ProgInstr *ins = &prog->ins[i];
+        if (!need[i] || !live[i] || ins->op < PROG_UNION) continue;
+        int isect = ins->op == PROG_INTERSECT || ins->op == PROG_SMOOTH_INTERSECT;
+        int uni = ins->op == PROG_UNION || ins->op == PROG_SMOOTH_UNION;
+        if (op_unary(ins->op)) {
+            need[ins->a] = 1;
+        } else if (flatten && !isect && !live[ins->b]) {
+            need[i] = 2;
+            need[ins->a] = 1;
+        } else if (flatten && uni && !live[ins->a]) {
+            need[i] = 2;
+            need[ins->b] = 1;
+        } else {
+            need[ins->a] = need[ins->b] = 1;
+        }
+    }
+
+    int m = 0;
+    for (int k = 0; k < n; k++) {
+        int i = ENTRY_INDEX(in[k]);
+        if (need[i] == 1) out[m++] = live[i] ? i : ENTRY_DEAD(i);
+    }
+    return m;
+}
+
+/* =========================================================================
+ * Evaluation
+ * ========================================================================= */
+
+typedef struct {
+    const DC_SdfProgram *prog;
+    const DC_SdfKernels *k;
+    DC_VoxelGrid        *grid;
+    const int           *full;      /* every instruction, live */
+    const float         *margin;    /* per instruction, see cull() */
+    int                  size[3];
+    int                  tiles[3];
+    int                  blo[3];    /* first block */
+    int                  nblocks[3];
+    int                  off[3];    /* grid cell 0 is this cell */
+    float                cs, band, reach;
+    int                  cull;      /* grid has a band */
+    int                  sparse;
+    int                  failed;    /* atomic; also cancels the job */
+} EvalJob;
+
+static void
+fill_inf(float *v, int n)
+{
+    for (int i = 0; i < n; i++) v[i] = HUGE_VALF;
+}
+
+/* Polynomial smooth minimum over radius k > 0: min(a, b) once they are k
+ * or more apart (also when either is +INF), a blend dipping at most k/4
+ * below it otherwise */
+static inline float
+smin(float a, float b, float k)
+{
+    if (!(fabsf(a - b) < k)) return minf(a, b);
+    float h = 0.5f + 0.5f * (b - a) / k;
+    return b + (a - b) * h - k * h * (1.0f - h);
+}
+
+/* a[i] = op(a[i], b[i]) for the smooth operators */
+static void
+smooth_rows(int op, float k, float *a, const float *b, int n)
+{
+    switch (op) {
+    case PROG_SMOOTH_UNION:
+        for (int i = 0; i < n; i++) a[i] = smin(a[i], b[i], k);
+        break;
+    case PROG_SMOOTH_INTERSECT:
+        for (int i = 0; i < n; i++) a[i] = -smin(-a[i], -b[i], k);
+        break;
+    default:
+        for (int i = 0; i < n; i++) a[i] = -smin(-a[i], b[i], k);
+        break;
+    }
+}
+
+/* Fold grid point p through domain r and the domains around it, adding
+ * the grid-space shift to off: p - off is the matching point of the
+ * original. */
+static void
+repeat_fold(const DC_SdfProgram *prog, int r, float p[3], float off[3])
+{
+    const ProgRepeat *rp = &prog->reps[r];
+    if (rp->parent >= 0) repeat_fold(prog, rp->parent, p, off);
+
+    float q[3];
+    dc_sdf_transform_inv_point(rp->has_xf ? &rp->xf : NULL, p[0], p[1], p[2],
+                               &q[0], &q[1], &q[2]);
+    for (int a = 0; a < 3; a++) {
+        if (rp->count[a] == 1) continue;
+        float i = roundf((q[a] - rp->centre[a]) / rp->period[a]);
+        if (rp->count[a] > 0)
+            i = i < 0.0f ? 0.0f : minf(i, (float)(rp->count[a] - 1));
+        if (i == 0.0f) continue;
+        for (int c = 0; c < 3; c++) {
+            p[c] -= i * rp->step[a][c];
+            off[c] += i * rp->step[a][c];
+        }
+    }
+}
+
+/* Row of a primitive in a repeat domain. Cells that fold onto the same
+ * copy form runs, each evaluated by the row kernel from its start point
+ * moved back onto the original; p0 and d are the unfolded row. */
+static void
+run_repeated(const EvalJob *job, const ProgInstr *ins, int x0, int iy, int iz,
+             const float p0[3], const float d[3], float *dst, int n)
+{
+    const DC_SdfTransform *t = ins->has_xf ? &ins->xf : NULL;
+    DC_SdfRowFn row = job->k->row[ins->prim];
+    float sc = t ? t->scale : 1.0f;
+
+    float run[3] = { 0.0f, 0.0f, 0.0f };
+    int start = 0;
+    for (int i = 0; i <= n; i++) {
+        float off[3] = { 0.0f, 0.0f, 0.0f };
+        if (i < n) {
+            float p[3];
+            dc_voxel_grid_cell_center(job->grid, x0 + i, iy, iz, &p[0], &p[1], &p[2]);
+            repeat_fold(job->prog, ins->rep - 1, p, off);
+            if (i == 0) {
+                memcpy(run, off, sizeof(run));
+                continue;
+            }
+            if (off[0] == run[0] && off[1] == run[1] && off[2] == run[2]) continue;
+        }
+        /* Cells [start, i) share the shift run */
+        float q0[3];
+        for (int c = 0; c < 3; c++) {
+            float back = t ? M(t->inv,c,0) * run[0] + M(t->inv,c,1) * run[1] +
+                             M(t->inv,c,2) * run[2]
+                           : run[c];
+            q0[c] = p0[c] + (float)start * d[c] - back;
+        }
+        row(ins->prm, q0, d, sc, dst + start, i - start);
+        start = i;
+        memcpy(run, off, sizeof(run));
+    }
+}
+
+/* Run list over the n cells of row (iy, iz) from x0 into out, with stack
+ * holding one DC_VOXEL_BRICK row per value. x0, iy and iz are full grid
+ * cells (EvalJob.off included). */
+static void
+run_row(const EvalJob *job, const int *list, int count,
+        int x0, int iy, int iz, int n, float *stack, float *out)
+{
+    const DC_SdfKernels *k = job->k;
+    float *top = stack;     /* next free row */
+    for (int e = 0; e < count; e++) {
+        if (ENTRY_IS_DEAD(list[e])) {
+            fill_inf(top, n);
+            top += DC_VOXEL_BRICK;
+            continue;
+        }
+        const ProgInstr *ins = &job->prog->ins[list[e]];
+        float *a = top - 2 * DC_VOXEL_BRICK, *b = top - DC_VOXEL_BRICK;
+        switch (ins->op) {
+        case PROG_PRIM: {
+            const DC_SdfTransform *t = ins->has_xf ? &ins->xf : NULL;
+            float p0[3], d[3];
+            fill_inf(top, n);
+            dc_sdf_row_setup(job->grid, t, x0, iy, iz, p0, d);
+            if (ins->rep)
+                run_repeated(job, ins, x0, iy, iz, p0, d, top, n);
+            else
+                k->row[ins->prim](ins->prm, p0, d, t ? t->scale : 1.0f, top, n);
+            top += DC_VOXEL_BRICK;
+            break;
+        }
+        case PROG_EMPTY:
+            fill_inf(top, n);
+            top += DC_VOXEL_BRICK;
+            break;
+        case PROG_UNION:
+            k->plane_union(a, b, a, (size_t)n);
+            top = b;
+            break;
+        case PROG_INTERSECT:
+            k->plane_intersect(a, b, a, (size_t)n);
+            top = b;
+            break;
+        case PROG_SUBTRACT:
+            k->plane_subtract(a, b, a, (size_t)n);
+            top = b;
+            break;
+        case PROG_ROUND:
+            for (int i = 0; i < n; i++) b[i] -= ins->prm[0];
+            break;
+        case PROG_SHELL:
+            for (int i = 0; i < n; i++) b[i] = fabsf(b[i]) - ins->prm[0];
+            break;
+        default:
+            smooth_rows(ins->op, ins->prm[0], a, b, n);
+            top = b;
+            break;
+        }
+    }
+    memcpy(out, stack, (size_t)n * sizeof(float));
+}
+
+/* MIN a tile's values (rows of DC_VOXEL_BRICK, z-major) into the grid.
+ * A constant sparse tile stays constant when the result keeps it beyond
+ * the band on one side, taking the bound closest to the surface. */
+static void
+store_tile(const EvalJob *job, int tx, int ty, int tz, const int *n,
+           const float *vals)
+{
+    DC_VoxelGrid *grid = job->grid;
+    int x0 = tx * DC_VOXEL_BRICK, y0 = ty * DC_VOXEL_BRICK, z0 = tz * DC_VOXEL_BRICK;
+
+    DC_Voxel tv;
+    if (job->sparse && dc_voxel_grid_tile_constant(grid, tx, ty, tz, &tv)) {
+        float band = job->band;
+        if (tv.distance < -band) return;
+        float vmin = HUGE_VALF, vmax = -HUGE_VALF;
+        for (int lz = 0; lz < n[2]; lz++)
+        for (int ly = 0; ly < n[1]; ly++) {
+            const float *v = vals + (lz * DC_VOXEL_BRICK + ly) * DC_VOXEL_BRICK;
+            for (int lx = 0; lx < n[0]; lx++) {
+                vmin = minf(vmin, v[lx]);
+                vmax = maxf(vmax, v[lx]);
+            }
+        }
+        if (tv.distance > band && (vmin > band || vmax < -band)) {
+            tv.distance = vmin > band ? minf(tv.distance, vmin) : vmax;
+            dc_voxel_grid_tile_fill(grid, tx, ty, tz, tv);
+            return;
+        }
+    }
+
+    float *plane = dc_voxel_grid_distances(grid);
+    for (int lz = 0; lz < n[2]; lz++)
+    for (int ly = 0; ly < n[1]; ly++) {
+        const float *v = vals + (lz * DC_VOXEL_BRICK + ly) * DC_VOXEL_BRICK;
+        int iy = y0 + ly, iz = z0 + lz;
+        if (plane) {
+            float *dst = plane + (size_t)x0 + (size_t)iy * job->size[0] +
+                         (size_t)iz * job->size[0] * job->size[1];
+            job->k->plane_union(dst, v, dst, (size_t)n[0]);
+            continue;
+        }
+        /* Tile rows are consecutive DC_Voxels (voxel.h) */
+        DC_Voxel *row = dc_voxel_grid_get(grid, x0, iy, iz);
+        if (!row) continue;
+        for (int lx = 0; lx < n[0]; lx++)
+            row[lx].distance = minf(row[lx].distance, v[lx]);
+    }
+}
+
+/* Cell-centre box of cells [c0, c1) per axis */
+static void
+cell_box(const EvalJob *job, const int c0[3], const int c1[3],
+         float lo[3], float hi[3])
+{
+    for (int a = 0; a < 3; a++) {
+        lo[a] = ((float)(c0[a] + job->off[a]) + 0.5f) * job->cs;
+        hi[a] = ((float)(c1[a] + job->off[a]) - 0.5f) * job->cs;
+    }
+}
+
+/* One block of PROG_BLOCK^3 tiles */
+static void
+eval_block(void *ctx, int item)
+{
+    EvalJob *job = ctx;
+    const DC_SdfProgram *prog = job->prog;
+    size_t len = prog->len;
+
+    int b[3] = { item % job->nblocks[0],
+                 (item / job->nblocks[0]) % job->nblocks[1],
+                 item / (job->nblocks[0] * job->nblocks[1]) };
+    int t0[3], t1[3];
+    for (int a = 0; a < 3; a++) {
+        t0[a] = (job->blo[a] + b[a]) * PROG_BLOCK;
+        t1[a] = t0[a] + PROG_BLOCK < job->tiles[a] ? t0[a] + PROG_BLOCK : job->tiles[a];
+    }
+
+    uint8_t *flags = malloc(2 * len);
+    int *lists = malloc(2 * len * sizeof(int));
+    float *stack = malloc((size_t)prog->max_depth * DC_VOXEL_BRICK * sizeof(float));
+    float *vals = malloc(DC_VOXEL_BRICK * DC_VOXEL_BRICK * DC_VOXEL_BRICK * sizeof(float));
+    if (!flags || !lists || !stack || !vals) {
+        g_atomic_int_set(&job->failed, 1);
+        goto done;
+    }
+
+    const int *block_list = job->full;
+    int block_n = (int)len;
+    if (job->cull) {
+        int c0[3], c1[3];
+        float lo[3], hi[3];
+        for (int a = 0; a < 3; a++) {
+            c0[a] = t0[a] * DC_VOXEL_BRICK;
+            c1[a] = t1[a] * DC_VOXEL_BRICK < job->size[a] ? t1[a] * DC_VOXEL_BRICK
+                                                          : job->size[a];
+        }
+        cell_box(job, c0, c1, lo, hi);
+        block_n = cull(prog, job->full, (int)len, lo, hi, job->reach, job->margin,
+                       0, flags, flags + len, lists);
+        block_list = lists;
+    }
+
+    for (int tz = t0[2]; tz < t1[2] && block_n > 0; tz++)
+    for (int ty = t0[1]; ty < t1[1]; ty++)
+    for (int tx = t0[0]; tx < t1[0]; tx++) {
+        int c0[3] = { tx * DC_VOXEL_BRICK, ty * DC_VOXEL_BRICK, tz * DC_VOXEL_BRICK };
+        int c1[3], n[3];
+        for (int a = 0; a < 3; a++) {
+            c1[a] = c0[a] + DC_VOXEL_BRICK < job->size[a] ? c0[a] + DC_VOXEL_BRICK
+                                                          : job->size[a];
+            n[a] = c1[a] - c0[a];
+        }
+
+        const int *list = block_list;
+        int count = block_n;
+        if (job->cull) {
+            float lo[3], hi[3];
+            cell_box(job, c0, c1, lo, hi);
+            count = cull(prog, block_list, block_n, lo, hi, job->reach, job->margin,
+                         1, flags, flags + len, lists + len);
+            list = lists + len;
+            if (count == 0) continue;
+        }
+
+        for (int lz = 0; lz < n[2]; lz++)
+        for (int ly = 0; ly < n[1]; ly++)
+            run_row(job, list, count, job->off[0] + c0[0],
+                    job->off[1] + c0[1] + ly, job->off[2] + c0[2] + lz, n[0],
+                    stack, vals + (lz * DC_VOXEL_BRICK + ly) * DC_VOXEL_BRICK);
+        store_tile(job, tx, ty, tz, n, vals);
+    }
+
+done:
+    free(flags);
+    free(lists);
+    free(stack);
+    free(vals);
+}
+
+int
+dc_sdf_program_eval(const DC_SdfProgram *prog, DC_VoxelGrid *grid)
+{
+    return dc_sdf_program_eval_slab(prog, grid, 0);
+}
+
+int
+dc_sdf_program_eval_slab(const DC_SdfProgram *prog, DC_VoxelGrid *grid, int z0)
+{
+    const int off[3] = { 0, 0, z0 };
+    return dc_sdf_program_eval_region(prog, grid, off);
+}
+
+int
+dc_sdf_program_eval_region(const DC_SdfProgram *prog, DC_VoxelGrid *grid,
+                           const int off[3])
+{
+    if (!prog || !grid || !off || prog->nroots != 1) return -1;
+
+    EvalJob job = {
+        .prog = prog,
+        .k = dc_sdf_kernels(),
+        .grid = grid,
+        .size = { dc_voxel_grid_size_x(grid), dc_voxel_grid_size_y(grid),
+                  dc_voxel_grid_size_z(grid) },
+        .off = { off[0], off[1], off[2] },
+        .cs = dc_voxel_grid_cell_size(grid),
+        .band = dc_voxel_grid_band(grid),
+        .sparse = dc_voxel_grid_is_sparse(grid),
+    };
+    dc_voxel_grid_tile_dims(grid, &job.tiles[0], &job.tiles[1], &job.tiles[2]);
+    job.cull = job.band > 0.0f;
+    /* Half a cell to spare for rounding in the box tests */
+    job.reach = job.band + 0.5f * job.cs;
+
+    /* Blocks the root can reach */
+    const ProgInstr *root = &prog->ins[prog->len - 1];
+    for (int a = 0; a < 3; a++) {
+        int t0 = 0, t1 = job.tiles[a];
+        if (job.cull) {
+            /* Cell i is centred at (i + 0.5) * cs */
+            float l = (root->lo[a] - job.reach) / job.cs - 0.5f - (float)off[a];
+            float h = (root->hi[a] + job.reach) / job.cs - 0.5f - (float)off[a];
+            if (!(h >= 0.0f) || !(l <= (float)(job.size[a] - 1))) return 0;
+            int c0 = l <= 0.0f ? 0 : (int)ceilf(l);
+            int c1 = h >= (float)(job.size[a] - 1) ? job.size[a] : (int)floorf(h) + 1;
+            if (c0 >= c1) return 0;
+            t0 = c0 / DC_VOXEL_BRICK;
+            t1 = (c1 - 1) / DC_VOXEL_BRICK + 1;
+        }
+        job.blo[a] = t0 / PROG_BLOCK;
+        job.nblocks[a] = (t1 - 1) / PROG_BLOCK + 1 - job.blo[a];
+    }
+
+    int *full = malloc(prog->len * sizeof(int));
+    float *margin = malloc(prog->len * sizeof(float));
+    if (!full || !margin) {
+        free(full);
+        free(margin);
+        return -1;
+    }
+    for (size_t i = 0; i < prog->len; i++) full[i] = (int)i;
+    /* Margins accumulate down from the root; operands precede operators */
+    margin[prog->len - 1] = 0.0f;
+    for (size_t i = prog->len; i-- > 0;) {
+        const ProgInstr *ins = &prog->ins[i];
+        if (ins->op < PROG_UNION) continue;
+        float m = margin[i] + op_margin(ins);
+        margin[ins->a] = m;
+        if (!op_unary(ins->op)) margin[ins->b] = m;
+    }
+    job.full = full;
+    job.margin = margin;
+
+    /* Sparse grids allocate bricks on write, which is not thread-safe */
+    int count = job.nblocks[0] * job.nblocks[1] * job.nblocks[2];
+    dc_voxel_pool_run(eval_block, &job, count, job.sparse ? 1 : 0, &job.failed);
+
+    free(full);
+    free(margin);
+    return g_atomic_int_get(&job.failed) ? -1 : 0;
+}
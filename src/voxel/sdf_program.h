@@ -0,0 +1,148 @@
+#ifndef DC_SDF_PROGRAM_H
+#define DC_SDF_PROGRAM_H
+
+/*
+ * sdf_program.h — Compiled SDF expressions, evaluated in one grid pass.
+ *
+ * A program is a CSG expression over primitives in postfix order: each
+ * primitive pushes its distance, each operator pops two values and pushes
+ * the result. dc_sdf_program_eval() runs the whole expression once per
+ * cell, a tile row at a time, so no intermediate grid is ever built.
+ *
+ * Every node carries a grid-space bounding box (primitives: their
+ * transformed box; union: the hull; intersect: the overlap; subtract: the
+ * left operand; smooth and unary operators grow these by as far as they
+ * move the surface; a repeat spans all its copies). On a grid with a
+ * narrow band (voxel.h) each block and tile of cells only runs the nodes
+ * whose box, grown by the band, reaches it; the others evaluate as +INF,
+ * which changes no cell within the band. Operands of smooth and unary
+ * operators reach further by the operator's radius, as they still change
+ * the result that far from its surface.
+ *
+ * Without a band every node runs everywhere, and a program of primitives,
+ * union, intersect and subtract is bit-identical to building each
+ * primitive in its own grid and combining the grids with
+ * dc_sdf_union/intersect/subtract.
+ *
+ * No GTK dependency.
+ */
+
+#include "voxel/sdf.h"
+
+#include <stddef.h>
+
+typedef struct DC_SdfProgram DC_SdfProgram;
+
+DC_SdfProgram *dc_sdf_program_new(void);
+void dc_sdf_program_free(DC_SdfProgram *prog);
+
+/* =========================================================================
+ * Building — primitives push a value, operators pop two
+ *
+ * Primitive parameters match dc_sdf_*_t() (sdf.h); t may be NULL and is
+ * copied. Degenerate primitives (radius <= 0) push the empty shape.
+ * All return 0, or -1 on allocation failure; operators also return -1
+ * when fewer than two values are on the stack.
+ * ========================================================================= */
+
+int dc_sdf_program_sphere(DC_SdfProgram *prog,
+                          float cx, float cy, float cz, float radius,
+                          const DC_SdfTransform *t);
+
+int dc_sdf_program_box(DC_SdfProgram *prog,
+                       float x0, float y0, float z0,
+                       float x1, float y1, float z1,
+                       const DC_SdfTransform *t);
+
+int dc_sdf_program_cylinder(DC_SdfProgram *prog,
+                            float cx, float cy, float radius,
+                            float z0, float z1,
+                            const DC_SdfTransform *t);
+
+int dc_sdf_program_torus(DC_SdfProgram *prog,
+                         float cx, float cy, float cz,
+                         float major_r, float minor_r,
+                         const DC_SdfTransform *t);
+
+/* Push the empty shape (+INF everywhere). */
+int dc_sdf_program_empty(DC_SdfProgram *prog);
+
+/* Pop b, then a; push min(a, b). */
+int dc_sdf_program_union(DC_SdfProgram *prog);
+
+/* Pop b, then a; push max(a, b). */
+int dc_sdf_program_intersect(DC_SdfProgram *prog);
+
+/* Pop b, then a; push max(a, -b). */
+int dc_sdf_program_subtract(DC_SdfProgram *prog);
+
+/* Smooth variants of the above (polynomial smooth min/max): where the
+ * operands' surfaces meet, the sharp edge becomes a fillet of radius
+ * about k. Away from the seam, further than k from either surface, they
+ * match the plain operators. k <= 0 emits the plain operator. */
+int dc_sdf_program_smooth_union(DC_SdfProgram *prog, float k);
+int dc_sdf_program_smooth_intersect(DC_SdfProgram *prog, float k);
+int dc_sdf_program_smooth_subtract(DC_SdfProgram *prog, float k);
+
+/* =========================================================================
+ * Modifiers — pop one value, push the modified value
+ *
+ * Return 0, or -1 on allocation failure or an empty stack.
+ * ========================================================================= */
+
+/* a - r: the shape grown by r, its edges rounded to radius r (a negative
+ * r shrinks it instead). */
+int dc_sdf_program_round(DC_SdfProgram *prog, float r);
+
+/* |a| - thickness/2: a hollow wall of the given thickness centred on the
+ * surface of a (onion). */
+int dc_sdf_program_shell(DC_SdfProgram *prog, float thickness);
+
+/* a repeated count[k] times along axis k of t's local space (t may be
+ * NULL for the grid axes), period[k] apart, starting with a itself.
+ * count 0 repeats without end; count 1 or period <= 0 leaves the axis
+ * alone. t is copied.
+ *
+ * The repeat is a modulo domain, not a union of copies: each cell folds
+ * its position onto the nearest copy and evaluates a there once, so the
+ * cost does not grow with the count. The result is exact while a stays
+ * within half a period of its centre along each repeated axis. Repeats
+ * nest. */
+int dc_sdf_program_repeat(DC_SdfProgram *prog, const float period[3],
+                          const int count[3], const DC_SdfTransform *t);
+
+/* Instructions emitted so far. */
+size_t dc_sdf_program_length(const DC_SdfProgram *prog);
+
+/* Values on the stack (1 for a complete program). */
+int dc_sdf_program_values(const DC_SdfProgram *prog);
+
+/* =========================================================================
+ * Evaluation
+ * ========================================================================= */
+
+/* MIN the program's value into every cell of grid (CSG union with its
+ * content, as the dc_sdf_*_t primitives do). Dense grids are evaluated
+ * on the voxel worker pool; sparse grids on the calling thread, filling
+ * bricks only where the result comes within the band of the surface.
+ *
+ * Returns 0 on success, -1 if the program does not leave exactly one
+ * value or on allocation failure. */
+int dc_sdf_program_eval(const DC_SdfProgram *prog, DC_VoxelGrid *grid);
+
+/* dc_sdf_program_eval on a slab of a taller grid: grid's layer iz holds
+ * layer z0 + iz of the full grid (cell centres at (z0 + iz + 0.5) * cs).
+ * Values are bit-identical to the same cells of the full grid, so a grid
+ * too large for memory can be evaluated a slab at a time. */
+int dc_sdf_program_eval_slab(const DC_SdfProgram *prog, DC_VoxelGrid *grid,
+                             int z0);
+
+/* The same for any box of the full grid: grid's cell (ix, iy, iz) holds
+ * cell off + (ix, iy, iz), so just the part of a grid an edit touched can
+ * be evaluated again. Rows are stepped from their first cell: values are
+ * bit-identical to the full grid's when off[0] is a multiple of
+ * DC_VOXEL_BRICK, and may differ in the last bit otherwise. */
+int dc_sdf_program_eval_region(const DC_SdfProgram *prog, DC_VoxelGrid *grid,
+                               const int off[3]);
+
+#endif /* DC_SDF_PROGRAM_H */
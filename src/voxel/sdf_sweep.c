@@ -0,0 +1,216 @@
+/*
+ * sdf_sweep.c — Narrow-band distance propagation on voxel grids.
+ *
+ * Fast sweeping (Zhao 2005): Gauss-Seidel passes over the grid in the
+ * 8 axis-direction orderings. Each far cell takes the Godunov upwind
+ * solution of |grad d| = 1 from its smaller axis neighbours, so a front
+ * travelling in any octant is resolved by the sweep that follows it. One
+ * round of 8 sweeps is usually exact to first order; a second confirms.
+ * Cost is O(cells) per round, against O(cells * surface) for evaluating
+ * exact distance everywhere.
+ *
+ * The sweep works on a flat float copy of |distance| and writes back
+ * once, leaving frozen signs intact and far cells positive.
+ */
+
+#include "voxel/sdf_sweep.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define SWEEP_INF 1e20f
+
+/* Internal mask value: far cell already reached by dc_sdf_sign_fill */
+#define SIGN_VISITED 3
+
+static inline DC_Voxel *
+cell_at(DC_VoxelGrid *grid, size_t idx, int sx, size_t sxy)
+{
+    return dc_voxel_grid_get(grid, (int)(idx % sx), (int)((idx % sxy) / sx),
+                             (int)(idx / sxy));
+}
+
+/* Godunov upwind update for neighbour minima a, b, c along each axis. */
+static inline float
+eikonal_update(float a, float b, float c, float h)
+{
+    float t;
+    if (a > b) { t = a; a = b; b = t; }
+    if (b > c) { t = b; b = c; c = t; }
+    if (a > b) { t = a; a = b; b = t; }
+
+    float u = a + h;
+    if (u <= b) return u;
+
+    u = 0.5f * (a + b + sqrtf(fmaxf(0.0f, 2.0f*h*h - (a-b)*(a-b))));
+    if (u <= c) return u;
+
+    float s = a + b + c;
+    float disc = s*s - 3.0f * (a*a + b*b + c*c - h*h);
+    return (s + sqrtf(fmaxf(0.0f, disc))) / 3.0f;
+}
+
+int
+dc_sdf_sweep(DC_VoxelGrid *grid, const uint8_t *mask, int max_rounds)
+{
+    if (!grid || !mask) return 0;
+    if (max_rounds <= 0) max_rounds = 4;
+
+    int sx = dc_voxel_grid_size_x(grid);
+    int sy = dc_voxel_grid_size_y(grid);
+    int sz = dc_voxel_grid_size_z(grid);
+    float h = dc_voxel_grid_cell_size(grid);
+    size_t total = (size_t)sx * sy * sz;
+    size_t sxy = (size_t)sx * sy;
+
+    size_t frozen = 0;
+    for (size_t i = 0; i < total; i++)
+        if (mask[i] == DC_SDF_FROZEN) frozen++;
+    if (frozen == 0) return 0;
+
+    float *phi = malloc(total * sizeof(float));
+    if (!phi) return -1;
+
+    for (size_t i = 0; i < total; i++)
+        phi[i] = mask[i] == DC_SDF_FROZEN
+               ? fabsf(cell_at(grid, i, sx, sxy)->distance) : SWEEP_INF;
+
+    /* Stop once a round moves no cell by more than this */
+    float tol = h * 1e-5f;
+
+    int rounds = 0;
+    for (; rounds < max_rounds; ) {
+        int changed = 0;
+        rounds++;
+
+        for (int dir = 0; dir < 8; dir++) {
+            int stx = (dir & 1) ? -1 : 1;
+            int sty = (dir & 2) ? -1 : 1;
+            int stz = (dir & 4) ? -1 : 1;
+            int x0 = stx > 0 ? 0 : sx - 1, x1 = stx > 0 ? sx : -1;
+            int y0 = sty > 0 ? 0 : sy - 1, y1 = sty > 0 ? sy : -1;
+            int z0 = stz > 0 ? 0 : sz - 1, z1 = stz > 0 ? sz : -1;
+
+            for (int iz = z0; iz != z1; iz += stz)
+            for (int iy = y0; iy != y1; iy += sty)
+            for (int ix = x0; ix != x1; ix += stx) {
+                size_t idx = (size_t)ix + (size_t)iy * sx + (size_t)iz * sxy;
+
+                if (mask[idx] == DC_SDF_FROZEN) {
+                    /* Lipschitz clamp against frozen neighbours only:
+                     * swept values are approximations, not bounds. */
+                    float lim = phi[idx];
+                    if (ix > 0      && mask[idx-1] == DC_SDF_FROZEN)   lim = fminf(lim, phi[idx-1] + h);
+                    if (ix < sx - 1 && mask[idx+1] == DC_SDF_FROZEN)   lim = fminf(lim, phi[idx+1] + h);
+                    if (iy > 0      && mask[idx-sx] == DC_SDF_FROZEN)  lim = fminf(lim, phi[idx-sx] + h);
+                    if (iy < sy - 1 && mask[idx+sx] == DC_SDF_FROZEN)  lim = fminf(lim, phi[idx+sx] + h);
+                    if (iz > 0      && mask[idx-sxy] == DC_SDF_FROZEN) lim = fminf(lim, phi[idx-sxy] + h);
+                    if (iz < sz - 1 && mask[idx+sxy] == DC_SDF_FROZEN) lim = fminf(lim, phi[idx+sxy] + h);
+                    if (lim < phi[idx] - tol) { phi[idx] = lim; changed = 1; }
+                    continue;
+                }
+
+                float a = SWEEP_INF, b = SWEEP_INF, c = SWEEP_INF;
+                if (ix > 0)      a = phi[idx-1];
+                if (ix < sx - 1) a = fminf(a, phi[idx+1]);
+                if (iy > 0)      b = phi[idx-sx];
+                if (iy < sy - 1) b = fminf(b, phi[idx+sx]);
+                if (iz > 0)      c = phi[idx-sxy];
+                if (iz < sz - 1) c = fminf(c, phi[idx+sxy]);
+                if (a >= SWEEP_INF && b >= SWEEP_INF && c >= SWEEP_INF) continue;
+
+                float u = eikonal_update(a, b, c, h);
+                if (u < phi[idx]) {
+                    if (u < phi[idx] - tol) changed = 1;
+                    phi[idx] = u;
+                }
+            }
+        }
+
+        if (!changed) break;
+    }
+
+    for (size_t i = 0; i < total; i++) {
+        DC_Voxel *v = cell_at(grid, i, sx, sxy);
+        if (mask[i] == DC_SDF_FROZEN)
+            v->distance = v->distance < 0.0f ? -phi[i] : phi[i];
+        else
+            v->distance = phi[i];
+    }
+
+    free(phi);
+    return rounds;
+}
+
+long
+dc_sdf_sign_fill(DC_VoxelGrid *grid, uint8_t *mask)
+{
+    if (!grid || !mask) return 0;
+
+    int sx = dc_voxel_grid_size_x(grid);
+    int sy = dc_voxel_grid_size_y(grid);
+    int sz = dc_voxel_grid_size_z(grid);
+    size_t total = (size_t)sx * sy * sz;
+    size_t sxy = (size_t)sx * sy;
+
+    /* Grids are capped well below 2^32 cells (see voxel.c) */
+    uint32_t *queue = malloc(total * sizeof(uint32_t));
+    if (!queue) return -1;
+
+    long unsigned_cells = 0;
+
+    for (size_t seed = 0; seed < total; seed++) {
+        if (mask[seed] != DC_SDF_FAR) continue;
+
+        size_t head = 0, tail = 0;
+        int has_in = 0, has_out = 0;
+        mask[seed] = SIGN_VISITED;
+        queue[tail++] = (uint32_t)seed;
+
+        while (head < tail) {
+            size_t idx = queue[head++];
+            int ix = (int)(idx % sx);
+            int iy = (int)((idx % sxy) / sx);
+            int iz = (int)(idx / sxy);
+
+            size_t nb[6];
+            int nn = 0;
+            if (ix > 0)      nb[nn++] = idx - 1;
+            if (ix < sx - 1) nb[nn++] = idx + 1;
+            if (iy > 0)      nb[nn++] = idx - sx;
+            if (iy < sy - 1) nb[nn++] = idx + sx;
+            if (iz > 0)      nb[nn++] = idx - sxy;
+            if (iz < sz - 1) nb[nn++] = idx + sxy;
+
+            for (int k = 0; k < nn; k++) {
+                size_t n = nb[k];
+                if (mask[n] == DC_SDF_FROZEN) {
+                    if (cell_at(grid, n, sx, sxy)->distance < 0.0f) has_in = 1;
+                    else                                           has_out = 1;
+                } else if (mask[n] == DC_SDF_FAR) {
+                    mask[n] = SIGN_VISITED;
+                    queue[tail++] = (uint32_t)n;
+                }
+            }
+        }
+
+        if (has_in != has_out) {
+            if (has_in) {
+                for (size_t q = 0; q < tail; q++) {
+                    DC_Voxel *v = cell_at(grid, queue[q], sx, sxy);
+                    v->distance = -fabsf(v->distance);
+                }
+            }
+        } else {
+            for (size_t q = 0; q < tail; q++)
+                mask[queue[q]] = DC_SDF_UNSIGNED;
+            unsigned_cells += (long)tail;
+        }
+    }
+
+    for (size_t i = 0; i < total; i++)
+        if (mask[i] == SIGN_VISITED) mask[i] = DC_SDF_FAR;
+
+    free(queue);
+    return unsigned_cells;
+}
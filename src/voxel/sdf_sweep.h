@@ -0,0 +1,52 @@
+#ifndef DC_SDF_SWEEP_H
+#define DC_SDF_SWEEP_H
+
+/*
+ * sdf_sweep.h — Narrow-band distance propagation on voxel grids.
+ *
+ * Voxelizers compute exact distances only for cells within a few cells of
+ * the surface and mark them frozen in a band mask. dc_sdf_sweep() fills
+ * every other cell by solving the Eikonal equation |grad d| = 1 with the
+ * fast sweeping method, and dc_sdf_sign_fill() carries the inside/outside
+ * sign of the band into the far field by connected component.
+ *
+ * The mask is one byte per cell in grid order (ix + iy*sx + iz*sx*sy).
+ *
+ * No GTK dependency.
+ */
+
+#include "voxel/voxel.h"
+
+#include <stdint.h>
+
+/* Band mask values */
+#define DC_SDF_FAR       0  /* distance (and sign) to be filled in */
+#define DC_SDF_FROZEN    1  /* exact distance and sign already stored */
+#define DC_SDF_UNSIGNED  2  /* set by dc_sdf_sign_fill: sign still unknown */
+
+/* Default narrow-band half-width, in cells, for the voxelizers. */
+#define DC_SDF_BAND_CELLS 3
+
+/* Propagate |distance| from the frozen cells into every DC_SDF_FAR cell.
+ *
+ * Frozen cells keep their value, except that each is clamped to
+ * (frozen neighbour + cell_size): true distance is 1-Lipschitz, so this
+ * only lowers values a closest-point solver overshot. Far cells receive a
+ * non-negative distance. Runs rounds of 8 Gauss-Seidel sweeps until
+ * nothing changes or max_rounds (<= 0 selects 4) is reached.
+ *
+ * Returns the number of rounds run, 0 if no cell is frozen (grid left
+ * untouched), or -1 on allocation failure. */
+int dc_sdf_sweep(DC_VoxelGrid *grid, const uint8_t *mask, int max_rounds);
+
+/* Sign the DC_SDF_FAR cells by 6-connected component. A component
+ * bordered only by inside (negative) frozen cells becomes inside; one
+ * bordered only by outside cells stays positive. Components touching both
+ * (the surface leaks) or neither are marked DC_SDF_UNSIGNED in the mask
+ * and left positive for the caller to resolve per cell.
+ *
+ * Returns the number of DC_SDF_UNSIGNED cells, or -1 on allocation
+ * failure (mask unchanged). */
+long dc_sdf_sign_fill(DC_VoxelGrid *grid, uint8_t *mask);
+
+#endif /* DC_SDF_SWEEP_H */
@@ -0,0 +1,630 @@
+#define _POSIX_C_SOURCE 200809L
+/*
+ * tri_bvh.c — Bounding volume hierarchy over a triangle soup.
+ *
+ * Build: top-down, binned SAH (16 bins along the longest centroid axis).
+ * Falls back to an index-median split when binning cannot separate the
+ * triangles, and forces a leaf past DC_TRI_BVH_MAX_DEPTH so queries can
+ * use a fixed-size traversal stack.
+ *
+ * Node bounds are padded by a small scene-relative epsilon. The ray test
+ * accepts points on triangle edges (u,v in [0,1]), so a tight box could
+ * reject a triangle the brute-force loop would count; the padding keeps
+ * the BVH result identical to the exhaustive one.
+ *
+ * Triangle vertices are copied into leaf order so a leaf's triangles
+ * are contiguous in memory.
+ *
+ * Winding number: each node also stores a first-order dipole moment
+ * (area-weighted centroid, summed area vector, bounding radius). A node
+ * far enough from the query point contributes its dipole term instead
+ * of its exact per-triangle solid angles, so a query touches O(log n)
+ * nodes away from the surface.
+ */
+
+#include "voxel/tri_bvh.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DC_TRI_BVH_LEAF_MAX   4
+#define DC_TRI_BVH_BINS       16
+#define DC_TRI_BVH_MAX_DEPTH  60
+#define DC_TRI_BVH_STACK      (DC_TRI_BVH_MAX_DEPTH + 4)
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef struct {
+    float bmin[3];
+    float bmax[3];
+    int   first;    /* leaf: first triangle; internal: left child index */
+    int   count;    /* leaf: triangle count; internal: 0 */
+} BvhNode;
+
+/* Dipole moment of a subtree, for the far-field winding number */
+typedef struct {
+    float c[3];     /* area-weighted centroid */
+    float n[3];     /* sum of triangle area vectors (0.5 * e1 x e2) */
+    float r;        /* radius of a ball around c holding every vertex */
+    float area;     /* total unsigned triangle area */
+} BvhMoment;
+
+struct DC_TriBvh {
+    BvhNode   *nodes;
+    BvhMoment *moments; /* parallel to nodes */
+    int        node_count;
+    float   *tris;      /* 9 floats per triangle, leaf order */
+    int      tri_count;
+    int      depth;
+};
+
+/* =========================================================================
+ * Triangle geometry helpers
+ * ========================================================================= */
+
+static float
+vec3_dot(const float *a, const float *b)
+{
+    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+static void
+vec3_sub(float *out, const float *a, const float *b)
+{
+    out[0] = a[0]-b[0]; out[1] = a[1]-b[1]; out[2] = a[2]-b[2];
+}
+
+static void
+vec3_cross(float *out, const float *a, const float *b)
+{
+    out[0] = a[1]*b[2] - a[2]*b[1];
+    out[1] = a[2]*b[0] - a[0]*b[2];
+    out[2] = a[0]*b[1] - a[1]*b[0];
+}
+
+static float
+clampf(float v, float lo, float hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+float
+dc_tri_point_dist(const float *p, const float *v0, const float *v1, const float *v2)
+{
+    float e0[3], e1[3], v[3];
+    vec3_sub(e0, v1, v0);
+    vec3_sub(e1, v2, v0);
+    vec3_sub(v, p, v0);
+
+    float d00 = vec3_dot(e0, e0);
+    float d01 = vec3_dot(e0, e1);
+    float d11 = vec3_dot(e1, e1);
+    float d20 = vec3_dot(v, e0);
+    float d21 = vec3_dot(v, e1);
+
+    float denom = d00 * d11 - d01 * d01;
+    if (fabsf(denom) < 1e-12f) {
+        /* Degenerate triangle — distance to v0 */
+        float d[3]; vec3_sub(d, p, v0);
+        return sqrtf(vec3_dot(d, d));
+    }
+
+    float s = (d11 * d20 - d01 * d21) / denom;
+    float t = (d00 * d21 - d01 * d20) / denom;
+
+    /* Clamp to triangle */
+    s = clampf(s, 0.0f, 1.0f);
+    t = clampf(t, 0.0f, 1.0f);
+    if (s + t > 1.0f) {
+        float scale = 1.0f / (s + t);
+        s *= scale;
+        t *= scale;
+    }
+
+    /* Closest point on triangle */
+    float closest[3];
+    closest[0] = v0[0] + s * e0[0] + t * e1[0];
+    closest[1] = v0[1] + s * e0[1] + t * e1[1];
+    closest[2] = v0[2] + s * e0[2] + t * e1[2];
+
+    float d[3];
+    vec3_sub(d, p, closest);
+    return sqrtf(vec3_dot(d, d));
+}
+
+int
+dc_tri_ray_x_hit(const float *p, const float *v0, const float *v1, const float *v2)
+{
+    float e1[3], e2[3], h[3], s[3], q[3];
+    float dir[3] = {1, 0, 0}; /* +X ray */
+
+    vec3_sub(e1, v1, v0);
+    vec3_sub(e2, v2, v0);
+    vec3_cross(h, dir, e2);
+    float a = vec3_dot(e1, h);
+    if (fabsf(a) < 1e-8f) return 0;
+
+    float f = 1.0f / a;
+    vec3_sub(s, p, v0);
+    float u = f * vec3_dot(s, h);
+    if (u < 0.0f || u > 1.0f) return 0;
+
+    vec3_cross(q, s, e1);
+    float v = f * vec3_dot(dir, q);
+    if (v < 0.0f || u + v > 1.0f) return 0;
+
+    float t = f * vec3_dot(e2, q);
+    return t > 1e-6f ? 1 : 0;
+}
+
+float
+dc_tri_solid_angle(const float *p, const float *v0, const float *v1, const float *v2)
+{
+    /* Van Oosterom & Strackee. Accumulate in double: the denominator
+     * cancels badly for points close to the triangle plane. */
+    double a[3], b[3], c[3];
+    for (int k = 0; k < 3; k++) {
+        a[k] = (double)v0[k] - p[k];
+        b[k] = (double)v1[k] - p[k];
+        c[k] = (double)v2[k] - p[k];
+    }
+    double la = sqrt(a[0]*a[0] + a[1]*a[1] + a[2]*a[2]);
+    double lb = sqrt(b[0]*b[0] + b[1]*b[1] + b[2]*b[2]);
+    double lc = sqrt(c[0]*c[0] + c[1]*c[1] + c[2]*c[2]);
+
+    double det = a[0] * (b[1]*c[2] - b[2]*c[1])
+               - a[1] * (b[0]*c[2] - b[2]*c[0])
+               + a[2] * (b[0]*c[1] - b[1]*c[0]);
+    double ab = a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+    double bc = b[0]*c[0] + b[1]*c[1] + b[2]*c[2];
+    double ca = c[0]*a[0] + c[1]*a[1] + c[2]*a[2];
+    double den = la*lb*lc + ab*lc + bc*la + ca*lb;
+
+    return (float)(2.0 * atan2(det, den));
+}
+
+/* =========================================================================
+ * Build
+ * ========================================================================= */
+
+typedef struct {
+    const float *data;      /* caller's 12-float triangles */
+    float       *tri_min;   /* 3 per triangle, padded */
+    float       *tri_max;
+    float       *centroid;  /* 3 per triangle */
+    int         *idx;       /* permutation, partitioned in place */
+    BvhNode     *nodes;
+    int          node_count;
+    int          depth;
+} BvhBuild;
+
+static float
+box_area(const float *mn, const float *mx)
+{
+    float dx = mx[0] - mn[0], dy = mx[1] - mn[1], dz = mx[2] - mn[2];
+    if (dx < 0 || dy < 0 || dz < 0) return 0.0f;
+    return dx*dy + dy*dz + dz*dx;
+}
+
+static void
+box_grow(float *mn, float *mx, const float *bmn, const float *bmx)
+{
+    for (int a = 0; a < 3; a++) {
+        if (bmn[a] < mn[a]) mn[a] = bmn[a];
+        if (bmx[a] > mx[a]) mx[a] = bmx[a];
+    }
+}
+
+static void
+build_node(BvhBuild *b, int ni, int first, int count, int depth)
+{
+    BvhNode *node = &b->nodes[ni];
+    float cmin[3] = { 1e30f, 1e30f, 1e30f};
+    float cmax[3] = {-1e30f,-1e30f,-1e30f};
+
+    for (int a = 0; a < 3; a++) { node->bmin[a] = 1e30f; node->bmax[a] = -1e30f; }
+    for (int i = first; i < first + count; i++) {
+        int t = b->idx[i];
+        box_grow(node->bmin, node->bmax, b->tri_min + t*3, b->tri_max + t*3);
+        box_grow(cmin, cmax, b->centroid + t*3, b->centroid + t*3);
+    }
+
+    if (depth > b->depth) b->depth = depth;
+
+    if (count <= DC_TRI_BVH_LEAF_MAX || depth >= DC_TRI_BVH_MAX_DEPTH) {
+        node->first = first;
+        node->count = count;
+        return;
+    }
+
+    /* Longest centroid axis */
+    int axis = 0;
+    float ext[3] = { cmax[0]-cmin[0], cmax[1]-cmin[1], cmax[2]-cmin[2] };
+    if (ext[1] > ext[axis]) axis = 1;
+    if (ext[2] > ext[axis]) axis = 2;
+
+    int mid = -1;
+    if (ext[axis] > 0.0f) {
+        int   bin_n[DC_TRI_BVH_BINS];
+        float bin_min[DC_TRI_BVH_BINS][3], bin_max[DC_TRI_BVH_BINS][3];
+        for (int k = 0; k < DC_TRI_BVH_BINS; k++) {
+            bin_n[k] = 0;
+            for (int a = 0; a < 3; a++) { bin_min[k][a] = 1e30f; bin_max[k][a] = -1e30f; }
+        }
+
+        float scale = (float)DC_TRI_BVH_BINS / ext[axis];
+        for (int i = first; i < first + count; i++) {
+            int t = b->idx[i];
+            int k = (int)((b->centroid[t*3 + axis] - cmin[axis]) * scale);
+            if (k >= DC_TRI_BVH_BINS) k = DC_TRI_BVH_BINS - 1;
+            if (k < 0) k = 0;
+            bin_n[k]++;
+            box_grow(bin_min[k], bin_max[k], b->tri_min + t*3, b->tri_max + t*3);
+        }
+
+        /* Sweep from the right to get suffix areas, then from the left */
+        float right_area[DC_TRI_BVH_BINS];
+        int   right_n[DC_TRI_BVH_BINS];
+        float rmn[3] = { 1e30f, 1e30f, 1e30f}, rmx[3] = {-1e30f,-1e30f,-1e30f};
+        int rn = 0;
+        for (int k = DC_TRI_BVH_BINS - 1; k > 0; k--) {
+            rn += bin_n[k];
+            if (bin_n[k]) box_grow(rmn, rmx, bin_min[k], bin_max[k]);
+            right_n[k] = rn;
+            right_area[k] = box_area(rmn, rmx);
+        }
+
+        float lmn[3] = { 1e30f, 1e30f, 1e30f}, lmx[3] = {-1e30f,-1e30f,-1e30f};
+        int ln = 0;
+        float best_cost = 1e30f;
+        int best_split = -1;
+        for (int k = 0; k < DC_TRI_BVH_BINS - 1; k++) {
+            ln += bin_n[k];
+            if (bin_n[k]) box_grow(lmn, lmx, bin_min[k], bin_max[k]);
+            if (ln == 0 || right_n[k+1] == 0) continue;
+            float cost = box_area(lmn, lmx) * (float)ln +
+                         right_area[k+1] * (float)right_n[k+1];
+            if (cost < best_cost) { best_cost = cost; best_split = k; }
+        }
+
+        if (best_split >= 0) {
+            /* Partition idx[first..first+count) by bin */
+            int lo = first, hi = first + count - 1;
+            while (lo <= hi) {
+                int t = b->idx[lo];
+                int k = (int)((b->centroid[t*3 + axis] - cmin[axis]) * scale);
+                if (k >= DC_TRI_BVH_BINS) k = DC_TRI_BVH_BINS - 1;
+                if (k < 0) k = 0;
+                if (k <= best_split) {
+                    lo++;
+                } else {
+                    b->idx[lo] = b->idx[hi];
+                    b->idx[hi] = t;
+                    hi--;
+                }
+            }
+            mid = lo;
+        }
+    }
+
+    /* Binning could not separate (coincident centroids) — halve by index */
+    if (mid <= first || mid >= first + count)
+        mid = first + count / 2;
+
+    int left = b->node_count;
+    b->node_count += 2;
+    node->first = left;
+    node->count = 0;
+
+    build_node(b, left,     first, mid - first,         depth + 1);
+    build_node(b, left + 1, mid,   first + count - mid, depth + 1);
+}
+
+/* Children are always allocated after their parent, so a reverse sweep
+ * over the node array visits every child before its parent. */
+static void
+build_moments(DC_TriBvh *bvh)
+{
+    for (int ni = bvh->node_count - 1; ni >= 0; ni--) {
+        const BvhNode *node = &bvh->nodes[ni];
+        BvhMoment *m = &bvh->moments[ni];
+        double area = 0.0, c[3] = {0, 0, 0}, n[3] = {0, 0, 0};
+
+        if (node->count > 0) {
+            for (int i = node->first; i < node->first + node->count; i++) {
+                const float *v = bvh->tris + (size_t)i * 9;
+                float e1[3], e2[3], x[3];
+                vec3_sub(e1, v + 3, v);
+                vec3_sub(e2, v + 6, v);
+                vec3_cross(x, e1, e2);
+                double a = 0.5 * sqrt((double)vec3_dot(x, x));
+                for (int k = 0; k < 3; k++) {
+                    n[k] += 0.5 * x[k];
+                    c[k] += a * (v[k] + v[3+k] + v[6+k]) / 3.0;
+                }
+                area += a;
+            }
+        } else {
+            for (int ci = node->first; ci <= node->first + 1; ci++) {
+                const BvhMoment *cm = &bvh->moments[ci];
+                double a = cm->area;
+                for (int k = 0; k < 3; k++) {
+                    n[k] += cm->n[k];
+                    c[k] += a * cm->c[k];
+                }
+                area += a;
+            }
+        }
+
+        if (area > 0.0) {
+            for (int k = 0; k < 3; k++) m->c[k] = (float)(c[k] / area);
+        } else {
+            /* Only degenerate triangles: use the box centre */
+            for (int k = 0; k < 3; k++)
+                m->c[k] = 0.5f * (node->bmin[k] + node->bmax[k]);
+        }
+        for (int k = 0; k < 3; k++) m->n[k] = (float)n[k];
+        m->area = (float)area;
+
+        /* Radius: exact over leaf vertices, bounded via children above */
+        float r = 0.0f;
+        if (node->count > 0) {
+            for (int i = node->first; i < node->first + node->count; i++) {
+                const float *v = bvh->tris + (size_t)i * 9;
+                for (int j = 0; j < 3; j++) {
+                    float d[3];
+                    vec3_sub(d, v + j * 3, m->c);
+                    float dd = sqrtf(vec3_dot(d, d));
+                    if (dd > r) r = dd;
+                }
+            }
+        } else {
+            for (int ci = node->first; ci <= node->first + 1; ci++) {
+                const BvhMoment *cm = &bvh->moments[ci];
+                float d[3];
+                vec3_sub(d, cm->c, m->c);
+                float dd = sqrtf(vec3_dot(d, d)) + cm->r;
+                if (dd > r) r = dd;
+            }
+        }
+        m->r = r;
+    }
+}
+
+DC_TriBvh *
+dc_tri_bvh_build(const float *data, int num_triangles)
+{
+    if (!data || num_triangles <= 0) return NULL;
+
+    DC_TriBvh *bvh = calloc(1, sizeof(DC_TriBvh));
+    if (!bvh) return NULL;
+
+    size_t n = (size_t)num_triangles;
+    BvhBuild b = {0};
+    b.data     = data;
+    b.tri_min  = malloc(n * 3 * sizeof(float));
+    b.tri_max  = malloc(n * 3 * sizeof(float));
+    b.centroid = malloc(n * 3 * sizeof(float));
+    b.idx      = malloc(n * sizeof(int));
+    b.nodes    = malloc((2 * n) * sizeof(BvhNode));
+    bvh->tris  = malloc(n * 9 * sizeof(float));
+
+    if (!b.tri_min || !b.tri_max || !b.centroid || !b.idx || !b.nodes ||
+        !bvh->tris) {
+        free(b.tri_min); free(b.tri_max); free(b.centroid);
+        free(b.idx); free(b.nodes);
+        free(bvh->tris); free(bvh);
+        return NULL;
+    }
+
+    /* Scene-relative padding (see file comment) */
+    float max_abs = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        const float *v = data + i * 12 + 3;
+        for (int k = 0; k < 9; k++)
+            if (fabsf(v[k]) > max_abs) max_abs = fabsf(v[k]);
+    }
+    float pad = max_abs * 1e-5f + 1e-12f;
+
+    for (size_t i = 0; i < n; i++) {
+        const float *v = data + i * 12 + 3;
+        for (int a = 0; a < 3; a++) {
+            float lo = v[a], hi = v[a];
+            if (v[3+a] < lo) lo = v[3+a];
+            if (v[3+a] > hi) hi = v[3+a];
+            if (v[6+a] < lo) lo = v[6+a];
+            if (v[6+a] > hi) hi = v[6+a];
+            b.tri_min[i*3 + a] = lo - pad;
+            b.tri_max[i*3 + a] = hi + pad;
+            b.centroid[i*3 + a] = (v[a] + v[3+a] + v[6+a]) * (1.0f / 3.0f);
+        }
+        b.idx[i] = (int)i;
+    }
+
+    b.node_count = 1;
+    build_node(&b, 0, 0, num_triangles, 0);
+
+    /* Copy vertices into leaf order */
+    for (size_t i = 0; i < n; i++)
+        memcpy(bvh->tris + i * 9, data + (size_t)b.idx[i] * 12 + 3,
+               9 * sizeof(float));
+
+    bvh->nodes = b.nodes;
+    bvh->node_count = b.node_count;
+    bvh->tri_count = num_triangles;
+    bvh->depth = b.depth;
+
+    /* Shrink node array to what was used */
+    BvhNode *shrunk = realloc(bvh->nodes, (size_t)b.node_count * sizeof(BvhNode));
+    if (shrunk) bvh->nodes = shrunk;
+
+    free(b.tri_min);
+    free(b.tri_max);
+    free(b.centroid);
+    free(b.idx);
+
+    bvh->moments = malloc((size_t)bvh->node_count * sizeof(BvhMoment));
+    if (!bvh->moments) {
+        dc_tri_bvh_free(bvh);
+        return NULL;
+    }
+    build_moments(bvh);
+    return bvh;
+}
+
+void
+dc_tri_bvh_free(DC_TriBvh *bvh)
+{
+    if (!bvh) return;
+    free(bvh->nodes);
+    free(bvh->moments);
+    free(bvh->tris);
+    free(bvh);
+}
+
+int
+dc_tri_bvh_node_count(const DC_TriBvh *bvh)
+{
+    return bvh ? bvh->node_count : 0;
+}
+
+int
+dc_tri_bvh_depth(const DC_TriBvh *bvh)
+{
+    return bvh ? bvh->depth : 0;
+}
+
+/* =========================================================================
+ * Queries
+ * ========================================================================= */
+
+static float
+box_dist2(const BvhNode *node, const float *p)
+{
+    float d2 = 0.0f;
+    for (int a = 0; a < 3; a++) {
+        float d = 0.0f;
+        if (p[a] < node->bmin[a])      d = node->bmin[a] - p[a];
+        else if (p[a] > node->bmax[a]) d = p[a] - node->bmax[a];
+        d2 += d * d;
+    }
+    return d2;
+}
+
+float
+dc_tri_bvh_closest(const DC_TriBvh *bvh, const float *p)
+{
+    float best = 1e18f;
+    if (!bvh || bvh->tri_count <= 0) return best;
+
+    int stack[DC_TRI_BVH_STACK];
+    int sp = 0;
+    stack[sp++] = 0;
+
+    while (sp > 0) {
+        const BvhNode *node = &bvh->nodes[stack[--sp]];
+        if (box_dist2(node, p) > best * best) continue;
+
+        if (node->count > 0) {
+            for (int i = node->first; i < node->first + node->count; i++) {
+                const float *v = bvh->tris + (size_t)i * 9;
+                float d = dc_tri_point_dist(p, v, v + 3, v + 6);
+                if (d < best) best = d;
+            }
+            continue;
+        }
+
+        /* Visit the nearer child first: push it last */
+        int l = node->first, r = node->first + 1;
+        float dl = box_dist2(&bvh->nodes[l], p);
+        float dr = box_dist2(&bvh->nodes[r], p);
+        if (dl <= dr) {
+            if (dr <= best * best) stack[sp++] = r;
+            if (dl <= best * best) stack[sp++] = l;
+        } else {
+            if (dl <= best * best) stack[sp++] = l;
+            if (dr <= best * best) stack[sp++] = r;
+        }
+    }
+
+    return best;
+}
+
+int
+dc_tri_bvh_ray_x_crossings(const DC_TriBvh *bvh, const float *p)
+{
+    if (!bvh || bvh->tri_count <= 0) return 0;
+
+    int crossings = 0;
+    int stack[DC_TRI_BVH_STACK];
+    int sp = 0;
+    stack[sp++] = 0;
+
+    while (sp > 0) {
+        const BvhNode *node = &bvh->nodes[stack[--sp]];
+
+        /* +X ray: the slab test reduces to a YZ containment check
+         * plus "box not entirely behind p". */
+        if (p[1] < node->bmin[1] || p[1] > node->bmax[1] ||
+            p[2] < node->bmin[2] || p[2] > node->bmax[2] ||
+            p[0] > node->bmax[0])
+            continue;
+
+        if (node->count > 0) {
+            for (int i = node->first; i < node->first + node->count; i++) {
+                const float *v = bvh->tris + (size_t)i * 9;
+                crossings += dc_tri_ray_x_hit(p, v, v + 3, v + 6);
+            }
+            continue;
+        }
+
+        stack[sp++] = node->first;
+        stack[sp++] = node->first + 1;
+    }
+
+    return crossings;
+}
+
+float
+dc_tri_bvh_winding_number(const DC_TriBvh *bvh, const float *p, float beta)
+{
+    if (!bvh || bvh->tri_count <= 0) return 0.0f;
+    if (beta <= 0.0f) beta = DC_TRI_BVH_WINDING_BETA;
+
+    double omega = 0.0;
+    int stack[DC_TRI_BVH_STACK];
+    int sp = 0;
+    stack[sp++] = 0;
+
+    while (sp > 0) {
+        int ni = stack[--sp];
+        const BvhNode *node = &bvh->nodes[ni];
+        const BvhMoment *m = &bvh->moments[ni];
+
+        float d[3];
+        vec3_sub(d, m->c, p);
+        float d2 = vec3_dot(d, d);
+        if (d2 > beta * beta * m->r * m->r) {
+            /* Far field: solid angle of a dipole of strength n at c */
+            float dl = sqrtf(d2);
+            omega += (double)vec3_dot(d, m->n) / ((double)d2 * dl);
+            continue;
+        }
+
+        if (node->count > 0) {
+            for (int i = node->first; i < node->first + node->count; i++) {
+                const float *v = bvh->tris + (size_t)i * 9;
+                omega += dc_tri_solid_angle(p, v, v + 3, v + 6);
+            }
+            continue;
+        }
+
+        stack[sp++] = node->first;
+        stack[sp++] = node->first + 1;
+    }
+
+    return (float)(omega / (4.0 * M_PI));
+}
@@ -0,0 +1,77 @@
+#ifndef DC_TRI_BVH_H
+#define DC_TRI_BVH_H
+
+/*
+ * tri_bvh.h — Bounding volume hierarchy over a triangle soup.
+ *
+ * Accelerates the per-voxel queries the STL voxelizer needs:
+ *   - unsigned distance to the closest triangle
+ *   - number of triangles crossed by a +X ray (inside/outside parity)
+ *   - generalized winding number (inside/outside for meshes with holes,
+ *     cracks or duplicated faces)
+ *
+ * Built once per mesh with a binned SAH split, then queried read-only.
+ * Queries do not mutate the tree, so one BVH can be shared by any
+ * number of threads.
+ *
+ * The brute-force helpers are exported too so callers can keep an
+ * exact reference path; both paths use the same per-triangle math and
+ * therefore produce identical results.
+ *
+ * No GTK dependency.
+ */
+
+/* -------------------------------------------------------------------------
+ * DC_TriBvh — opaque, immutable after build
+ * ---------------------------------------------------------------------- */
+typedef struct DC_TriBvh DC_TriBvh;
+
+/* Build a BVH from interleaved STL triangle data (12 floats per triangle:
+ * nx,ny,nz, v0xyz, v1xyz, v2xyz). The vertex data is copied; the caller
+ * keeps ownership of data. Returns NULL on bad args or allocation failure. */
+DC_TriBvh *dc_tri_bvh_build(const float *data, int num_triangles);
+
+/* Free the BVH. Safe with NULL. */
+void dc_tri_bvh_free(DC_TriBvh *bvh);
+
+/* Unsigned distance from p to the closest triangle.
+ * Returns 1e18f if the BVH is empty. */
+float dc_tri_bvh_closest(const DC_TriBvh *bvh, const float *p);
+
+/* Count triangles hit by the ray from p in the +X direction. */
+int dc_tri_bvh_ray_x_crossings(const DC_TriBvh *bvh, const float *p);
+
+/* Default accuracy for dc_tri_bvh_winding_number. A subtree is replaced
+ * by its dipole once the query point is beta bounding-radii away. */
+#define DC_TRI_BVH_WINDING_BETA 3.0f
+
+/* Generalized winding number of the mesh at p: the summed signed solid
+ * angle of all triangles over 4*pi. ~1 inside a closed outward-facing
+ * mesh, ~0 outside, and degrades smoothly across holes. Distant subtrees
+ * use a dipole approximation; beta <= 0 selects DC_TRI_BVH_WINDING_BETA,
+ * larger values trade speed for accuracy. */
+float dc_tri_bvh_winding_number(const DC_TriBvh *bvh, const float *p,
+                                  float beta);
+
+/* Tree statistics (for logging and benchmarks). */
+int dc_tri_bvh_node_count(const DC_TriBvh *bvh);
+int dc_tri_bvh_depth(const DC_TriBvh *bvh);
+
+/* =========================================================================
+ * Per-triangle primitives (shared with the brute-force path)
+ * ========================================================================= */
+
+/* Unsigned distance from point p to triangle (v0, v1, v2). */
+float dc_tri_point_dist(const float *p, const float *v0,
+                          const float *v1, const float *v2);
+
+/* 1 if the ray from p in +X hits triangle (v0, v1, v2), else 0. */
+int dc_tri_ray_x_hit(const float *p, const float *v0,
+                       const float *v1, const float *v2);
+
+/* Signed solid angle subtended by triangle (v0, v1, v2) at p, in
+ * steradians. Positive when p is behind the counter-clockwise face. */
+float dc_tri_solid_angle(const float *p, const float *v0,
+                           const float *v1, const float *v2);
+
+#endif /* DC_TRI_BVH_H */
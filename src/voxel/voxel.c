@@ -21,13 +21,61 @@
 /* =========================================================================
  * Internal structure
  * ========================================================================= */
+
+/* Sparse bricks are DC_VOXEL_BRICK^3 cells, indexed with shifts */
+#define BRICK_SHIFT 3
+#define BRICK_MASK  (DC_VOXEL_BRICK - 1)
+#define BRICK_CELLS (DC_VOXEL_BRICK * DC_VOXEL_BRICK * DC_VOXEL_BRICK)
+_Static_assert((1 << BRICK_SHIFT) == DC_VOXEL_BRICK, "brick shift");
+
 struct DC_VoxelGrid {
     int       sx, sy, sz;   /* grid dimensions in cells */
     float     cell_size;    /* world units per cell */
     float     origin[3];    /* world-space position of cell (0,0,0) */
-    DC_Voxel *cells;        /* flat array: cells[ix + iy*sx + iz*sx*sy] */
+    DC_Voxel *cells;        /* AoS: cells[ix + iy*sx + iz*sx*sy]; else NULL */
+
+    /* SoA: planes in the same cell order. act and rgb stay NULL (all
+     * inactive / black) until something writes them. A quantized grid
+     * holds its distances in qdist (format qfmt, int8 range qrange)
+     * instead of dist. */
+    float    *dist;
+    uint8_t  *act;
+    uint8_t  *rgb;
+    void     *qdist;
+    int       qfmt;
+    float     qrange;
+
+    /* Sparse: tile t = tx + ty*ntx + tz*ntx*nty holds bricks[t], or the
+     * constant tiles[t] while bricks[t] is NULL. */
+    int        ntx, nty, ntz;
+    DC_Voxel **bricks;
+    DC_Voxel  *tiles;
+    size_t     nbricks;
+    float      band;
+
+    /* Wrapped SoA planes (dc_voxel_grid_wrap_soa): bit 0 dist, 1 act,
+     * 2 rgb are not ours to free; ext_release(ext_ctx) runs instead. */
+    unsigned   ext_planes;
+    void     (*ext_release)(void *ctx);
+    void      *ext_ctx;
 };
 
+enum { EXT_DIST = 1, EXT_ACT = 2, EXT_RGB = 4 };
+
+static const DC_Voxel EMPTY_VOXEL = { 0, 0, 0, 0, HUGE_VALF };
+
+static inline int
+is_soa(const DC_VoxelGrid *g)
+{
+    return g->dist || g->qdist;
+}
+
+static size_t
+dist_bytes(int fmt)
+{
+    return fmt == DC_VOXEL_DIST_F16 ? 2 : fmt == DC_VOXEL_DIST_I8 ? 1 : 4;
+}
+
 static inline int
 in_bounds(const DC_VoxelGrid *g, int ix, int iy, int iz)
 {
@@ -43,6 +91,126 @@ cell_index(const DC_VoxelGrid *g, int ix, int iy, int iz)
            (size_t)iz * (size_t)g->sx * (size_t)g->sy;
 }
 
+static inline size_t
+tile_index(const DC_VoxelGrid *g, int tx, int ty, int tz)
+{
+    return (size_t)tx + (size_t)ty * (size_t)g->ntx +
+           (size_t)tz * (size_t)g->ntx * (size_t)g->nty;
+}
+
+static inline size_t
+brick_offset(int ix, int iy, int iz)
+{
+    return (size_t)(ix & BRICK_MASK) |
+           (size_t)(iy & BRICK_MASK) << BRICK_SHIFT |
+           (size_t)(iz & BRICK_MASK) << (2 * BRICK_SHIFT);
+}
+
+static inline size_t
+grid_total(const DC_VoxelGrid *g)
+{
+    return (size_t)g->sx * (size_t)g->sy * (size_t)g->sz;
+}
+
+/* Cell lookup without allocation for AoS and sparse grids; caller checks
+ * bounds. */
+static inline const DC_Voxel *
+cell_const(const DC_VoxelGrid *g, int ix, int iy, int iz)
+{
+    if (g->cells) return &g->cells[cell_index(g, ix, iy, iz)];
+    size_t t = tile_index(g, ix >> BRICK_SHIFT, iy >> BRICK_SHIFT,
+                          iz >> BRICK_SHIFT);
+    return g->bricks[t] ? &g->bricks[t][brick_offset(ix, iy, iz)]
+                        : &g->tiles[t];
+}
+
+/* Decoded distance at index idx of a quantized plane. */
+static inline float
+qdist_at(const DC_VoxelGrid *g, size_t idx)
+{
+    if (g->qfmt == DC_VOXEL_DIST_F16)
+        return dc_voxel_half_to_float(((const uint16_t *)g->qdist)[idx]);
+    return (float)((const int8_t *)g->qdist)[idx] * (g->qrange / 127.0f);
+}
+
+/* Distance of an in-bounds cell, any mode. */
+static inline float
+cell_distance(const DC_VoxelGrid *g, int ix, int iy, int iz)
+{
+    if (g->dist) return g->dist[cell_index(g, ix, iy, iz)];
+    if (g->qdist) return qdist_at(g, cell_index(g, ix, iy, iz));
+    return cell_const(g, ix, iy, iz)->distance;
+}
+
+/* Give a quantized grid back its float plane before a write. Returns
+ * -1 (grid unchanged) if the plane cannot be allocated. */
+static int
+dequantize(DC_VoxelGrid *g)
+{
+    if (!g->qdist) return 0;
+    size_t total = grid_total(g);
+    float *dist = malloc(total * sizeof(float));
+    if (!dist) return -1;
+    for (size_t i = 0; i < total; i++)
+        dist[i] = qdist_at(g, i);
+    if (!(g->ext_planes & EXT_DIST)) free(g->qdist);
+    g->ext_planes &= ~(unsigned)EXT_DIST;
+    g->qdist = NULL;
+    g->qfmt = DC_VOXEL_DIST_F32;
+    g->dist = dist;
+    return 0;
+}
+
+/* Lazily allocated zeroed SoA plane of `per_cell` bytes per cell. */
+static uint8_t *
+plane_alloc(const DC_VoxelGrid *g, uint8_t **plane, size_t per_cell)
+{
+    if (!*plane) *plane = calloc(grid_total(g), per_cell);
+    return *plane;
+}
+
+/* Store a whole voxel into an SoA grid. Active and color planes are only
+ * allocated once a nonzero value has to be stored. Returns -1 if a plane
+ * could not be allocated. */
+static int
+soa_store(DC_VoxelGrid *g, size_t idx, DC_Voxel v)
+{
+    g->dist[idx] = v.distance;
+    if (v.active || g->act) {
+        if (!plane_alloc(g, &g->act, 1)) return -1;
+        g->act[idx] = v.active;
+    }
+    if (v.r || v.g || v.b || g->rgb) {
+        if (!plane_alloc(g, &g->rgb, 3)) return -1;
+        g->rgb[idx*3+0] = v.r; g->rgb[idx*3+1] = v.g; g->rgb[idx*3+2] = v.b;
+    }
+    return 0;
+}
+
+/* Materialize a constant tile. Returns NULL on allocation failure. */
+static DC_Voxel *
+brick_alloc(DC_VoxelGrid *g, size_t t)
+{
+    DC_Voxel *b = malloc(BRICK_CELLS * sizeof(DC_Voxel));
+    if (!b) return NULL;
+    for (int i = 0; i < BRICK_CELLS; i++) b[i] = g->tiles[t];
+    g->bricks[t] = b;
+    g->nbricks++;
+    return b;
+}
+
+/* Cell range of tile (tx,ty,tz) along each axis, clipped to the grid. */
+static void
+tile_range(const DC_VoxelGrid *g, int tx, int ty, int tz, int *lo, int *hi)
+{
+    int t[3] = { tx, ty, tz }, dim[3] = { g->sx, g->sy, g->sz };
+    for (int a = 0; a < 3; a++) {
+        lo[a] = t[a] * DC_VOXEL_BRICK;
+        hi[a] = lo[a] + DC_VOXEL_BRICK;
+        if (hi[a] > dim[a]) hi[a] = dim[a];
+    }
+}
+
 /* =========================================================================
  * Lifecycle
  * ========================================================================= */
@@ -82,14 +250,212 @@ dc_voxel_grid_new(int sx, int sy, int sz, float cell_size)
     return g;
 }
 
+DC_VoxelGrid *
+dc_voxel_grid_new_sparse(int sx, int sy, int sz, float cell_size, float band)
+{
+    if (sx <= 0 || sy <= 0 || sz <= 0 || cell_size <= 0.0f || band < 0.0f)
+        return NULL;
+
+    DC_VoxelGrid *g = calloc(1, sizeof(DC_VoxelGrid));
+    if (!g) return NULL;
+
+    g->sx = sx;
+    g->sy = sy;
+    g->sz = sz;
+    g->cell_size = cell_size;
+    g->band = band;
+    g->ntx = (sx + DC_VOXEL_BRICK - 1) / DC_VOXEL_BRICK;
+    g->nty = (sy + DC_VOXEL_BRICK - 1) / DC_VOXEL_BRICK;
+    g->ntz = (sz + DC_VOXEL_BRICK - 1) / DC_VOXEL_BRICK;
+
+    /* The tile tables are the only up-front cost */
+    size_t ntiles = (size_t)g->ntx * (size_t)g->nty * (size_t)g->ntz;
+    size_t table_bytes = ntiles * (sizeof(DC_Voxel *) + sizeof(DC_Voxel));
+    if (table_bytes > DC_VOXEL_GRID_MAX_BYTES) {
+        DC_LOG_WARN_APP("sparse voxel grid alloc refused: %dx%dx%d cells "
+                        "(%.2f GiB of tiles) exceeds %.0f GiB cap",
+                        sx, sy, sz,
+                        (double)table_bytes / (1024.0*1024.0*1024.0),
+                        (double)DC_VOXEL_GRID_MAX_BYTES / (1024.0*1024.0*1024.0));
+        free(g);
+        return NULL;
+    }
+    g->bricks = calloc(ntiles, sizeof(DC_Voxel *));
+    g->tiles = malloc(ntiles * sizeof(DC_Voxel));
+    if (!g->bricks || !g->tiles) {
+        free(g->bricks);
+        free(g->tiles);
+        free(g);
+        return NULL;
+    }
+    for (size_t t = 0; t < ntiles; t++)
+        g->tiles[t] = EMPTY_VOXEL;
+
+    return g;
+}
+
+DC_VoxelGrid *
+dc_voxel_grid_new_soa(int sx, int sy, int sz, float cell_size)
+{
+    if (sx <= 0 || sy <= 0 || sz <= 0 || cell_size <= 0.0f)
+        return NULL;
+
+    DC_VoxelGrid *g = calloc(1, sizeof(DC_VoxelGrid));
+    if (!g) return NULL;
+
+    g->sx = sx;
+    g->sy = sy;
+    g->sz = sz;
+    g->cell_size = cell_size;
+
+    /* Cap all three planes together: 8 bytes per cell, as for AoS */
+    size_t total = grid_total(g);
+    size_t total_bytes = total * sizeof(DC_Voxel);
+    if (total_bytes / sizeof(DC_Voxel) != total ||
+        total_bytes > DC_VOXEL_GRID_MAX_BYTES) {
+        DC_LOG_WARN_APP("voxel grid alloc refused: %dx%dx%d cells "
+                        "(%.2f GiB) exceeds %.0f GiB cap",
+                        sx, sy, sz,
+                        (double)total_bytes / (1024.0*1024.0*1024.0),
+                        (double)DC_VOXEL_GRID_MAX_BYTES / (1024.0*1024.0*1024.0));
+        free(g);
+        return NULL;
+    }
+    g->dist = malloc(total * sizeof(float));
+    if (!g->dist) { free(g); return NULL; }
+    for (size_t i = 0; i < total; i++)
+        g->dist[i] = HUGE_VALF;
+
+    return g;
+}
+
+DC_VoxelGrid *
+dc_voxel_grid_wrap_soa(int sx, int sy, int sz, float cell_size,
+                         DC_VoxelDistFormat fmt, float range, void *dist,
+                         uint8_t *act, uint8_t *rgb,
+                         void (*release)(void *ctx), void *ctx)
+{
+    if (sx <= 0 || sy <= 0 || sz <= 0 || cell_size <= 0.0f || !dist ||
+        (fmt == DC_VOXEL_DIST_I8 && !(range > 0.0f)))
+        return NULL;
+
+    DC_VoxelGrid *g = calloc(1, sizeof(DC_VoxelGrid));
+    if (!g) return NULL;
+
+    g->sx = sx;
+    g->sy = sy;
+    g->sz = sz;
+    g->cell_size = cell_size;
+    if (fmt == DC_VOXEL_DIST_F32) {
+        g->dist = dist;
+    } else {
+        g->qdist = dist;
+        g->qfmt = fmt;
+        g->qrange = range;
+    }
+    g->act = act;
+    g->rgb = rgb;
+    g->ext_planes = EXT_DIST | (act ? EXT_ACT : 0) | (rgb ? EXT_RGB : 0);
+    g->ext_release = release;
+    g->ext_ctx = ctx;
+    return g;
+}
+
+int
+dc_voxel_grid_is_wrapped(const DC_VoxelGrid *g)
+{
+    return g && g->ext_planes;
+}
+
+static void
+free_bricks(DC_VoxelGrid *g)
+{
+    size_t ntiles = (size_t)g->ntx * (size_t)g->nty * (size_t)g->ntz;
+    for (size_t t = 0; t < ntiles && g->nbricks > 0; t++) {
+        if (!g->bricks[t]) continue;
+        free(g->bricks[t]);
+        g->bricks[t] = NULL;
+        g->nbricks--;
+    }
+}
+
 void
 dc_voxel_grid_free(DC_VoxelGrid *g)
 {
     if (!g) return;
+    if (g->bricks) free_bricks(g);
+    free(g->bricks);
+    free(g->tiles);
     free(g->cells);
+    if (!(g->ext_planes & EXT_DIST)) { free(g->dist); free(g->qdist); }
+    if (!(g->ext_planes & EXT_ACT))  free(g->act);
+    if (!(g->ext_planes & EXT_RGB))  free(g->rgb);
+    if (g->ext_release) g->ext_release(g->ext_ctx);
     free(g);
 }
 
+DC_VoxelGrid *
+dc_voxel_grid_copy(const DC_VoxelGrid *src)
+{
+    if (!src) return NULL;
+    DC_VoxelGrid *g;
+    if (src->cells)
+        g = dc_voxel_grid_new(src->sx, src->sy, src->sz, src->cell_size);
+    else if (is_soa(src))
+        g = dc_voxel_grid_new_soa(src->sx, src->sy, src->sz, src->cell_size);
+    else
+        g = dc_voxel_grid_new_sparse(src->sx, src->sy, src->sz,
+                                     src->cell_size, src->band);
+    if (!g) return NULL;
+    memcpy(g->origin, src->origin, sizeof(g->origin));
+    g->band = src->band;
+    if (src->cells) {
+        memcpy(g->cells, src->cells, grid_total(src) * sizeof(DC_Voxel));
+        return g;
+    }
+    if (is_soa(src)) {
+        size_t total = grid_total(src);
+        if (src->qdist) {
+            /* Stay quantized: swap the float plane for a packed copy */
+            void *q = malloc(total * dist_bytes(src->qfmt));
+            if (!q) {
+                dc_voxel_grid_free(g);
+                return NULL;
+            }
+            memcpy(q, src->qdist, total * dist_bytes(src->qfmt));
+            free(g->dist);
+            g->dist = NULL;
+            g->qdist = q;
+            g->qfmt = src->qfmt;
+            g->qrange = src->qrange;
+        } else {
+            memcpy(g->dist, src->dist, total * sizeof(float));
+        }
+        if ((src->act && !plane_alloc(g, &g->act, 1)) ||
+            (src->rgb && !plane_alloc(g, &g->rgb, 3))) {
+            dc_voxel_grid_free(g);
+            return NULL;
+        }
+        if (src->act) memcpy(g->act, src->act, total);
+        if (src->rgb) memcpy(g->rgb, src->rgb, total * 3);
+        return g;
+    }
+
+    size_t ntiles = (size_t)src->ntx * (size_t)src->nty * (size_t)src->ntz;
+    memcpy(g->tiles, src->tiles, ntiles * sizeof(DC_Voxel));
+    for (size_t t = 0; t < ntiles; t++) {
+        if (!src->bricks[t]) continue;
+        g->bricks[t] = malloc(BRICK_CELLS * sizeof(DC_Voxel));
+        if (!g->bricks[t]) {
+            dc_voxel_grid_free(g);
+            return NULL;
+        }
+        memcpy(g->bricks[t], src->bricks[t], BRICK_CELLS * sizeof(DC_Voxel));
+        g->nbricks++;
+    }
+    return g;
+}
+
 /* =========================================================================
  * Dimensions
  * ========================================================================= */
@@ -132,29 +498,98 @@ dc_voxel_grid_bounds(const DC_VoxelGrid *g,
 DC_Voxel *
 dc_voxel_grid_get(DC_VoxelGrid *g, int ix, int iy, int iz)
 {
-    if (!g || !in_bounds(g, ix, iy, iz)) return NULL;
-    return &g->cells[cell_index(g, ix, iy, iz)];
+    if (!g || is_soa(g) || !in_bounds(g, ix, iy, iz)) return NULL;
+    if (g->cells) return &g->cells[cell_index(g, ix, iy, iz)];
+
+    size_t t = tile_index(g, ix >> BRICK_SHIFT, iy >> BRICK_SHIFT,
+                          iz >> BRICK_SHIFT);
+    DC_Voxel *b = g->bricks[t] ? g->bricks[t] : brick_alloc(g, t);
+    return b ? &b[brick_offset(ix, iy, iz)] : NULL;
 }
 
 const DC_Voxel *
 dc_voxel_grid_get_const(const DC_VoxelGrid *g, int ix, int iy, int iz)
 {
-    if (!g || !in_bounds(g, ix, iy, iz)) return NULL;
-    return &g->cells[cell_index(g, ix, iy, iz)];
+    if (!g || is_soa(g) || !in_bounds(g, ix, iy, iz)) return NULL;
+    return cell_const(g, ix, iy, iz);
 }
 
 int
 dc_voxel_grid_set(DC_VoxelGrid *g, int ix, int iy, int iz, DC_Voxel voxel)
 {
-    if (!g || !in_bounds(g, ix, iy, iz)) return -1;
-    g->cells[cell_index(g, ix, iy, iz)] = voxel;
+    if (g && is_soa(g)) {
+        if (!in_bounds(g, ix, iy, iz) || dequantize(g) != 0) return -1;
+        return soa_store(g, cell_index(g, ix, iy, iz), voxel);
+    }
+    DC_Voxel *v = dc_voxel_grid_get(g, ix, iy, iz);
+    if (!v) return -1;
+    *v = voxel;
+    return 0;
+}
+
+int
+dc_voxel_grid_load(const DC_VoxelGrid *g, int ix, int iy, int iz,
+                     DC_Voxel *out)
+{
+    if (!g || !out || !in_bounds(g, ix, iy, iz)) return -1;
+    if (!is_soa(g)) {
+        *out = *cell_const(g, ix, iy, iz);
+        return 0;
+    }
+    size_t idx = cell_index(g, ix, iy, iz);
+    out->distance = g->dist ? g->dist[idx] : qdist_at(g, idx);
+    out->active = g->act ? g->act[idx] : 0;
+    out->r = g->rgb ? g->rgb[idx*3+0] : 0;
+    out->g = g->rgb ? g->rgb[idx*3+1] : 0;
+    out->b = g->rgb ? g->rgb[idx*3+2] : 0;
     return 0;
 }
 
+float
+dc_voxel_grid_distance(const DC_VoxelGrid *g, int ix, int iy, int iz)
+{
+    if (!g || !in_bounds(g, ix, iy, iz)) return HUGE_VALF;
+    return cell_distance(g, ix, iy, iz);
+}
+
+float *
+dc_voxel_grid_distance_ref(DC_VoxelGrid *g, int ix, int iy, int iz)
+{
+    if (!g || !in_bounds(g, ix, iy, iz)) return NULL;
+    if (is_soa(g) && dequantize(g) != 0) return NULL;
+    if (g->dist) return &g->dist[cell_index(g, ix, iy, iz)];
+    DC_Voxel *v = dc_voxel_grid_get(g, ix, iy, iz);
+    return v ? &v->distance : NULL;
+}
+
 void
 dc_voxel_grid_clear(DC_VoxelGrid *g)
 {
     if (!g) return;
+    if (is_soa(g)) {
+        size_t total = grid_total(g);
+        if (g->qdist && g->qfmt == DC_VOXEL_DIST_F16) {
+            uint16_t inf = dc_voxel_half_from_float(HUGE_VALF);
+            for (size_t i = 0; i < total; i++)
+                ((uint16_t *)g->qdist)[i] = inf;
+        } else if (g->qdist) {
+            memset(g->qdist, 127, total);
+        }
+        for (size_t i = 0; g->dist && i < total; i++)
+            g->dist[i] = HUGE_VALF;
+        if (!(g->ext_planes & EXT_ACT)) free(g->act);
+        if (!(g->ext_planes & EXT_RGB)) free(g->rgb);
+        g->act = g->rgb = NULL;
+        g->ext_planes &= ~(unsigned)(EXT_ACT | EXT_RGB);
+        return;
+    }
+    if (g->bricks) {
+        free_bricks(g);
+        size_t ntiles = (size_t)g->ntx * (size_t)g->nty * (size_t)g->ntz;
+        for (size_t t = 0; t < ntiles; t++)
+            g->tiles[t] = EMPTY_VOXEL;
+        return;
+    }
     size_t total = (size_t)g->sx * (size_t)g->sy * (size_t)g->sz;
     for (size_t i = 0; i < total; i++) {
         g->cells[i].active = 0;
@@ -167,13 +602,360 @@ size_t
 dc_voxel_grid_active_count(const DC_VoxelGrid *g)
 {
     if (!g) return 0;
-    size_t total = (size_t)g->sx * (size_t)g->sy * (size_t)g->sz;
     size_t count = 0;
+    if (is_soa(g)) {
+        if (!g->act) return 0;
+        size_t total = grid_total(g);
+        for (size_t i = 0; i < total; i++)
+            count += g->act[i] != 0;
+        return count;
+    }
+    if (g->bricks) {
+        for (int tz = 0; tz < g->ntz; tz++)
+        for (int ty = 0; ty < g->nty; ty++)
+        for (int tx = 0; tx < g->ntx; tx++) {
+            int lo[3], hi[3];
+            tile_range(g, tx, ty, tz, lo, hi);
+            size_t t = tile_index(g, tx, ty, tz);
+            if (!g->bricks[t]) {
+                if (g->tiles[t].active)
+                    count += (size_t)(hi[0] - lo[0]) * (size_t)(hi[1] - lo[1])
+                           * (size_t)(hi[2] - lo[2]);
+                continue;
+            }
+            for (int iz = lo[2]; iz < hi[2]; iz++)
+            for (int iy = lo[1]; iy < hi[1]; iy++)
+            for (int ix = lo[0]; ix < hi[0]; ix++)
+                if (g->bricks[t][brick_offset(ix, iy, iz)].active) count++;
+        }
+        return count;
+    }
+    size_t total = (size_t)g->sx * (size_t)g->sy * (size_t)g->sz;
     for (size_t i = 0; i < total; i++)
         if (g->cells[i].active) count++;
     return count;
 }
 
+void
+dc_voxel_grid_fill_color(DC_VoxelGrid *g, uint8_t r, uint8_t gb, uint8_t b)
+{
+    if (!g) return;
+    if (g->cells) {
+        size_t total = (size_t)g->sx * (size_t)g->sy * (size_t)g->sz;
+        for (size_t i = 0; i < total; i++) {
+            g->cells[i].r = r; g->cells[i].g = gb; g->cells[i].b = b;
+        }
+        return;
+    }
+    if (is_soa(g)) {
+        if (!g->rgb && !r && !gb && !b) return;
+        if (!plane_alloc(g, &g->rgb, 3)) return;
+        size_t total = grid_total(g);
+        for (size_t i = 0; i < total; i++) {
+            g->rgb[i*3+0] = r; g->rgb[i*3+1] = gb; g->rgb[i*3+2] = b;
+        }
+        return;
+    }
+    size_t ntiles = (size_t)g->ntx * (size_t)g->nty * (size_t)g->ntz;
+    for (size_t t = 0; t < ntiles; t++) {
+        g->tiles[t].r = r; g->tiles[t].g = gb; g->tiles[t].b = b;
+        if (!g->bricks[t]) continue;
+        for (int i = 0; i < BRICK_CELLS; i++) {
+            g->bricks[t][i].r = r; g->bricks[t][i].g = gb; g->bricks[t][i].b = b;
+        }
+    }
+}
+
+/* =========================================================================
+ * Tiles
+ * ========================================================================= */
+int
+dc_voxel_grid_is_sparse(const DC_VoxelGrid *g)
+{
+    return g && g->bricks;
+}
+
+float
+dc_voxel_grid_band(const DC_VoxelGrid *g)
+{
+    return g ? g->band : 0.0f;
+}
+
+int
+dc_voxel_grid_set_band(DC_VoxelGrid *g, float band)
+{
+    if (!g || g->bricks || band < 0.0f) return -1;
+    g->band = band;
+    return 0;
+}
+
+void
+dc_voxel_grid_tile_dims(const DC_VoxelGrid *g, int *tx, int *ty, int *tz)
+{
+    int n[3] = { 0, 0, 0 };
+    if (g) {
+        n[0] = (g->sx + DC_VOXEL_BRICK - 1) / DC_VOXEL_BRICK;
+        n[1] = (g->sy + DC_VOXEL_BRICK - 1) / DC_VOXEL_BRICK;
+        n[2] = (g->sz + DC_VOXEL_BRICK - 1) / DC_VOXEL_BRICK;
+    }
+    if (tx) *tx = n[0];
+    if (ty) *ty = n[1];
+    if (tz) *tz = n[2];
+}
+
+static int
+tile_in_range(const DC_VoxelGrid *g, int tx, int ty, int tz)
+{
+    return tx >= 0 && ty >= 0 && tz >= 0 &&
+           tx * DC_VOXEL_BRICK < g->sx &&
+           ty * DC_VOXEL_BRICK < g->sy &&
+           tz * DC_VOXEL_BRICK < g->sz;
+}
+
+int
+dc_voxel_grid_tile_constant(const DC_VoxelGrid *g, int tx, int ty, int tz,
+                              DC_Voxel *value)
+{
+    if (!g || !g->bricks || !tile_in_range(g, tx, ty, tz)) return 0;
+    size_t t = tile_index(g, tx, ty, tz);
+    if (g->bricks[t]) return 0;
+    if (value) *value = g->tiles[t];
+    return 1;
+}
+
+int
+dc_voxel_grid_tile_fill(DC_VoxelGrid *g, int tx, int ty, int tz,
+                          DC_Voxel value)
+{
+    if (!g || !tile_in_range(g, tx, ty, tz)) return -1;
+    if (g->bricks) {
+        size_t t = tile_index(g, tx, ty, tz);
+        if (g->bricks[t]) {
+            free(g->bricks[t]);
+            g->bricks[t] = NULL;
+            g->nbricks--;
+        }
+        g->tiles[t] = value;
+        return 0;
+    }
+    int lo[3], hi[3];
+    tile_range(g, tx, ty, tz, lo, hi);
+    for (int iz = lo[2]; iz < hi[2]; iz++)
+    for (int iy = lo[1]; iy < hi[1]; iy++)
+    for (int ix = lo[0]; ix < hi[0]; ix++) {
+        size_t idx = cell_index(g, ix, iy, iz);
+        if (g->cells) g->cells[idx] = value;
+        else if (soa_store(g, idx, value) != 0) return -1;
+    }
+    return 0;
+}
+
+size_t
+dc_voxel_grid_prune(DC_VoxelGrid *g)
+{
+    if (!g || !g->bricks) return 0;
+    size_t freed = 0;
+    for (int tz = 0; tz < g->ntz; tz++)
+    for (int ty = 0; ty < g->nty; ty++)
+    for (int tx = 0; tx < g->ntx; tx++) {
+        size_t t = tile_index(g, tx, ty, tz);
+        const DC_Voxel *b = g->bricks[t];
+        if (!b) continue;
+
+        /* Cells past the grid edge are never read; ignore them */
+        int lo[3], hi[3];
+        tile_range(g, tx, ty, tz, lo, hi);
+        DC_Voxel first = b[brick_offset(lo[0], lo[1], lo[2])];
+        int inside = first.distance < 0.0f;
+        float nearest = fabsf(first.distance);
+        int keep = 0;
+        for (int iz = lo[2]; iz < hi[2] && !keep; iz++)
+        for (int iy = lo[1]; iy < hi[1] && !keep; iy++)
+        for (int ix = lo[0]; ix < hi[0] && !keep; ix++) {
+            const DC_Voxel *v = &b[brick_offset(ix, iy, iz)];
+            float ad = fabsf(v->distance);
+            keep = v->active != first.active || v->r != first.r ||
+                   v->g != first.g || v->b != first.b ||
+                   ad < g->band || (v->distance < 0.0f) != inside;
+            if (ad < nearest) nearest = ad;
+        }
+        if (keep) continue;
+
+        first.distance = inside ? -nearest : nearest;
+        dc_voxel_grid_tile_fill(g, tx, ty, tz, first);
+        freed++;
+    }
+    return freed;
+}
+
+size_t
+dc_voxel_grid_brick_count(const DC_VoxelGrid *g)
+{
+    return g ? g->nbricks : 0;
+}
+
+size_t
+dc_voxel_grid_memory_bytes(const DC_VoxelGrid *g)
+{
+    if (!g) return 0;
+    if (g->cells)
+        return grid_total(g) * sizeof(DC_Voxel);
+    if (is_soa(g))
+        return grid_total(g) * (dist_bytes(g->qdist ? g->qfmt : 0) +
+                                (g->act ? 1 : 0) + (g->rgb ? 3 : 0));
+    size_t ntiles = (size_t)g->ntx * (size_t)g->nty * (size_t)g->ntz;
+    return ntiles * (sizeof(DC_Voxel *) + sizeof(DC_Voxel)) +
+           g->nbricks * BRICK_CELLS * sizeof(DC_Voxel);
+}
+
+/* =========================================================================
+ * Planes
+ * ========================================================================= */
+int
+dc_voxel_grid_is_soa(const DC_VoxelGrid *g)
+{
+    return g && is_soa(g);
+}
+
+float *
+dc_voxel_grid_distances(DC_VoxelGrid *g)
+{
+    if (!g || dequantize(g) != 0) return NULL;
+    return g->dist;
+}
+
+const float *
+dc_voxel_grid_distances_const(const DC_VoxelGrid *g)
+{
+    return g ? g->dist : NULL;
+}
+
+uint8_t *
+dc_voxel_grid_active_plane(DC_VoxelGrid *g)
+{
+    return g && is_soa(g) ? plane_alloc(g, &g->act, 1) : NULL;
+}
+
+const uint8_t *
+dc_voxel_grid_active_plane_const(const DC_VoxelGrid *g)
+{
+    return g ? g->act : NULL;
+}
+
+uint8_t *
+dc_voxel_grid_color_plane(DC_VoxelGrid *g)
+{
+    return g && is_soa(g) ? plane_alloc(g, &g->rgb, 3) : NULL;
+}
+
+const uint8_t *
+dc_voxel_grid_color_plane_const(const DC_VoxelGrid *g)
+{
+    return g ? g->rgb : NULL;
+}
+
+/* =========================================================================
+ * Quantized distances
+ * ========================================================================= */
+uint16_t
+dc_voxel_half_from_float(float f)
+{
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    uint32_t sign = (x >> 16) & 0x8000u;
+    uint32_t exp = (x >> 23) & 0xffu;
+    uint32_t man = x & 0x7fffffu;
+
+    if (exp == 0xff) return (uint16_t)(sign | 0x7c00u | (man ? 0x200u : 0));
+    int e = (int)exp - 127 + 15;
+    if (e >= 31) return (uint16_t)(sign | 0x7c00u);
+    if (e <= 0) {
+        /* Subnormal half: 10-bit mantissa in units of 2^-24 */
+        if (e < -10) return (uint16_t)sign;
+        man |= 0x800000u;
+        int shift = 14 - e;
+        uint32_t m = man >> shift;
+        uint32_t rem = man & ((1u << shift) - 1), halfway = 1u << (shift - 1);
+        if (rem > halfway || (rem == halfway && (m & 1))) m++;
+        return (uint16_t)(sign | m);
+    }
+    /* Round to nearest even; a carry ripples into the exponent, up to inf */
+    uint32_t h = ((uint32_t)e << 10) | (man >> 13);
+    uint32_t rem = man & 0x1fffu;
+    if (rem > 0x1000u || (rem == 0x1000u && (h & 1))) h++;
+    return (uint16_t)(sign | h);
+}
+
+float
+dc_voxel_half_to_float(uint16_t h)
+{
+    uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+    uint32_t exp = (h >> 10) & 0x1fu, man = h & 0x3ffu, x;
+    if (exp == 0) {
+        float f = ldexpf((float)man, -24);
+        return sign ? -f : f;
+    }
+    if (exp == 31) x = sign | 0x7f800000u | (man << 13);
+    else           x = sign | ((exp + 112) << 23) | (man << 13);
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+int8_t
+dc_voxel_i8_from_float(float d, float range)
+{
+    float t = d * (127.0f / range);
+    if (!(t < 127.0f)) return 127;      /* also NaN */
+    if (t <= -127.0f) return -127;
+    return (int8_t)lrintf(t);
+}
+
+int
+dc_voxel_grid_quantize(DC_VoxelGrid *g, DC_VoxelDistFormat fmt)
+{
+    if (!g || !is_soa(g)) return -1;
+    if (fmt == DC_VOXEL_DIST_F32) return dequantize(g);
+    if (fmt != DC_VOXEL_DIST_F16 && fmt != DC_VOXEL_DIST_I8) return -1;
+    if (fmt == DC_VOXEL_DIST_I8 && !(g->band > 0.0f)) return -1;
+    if (g->qdist && g->qfmt == (int)fmt &&
+        (fmt == DC_VOXEL_DIST_F16 || g->qrange == g->band))
+        return 0;
+
+    size_t total = grid_total(g);
+    void *q = malloc(total * dist_bytes(fmt));
+    if (!q) return -1;
+    for (size_t i = 0; i < total; i++) {
+        float d = g->dist ? g->dist[i] : qdist_at(g, i);
+        if (fmt == DC_VOXEL_DIST_F16)
+            ((uint16_t *)q)[i] = dc_voxel_half_from_float(d);
+        else
+            ((int8_t *)q)[i] = dc_voxel_i8_from_float(d, g->band);
+    }
+    if (!(g->ext_planes & EXT_DIST)) { free(g->dist); free(g->qdist); }
+    g->ext_planes &= ~(unsigned)EXT_DIST;
+    g->dist = NULL;
+    g->qdist = q;
+    g->qfmt = fmt;
+    g->qrange = g->band;
+    return 0;
+}
+
+DC_VoxelDistFormat
+dc_voxel_grid_dist_format(const DC_VoxelGrid *g)
+{
+    return g && g->qdist ? (DC_VoxelDistFormat)g->qfmt : DC_VOXEL_DIST_F32;
+}
+
+const void *
+dc_voxel_grid_dist_plane(const DC_VoxelGrid *g, float *range)
+{
+    if (!g || !is_soa(g)) return NULL;
+    if (range)
+        *range = g->qdist && g->qfmt == DC_VOXEL_DIST_I8 ? g->qrange : 0.0f;
+    return g->qdist ? g->qdist : (const void *)g->dist;
+}
+
 /* =========================================================================
  * Coordinate conversion
  * ========================================================================= */
@@ -204,9 +986,76 @@ dc_voxel_grid_cell_center(const DC_VoxelGrid *g,
     if (wz) *wz = iz * g->cell_size + half;
 }
 
+/* Weighted form so untouched +INF cells interpolate to +INF, not NaN */
+static inline float
+lerpf(float a, float b, float t)
+{
+    if (t <= 0.0f) return a;
+    return (1.0f - t) * a + t * b;
+}
+
+float
+dc_voxel_grid_sample(const DC_VoxelGrid *g, float wx, float wy, float wz)
+{
+    if (!g) return HUGE_VALF;
+
+    /* Continuous cell coordinates, 0 at the centre of cell 0 */
+    float f[3] = {
+        (wx - g->origin[0]) / g->cell_size - 0.5f,
+        (wy - g->origin[1]) / g->cell_size - 0.5f,
+        (wz - g->origin[2]) / g->cell_size - 0.5f,
+    };
+    int dim[3] = { g->sx, g->sy, g->sz };
+    int i0[3], i1[3];
+    float t[3];
+    for (int a = 0; a < 3; a++) {
+        float c = f[a];
+        if (c < 0.0f) c = 0.0f;
+        if (c > (float)(dim[a] - 1)) c = (float)(dim[a] - 1);
+        i0[a] = (int)c;
+        i1[a] = i0[a] + 1 < dim[a] ? i0[a] + 1 : i0[a];
+        t[a] = c - (float)i0[a];
+    }
+
+    float d[8];
+    for (int k = 0; k < 8; k++) {
+        int ix = (k & 1) ? i1[0] : i0[0];
+        int iy = (k & 2) ? i1[1] : i0[1];
+        int iz = (k & 4) ? i1[2] : i0[2];
+        d[k] = cell_distance(g, ix, iy, iz);
+    }
+    float x00 = lerpf(d[0], d[1], t[0]);
+    float x10 = lerpf(d[2], d[3], t[0]);
+    float x01 = lerpf(d[4], d[5], t[0]);
+    float x11 = lerpf(d[6], d[7], t[0]);
+    return lerpf(lerpf(x00, x10, t[1]), lerpf(x01, x11, t[1]), t[2]);
+}
+
 /* =========================================================================
  * Primitive fills
  * ========================================================================= */
+
+/* MIN dist into a cell; cells reached inside (dist <= 0) become active
+ * and take the color. */
+static void
+fill_cell(DC_VoxelGrid *g, int ix, int iy, int iz, float dist,
+          uint8_t r, uint8_t gb, uint8_t b)
+{
+    DC_Voxel v;
+    if (dc_voxel_grid_load(g, ix, iy, iz, &v) != 0) return;
+
+    /* Store minimum distance (for SDF compositing) */
+    if (dist < v.distance) {
+        v.distance = dist;
+    }
+    if (dist <= 0.0f) {
+        v.active = 1;
+        v.r = r;
+        v.g = gb;
+        v.b = b;
+    }
+    dc_voxel_grid_set(g, ix, iy, iz, v);
+}
 void
 dc_voxel_grid_fill_sphere(DC_VoxelGrid *g,
                             float cx, float cy, float cz, float radius,
@@ -225,17 +1074,7 @@ dc_voxel_grid_fill_sphere(DC_VoxelGrid *g,
                 float dz = wz - cz;
                 float dist = sqrtf(dx*dx + dy*dy + dz*dz) - radius;
 
-                DC_Voxel *v = &g->cells[cell_index(g, ix, iy, iz)];
-                /* Store minimum distance (for SDF compositing) */
-                if (dist < v->distance) {
-                    v->distance = dist;
-                }
-                if (dist <= 0.0f) {
-                    v->active = 1;
-                    v->r = r;
-                    v->g = gb;
-                    v->b = b;
-                }
+                fill_cell(g, ix, iy, iz, dist, r, gb, b);
             }
         }
     }
@@ -270,16 +1109,7 @@ dc_voxel_grid_fill_box(DC_VoxelGrid *g,
                 float inside = fminf(fmaxf(dx, fmaxf(dy, dz)), 0.0f);
                 float dist = outside + inside;
 
-                DC_Voxel *v = &g->cells[cell_index(g, ix, iy, iz)];
-                if (dist < v->distance) {
-                    v->distance = dist;
-                }
-                if (dist <= 0.0f) {
-                    v->active = 1;
-                    v->r = r;
-                    v->g = gb;
-                    v->b = b;
-                }
+                fill_cell(g, ix, iy, iz, dist, r, gb, b);
             }
         }
     }
@@ -11,6 +11,17 @@
  *
  * No GTK dependency — pure C, testable from CLI.
  *
+ * Storage: dc_voxel_grid_new() allocates every cell up front.
+ * dc_voxel_grid_new_sparse() instead splits the grid into tiles of
+ * DC_VOXEL_BRICK^3 cells, each either one constant value or an allocated
+ * brick of cells, so only the narrow band around surfaces costs memory.
+ * dc_voxel_grid_new_soa() is dense but stores each field as its own
+ * plane (see "Planes" below), so distance-only loops stream 4 bytes per
+ * cell and the distance plane can be handed to GL as-is.
+ * dc_voxel_grid_wrap_soa() is an SoA grid over planes held elsewhere.
+ * The cell API is the same for AoS and sparse grids; the tile API below
+ * lets bulk operations skip constant tiles.
+ *
  * Ownership: dc_voxel_grid_new() returns an owned grid.
  * dc_voxel_grid_free() releases all memory.
  */
@@ -32,6 +43,13 @@ typedef struct {
  * ---------------------------------------------------------------------- */
 typedef struct DC_VoxelGrid DC_VoxelGrid;
 
+/* Storage format of an SoA distance plane (see "Quantized distances") */
+typedef enum {
+    DC_VOXEL_DIST_F32 = 0,
+    DC_VOXEL_DIST_F16,
+    DC_VOXEL_DIST_I8,
+} DC_VoxelDistFormat;
+
 /* =========================================================================
  * Lifecycle
  * ========================================================================= */
@@ -40,9 +58,42 @@ typedef struct DC_VoxelGrid DC_VoxelGrid;
  * All cells initialized to inactive, distance = +INF. */
 DC_VoxelGrid *dc_voxel_grid_new(int sx, int sy, int sz, float cell_size);
 
+/* Create a sparse grid. Every tile starts as the constant inactive,
+ * +INF voxel; bricks are allocated on first mutable access.
+ *
+ * band: narrow-band half-width in world units (see "Narrow band" below).
+ * Constant tiles only ever hold distances of at least band in magnitude,
+ * with the sign of every cell in the tile. */
+DC_VoxelGrid *dc_voxel_grid_new_sparse(int sx, int sy, int sz,
+                                         float cell_size, float band);
+
+/* Create a dense structure-of-arrays grid: a float distance plane
+ * (+INF), with active and color planes allocated on first write. */
+DC_VoxelGrid *dc_voxel_grid_new_soa(int sx, int sy, int sz, float cell_size);
+
+/* Create a dense SoA grid over planes the caller already holds, such as
+ * a mapped cache file (voxel_cache.h). dist is required, in format fmt
+ * (range as for dc_voxel_grid_quantize; ignored unless int8). act and
+ * rgb may be NULL and are then allocated on first write as usual. The
+ * grid reads and writes the planes in place but never frees them:
+ * release(ctx), if set, runs from dc_voxel_grid_free. Returns NULL on
+ * bad arguments. */
+DC_VoxelGrid *dc_voxel_grid_wrap_soa(int sx, int sy, int sz, float cell_size,
+                                       DC_VoxelDistFormat fmt, float range,
+                                       void *dist,
+                                       uint8_t *act, uint8_t *rgb,
+                                       void (*release)(void *ctx), void *ctx);
+
+/* 1 if the grid was made by dc_voxel_grid_wrap_soa. */
+int dc_voxel_grid_is_wrapped(const DC_VoxelGrid *grid);
+
 /* Free the grid. Safe with NULL. */
 void dc_voxel_grid_free(DC_VoxelGrid *grid);
 
+/* Deep copy of a grid (cells, cell size, origin). Returns NULL on
+ * allocation failure or NULL input. */
+DC_VoxelGrid *dc_voxel_grid_copy(const DC_VoxelGrid *grid);
+
 /* =========================================================================
  * Dimensions
  * ========================================================================= */
@@ -66,7 +117,20 @@ void dc_voxel_grid_bounds(const DC_VoxelGrid *grid,
  * ========================================================================= */
 
 /* Get a pointer to the voxel at (ix, iy, iz). Returns NULL if out of bounds.
- * Borrowed pointer — valid until grid is freed. */
+ * Borrowed pointer — valid until grid is freed.
+ *
+ * On a sparse grid the mutable getter allocates the cell's brick (NULL if
+ * that fails), and the pointer stays valid until the tile is filled or
+ * pruned. The const getter never allocates: cells of a constant tile all
+ * share its value. Allocation is not thread-safe; threads writing a
+ * sparse grid must not share tiles.
+ *
+ * In both modes the cells of one tile row, ix in [tx*DC_VOXEL_BRICK,
+ * (tx+1)*DC_VOXEL_BRICK) clipped to the grid, are consecutive in memory:
+ * the pointer to the first may be indexed along the row.
+ *
+ * SoA grids have no DC_Voxel cells: both getters return NULL. Use the
+ * by-value and distance accessors below, or the planes. */
 DC_Voxel *dc_voxel_grid_get(DC_VoxelGrid *grid, int ix, int iy, int iz);
 const DC_Voxel *dc_voxel_grid_get_const(const DC_VoxelGrid *grid,
                                           int ix, int iy, int iz);
@@ -78,9 +142,139 @@ int dc_voxel_grid_set(DC_VoxelGrid *grid, int ix, int iy, int iz,
 /* Clear all cells to inactive, distance = +INF. */
 void dc_voxel_grid_clear(DC_VoxelGrid *grid);
 
+/* Copy cell (ix,iy,iz) into *out, any storage mode. Returns -1 if out of
+ * bounds. */
+int dc_voxel_grid_load(const DC_VoxelGrid *grid, int ix, int iy, int iz,
+                         DC_Voxel *out);
+
+/* Distance at a cell, any storage mode. HUGE_VALF if out of bounds. */
+float dc_voxel_grid_distance(const DC_VoxelGrid *grid, int ix, int iy, int iz);
+
+/* Writable distance of a cell, any storage mode (allocating a sparse
+ * brick as dc_voxel_grid_get does). NULL if out of bounds. */
+float *dc_voxel_grid_distance_ref(DC_VoxelGrid *grid, int ix, int iy, int iz);
+
 /* Count active voxels. */
 size_t dc_voxel_grid_active_count(const DC_VoxelGrid *grid);
 
+/* Set the color of every cell, leaving active flags and distances. */
+void dc_voxel_grid_fill_color(DC_VoxelGrid *grid,
+                                uint8_t r, uint8_t g, uint8_t b);
+
+/* =========================================================================
+ * Tiles
+ *
+ * Both storage modes are addressed as tiles of DC_VOXEL_BRICK^3 cells;
+ * tile (tx,ty,tz) covers cells [tx*DC_VOXEL_BRICK, +DC_VOXEL_BRICK) per
+ * axis, clipped to the grid. Dense grids have no constant tiles, so code
+ * written against this API runs unchanged on them.
+ * ========================================================================= */
+
+#define DC_VOXEL_BRICK 8
+
+int    dc_voxel_grid_is_sparse(const DC_VoxelGrid *grid);
+
+/* Tiles per axis: ceil(size / DC_VOXEL_BRICK). */
+void dc_voxel_grid_tile_dims(const DC_VoxelGrid *grid,
+                               int *tx, int *ty, int *tz);
+
+/* If tile (tx,ty,tz) is a single constant value, store it in *value and
+ * return 1. Returns 0 for allocated bricks and for every dense tile. */
+int dc_voxel_grid_tile_constant(const DC_VoxelGrid *grid,
+                                  int tx, int ty, int tz, DC_Voxel *value);
+
+/* Set every cell of a tile to value. On a sparse grid this frees the
+ * brick and makes the tile constant. Returns -1 if out of range. */
+int dc_voxel_grid_tile_fill(DC_VoxelGrid *grid, int tx, int ty, int tz,
+                              DC_Voxel value);
+
+/* Collapse sparse bricks that no longer carry surface detail: every cell
+ * shares active flag and color, and all distances lie beyond the band on
+ * one side. The tile keeps the distance closest to the surface. Returns the number of bricks freed (0 for dense grids). */
+size_t dc_voxel_grid_prune(DC_VoxelGrid *grid);
+
+/* Allocated bricks (0 for dense grids). */
+size_t dc_voxel_grid_brick_count(const DC_VoxelGrid *grid);
+
+/* Bytes held by the cell storage. */
+size_t dc_voxel_grid_memory_bytes(const DC_VoxelGrid *grid);
+
+/* =========================================================================
+ * Narrow band
+ *
+ * A grid with band > 0 only keeps distances exact within band of a
+ * surface. Farther cells hold some value of the right sign that is at
+ * least band in magnitude (often +INF, the initial value), which is all
+ * meshing, activation and the sphere tracer need. SDF primitives use this
+ * to visit only the cells near their bounding box (sdf.h). band = 0, the
+ * default for dense grids, keeps every distance exact.
+ * ========================================================================= */
+
+float dc_voxel_grid_band(const DC_VoxelGrid *grid);
+
+/* Set the band of a dense (AoS or SoA) grid; does not touch any cell.
+ * Returns -1 for sparse grids, whose band is fixed at creation, and for
+ * negative bands. */
+int dc_voxel_grid_set_band(DC_VoxelGrid *grid, float band);
+
+/* =========================================================================
+ * Planes (SoA grids)
+ *
+ * Each plane is one contiguous array in cell order
+ * (ix + iy*sx + iz*sx*sy). The color plane holds 3 bytes per cell (r,g,b),
+ * matching a GL_RGB8 texture. All accessors return NULL for AoS and
+ * sparse grids.
+ * ========================================================================= */
+
+int dc_voxel_grid_is_soa(const DC_VoxelGrid *grid);
+
+float       *dc_voxel_grid_distances(DC_VoxelGrid *grid);
+const float *dc_voxel_grid_distances_const(const DC_VoxelGrid *grid);
+
+/* Mutable accessors allocate a zeroed plane on first use (NULL if that
+ * fails). The const ones return NULL while the plane is unallocated,
+ * meaning every cell is inactive / black. */
+uint8_t       *dc_voxel_grid_active_plane(DC_VoxelGrid *grid);
+const uint8_t *dc_voxel_grid_active_plane_const(const DC_VoxelGrid *grid);
+uint8_t       *dc_voxel_grid_color_plane(DC_VoxelGrid *grid);
+const uint8_t *dc_voxel_grid_color_plane_const(const DC_VoxelGrid *grid);
+
+/* =========================================================================
+ * Quantized distances (SoA grids)
+ *
+ * Only distances within the band carry detail, so an SoA grid can keep
+ * its distance plane as IEEE half floats (2 bytes, relative error at
+ * most 2^-11) or as int8 steps of range/127 (1 byte, error at most
+ * range/254 inside the range), range being the band when the grid was
+ * quantized. int8 codes of +-127 mean "at least range away", which is
+ * all the narrow band promises for far cells.
+ *
+ * Cell reads (dc_voxel_grid_distance, _load, _sample) decode on the fly.
+ * dc_voxel_grid_distances_const() returns NULL, so bulk readers take
+ * their per-cell path. The first write (dc_voxel_grid_distances(),
+ * _distance_ref, _set) turns the plane back into float32 in place,
+ * keeping the rounding, so quantize finished grids only.
+ * ========================================================================= */
+
+/* Re-encode the distance plane of an SoA grid in place; DC_VOXEL_DIST_F32
+ * restores a float plane. Returns -1 (grid unchanged) for non-SoA grids,
+ * int8 on a grid without a band, and allocation failure. */
+int dc_voxel_grid_quantize(DC_VoxelGrid *grid, DC_VoxelDistFormat fmt);
+
+/* Current distance format (DC_VOXEL_DIST_F32 for AoS and sparse grids). */
+DC_VoxelDistFormat dc_voxel_grid_dist_format(const DC_VoxelGrid *grid);
+
+/* Raw distance plane of an SoA grid in cell order: float, uint16_t half
+ * or int8_t codes, per dc_voxel_grid_dist_format. *range receives the
+ * int8 range (0 otherwise). NULL for AoS and sparse grids. */
+const void *dc_voxel_grid_dist_plane(const DC_VoxelGrid *grid, float *range);
+
+/* Scalar codecs used by the quantized formats. Half conversion rounds to
+ * nearest even and overflows to inf; int8 saturates at +-127. */
+uint16_t dc_voxel_half_from_float(float f);
+float    dc_voxel_half_to_float(uint16_t h);
+int8_t   dc_voxel_i8_from_float(float d, float range);
+
 /* =========================================================================
  * World <-> grid coordinate conversion
  * ========================================================================= */
@@ -96,6 +290,12 @@ void dc_voxel_grid_cell_center(const DC_VoxelGrid *grid,
                                  int ix, int iy, int iz,
                                  float *wx, float *wy, float *wz);
 
+/* Trilinear interpolation of the distance field at a world position
+ * (origin-aware; distances live at cell centres). Positions outside the
+ * grid clamp to the border cells. Returns HUGE_VALF for a NULL grid. */
+float dc_voxel_grid_sample(const DC_VoxelGrid *grid,
+                             float wx, float wy, float wz);
+
 /* =========================================================================
  * Primitive fill operations (convenience for testing)
  * ========================================================================= */
@@ -0,0 +1,474 @@
+#define _POSIX_C_SOURCE 200809L
+/*
+ * voxel_cache.c — Native on-disk format for voxel grids.
+ */
+
+#include "voxel/voxel_cache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define VC_VERSION 1
+#define VC_ALIGN   64
+
+enum { VC_ACTIVE = 1, VC_COLOR = 2 };
+
+/* On-disk header, native-endian. version doubles as the byte-order
+ * check: read back swapped it is not VC_VERSION. */
+typedef struct {
+    char     magic[4];          /* "DCVX" */
+    uint32_t version;
+    uint32_t header_bytes;      /* sizeof(VcHeader) */
+    uint32_t encoding;          /* DC_VoxelDistFormat */
+    int32_t  size[3];
+    float    cell_size;
+    float    origin[3];
+    float    band;
+    float    range;             /* int8: distance of code 127 */
+    uint32_t planes;            /* VC_ACTIVE | VC_COLOR */
+    uint64_t source_hash;
+    uint64_t dist_offset;
+    uint64_t act_offset;        /* 0 = no plane */
+    uint64_t rgb_offset;        /* 0 = no plane */
+    uint64_t file_bytes;
+    uint64_t reserved[4];
+} VcHeader;
+_Static_assert(sizeof(VcHeader) == 128, "cache header layout");
+
+static const char VC_MAGIC[4] = { 'D', 'C', 'V', 'X' };
+
+static uint64_t
+align_up(uint64_t n)
+{
+    return (n + VC_ALIGN - 1) & ~(uint64_t)(VC_ALIGN - 1);
+}
+
+static size_t
+encoding_bytes(uint32_t enc)
+{
+    switch (enc) {
+    case DC_VOXEL_DIST_F32: return 4;
+    case DC_VOXEL_DIST_F16: return 2;
+    case DC_VOXEL_DIST_I8:  return 1;
+    }
+    return 0;
+}
+
+uint64_t
+dc_voxel_cache_hash(const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h ? h : 1;
+}
+
+/* =========================================================================
+ * Save
+ * ========================================================================= */
+
+/* Write n zero bytes. */
+static int
+write_pad(FILE *fp, uint64_t n)
+{
+    static const uint8_t zeros[VC_ALIGN];
+    return n == 0 || fwrite(zeros, 1, (size_t)n, fp) == n ? 0 : -1;
+}
+
+/* Write one plane (0 distance, 1 active, 2 color) a Z-slice at a time.
+ * SoA planes already in the file's format are written as they are;
+ * everything else goes through the cell API. */
+static int
+write_plane(FILE *fp, const DC_VoxelGrid *g, int kind,
+            const VcHeader *hdr, uint8_t *buf)
+{
+    int sx = hdr->size[0], sy = hdr->size[1], sz = hdr->size[2];
+    size_t n = (size_t)sx * (size_t)sy;
+    float range = 0.0f;
+    const uint8_t *dist = dc_voxel_grid_dist_plane(g, &range);
+    const uint8_t *act = dc_voxel_grid_active_plane_const(g);
+    const uint8_t *rgb = dc_voxel_grid_color_plane_const(g);
+    int soa = dc_voxel_grid_is_soa(g);
+    int same = dist && dc_voxel_grid_dist_format(g) == hdr->encoding &&
+               (hdr->encoding != DC_VOXEL_DIST_I8 || range == hdr->range);
+    size_t elem = kind == 0 ? encoding_bytes(hdr->encoding) :
+                  kind == 1 ? 1 : 3;
+
+    for (int iz = 0; iz < sz; iz++) {
+        size_t base = (size_t)iz * n;
+        const void *src = buf;
+        if (kind == 0 && same)
+            src = dist + base * elem;
+        else if (soa && kind == 1 && act)
+            src = act + base;
+        else if (soa && kind == 2 && rgb)
+            src = rgb + base * 3;
+        else {
+            for (int iy = 0; iy < sy; iy++)
+            for (int ix = 0; ix < sx; ix++) {
+                size_t i = (size_t)ix + (size_t)iy * (size_t)sx;
+                DC_Voxel v;
+                dc_voxel_grid_load(g, ix, iy, iz, &v);
+                if (kind == 1) { buf[i] = v.active; continue; }
+                if (kind == 2) {
+                    buf[i*3+0] = v.r; buf[i*3+1] = v.g; buf[i*3+2] = v.b;
+                    continue;
+                }
+                switch (hdr->encoding) {
+                case DC_VOXEL_DIST_F32:
+                    memcpy(buf + i * 4, &v.distance, 4);
+                    break;
+                case DC_VOXEL_DIST_F16: {
+                    uint16_t h = dc_voxel_half_from_float(v.distance);
+                    memcpy(buf + i * 2, &h, 2);
+                    break;
+                }
+                case DC_VOXEL_DIST_I8:
+                    buf[i] = (uint8_t)dc_voxel_i8_from_float(v.distance,
+                                                             hdr->range);
+                    break;
+                }
+            }
+        }
+        if (fwrite(src, elem, n, fp) != n) return -1;
+    }
+    return 0;
+}
+
+int
+dc_voxel_cache_save(const DC_VoxelGrid *grid, const char *path,
+                      uint64_t source_hash,
+                      const DC_VoxelCacheOpts *opts, DC_Error *err)
+{
+    DC_VoxelDistFormat enc = opts ? opts->encoding : DC_VOXEL_DIST_F32;
+    if (!grid || !path || encoding_bytes(enc) == 0) {
+        if (err) DC_SET_ERROR(err, DC_ERROR_INVALID_ARG, "bad voxel cache args");
+        return -1;
+    }
+    float band = dc_voxel_grid_band(grid);
+    if (enc == DC_VOXEL_DIST_I8 && !(band > 0.0f) &&
+        dc_voxel_grid_dist_format(grid) != DC_VOXEL_DIST_I8) {
+        if (err) DC_SET_ERROR(err, DC_ERROR_INVALID_ARG,
+                              "int8 voxel cache needs a narrow band");
+        return -1;
+    }
+
+    VcHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, VC_MAGIC, sizeof(hdr.magic));
+    hdr.version = VC_VERSION;
+    hdr.header_bytes = sizeof(VcHeader);
+    hdr.encoding = (uint32_t)enc;
+    hdr.size[0] = dc_voxel_grid_size_x(grid);
+    hdr.size[1] = dc_voxel_grid_size_y(grid);
+    hdr.size[2] = dc_voxel_grid_size_z(grid);
+    hdr.cell_size = dc_voxel_grid_cell_size(grid);
+    dc_voxel_grid_get_origin(grid, &hdr.origin[0], &hdr.origin[1],
+                             &hdr.origin[2]);
+    hdr.band = band;
+    /* An int8 grid keeps its own range; anything else is quantized to
+     * the band */
+    float range = 0.0f;
+    dc_voxel_grid_dist_plane(grid, &range);
+    hdr.range = enc != DC_VOXEL_DIST_I8 ? 0.0f
+              : dc_voxel_grid_dist_format(grid) == DC_VOXEL_DIST_I8 ? range
+              : band;
+    hdr.source_hash = source_hash;
+
+    /* SoA grids only carry the planes they have; other modes keep both */
+    int soa = dc_voxel_grid_is_soa(grid);
+    if (!soa || dc_voxel_grid_active_plane_const(grid))
+        hdr.planes |= VC_ACTIVE;
+    if ((!opts || !opts->no_color) &&
+        (!soa || dc_voxel_grid_color_plane_const(grid)))
+        hdr.planes |= VC_COLOR;
+
+    uint64_t cells = (uint64_t)hdr.size[0] * (uint64_t)hdr.size[1] *
+                     (uint64_t)hdr.size[2];
+    uint64_t off = align_up(sizeof(VcHeader));
+    hdr.dist_offset = off;
+    off = align_up(off + cells * encoding_bytes(enc));
+    if (hdr.planes & VC_ACTIVE) {
+        hdr.act_offset = off;
+        off = align_up(off + cells);
+    }
+    if (hdr.planes & VC_COLOR) {
+        hdr.rgb_offset = off;
+        off = align_up(off + cells * 3);
+    }
+    hdr.file_bytes = off;
+
+    size_t tlen = strlen(path) + 32;
+    char *tmp = malloc(tlen);
+    uint8_t *buf = malloc((size_t)hdr.size[0] * (size_t)hdr.size[1] * 4);
+    FILE *fp = tmp ? (snprintf(tmp, tlen, "%s.%ld.tmp", path,
+                               (long)getpid()), fopen(tmp, "wb")) : NULL;
+    if (!fp || !buf) {
+        if (err) DC_SET_ERROR(err, fp ? DC_ERROR_MEMORY : DC_ERROR_IO,
+                              "cannot write voxel cache %s", path);
+        if (fp) { fclose(fp); remove(tmp); }
+        free(tmp);
+        free(buf);
+        return -1;
+    }
+
+    uint64_t pos = sizeof(VcHeader);
+    int rc = fwrite(&hdr, sizeof(hdr), 1, fp) == 1 ? 0 : -1;
+    const uint64_t offsets[3] = { hdr.dist_offset, hdr.act_offset,
+                                  hdr.rgb_offset };
+    const uint64_t elems[3] = { encoding_bytes(enc), 1, 3 };
+    for (int k = 0; k < 3 && rc == 0; k++) {
+        if (!offsets[k]) continue;
+        rc = write_pad(fp, offsets[k] - pos);
+        if (rc == 0) rc = write_plane(fp, grid, k, &hdr, buf);
+        pos = offsets[k] + cells * elems[k];
+    }
+    if (rc == 0) rc = write_pad(fp, hdr.file_bytes - pos);
+    if (fclose(fp) != 0) rc = -1;
+    if (rc == 0 && rename(tmp, path) != 0) rc = -1;
+    if (rc != 0) {
+        remove(tmp);
+        if (err) DC_SET_ERROR(err, DC_ERROR_IO,
+                              "cannot write voxel cache %s", path);
+    }
+    free(tmp);
+    free(buf);
+    return rc;
+}
+
+/* =========================================================================
+ * Load
+ * ========================================================================= */
+
+/* Read and validate the header of an open cache file. Every plane must
+ * lie inside the file, so a mapping of file_bytes covers it. */
+static int
+read_header(int fd, VcHeader *hdr)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(VcHeader))
+        return -1;
+    if (pread(fd, hdr, sizeof(*hdr), 0) != (ssize_t)sizeof(*hdr))
+        return -1;
+    if (memcmp(hdr->magic, VC_MAGIC, sizeof(VC_MAGIC)) != 0 ||
+        hdr->version != VC_VERSION ||
+        hdr->header_bytes != sizeof(VcHeader) ||
+        encoding_bytes(hdr->encoding) == 0 ||
+        hdr->size[0] <= 0 || hdr->size[1] <= 0 || hdr->size[2] <= 0 ||
+        !(hdr->cell_size > 0.0f) || !(hdr->band >= 0.0f) ||
+        (hdr->encoding == DC_VOXEL_DIST_I8 && !(hdr->range > 0.0f)) ||
+        hdr->file_bytes != (uint64_t)st.st_size)
+        return -1;
+
+    /* Every plane takes at least a byte per cell, so cells never exceeds
+     * file_bytes; checking that by division before each multiply keeps
+     * the product from wrapping, however large the file. The planes
+     * below divide again before scaling by their element size. */
+    uint64_t cells = (uint64_t)hdr->size[0];
+    for (int a = 1; a < 3; a++) {
+        if (cells > hdr->file_bytes / (uint64_t)hdr->size[a]) return -1;
+        cells *= (uint64_t)hdr->size[a];
+    }
+    const uint64_t offsets[3] = { hdr->dist_offset, hdr->act_offset,
+                                  hdr->rgb_offset };
+    const uint64_t elems[3] = { encoding_bytes(hdr->encoding), 1, 3 };
+    const int need[3] = { 1, (hdr->planes & VC_ACTIVE) != 0,
+                          (hdr->planes & VC_COLOR) != 0 };
+    for (int k = 0; k < 3; k++) {
+        if (!need[k]) {
+            if (offsets[k]) return -1;
+            continue;
+        }
+        if (offsets[k] < sizeof(VcHeader) || offsets[k] % VC_ALIGN ||
+            cells > hdr->file_bytes / elems[k] ||
+            offsets[k] > hdr->file_bytes - cells * elems[k])
+            return -1;
+    }
+    return 0;
+}
+
+typedef struct {
+    void  *base;
+    size_t len;
+} VcMapping;
+
+static void
+mapping_release(void *ctx)
+{
+    VcMapping *m = ctx;
+    munmap(m->base, m->len);
+    free(m);
+}
+
+DC_VoxelGrid *
+dc_voxel_cache_load(const char *path, uint64_t source_hash, DC_Error *err)
+{
+    if (!path) {
+        if (err) DC_SET_ERROR(err, DC_ERROR_INVALID_ARG, "NULL cache path");
+        return NULL;
+    }
+    int fd = open(path, O_RDONLY);
+    VcHeader hdr;
+    if (fd < 0 || read_header(fd, &hdr) != 0) {
+        if (fd >= 0) close(fd);
+        if (err) DC_SET_ERROR(err, DC_ERROR_IO,
+                              "no valid voxel cache at %s", path);
+        return NULL;
+    }
+    if (source_hash && hdr.source_hash != source_hash) {
+        close(fd);
+        if (err) DC_SET_ERROR(err, DC_ERROR_NOT_FOUND,
+                              "voxel cache %s is stale", path);
+        return NULL;
+    }
+
+    /* Private and writable: the grid may be edited like any other, with
+     * touched pages copied and the file left alone */
+    void *base = mmap(NULL, (size_t)hdr.file_bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        if (err) DC_SET_ERROR(err, DC_ERROR_IO, "cannot map %s", path);
+        return NULL;
+    }
+
+    /* The grid owns the mapping from here on; quantized planes stay
+     * quantized (voxel.h) */
+    DC_VoxelGrid *g = NULL;
+    VcMapping *m = malloc(sizeof(*m));
+    if (m) {
+        uint8_t *b = base;
+        m->base = base;
+        m->len = (size_t)hdr.file_bytes;
+        g = dc_voxel_grid_wrap_soa(
+            hdr.size[0], hdr.size[1], hdr.size[2], hdr.cell_size,
+            (DC_VoxelDistFormat)hdr.encoding, hdr.range, b + hdr.dist_offset,
+            hdr.act_offset ? b + hdr.act_offset : NULL,
+            hdr.rgb_offset ? b + hdr.rgb_offset : NULL,
+            mapping_release, m);
+    }
+    if (!g) {
+        free(m);
+        munmap(base, (size_t)hdr.file_bytes);
+        if (err) DC_SET_ERROR(err, DC_ERROR_MEMORY,
+                              "voxel cache load %dx%dx%d", hdr.size[0],
+                              hdr.size[1], hdr.size[2]);
+        return NULL;
+    }
+
+    dc_voxel_grid_set_origin(g, hdr.origin[0], hdr.origin[1], hdr.origin[2]);
+    dc_voxel_grid_set_band(g, hdr.band);
+
+    /* A hit is a use: refresh the mtime dc_voxel_cache_evict orders by */
+    utimensat(AT_FDCWD, path, NULL, 0);
+    return g;
+}
+
+int
+dc_voxel_cache_info(const char *path, DC_VoxelCacheInfo *info)
+{
+    if (!path || !info) return -1;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    VcHeader hdr;
+    int rc = read_header(fd, &hdr);
+    close(fd);
+    if (rc != 0) return -1;
+
+    for (int a = 0; a < 3; a++) {
+        info->size[a] = hdr.size[a];
+        info->origin[a] = hdr.origin[a];
+    }
+    info->cell_size = hdr.cell_size;
+    info->band = hdr.band;
+    info->encoding = (DC_VoxelDistFormat)hdr.encoding;
+    info->has_active = hdr.act_offset != 0;
+    info->has_color = hdr.rgb_offset != 0;
+    info->source_hash = hdr.source_hash;
+    return 0;
+}
+
+typedef struct {
+    char    *path;
+    uint64_t bytes;
+    struct timespec mtime;
+} VcEntry;
+
+static int
+entry_older(const void *a, const void *b)
+{
+    const VcEntry *x = a, *y = b;
+    if (x->mtime.tv_sec != y->mtime.tv_sec)
+        return x->mtime.tv_sec < y->mtime.tv_sec ? -1 : 1;
+    if (x->mtime.tv_nsec != y->mtime.tv_nsec)
+        return x->mtime.tv_nsec < y->mtime.tv_nsec ? -1 : 1;
+    return strcmp(x->path, y->path);
+}
+
+int
+dc_voxel_cache_evict(const char *dir, uint64_t max_bytes, const char *keep)
+{
+    if (!dir) return -1;
+    DIR *d = opendir(dir);
+    if (!d) return -1;
+
+    VcEntry *ents = NULL;
+    size_t n = 0, cap = 0;
+    uint64_t total = 0;
+    size_t ext_len = strlen(DC_VOXEL_CACHE_EXT);
+    size_t dir_len = strlen(dir);
+    struct dirent *de;
+    while ((de = readdir(d)) != NULL) {
+        size_t len = strlen(de->d_name);
+        if (len <= ext_len ||
+            strcmp(de->d_name + len - ext_len, DC_VOXEL_CACHE_EXT) != 0)
+            continue;
+        char *path = malloc(dir_len + len + 2);
+        if (!path) continue;
+        snprintf(path, dir_len + len + 2, "%s/%s", dir, de->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+            free(path);
+            continue;
+        }
+        if (n == cap) {
+            size_t nc = cap ? cap * 2 : 32;
+            VcEntry *ne = realloc(ents, nc * sizeof(*ents));
+            if (!ne) {
+                free(path);
+                break;
+            }
+            ents = ne;
+            cap = nc;
+        }
+        ents[n].path = path;
+        ents[n].bytes = (uint64_t)st.st_size;
+        ents[n].mtime = st.st_mtim;
+        total += ents[n].bytes;
+        n++;
+    }
+    closedir(d);
+
+    qsort(ents, n, sizeof(*ents), entry_older);
+    int removed = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (total > max_bytes &&
+            !(keep && strcmp(ents[i].path, keep) == 0) &&
+            remove(ents[i].path) == 0) {
+            total -= ents[i].bytes;
+            removed++;
+        }
+        free(ents[i].path);
+    }
+    free(ents);
+    return removed;
+}
@@ -0,0 +1,91 @@
+#ifndef DC_VOXEL_CACHE_H
+#define DC_VOXEL_CACHE_H
+
+/*
+ * voxel_cache.h — Native on-disk format for voxel grids.
+ *
+ * A .dcvox file holds one grid: a fixed header (dimensions, origin,
+ * cell size, narrow band, distance encoding, a content hash of whatever
+ * the grid was built from) followed by the SoA planes of voxel.h, each
+ * 64-byte aligned: distances, then the optional active and color planes.
+ *
+ * Distances are stored in any DC_VoxelDistFormat (voxel.h): float32,
+ * float16, or int8 steps of band/127. A file loads by mapping it: the
+ * grid's planes point straight into the page cache, so reopening even a
+ * very large grid costs no evaluation and no copy, and a quantized file
+ * gives a quantized grid. The mapping is private, so edits to the
+ * loaded grid never reach the file.
+ *
+ * Files are native-endian; a file from a machine of the other byte
+ * order is rejected like any other format mismatch.
+ *
+ * No GTK dependency.
+ */
+
+#include "voxel/voxel.h"
+#include "core/error.h"
+
+#include <stdint.h>
+
+#define DC_VOXEL_CACHE_EXT ".dcvox"
+
+/* Zero-initialized opts (or NULL) select the defaults.
+ *
+ * encoding: distance format of the file. DC_VOXEL_DIST_I8 needs a grid
+ * with a band (or one already quantized to int8).
+ *
+ * no_color: leave the color plane out (loaded grids are black). The
+ * active plane is always kept when the grid has one. */
+typedef struct {
+    DC_VoxelDistFormat encoding;
+    int                no_color;
+} DC_VoxelCacheOpts;
+
+/* Header fields of a cache file, as read by dc_voxel_cache_info. */
+typedef struct {
+    int                   size[3];
+    float                 cell_size;
+    float                 origin[3];
+    float                 band;
+    DC_VoxelDistFormat    encoding;
+    int                   has_active;
+    int                   has_color;
+    uint64_t              source_hash;
+} DC_VoxelCacheInfo;
+
+/* 64-bit FNV-1a of len bytes, for the source_hash arguments. Never
+ * returns 0. */
+uint64_t dc_voxel_cache_hash(const void *data, size_t len);
+
+/* Write grid (any storage mode) to path. The file is written next to
+ * path and renamed into place, so readers, including live mappings of
+ * an older version, never see a partial file.
+ *
+ * Returns 0 on success, -1 on error (DC_ERROR_INVALID_ARG for a NULL
+ * grid or an int8 encoding without a band, DC_ERROR_IO otherwise). */
+int dc_voxel_cache_save(const DC_VoxelGrid *grid, const char *path,
+                          uint64_t source_hash,
+                          const DC_VoxelCacheOpts *opts, DC_Error *err);
+
+/* Load a cache file as an SoA grid with origin and band restored.
+ * source_hash 0 accepts any file; otherwise a file built from other
+ * content fails with DC_ERROR_NOT_FOUND, so callers can treat a stale
+ * cache as a miss. A successful load refreshes the file's mtime, which
+ * is its age for dc_voxel_cache_evict. Returns NULL on error
+ * (DC_ERROR_IO for a missing or malformed file). err may be NULL. */
+DC_VoxelGrid *dc_voxel_cache_load(const char *path, uint64_t source_hash,
+                                    DC_Error *err);
+
+/* Read just the header of a cache file. Returns 0 on success, -1 if the
+ * file is missing or not a cache file. */
+int dc_voxel_cache_info(const char *path, DC_VoxelCacheInfo *info);
+
+/* Trim the cache files (DC_VOXEL_CACHE_EXT) in dir to at most max_bytes
+ * in total, removing the least recently written or loaded first. keep,
+ * if non-NULL, is never removed (the file just written). Other files in
+ * dir are ignored. Grids still mapped from a removed file stay valid.
+ * Returns the number of files removed, -1 if dir cannot be read. */
+int dc_voxel_cache_evict(const char *dir, uint64_t max_bytes,
+                           const char *keep);
+
+#endif /* DC_VOXEL_CACHE_H */
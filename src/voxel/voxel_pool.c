@@ -0,0 +1,149 @@
+/*
+ * voxel_pool.c — Shared worker pool for the voxel pipeline.
+ *
+ * Jobs live on their caller's stack and are linked into a queue under
+ * s_lock. A worker attaches to the first job that still wants helpers,
+ * claims items with an atomic counter, and detaches when the counter runs
+ * out. The caller works its own job the same way, unlinks it, then waits
+ * for attached workers to drain. Since every caller makes progress on its
+ * own job, nested jobs cannot deadlock even with all workers busy.
+ */
+
+#include "voxel/voxel_pool.h"
+#include "core/log.h"
+
+#include <glib.h>
+
+#define POOL_MAX_WORKERS 63
+
+typedef struct PoolJob {
+    DC_VoxelPoolFn  fn;
+    void           *ctx;
+    int             count;
+    volatile int   *cancel;
+    int             next;       /* atomic: next unclaimed item */
+    int             ran;        /* atomic: items completed */
+    int             helpers;    /* worker slots still open (s_lock) */
+    int             attached;   /* workers currently on the job (s_lock) */
+    struct PoolJob *link;
+} PoolJob;
+
+static GMutex   s_lock;
+static GCond    s_work;         /* a job was queued */
+static GCond    s_drained;      /* a worker left a job */
+static PoolJob *s_queue = NULL;
+static int      s_workers = -1; /* -1 = not started */
+
+static void
+run_items(PoolJob *job)
+{
+    for (;;) {
+        if (job->cancel && g_atomic_int_get(job->cancel)) break;
+        int i = g_atomic_int_add(&job->next, 1);
+        if (i >= job->count) break;
+        job->fn(job->ctx, i);
+        g_atomic_int_inc(&job->ran);
+    }
+}
+
+static void
+unlink_job(PoolJob *job)
+{
+    for (PoolJob **p = &s_queue; *p; p = &(*p)->link) {
+        if (*p == job) { *p = job->link; return; }
+    }
+}
+
+static gpointer
+pool_worker(gpointer data)
+{
+    (void)data;
+    g_mutex_lock(&s_lock);
+    for (;;) {
+        PoolJob *job = s_queue;
+        if (!job) {
+            g_cond_wait(&s_work, &s_lock);
+            continue;
+        }
+        if (--job->helpers == 0) unlink_job(job);
+        job->attached++;
+        g_mutex_unlock(&s_lock);
+
+        run_items(job);
+
+        g_mutex_lock(&s_lock);
+        job->attached--;
+        g_cond_broadcast(&s_drained);
+    }
+    return NULL;
+}
+
+/* Caller holds s_lock. */
+static void
+pool_start_locked(void)
+{
+    if (s_workers >= 0) return;
+
+    int want = (int)g_get_num_processors() - 1;
+    if (want > POOL_MAX_WORKERS) want = POOL_MAX_WORKERS;
+
+    s_workers = 0;
+    for (int i = 0; i < want; i++) {
+        GThread *t = g_thread_try_new("voxel-pool", pool_worker, NULL, NULL);
+        if (!t) break;
+        g_thread_unref(t);
+        s_workers++;
+    }
+    dc_log(DC_LOG_INFO, DC_LOG_EVENT_APP,
+           "voxel_pool: %d worker threads", s_workers);
+}
+
+int
+dc_voxel_pool_threads(void)
+{
+    g_mutex_lock(&s_lock);
+    pool_start_locked();
+    int n = s_workers + 1;
+    g_mutex_unlock(&s_lock);
+    return n;
+}
+
+int
+dc_voxel_pool_run(DC_VoxelPoolFn fn, void *ctx, int count, int threads,
+                  volatile int *cancel)
+{
+    if (!fn || count <= 0) return 0;
+
+    PoolJob job = {
+        .fn = fn, .ctx = ctx, .count = count, .cancel = cancel,
+    };
+
+    int queued = 0;
+    if (threads != 1 && count > 1) {
+        g_mutex_lock(&s_lock);
+        pool_start_locked();
+        int helpers = threads > 0 ? threads - 1 : s_workers;
+        if (helpers > s_workers) helpers = s_workers;
+        if (helpers > count - 1) helpers = count - 1;
+        if (helpers > 0) {
+            job.helpers = helpers;
+            job.link = s_queue;
+            s_queue = &job;
+            queued = 1;
+            g_cond_broadcast(&s_work);
+        }
+        g_mutex_unlock(&s_lock);
+    }
+
+    run_items(&job);
+
+    if (queued) {
+        g_mutex_lock(&s_lock);
+        unlink_job(&job);
+        while (job.attached > 0)
+            g_cond_wait(&s_drained, &s_lock);
+        g_mutex_unlock(&s_lock);
+    }
+
+    return g_atomic_int_get(&job.ran) == count ? 0 : 1;
+}
@@ -0,0 +1,35 @@
+#ifndef DC_VOXEL_POOL_H
+#define DC_VOXEL_POOL_H
+
+/*
+ * voxel_pool.h — Shared worker pool for the voxel pipeline.
+ *
+ * One process-wide set of GLib worker threads, started on first use and
+ * sized to the CPU count. Callers hand it a function over a range of
+ * independent items (Z-slabs, grid layers); idle workers and the calling
+ * thread claim items one at a time until none are left. Any number of
+ * callers may run at once, including from inside a running item.
+ *
+ * No GTK dependency.
+ */
+
+/* Work function: process item `item` of the job. */
+typedef void (*DC_VoxelPoolFn)(void *ctx, int item);
+
+/* Run fn(ctx, i) for every i in [0, count) and wait for all of them.
+ *
+ * threads: upper bound on threads working the job, the caller included.
+ * 0 = the whole pool, 1 = serial on the calling thread.
+ *
+ * cancel: optional flag polled before each item is claimed. Once it reads
+ * nonzero no further items start; items already running finish.
+ *
+ * Returns 0 when every item ran, 1 if the job was cancelled first. */
+int dc_voxel_pool_run(DC_VoxelPoolFn fn, void *ctx, int count, int threads,
+                      volatile int *cancel);
+
+/* Threads available to one job: pool workers plus the caller. Starts the
+ * pool if needed. */
+int dc_voxel_pool_threads(void);
+
+#endif /* DC_VOXEL_POOL_H */
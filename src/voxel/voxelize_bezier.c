@@ -6,22 +6,26 @@
  * is lossless at every resolution.
  *
  * Algorithm:
- *   For each patch in the mesh:
- *     1. Compute patch AABB, expand by narrowband
- *     2. For each voxel in the expanded AABB:
- *        a. Newton-solve for closest (u,v) on patch
- *        b. Compute signed distance via normal dot product
- *        c. Min-abs with existing (closest surface wins)
- *     3. Activate cells where distance <= 0
- *     4. Color by SDF gradient (normal-mapped)
+ *   1. Mark the narrow band: voxels inside any patch AABB grown by band,
+ *      less any a coarser seed grid places well outside it
+ *   2. For each band voxel:
+ *        a. Newton-solve for closest (u,v) on the patches in its bucket
+ *        b. Keep the closest distance if it lies within the band
+ *   3. Fast-sweep the distance into the rest of the grid (sdf_sweep.c)
+ *   4. Flood-fill sign from a corner; activate cells where distance <= 0
+ *   5. Sign-preserving smoothing, uniform color
  */
 
 #include "voxel/voxelize_bezier.h"
 #include "voxel/sdf.h"
+#include "voxel/sdf_sweep.h"
+#include "voxel/voxel_pool.h"
 #include "core/log.h"
 
+#include <glib.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <float.h>
 
 /* Include Trinity Site bezier headers directly.
@@ -30,10 +34,271 @@
 #include "../../talmud-main/talmud/sacred/trinity_site/ts_bezier_surface.h"
 #include "../../talmud-main/talmud/sacred/trinity_site/ts_bezier_mesh.h"
 
+/* =========================================================================
+ * Patch index
+ *
+ * Patch control-point AABBs are computed once and bucketed into a coarse
+ * uniform grid laid over the voxel grid, PATCH_BUCKET voxels per side.
+ * A bucket lists every patch whose AABB, grown by the band, overlaps it,
+ * so a voxel only Newton-solves against patches that can lie within the
+ * band. Lists keep patch order, so results match an exhaustive scan.
+ * ========================================================================= */
+
+#define PATCH_BUCKET 4
+
+typedef struct {
+    ts_bezier_patch patch;
+    ts_vec3         bmin, bmax;
+    int             lo[3], hi[3];   /* voxel range of the grown AABB */
+} BzPatch;
+
+typedef struct {
+    BzPatch *patches;
+    int      count;
+    int      nb[3];     /* buckets per axis */
+    int     *start;     /* nb[0]*nb[1]*nb[2] + 1 offsets into items */
+    int     *items;     /* patch indices */
+} PatchIndex;
+
+static void
+patch_index_free(PatchIndex *ix)
+{
+    free(ix->patches);
+    free(ix->start);
+    free(ix->items);
+}
+
+static int
+patch_index_build(PatchIndex *ix, const ts_bezier_mesh *mesh,
+                  const float *org, float cs, const int *dim, double band)
+{
+    memset(ix, 0, sizeof(*ix));
+    ix->count = mesh->rows * mesh->cols;
+    for (int a = 0; a < 3; a++)
+        ix->nb[a] = (dim[a] + PATCH_BUCKET - 1) / PATCH_BUCKET;
+    size_t nbuckets = (size_t)ix->nb[0] * ix->nb[1] * ix->nb[2];
+
+    ix->patches = malloc((size_t)ix->count * sizeof(BzPatch));
+    ix->start = calloc(nbuckets + 1, sizeof(int));
+    if (!ix->patches || !ix->start) {
+        patch_index_free(ix);
+        return -1;
+    }
+
+    for (int pr = 0; pr < mesh->rows; pr++) {
+        for (int pc = 0; pc < mesh->cols; pc++) {
+            BzPatch *bp = &ix->patches[pr * mesh->cols + pc];
+            bp->patch = ts_bezier_mesh_get_patch(mesh, pr, pc);
+            ts_bezier_patch_bbox(&bp->patch, &bp->bmin, &bp->bmax);
+            /* Voxel centres sit at org + (i + 0.5) * cs */
+            for (int a = 0; a < 3; a++) {
+                int lo = (int)ceil((bp->bmin.v[a] - band - org[a]) / cs - 0.5);
+                int hi = (int)floor((bp->bmax.v[a] + band - org[a]) / cs - 0.5);
+                bp->lo[a] = lo < 0 ? 0 : lo;
+                bp->hi[a] = hi > dim[a] - 1 ? dim[a] - 1 : hi;
+            }
+        }
+    }
+
+    /* Counting pass, then fill (CSR) */
+    for (int pass = 0; pass < 2; pass++) {
+        int *fill = NULL;
+        if (pass == 1) {
+            for (size_t b = 0; b < nbuckets; b++)
+                ix->start[b + 1] += ix->start[b];
+            ix->items = malloc((size_t)(ix->start[nbuckets] + 1) * sizeof(int));
+            fill = malloc(nbuckets * sizeof(int));
+            if (!ix->items || !fill) {
+                free(fill);
+                patch_index_free(ix);
+                return -1;
+            }
+            memcpy(fill, ix->start, nbuckets * sizeof(int));
+        }
+        for (int i = 0; i < ix->count; i++) {
+            const BzPatch *bp = &ix->patches[i];
+            if (bp->lo[0] > bp->hi[0] || bp->lo[1] > bp->hi[1] ||
+                bp->lo[2] > bp->hi[2])
+                continue;
+            for (int bz = bp->lo[2] / PATCH_BUCKET; bz <= bp->hi[2] / PATCH_BUCKET; bz++)
+            for (int by = bp->lo[1] / PATCH_BUCKET; by <= bp->hi[1] / PATCH_BUCKET; by++)
+            for (int bx = bp->lo[0] / PATCH_BUCKET; bx <= bp->hi[0] / PATCH_BUCKET; bx++) {
+                size_t b = (size_t)bx + (size_t)by * ix->nb[0]
+                         + (size_t)bz * ix->nb[0] * ix->nb[1];
+                if (pass == 0) ix->start[b + 1]++;
+                else           ix->items[fill[b]++] = i;
+            }
+        }
+        free(fill);
+    }
+    return 0;
+}
+
+/* =========================================================================
+ * Per-layer work
+ *
+ * Each Z layer is one item on the voxel pool. Layers touch disjoint
+ * cells and mask bytes, so the grid comes out the same for any split.
+ * ========================================================================= */
+
+typedef struct {
+    const PatchIndex   *pidx;
+    DC_VoxelGrid       *grid;
+    uint8_t            *mask;
+    const DC_VoxelGrid *seed;
+    float               org[3];
+    float               cs;
+    int                 sx, sy;
+    double              band;
+    double              seed_reach;
+    int                 newton_iters;
+    gint                exact;          /* atomic */
+    gint                seed_skipped;   /* atomic */
+} BandCtx;
+
+static void
+band_layer(void *data, int iz)
+{
+    BandCtx *c = data;
+    const PatchIndex *pidx = c->pidx;
+    int sx = c->sx, sy = c->sy;
+    float cell_size = c->cs;
+    double band = c->band;
+    int exact = 0, seed_skipped = 0;
+
+    for (int iy = 0; iy < sy; iy++) {
+        for (int ix = 0; ix < sx; ix++) {
+            size_t idx = (size_t)ix + (size_t)iy*sx + (size_t)iz*sx*sy;
+            if (c->mask[idx] != DC_SDF_FROZEN) continue;
+
+            float wx, wy, wz;
+            /* Compute world position manually — cell_center doesn't include origin */
+            wx = c->org[0] + ((float)ix + 0.5f) * cell_size;
+            wy = c->org[1] + ((float)iy + 0.5f) * cell_size;
+            wz = c->org[2] + ((float)iz + 0.5f) * cell_size;
+
+            /* Coarse-to-fine: a previous, coarser pass bounds where the
+             * surface can be. Its distance is within about one coarse cell
+             * of the truth (interpolation, smoothing), so anything it
+             * places further than band + 2 coarse cells away cannot be in
+             * this pass's band. */
+            if (c->seed &&
+                fabsf(dc_voxel_grid_sample(c->seed, wx, wy, wz)) > c->seed_reach) {
+                c->mask[idx] = DC_SDF_FAR;
+                seed_skipped++;
+                continue;
+            }
+
+            ts_vec3 query = ts_vec3_make(wx, wy, wz);
+
+            size_t b = (size_t)(ix / PATCH_BUCKET)
+                     + (size_t)(iy / PATCH_BUCKET) * pidx->nb[0]
+                     + (size_t)(iz / PATCH_BUCKET) * pidx->nb[0] * pidx->nb[1];
+
+            /* Find closest point on any candidate patch within the band.
+             * Take the closest over every patch that can reach the cell,
+             * not just one: testing them all avoids the grid topology
+             * issue where adjacent patches create false internal surfaces. */
+            double best_dist = 1e30;
+            for (int k = pidx->start[b]; k < pidx->start[b + 1]; k++) {
+                const BzPatch *bp = &pidx->patches[pidx->items[k]];
+
+                /* Quick AABB rejection */
+                const ts_vec3 pmin = bp->bmin, pmax = bp->bmax;
+                double dx2 = fmax(pmin.v[0]-wx, fmax(0, wx-pmax.v[0]));
+                double dy2 = fmax(pmin.v[1]-wy, fmax(0, wy-pmax.v[1]));
+                double dz2 = fmax(pmin.v[2]-wz, fmax(0, wz-pmax.v[2]));
+                double box_dist = sqrt(dx2*dx2+dy2*dy2+dz2*dz2);
+                if (box_dist > band || box_dist > best_dist) continue;
+
+                double u, v;
+                ts_bezier_patch_closest_uv(&bp->patch, query, &u, &v, c->newton_iters);
+                ts_vec3 closest = ts_bezier_patch_eval(&bp->patch, u, v);
+                double dist = ts_vec3_distance(closest, query);
+                if (dist < best_dist) best_dist = dist;
+            }
+
+            /* Beyond the band (or a Newton miss): leave it to the sweep */
+            if (best_dist > band) {
+                c->mask[idx] = DC_SDF_FAR;
+                continue;
+            }
+            DC_Voxel *vx = dc_voxel_grid_get(c->grid, ix, iy, iz);
+            if (vx) vx->distance = (float)best_dist;
+            exact++;
+        }
+    }
+
+    g_atomic_int_add(&c->exact, exact);
+    g_atomic_int_add(&c->seed_skipped, seed_skipped);
+}
+
+typedef struct {
+    DC_VoxelGrid *grid;
+    float        *tmp;
+    int           sx, sy;
+} SmoothCtx;
+
+/* Copy one layer's unsigned distances into tmp */
+static void
+smooth_read_layer(void *data, int iz)
+{
+    SmoothCtx *c = data;
+    for (int iy = 0; iy < c->sy; iy++)
+    for (int ix = 0; ix < c->sx; ix++) {
+        size_t idx = (size_t)iz * c->sy * c->sx + (size_t)iy * c->sx + ix;
+        DC_Voxel *vx = dc_voxel_grid_get(c->grid, ix, iy, iz);
+        c->tmp[idx] = vx ? fabsf(vx->distance) : 1e6f;
+    }
+}
+
+/* 6-connected weighted average of tmp into interior layer item + 1 */
+static void
+smooth_write_layer(void *data, int item)
+{
+    SmoothCtx *c = data;
+    int sx = c->sx, sy = c->sy, iz = item + 1;
+    const float *tmp = c->tmp;
+    for (int iy = 1; iy < sy-1; iy++)
+    for (int ix = 1; ix < sx-1; ix++) {
+        size_t idx = (size_t)iz * sy * sx + (size_t)iy * sx + ix;
+        float ctr = tmp[idx];
+        float sum = ctr * 6.0f;
+        sum += tmp[idx-1] + tmp[idx+1];
+        sum += tmp[idx-sx] + tmp[idx+sx];
+        sum += tmp[idx-(size_t)sy*sx] + tmp[idx+(size_t)sy*sx];
+        float smoothed = sum / 12.0f;
+        DC_Voxel *vx = dc_voxel_grid_get(c->grid, ix, iy, iz);
+        if (vx) {
+            float sign = vx->distance < 0 ? -1.0f : 1.0f;
+            vx->distance = sign * smoothed;
+        }
+    }
+}
+
 DC_VoxelGrid *
 dc_voxelize_bezier(const void *mesh_ptr, int resolution,
                      int band_cells, int newton_iters,
                      DC_Error *err)
+{
+    return dc_voxelize_bezier_ex(mesh_ptr, resolution, band_cells,
+                                 newton_iters, NULL, err);
+}
+
+DC_VoxelGrid *
+dc_voxelize_bezier_seeded(const void *mesh_ptr, int resolution,
+                            int band_cells, int newton_iters,
+                            const DC_VoxelGrid *seed, DC_Error *err)
+{
+    DC_VoxelizeBezierOpts opts = { .seed = seed };
+    return dc_voxelize_bezier_ex(mesh_ptr, resolution, band_cells,
+                                 newton_iters, &opts, err);
+}
+
+DC_VoxelGrid *
+dc_voxelize_bezier_ex(const void *mesh_ptr, int resolution,
+                        int band_cells, int newton_iters,
+                        const DC_VoxelizeBezierOpts *opts, DC_Error *err)
 {
     const ts_bezier_mesh *mesh = (const ts_bezier_mesh *)mesh_ptr;
 
@@ -96,93 +361,78 @@ dc_voxelize_bezier(const void *mesh_ptr, int resolution,
 
     double band = band_cells * (double)cell_size;
 
-    /* For each patch: narrow-band unsigned distance evaluation.
-     * Use the mesh's closest-point function which tests ALL patches and
-     * returns the globally closest point. This avoids the grid topology
-     * issue where adjacent patches create false internal surfaces. */
-    for (int iz = 0; iz < sz; iz++) {
-        for (int iy = 0; iy < sy; iy++) {
-            for (int ix = 0; ix < sx; ix++) {
-                float wx, wy, wz;
-                /* Compute world position manually — cell_center doesn't include origin */
-                wx = ox + ((float)ix + 0.5f) * cell_size;
-                wy = oy + ((float)iy + 0.5f) * cell_size;
-                wz = oz + ((float)iz + 0.5f) * cell_size;
-                ts_vec3 query = ts_vec3_make(wx, wy, wz);
-
-                /* Find closest point on ANY patch in the mesh */
-                double best_dist = 1e30;
-                for (int pr = 0; pr < mesh->rows; pr++) {
-                    for (int pc = 0; pc < mesh->cols; pc++) {
-                        ts_bezier_patch patch = ts_bezier_mesh_get_patch(mesh, pr, pc);
-
-                        /* Quick AABB rejection */
-                        ts_vec3 pmin, pmax;
-                        ts_bezier_patch_bbox(&patch, &pmin, &pmax);
-                        double dx2 = fmax(pmin.v[0]-wx, fmax(0, wx-pmax.v[0]));
-                        double dy2 = fmax(pmin.v[1]-wy, fmax(0, wy-pmax.v[1]));
-                        double dz2 = fmax(pmin.v[2]-wz, fmax(0, wz-pmax.v[2]));
-                        if (sqrt(dx2*dx2+dy2*dy2+dz2*dz2) > best_dist + band) continue;
-
-                        double u, v;
-                        ts_bezier_patch_closest_uv(&patch, query, &u, &v, newton_iters);
-                        ts_vec3 closest = ts_bezier_patch_eval(&patch, u, v);
-                        double dist = ts_vec3_distance(closest, query);
-                        if (dist < best_dist) best_dist = dist;
-                    }
-                }
+    float org[3] = { ox, oy, oz };
+    int dim[3] = { sx, sy, sz };
+    PatchIndex pidx;
+    if (patch_index_build(&pidx, mesh, org, cell_size, dim, band) != 0) {
+        dc_voxel_grid_free(grid);
+        if (err) DC_SET_ERROR(err, DC_ERROR_MEMORY, "patch index alloc");
+        return NULL;
+    }
 
-                DC_Voxel *vx = dc_voxel_grid_get(grid, ix, iy, iz);
-                if (vx && (float)best_dist < fabsf(vx->distance)) {
-                    vx->distance = (float)best_dist;
-                }
-            }
-        }
+    /* --- Narrow band ---
+     * Only cells whose centre lies inside some patch's control-point AABB
+     * grown by the band can be within `band` of the surface (convex hull
+     * property). Mark those; everything else is filled by the sweep. */
+    size_t total = (size_t)sx * sy * sz;
+    uint8_t *mask = calloc(total, 1);
+    if (!mask) {
+        patch_index_free(&pidx);
+        dc_voxel_grid_free(grid);
+        if (err) DC_SET_ERROR(err, DC_ERROR_MEMORY, "band mask alloc");
+        return NULL;
+    }
+    for (int i = 0; i < pidx.count; i++) {
+        const BzPatch *bp = &pidx.patches[i];
+        for (int iz = bp->lo[2]; iz <= bp->hi[2]; iz++)
+        for (int iy = bp->lo[1]; iy <= bp->hi[1]; iy++)
+        for (int ix = bp->lo[0]; ix <= bp->hi[0]; ix++)
+            mask[(size_t)ix + (size_t)iy*sx + (size_t)iz*sx*sy] = DC_SDF_FROZEN;
     }
 
-    /* --- Gap-closing pass ---
-     * At mesh edges/corners, the surface sampling may leave single-cell
-     * gaps where no surface sample was close enough. Close these gaps by
-     * propagating distances: if a voxel has large distance but a neighbor
-     * has small distance, the voxel is likely a gap in the surface shell.
-     * Set its distance to neighbor + cell_size to seal the gap. */
-    {
-        int closed = 0;
-        for (int pass = 0; pass < 3; pass++) { /* multiple passes for wider gaps */
-            for (int iz2 = 0; iz2 < sz; iz2++)
-            for (int iy2 = 0; iy2 < sy; iy2++)
-            for (int ix2 = 0; ix2 < sx; ix2++) {
-                DC_Voxel *vx = dc_voxel_grid_get(grid, ix2, iy2, iz2);
-                if (!vx) continue;
-                if (vx->distance <= cell_size * 1.5f) continue; /* already near surface */
-
-                /* Check 6-connected neighbors for surface proximity */
-                static const int ddx[] = {-1,1,0,0,0,0};
-                static const int ddy[] = {0,0,-1,1,0,0};
-                static const int ddz[] = {0,0,0,0,-1,1};
-                for (int d = 0; d < 6; d++) {
-                    int nx = ix2+ddx[d], ny = iy2+ddy[d], nz = iz2+ddz[d];
-                    if (nx < 0 || ny < 0 || nz < 0 ||
-                        nx >= sx || ny >= sy || nz >= sz) continue;
-                    DC_Voxel *nv = dc_voxel_grid_get(grid, nx, ny, nz);
-                    if (nv && nv->distance < cell_size) {
-                        /* This voxel is next to a surface voxel but has large distance.
-                         * It's a gap. Set its distance to propagate the surface shell. */
-                        float prop = nv->distance + cell_size;
-                        if (prop < vx->distance) {
-                            vx->distance = prop;
-                            closed++;
-                        }
-                        break;
-                    }
-                }
-            }
-        }
-        if (closed > 0) {
-            dc_log(DC_LOG_INFO, DC_LOG_EVENT_APP,
-                   "voxelize_bezier: closed %d surface gaps", closed);
-        }
+    BandCtx bc = {
+        .pidx = &pidx, .grid = grid, .mask = mask,
+        .org = { ox, oy, oz }, .cs = cell_size,
+        .sx = sx, .sy = sy, .band = band, .newton_iters = newton_iters,
+    };
+    const DC_VoxelGrid *seed = opts ? opts->seed : NULL;
+    if (seed) {
+        bc.seed = seed;
+        bc.seed_reach = band + 2.0 * dc_voxel_grid_cell_size(seed);
+    }
+    int threads = opts ? opts->threads : 0;
+    volatile int *cancel = opts ? opts->cancel : NULL;
+
+    /* Exact unsigned distance for band cells, one Z layer per pool item */
+    int stopped = dc_voxel_pool_run(band_layer, &bc, sz, threads, cancel);
+    patch_index_free(&pidx);
+    if (stopped) {
+        free(mask);
+        dc_voxel_grid_free(grid);
+        return NULL;
     }
+    size_t exact = (size_t)bc.exact, seed_skipped = (size_t)bc.seed_skipped;
+
+    /* --- Distance propagation ---
+     * Fast sweeping fills every cell outside the band with an Eikonal
+     * distance in O(N). It also seals single-cell gaps where the Newton
+     * solve overshot at patch edges: those cells either fall out of the
+     * band or get clamped by their frozen neighbours. This gives the
+     * smooth raymarcher a proper distance field for the entire grid. */
+    int rounds = dc_sdf_sweep(grid, mask, 0);
+    free(mask);
+    if (rounds < 0) {
+        dc_voxel_grid_free(grid);
+        if (err) DC_SET_ERROR(err, DC_ERROR_MEMORY, "distance sweep alloc");
+        return NULL;
+    }
+    if (cancel && g_atomic_int_get(cancel)) {
+        dc_voxel_grid_free(grid);
+        return NULL;
+    }
+    dc_log(DC_LOG_INFO, DC_LOG_EVENT_APP,
+           "voxelize_bezier: %zu of %zu cells exact, %zu skipped by seed, "
+           "%d sweep rounds", exact, total, seed_skipped, rounds);
 
     /* --- Flood-fill sign determination ---
      * Instead of per-patch normal sign (which fails at seams),
@@ -255,44 +505,6 @@ dc_voxelize_bezier(const void *mesh_ptr, int resolution,
         }
     }
 
-    /* --- Distance propagation ---
-     * The Newton solver only computes distances within the narrow band.
-     * Voxels far from the surface have HUGE_VALF, which makes the smooth
-     * raymarcher's trilinear interpolation produce garbage.
-     * Propagate distances outward: each voxel's distance is min of its
-     * current distance and (neighbor distance + cell_size).
-     * This gives a proper distance field for the entire grid. */
-    {
-        int changed = 1;
-        for (int pass = 0; pass < 64 && changed; pass++) {
-            changed = 0;
-            for (int iz2 = 0; iz2 < sz; iz2++)
-            for (int iy2 = 0; iy2 < sy; iy2++)
-            for (int ix2 = 0; ix2 < sx; ix2++) {
-                DC_Voxel *vx = dc_voxel_grid_get(grid, ix2, iy2, iz2);
-                if (!vx) continue;
-                float cur = fabsf(vx->distance);
-                static const int ddx[] = {-1,1,0,0,0,0};
-                static const int ddy[] = {0,0,-1,1,0,0};
-                static const int ddz[] = {0,0,0,0,-1,1};
-                for (int d = 0; d < 6; d++) {
-                    int nx = ix2+ddx[d], ny = iy2+ddy[d], nz = iz2+ddz[d];
-                    if (nx < 0 || ny < 0 || nz < 0 ||
-                        nx >= sx || ny >= sy || nz >= sz) continue;
-                    DC_Voxel *nv = dc_voxel_grid_get(grid, nx, ny, nz);
-                    if (!nv) continue;
-                    float prop = fabsf(nv->distance) + cell_size;
-                    if (prop < cur) {
-                        cur = prop;
-                        float sign = vx->distance < 0 ? -1.0f : 1.0f;
-                        vx->distance = sign * cur;
-                        changed = 1;
-                    }
-                }
-            }
-        }
-    }
-
     /* --- SDF smoothing (sign-preserving) ---
      * The Newton solver uses a single starting point, causing
      * inconsistent distances near patch boundaries (ring artifacts).
@@ -302,32 +514,10 @@ dc_voxelize_bezier(const void *mesh_ptr, int resolution,
         size_t total = (size_t)sx * sy * sz;
         float *tmp = malloc(total * sizeof(float));
         if (tmp) {
+            SmoothCtx sc = { .grid = grid, .tmp = tmp, .sx = sx, .sy = sy };
             for (int pass = 0; pass < 3; pass++) {
-                /* Read unsigned distances */
-                for (int iz2 = 0; iz2 < sz; iz2++)
-                for (int iy2 = 0; iy2 < sy; iy2++)
-                for (int ix2 = 0; ix2 < sx; ix2++) {
-                    size_t idx = (size_t)iz2 * sy * sx + (size_t)iy2 * sx + ix2;
-                    DC_Voxel *vx = dc_voxel_grid_get(grid, ix2, iy2, iz2);
-                    tmp[idx] = vx ? fabsf(vx->distance) : 1e6f;
-                }
-                /* Apply 6-connected weighted average on unsigned distances */
-                for (int iz2 = 1; iz2 < sz-1; iz2++)
-                for (int iy2 = 1; iy2 < sy-1; iy2++)
-                for (int ix2 = 1; ix2 < sx-1; ix2++) {
-                    size_t idx = (size_t)iz2 * sy * sx + (size_t)iy2 * sx + ix2;
-                    float c = tmp[idx];
-                    float sum = c * 6.0f;
-                    sum += tmp[idx-1] + tmp[idx+1];
-                    sum += tmp[idx-sx] + tmp[idx+sx];
-                    sum += tmp[idx-(size_t)sy*sx] + tmp[idx+(size_t)sy*sx];
-                    float smoothed = sum / 12.0f;
-                    DC_Voxel *vx = dc_voxel_grid_get(grid, ix2, iy2, iz2);
-                    if (vx) {
-                        float sign = vx->distance < 0 ? -1.0f : 1.0f;
-                        vx->distance = sign * smoothed;
-                    }
-                }
+                dc_voxel_pool_run(smooth_read_layer, &sc, sz, threads, NULL);
+                dc_voxel_pool_run(smooth_write_layer, &sc, sz - 2, threads, NULL);
             }
             free(tmp);
         }
@@ -8,13 +8,15 @@
  * signed distance values. The bezier math is evaluated directly — no
  * intermediate triangle mesh. The surface is lossless at every scale.
  *
- * Algorithm (per patch):
- *   1. Compute patch AABB, expand by narrowband width
- *   2. For each voxel in the expanded AABB:
- *      a. Newton-solve for closest (u,v) on the patch
- *      b. Compute signed distance via surface normal
- *      c. Min with existing value (closest surface wins)
- *   3. Activate cells where distance <= 0
+ * Algorithm:
+ *   1. Mark voxels within band_cells of some patch AABB
+ *   2. For each marked voxel, Newton-solve for the closest (u,v) on the
+ *      nearby patches; keep distances that fall inside the band
+ *   3. Fast-sweep that band into a distance for every voxel
+ *   4. Flood-fill the outside from a corner; the rest is inside
+ *
+ * Steps 1-2 and the final smoothing run per Z layer on the shared voxel
+ * worker pool.
  *
  * No GTK dependency.
  */
@@ -40,4 +42,34 @@ DC_VoxelGrid *dc_voxelize_bezier(const void *mesh, int resolution,
                                    int band_cells, int newton_iters,
                                    DC_Error *err);
 
+/* Options for dc_voxelize_bezier_ex. Zero-initialized (or NULL) opts
+ * give the defaults.
+ *
+ * seed: an earlier grid of the same mesh, typically a coarser pass. Band
+ * voxels it places well clear of the surface skip the Newton solve; the
+ * result is the same as unseeded. Only read.
+ *
+ * threads: threads for the per-layer work on the shared pool
+ * (voxel_pool.h). 0 = the whole pool, 1 = serial. Output is identical
+ * for any thread count.
+ *
+ * cancel: optional flag polled between layers. Once nonzero the call
+ * stops early and returns NULL without setting err. */
+typedef struct {
+    const DC_VoxelGrid *seed;
+    int                 threads;
+    volatile int       *cancel;
+} DC_VoxelizeBezierOpts;
+
+DC_VoxelGrid *dc_voxelize_bezier_ex(const void *mesh, int resolution,
+                                      int band_cells, int newton_iters,
+                                      const DC_VoxelizeBezierOpts *opts,
+                                      DC_Error *err);
+
+/* dc_voxelize_bezier_ex with only a seed (may be NULL). */
+DC_VoxelGrid *dc_voxelize_bezier_seeded(const void *mesh, int resolution,
+                                          int band_cells, int newton_iters,
+                                          const DC_VoxelGrid *seed,
+                                          DC_Error *err);
+
 #endif /* DC_VOXELIZE_BEZIER_H */
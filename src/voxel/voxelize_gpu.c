@@ -6,8 +6,16 @@
  * pass posts the result to the main thread so the user sees the
  * shape immediately and watches it sharpen.
  *
+ * Each pass seeds the next: the worker keeps a copy of the coarser
+ * grid, and the finer pass skips the closest-point solve wherever the
+ * upsampled coarse distance is clearly outside its narrow band.
+ *
+ * The thread here only sequences the passes; each pass fans its Z
+ * layers out over the shared voxel pool (voxel_pool.h) and stops between
+ * layers once dc_voxelize_async_cancel() raises the worker's flag.
+ *
  * GPU path (OpenCL): TODO — will accelerate the SDF evaluation.
- * CPU path: background GLib thread, works everywhere.
+ * CPU path: background GLib thread plus the voxel pool, works everywhere.
  */
 
 #include "voxel/voxelize_gpu.h"
@@ -110,39 +118,53 @@ voxelize_thread(gpointer data)
            "voxelize_async: coarse-to-fine, %d passes, target=%d",
            n_passes, w->target_res);
 
+    /* Previous pass's grid; posted grids belong to the main thread */
+    DC_VoxelGrid *seed = NULL;
+
     for (int p = 0; p < n_passes && !w->cancelled; p++) {
         int r = passes[p];
+        int last = (p == n_passes - 1);
         DC_Error err = {0};
 
         dc_log(DC_LOG_INFO, DC_LOG_EVENT_APP,
                "voxelize_async: pass %d/%d res=%d", p+1, n_passes, r);
 
-        DC_VoxelGrid *grid = dc_voxelize_bezier(w->mesh_ptr, r, 2, 15, &err);
+        DC_VoxelizeBezierOpts opts = {
+            .seed = seed,
+            .cancel = &w->cancelled,
+        };
+        DC_VoxelGrid *grid = dc_voxelize_bezier_ex(w->mesh_ptr, r, 2, 15,
+                                                   &opts, &err);
 
         if (w->cancelled) {
             dc_voxel_grid_free(grid);
             break;
         }
 
+        dc_voxel_grid_free(seed);
+        seed = (grid && !last) ? dc_voxel_grid_copy(grid) : NULL;
+
+        if (last) {
+            dc_log(DC_LOG_INFO, DC_LOG_EVENT_APP,
+                   "voxelize_async: final pass done, %zu active",
+                   grid ? dc_voxel_grid_active_count(grid) : 0);
+        }
+
         /* Post this pass's result to main thread */
         PassResult *pr = calloc(1, sizeof(PassResult));
         if (pr) {
             pr->worker = w;
             pr->grid = grid;
-            pr->final = (p == n_passes - 1);
+            pr->final = last;
             pr->pass_res = r;
             g_idle_add(on_pass_done, pr);
         } else {
             dc_voxel_grid_free(grid);
         }
-
-        if (p == n_passes - 1) {
-            dc_log(DC_LOG_INFO, DC_LOG_EVENT_APP,
-                   "voxelize_async: final pass done, %zu active",
-                   grid ? dc_voxel_grid_active_count(grid) : 0);
-        }
     }
 
+    dc_voxel_grid_free(seed);
+
     /* If cancelled before any pass posted final, clean up */
     if (w->cancelled) {
         PassResult *pr = calloc(1, sizeof(PassResult));
@@ -16,6 +16,53 @@
 #include "voxel/voxel.h"
 #include "core/error.h"
 
+/* -------------------------------------------------------------------------
+ * Options
+ * ---------------------------------------------------------------------- */
+
+/* Spatial acceleration for the per-voxel triangle queries. */
+typedef enum {
+    DC_VOXELIZE_ACCEL_BVH = 0,  /* BVH over triangles (default) */
+    DC_VOXELIZE_ACCEL_NONE,     /* brute force, O(voxels * triangles) */
+} DC_VoxelizeAccel;
+
+/* Inside/outside test for the distance sign. */
+typedef enum {
+    DC_VOXELIZE_SIGN_PARITY = 0, /* +X ray crossing parity (default) */
+    DC_VOXELIZE_SIGN_WINDING,    /* generalized winding number, robust to
+                                  * holes and non-manifold edges */
+} DC_VoxelizeSign;
+
+/* Zero-initialized opts (or NULL) select the defaults.
+ *
+ * threads: worker count for the Z-slab split. 0 = the whole shared pool
+ * (voxel_pool.h, one per CPU), 1 = serial on the calling thread. Output
+ * is bit-identical for any thread count.
+ *
+ * sign: DC_VOXELIZE_SIGN_WINDING treats a voxel as inside when the mesh's
+ * winding number there exceeds 0.5 in magnitude. With the BVH it uses a
+ * hierarchical dipole approximation, so it can differ from the exact
+ * brute-force sum on voxels that sit right at the 0.5 level set.
+ *
+ * band_cells: half-width of the narrow band, in cells, where distance is
+ * computed exactly. 0 = DC_SDF_BAND_CELLS. Cells outside the band get a
+ * fast-sweeping approximation (sdf_sweep.h) and the sign of their
+ * connected region; regions the band does not seal off (a leaky mesh) are
+ * signed per cell. Negative = exact distance and sign at every cell.
+ *
+ * progress_done / progress_total: optional. When set, *progress_total
+ * receives the number of Z-slabs and *progress_done counts finished slabs
+ * while voxelization runs (safe to poll from another thread). Matches the
+ * layout of ts_progress so callers can point at its fields. */
+typedef struct {
+    DC_VoxelizeAccel accel;
+    DC_VoxelizeSign  sign;
+    int              threads;
+    int              band_cells;
+    volatile int    *progress_done;
+    volatile int    *progress_total;
+} DC_VoxelizeStlOpts;
+
 /* Voxelize an STL file into an SDF grid.
  *
  * resolution: grid cells per longest axis dimension (e.g. 64, 128, 256)
@@ -33,4 +80,13 @@ DC_VoxelGrid *dc_voxelize_stl(const char *stl_path, int resolution,
 DC_VoxelGrid *dc_voxelize_triangles(const float *data, int num_triangles,
                                       int resolution, DC_Error *err);
 
+/* Variants taking explicit options. opts may be NULL. */
+DC_VoxelGrid *dc_voxelize_stl_ex(const char *stl_path, int resolution,
+                                   const DC_VoxelizeStlOpts *opts,
+                                   DC_Error *err);
+DC_VoxelGrid *dc_voxelize_triangles_ex(const float *data, int num_triangles,
+                                         int resolution,
+                                         const DC_VoxelizeStlOpts *opts,
+                                         DC_Error *err);
+
 #endif /* DC_VOXELIZE_STL_H */
@@ -32,6 +32,8 @@
 #include <string.h>
 #include <math.h>
 #include <float.h>
+#include <pthread.h>
+#include <unistd.h>
 
 #ifndef M_E
 #define M_E 2.71828182845904523536
@@ -1412,6 +1414,332 @@ static void test_csg_intersection_red(void) {
     TS_PASS();
 }
 
+/* --- UNION REDUCTION --- */
+/* GREEN: disjoint cubes are concatenated, not BSP-processed */
+static void test_csg_union_reduce_green(void) {
+    ts_mesh m[5];
+    for (int i = 0; i < 5; i++) {
+        m[i] = ts_mesh_init();
+        ts_gen_cube(1, 1, 1, &m[i]);
+        for (int k = 0; k < m[i].vert_count; k++) m[i].verts[k].pos[0] += 3.0 * i;
+    }
+    ts_mesh out = ts_csg_union_reduce(m, 5);
+    TS_ASSERT_EQ_INT(out.tri_count, 5 * 12);
+    TS_ASSERT_NEAR(fabs(mesh_signed_volume(&out)), 5.0, 1e-9);
+    ts_mesh_free(&out);
+    TS_PASS();
+}
+
+/* RED: overlapping cubes must be unioned, not just concatenated */
+static void test_csg_union_reduce_red(void) {
+    ts_mesh m[3];
+    for (int i = 0; i < 3; i++) {
+        m[i] = ts_mesh_init();
+        ts_gen_cube(2, 2, 2, &m[i]);
+        for (int k = 0; k < m[i].vert_count; k++) m[i].verts[k].pos[0] += 1.0 * i;
+    }
+    ts_mesh out = ts_csg_union_reduce(m, 3);
+    /* Concatenation would give 24; the union is a 4x2x2 box */
+    TS_ASSERT_NEAR(fabs(mesh_signed_volume(&out)), 16.0, 0.1);
+    ts_mesh_free(&out);
+    TS_PASS();
+}
+
+/* GREEN: overlap chains form one cluster; isolated meshes pass through */
+static void test_csg_union_clusters_green(void) {
+    /* a-b-c chained (a and c only meet through b), d far away */
+    const double off[4] = { 0.0, 1.5, 3.0, 10.0 };
+    ts_mesh m[4];
+    for (int i = 0; i < 4; i++) {
+        m[i] = ts_mesh_init();
+        ts_gen_cube(2, 2, 2, &m[i]);
+        for (int k = 0; k < m[i].vert_count; k++) m[i].verts[k].pos[0] += off[i];
+    }
+    ts_mesh out = ts_csg_union_clusters(m, 4);
+    /* Chain spans x in [0,5]: 5*2*2, plus the lone 2x2x2 cube */
+    TS_ASSERT_NEAR(fabs(mesh_signed_volume(&out)), 20.0 + 8.0, 0.1);
+    ts_mesh_free(&out);
+    TS_PASS();
+}
+
+/* RED: no overlap anywhere means no boolean — triangles are untouched */
+static void test_csg_union_clusters_red(void) {
+    ts_mesh m[6];
+    for (int i = 0; i < 6; i++) {
+        m[i] = ts_mesh_init();
+        ts_gen_cube(1, 1, 1, &m[i]);
+        /* Reverse x order exercises the sweep sort */
+        for (int k = 0; k < m[i].vert_count; k++) m[i].verts[k].pos[0] += 2.0 * (5 - i);
+    }
+    ts_mesh out = ts_csg_union_clusters(m, 6);
+    TS_ASSERT_EQ_INT(out.tri_count, 6 * 12);
+    /* Cluster order follows input order: first triangles belong to m[0] */
+    TS_ASSERT_TRUE(out.verts[out.tris[0].idx[0]].pos[0] >= 9.0);
+    ts_mesh_free(&out);
+
+    ts_mesh none = ts_csg_union_clusters(NULL, 0);
+    TS_ASSERT_EQ_INT(none.tri_count, 0);
+    TS_PASS();
+}
+
+/* --- BSP SPLITTER SELECTION --- */
+/* Rod with a cross hole: 10x10 footprint along z, 4 radius hole along x */
+static void csg_cross_rod(int fn, ts_mesh *rod, ts_mesh *hole) {
+    ts_gen_cylinder(40.0, 10.0, 10.0, fn, rod);
+    for (int i = 0; i < rod->vert_count; i++) rod->verts[i].pos[2] -= 20.0;
+    ts_gen_cylinder(30.0, 4.0, 4.0, fn, hole);
+    for (int i = 0; i < hole->vert_count; i++) {
+        double *p = hole->verts[i].pos;
+        double x = p[0], y = p[1], z = p[2] - 15.0;
+        p[0] = y; p[1] = z; p[2] = x;
+    }
+}
+
+/* GREEN: SAH splitter gives the same solid with fewer polygon splits */
+static void test_csg_bsp_splitter_green(void) {
+    ts_mesh rod = ts_mesh_init(), hole = ts_mesh_init();
+    ts_mesh first = ts_mesh_init(), sah = ts_mesh_init();
+    csg_cross_rod(64, &rod, &hole);
+
+    ts_csg_bsp_stats sf, ss;
+    int r1 = ts_csg_boolean_ex(&rod, &hole, TS_CSG_OP_DIFFERENCE, &first,
+                               TS_CSG_SPLIT_FIRST, &sf);
+    int r2 = ts_csg_boolean_ex(&rod, &hole, TS_CSG_OP_DIFFERENCE, &sah,
+                               TS_CSG_SPLIT_SAH, &ss);
+    TS_ASSERT_EQ_INT(r1, TS_CSG_OK);
+    TS_ASSERT_EQ_INT(r2, TS_CSG_OK);
+
+    double vf = mesh_signed_volume(&first), vs = mesh_signed_volume(&sah);
+    TS_ASSERT_TRUE(vf > 11000.0 && vf < 13000.0);
+    TS_ASSERT_NEAR(vs, vf, 1e-6 * vf);
+    TS_ASSERT_TRUE(ss.nodes > 0 && sf.nodes > 0);
+    TS_ASSERT_TRUE(ss.max_depth <= sf.max_depth);
+    TS_ASSERT_TRUE(ss.splits + ss.clip_splits < sf.splits + sf.clip_splits);
+    TS_ASSERT_TRUE(sah.tri_count < first.tri_count);
+
+    ts_mesh_free(&rod); ts_mesh_free(&hole);
+    ts_mesh_free(&first); ts_mesh_free(&sah);
+    TS_PASS();
+}
+
+/* Build a BSP from polys with the given splitter; returns the stats and
+ * the root plane's normal length squared */
+static ts_csg_bsp_stats csg_build_stats(ts_csg_polylist *pl, ts_csg_split_t splitter,
+                                        double *root_n2) {
+    ts_csg_ctx ctx = ts_csg_ctx_init();
+    ctx.eps = 1e-9;
+    ctx.splitter = splitter;
+    ts_csg_bsp *bsp = ts_csg_bsp_new();
+    ts_csg_bsp_build(&ctx, bsp, pl);
+    *root_n2 = bsp->plane[0]*bsp->plane[0] + bsp->plane[1]*bsp->plane[1] +
+               bsp->plane[2]*bsp->plane[2];
+    ts_csg_bsp_stats st = ctx.stats;
+    ts_csg_bsp_free(bsp);
+    ts_csg_ctx_free(&ctx);
+    return st;
+}
+
+/* RED: a zero-area facet is never the splitter. FIRST takes it and puts
+ * every polygon at the root; SAH skips it and builds a real tree */
+static void test_csg_bsp_splitter_red(void) {
+    /* Cube with a zero-area sliver in front of its faces */
+    ts_mesh box = ts_mesh_init();
+    ts_gen_cube(2, 2, 2, &box);
+    ts_csg_polylist faces = ts_csg_mesh_to_polys(&box);
+    for (int k = 0; k < 2; k++) {
+        ts_csg_polylist pl = ts_csg_polylist_init();
+        ts_csg_poly sliver = ts_csg_poly_init();
+        ts_csg_vertex v = { 0.25, 0.25, 0.25, 0, 0, 0 };
+        for (int j = 0; j < 3; j++) {
+            v.x += 0.1;
+            v.y += 0.1;
+            ts_csg_poly_add_vert(&sliver, v);  /* collinear */
+        }
+        ts_csg_poly_calc_plane(&sliver);
+        ts_csg_polylist_push(&pl, sliver);
+        for (int i = 0; i < faces.count; i++)
+            ts_csg_polylist_push(&pl, ts_csg_poly_clone(&faces.items[i]));
+
+        double n2;
+        ts_csg_bsp_stats st = csg_build_stats(&pl, k ? TS_CSG_SPLIT_FIRST
+                                                     : TS_CSG_SPLIT_SAH, &n2);
+        TS_ASSERT_EQ_INT(pl.count, 0);
+        if (k) {
+            TS_ASSERT_EQ_INT(st.nodes, 1);        /* degenerate root */
+            TS_ASSERT_TRUE(n2 < 0.5);
+        } else {
+            TS_ASSERT_NEAR(n2, 1.0, 1e-9);        /* a real face plane */
+            TS_ASSERT_TRUE(st.nodes >= 6);        /* one per face direction */
+        }
+    }
+    ts_csg_polylist_free(&faces);
+
+    /* Sphere: pole triangles come first in the generated mesh */
+    ts_mesh ball = ts_mesh_init();
+    ts_gen_sphere(5.0, 32, &ball);
+    double n2_sah, n2_first;
+    ts_csg_polylist pl = ts_csg_mesh_to_polys(&ball);
+    ts_csg_bsp_stats ss = csg_build_stats(&pl, TS_CSG_SPLIT_SAH, &n2_sah);
+    pl = ts_csg_mesh_to_polys(&ball);
+    ts_csg_bsp_stats sf = csg_build_stats(&pl, TS_CSG_SPLIT_FIRST, &n2_first);
+    TS_ASSERT_TRUE(n2_first < 0.5);
+    TS_ASSERT_NEAR(n2_sah, 1.0, 1e-9);
+    TS_ASSERT_TRUE(ss.nodes > sf.nodes);
+
+    /* Non-degenerate operands: SAH is never deeper or larger than FIRST */
+    ts_mesh rod = ts_mesh_init(), hole = ts_mesh_init(), out = ts_mesh_init();
+    csg_cross_rod(64, &rod, &hole);
+    ts_csg_boolean_ex(&rod, &hole, TS_CSG_OP_UNION, &out, TS_CSG_SPLIT_FIRST, &sf);
+    ts_mesh_free(&out);
+    ts_csg_boolean_ex(&rod, &hole, TS_CSG_OP_UNION, &out, TS_CSG_SPLIT_SAH, &ss);
+    TS_ASSERT_TRUE(ss.nodes <= sf.nodes);
+    TS_ASSERT_TRUE(ss.max_depth <= sf.max_depth);
+    TS_ASSERT_TRUE(ss.clip_splits < sf.clip_splits);
+    ts_mesh_free(&out);
+
+    /* Operations that build no tree report empty stats */
+    ts_mesh far = ts_mesh_init();
+    ts_gen_cube(1, 1, 1, &far);
+    for (int i = 0; i < far.vert_count; i++) far.verts[i].pos[0] += 100.0;
+    ts_csg_bsp_stats st = { 7, 7, 7, 7 };
+    ts_csg_boolean_ex(&ball, &far, TS_CSG_OP_UNION, &out, TS_CSG_SPLIT_SAH, &st);
+    TS_ASSERT_EQ_INT(st.nodes, 0);
+    TS_ASSERT_EQ_INT(st.max_depth, 0);
+    TS_ASSERT_EQ_INT(ts_csg_boolean_ex(NULL, &far, TS_CSG_OP_UNION, &out,
+                                       TS_CSG_SPLIT_SAH, &st), TS_CSG_ERROR);
+
+    ts_mesh_free(&box); ts_mesh_free(&ball); ts_mesh_free(&far);
+    ts_mesh_free(&rod); ts_mesh_free(&hole); ts_mesh_free(&out);
+    TS_PASS();
+}
+
+/* A convex operand gives SAH a tree as deep as its facet count; the
+ * clip, invert, collect and free walks must not recurse that deep.
+ * Both of these overflowed the stack when only the build was iterative. */
+static void test_csg_bsp_deep_tree(void) {
+    const struct { const char *src; int tris; } cases[] = {
+        { "difference() { sphere(10, $fn=200); cube(5); }\n", 41140 },
+        { "difference() { sphere(10, $fn=300); cube(5); }\n", 91718 },
+    };
+    for (int k = 0; k < 2; k++) {
+        ts_parse_error err = {0};
+        ts_mesh m = ts_interpret(cases[k].src, &err);
+        TS_ASSERT_TRUE(err.msg[0] == '\0');
+        TS_ASSERT_EQ_INT(m.tri_count, cases[k].tris);
+        ts_mesh_free(&m);
+    }
+
+    ts_mesh ball = ts_mesh_init(), box = ts_mesh_init(), out = ts_mesh_init();
+    ts_gen_sphere(10.0, 300, &ball);
+    ts_gen_cube(5, 5, 5, &box);
+    ts_csg_bsp_stats st;
+    TS_ASSERT_EQ_INT(ts_csg_boolean_ex(&ball, &box, TS_CSG_OP_DIFFERENCE, &out,
+                                       TS_CSG_SPLIT_SAH, &st), TS_CSG_OK);
+    TS_ASSERT_TRUE(st.max_depth > 10000);
+    TS_ASSERT_TRUE(out.tri_count > 0);
+    ts_mesh_free(&ball); ts_mesh_free(&box); ts_mesh_free(&out);
+    TS_PASS();
+}
+
+/* --- PARALLEL BOOLEANS --- */
+/* Jobs span six orders of magnitude, so each picks a different adaptive
+ * epsilon: any state shared between concurrent booleans shows up as a
+ * result that differs from the serial run. */
+#define CSG_PAR_THREADS 8
+#define CSG_PAR_ROUNDS  4
+#define CSG_PAR_JOBS    6
+
+typedef struct {
+    double scale;
+    ts_csg_op_t op;
+    int tri_count;   /* serial reference */
+    double vol;
+} csg_par_job;
+
+typedef struct {
+    const csg_par_job *jobs;
+    int seed;
+    int mismatches;
+} csg_par_worker;
+
+static int csg_par_run(const csg_par_job *j, int *tri_count, double *vol) {
+    ts_mesh a = ts_mesh_init(), b = ts_mesh_init(), out = ts_mesh_init();
+    ts_gen_sphere(j->scale, 16, &a);
+    ts_gen_cube(j->scale, j->scale, j->scale, &b);
+    for (int i = 0; i < b.vert_count; i++) b.verts[i].pos[0] += 0.5 * j->scale;
+
+    int ret = ts_csg_boolean(&a, &b, j->op, &out);
+    *tri_count = out.tri_count;
+    *vol = mesh_signed_volume(&out);
+
+    ts_mesh_free(&a); ts_mesh_free(&b); ts_mesh_free(&out);
+    return ret;
+}
+
+static void *csg_par_thread(void *arg) {
+    csg_par_worker *w = (csg_par_worker *)arg;
+    for (int r = 0; r < CSG_PAR_ROUNDS; r++) {
+        for (int k = 0; k < CSG_PAR_JOBS; k++) {
+            const csg_par_job *j = &w->jobs[(k + w->seed + r) % CSG_PAR_JOBS];
+            int n;
+            double v;
+            if (csg_par_run(j, &n, &v) != TS_CSG_OK ||
+                n != j->tri_count || v != j->vol)
+                w->mismatches++;
+        }
+    }
+    return NULL;
+}
+
+/* Run every job on CSG_PAR_THREADS threads at once, each starting at a
+ * different job, and return the total number of results that differ
+ * from the references in jobs (-1 if a thread could not start). */
+static int csg_par_stress(const csg_par_job *jobs) {
+    pthread_t th[CSG_PAR_THREADS];
+    csg_par_worker w[CSG_PAR_THREADS];
+    int started = 0, total = 0;
+    for (int t = 0; t < CSG_PAR_THREADS; t++) {
+        w[t] = (csg_par_worker){ jobs, t, 0 };
+        if (pthread_create(&th[t], NULL, csg_par_thread, &w[t]) != 0) break;
+        started++;
+    }
+    for (int t = 0; t < started; t++) {
+        pthread_join(th[t], NULL);
+        total += w[t].mismatches;
+    }
+    return started == CSG_PAR_THREADS ? total : -1;
+}
+
+static void csg_par_jobs_init(csg_par_job *jobs) {
+    static const double scales[3] = { 1e-3, 1.0, 1e3 };
+    for (int k = 0; k < CSG_PAR_JOBS; k++) {
+        jobs[k].scale = scales[k % 3];
+        jobs[k].op = (k < 3) ? TS_CSG_OP_UNION : TS_CSG_OP_DIFFERENCE;
+        csg_par_run(&jobs[k], &jobs[k].tri_count, &jobs[k].vol);
+    }
+}
+
+/* GREEN: booleans running concurrently match the serial results exactly */
+static void test_csg_parallel_green(void) {
+    csg_par_job jobs[CSG_PAR_JOBS];
+    csg_par_jobs_init(jobs);
+    for (int k = 0; k < CSG_PAR_JOBS; k++)
+        TS_ASSERT_TRUE(jobs[k].tri_count > 0);
+
+    TS_ASSERT_EQ_INT(csg_par_stress(jobs), 0);
+    TS_PASS();
+}
+
+/* RED: a wrong reference must be reported by every thread, every round */
+static void test_csg_parallel_red(void) {
+    csg_par_job jobs[CSG_PAR_JOBS];
+    csg_par_jobs_init(jobs);
+    jobs[1].tri_count++;
+
+    TS_ASSERT_EQ_INT(csg_par_stress(jobs), CSG_PAR_THREADS * CSG_PAR_ROUNDS);
+    TS_PASS();
+}
+
 /* --- HULL --- */
 /* GREEN: hull of a cube's vertices should still be a cube (volume=1) */
 static void test_csg_hull_green(void) {
@@ -1873,6 +2201,238 @@ static void test_mink_interp_fidget_pattern_green(void) {
     TS_PASS();
 }
 
+/* --- Parallel evaluation --- */
+/* Eight independent subassemblies: the top-level block and each
+ * difference() are task groups when threads > 1. */
+static const char *g_par_scad =
+    "$fn = 12;\n"
+    "module part(w) {\n"
+    "    difference() {\n"
+    "        cube([w, w, 2], center=true);\n"
+    "        cylinder(h=4, r=w/4, center=true);\n"
+    "        translate([w/3, 0, 0]) cube([1, 1, 4], center=true);\n"
+    "    }\n"
+    "}\n"
+    "for (i = [0:3]) translate([i*10, 0, 0]) part(4 + i);\n"
+    "translate([0, 10, 0]) part(5);\n"
+    "translate([10, 10, 0]) intersection() { sphere(r=3); cube(4, center=true); }\n"
+    "translate([20, 10, 0]) difference() { sphere(r=3); part(3); }\n"
+    "translate([30, 10, 0]) part(6);\n";
+
+/* GREEN: threaded evaluation gives the same mesh, bit for bit */
+static void test_eval_parallel_green(void) {
+    ts_parse_error err = {0};
+    ts_interpret_opts opts = {0};
+    ts_mesh serial = ts_interpret_ex(g_par_scad, &err, &opts);
+    TS_ASSERT_TRUE(err.msg[0] == '\0');
+    TS_ASSERT_TRUE(serial.tri_count > 0);
+
+    opts.threads = 4;
+    ts_progress progress = {0, 0};
+    opts.progress = &progress;
+    ts_mesh par = ts_interpret_ex(g_par_scad, &err, &opts);
+    TS_ASSERT_EQ_INT(par.vert_count, serial.vert_count);
+    TS_ASSERT_EQ_INT(par.tri_count, serial.tri_count);
+    TS_ASSERT_TRUE(memcmp(par.verts, serial.verts,
+                          (size_t)serial.vert_count * sizeof(serial.verts[0])) == 0);
+    TS_ASSERT_TRUE(memcmp(par.tris, serial.tris,
+                          (size_t)serial.tri_count * sizeof(serial.tris[0])) == 0);
+    TS_ASSERT_EQ_INT(progress.done, progress.total);
+
+    ts_mesh_free(&serial); ts_mesh_free(&par);
+    TS_PASS();
+}
+
+/* GREEN: subtracting the tools' union once removes the same solid as
+ * subtracting them one by one, including overlapping tools */
+static void test_eval_difference_balanced_green(void) {
+    const char *scad =
+        "$fn = 12;\n"
+        "difference() {\n"
+        "    cube([20, 10, 2]);\n"
+        "    for (i = [0:3]) translate([3 + i*4, 3, -1]) cylinder(h=4, r=1);\n"
+        "    translate([3, 7, -1]) cylinder(h=4, r=1);\n"
+        "    translate([3, 7, 1]) cylinder(h=1.01, r1=1, r2=2);\n"
+        "    translate([15, 6, -1]) cube([3, 2, 4]);\n"
+        "}\n";
+    ts_parse_error err = {0};
+    ts_interpret_opts opts = {0};
+    opts.sequential_difference = 1;
+    ts_mesh seq = ts_interpret_ex(scad, &err, &opts);
+    opts.sequential_difference = 0;
+    ts_mesh bal = ts_interpret_ex(scad, &err, &opts);
+    TS_ASSERT_TRUE(err.msg[0] == '\0');
+
+    double vs = mesh_signed_volume(&seq), vb = mesh_signed_volume(&bal);
+    TS_ASSERT_TRUE(vs > 300.0 && vs < 400.0);
+    TS_ASSERT_NEAR(vb, vs, 1e-6 * vs);
+    TS_ASSERT_TRUE(bal.tri_count <= seq.tri_count);
+
+    ts_mesh_free(&seq); ts_mesh_free(&bal);
+    TS_PASS();
+}
+
+/* GREEN: boolean union() merges overlapping children into one solid;
+ * the default concatenation double-counts the overlap */
+static void test_eval_boolean_union_green(void) {
+    const char *scad =
+        "union() {\n"
+        "    s = 2;\n"
+        "    module blk(x) translate([x, 0, 0]) cube(s);\n"
+        "    blk(0);\n"
+        "    blk(1);\n"
+        "    translate([10, 0, 0]) cube(1);\n"
+        "}\n";
+    ts_parse_error err = {0};
+    ts_interpret_opts opts = {0};
+    ts_mesh cat = ts_interpret_ex(scad, &err, &opts);
+    opts.boolean_union = 1;
+    ts_mesh uni = ts_interpret_ex(scad, &err, &opts);
+    TS_ASSERT_TRUE(err.msg[0] == '\0');
+
+    TS_ASSERT_NEAR(mesh_signed_volume(&cat), 8.0 + 8.0 + 1.0, 1e-6);
+    TS_ASSERT_NEAR(mesh_signed_volume(&uni), 12.0 + 1.0, 1e-6);
+
+    ts_mesh_free(&cat); ts_mesh_free(&uni);
+    TS_PASS();
+}
+
+/* RED: disjoint children skip the BSP entirely, serial or pooled */
+static void test_eval_boolean_union_red(void) {
+    const char *scad =
+        "$fn = 16;\n"
+        "union() {\n"
+        "    for (i = [0:4]) translate([i*3, 0, 0]) sphere(1);\n"
+        "    translate([0, 5, 0]) cube(1);\n"
+        "}\n";
+    ts_parse_error err = {0};
+    ts_interpret_opts opts = {0};
+    ts_mesh cat = ts_interpret_ex(scad, &err, &opts);
+    opts.boolean_union = 1;
+    ts_mesh uni = ts_interpret_ex(scad, &err, &opts);
+    opts.threads = 4;
+    ts_mesh par = ts_interpret_ex(scad, &err, &opts);
+    TS_ASSERT_TRUE(err.msg[0] == '\0');
+
+    TS_ASSERT_EQ_INT(uni.tri_count, cat.tri_count);
+    TS_ASSERT_EQ_INT(par.tri_count, cat.tri_count);
+    TS_ASSERT_NEAR(mesh_signed_volume(&uni), mesh_signed_volume(&cat), 1e-9);
+
+    ts_mesh_free(&cat); ts_mesh_free(&uni); ts_mesh_free(&par);
+    TS_PASS();
+}
+
+/* GREEN: for/let/if children are expanded so each instance is its own
+ * union operand — overlapping iterations are unioned, not concatenated */
+static void test_eval_boolean_union_for_green(void) {
+    const char *forms[] = {
+        "union() { for (i = [0:2]) translate([i*0.5, 0, 0]) cube(1); }\n",
+        "union() for (i = [0:2]) translate([i*0.5, 0, 0]) cube(1);\n",
+        "union() {\n"
+        "    if (true) let (d = 0.5) for (i = [0, 1]) translate([i*d, 0, 0]) cube(1);\n"
+        "    if (false) cube(9); else translate([1, 0, 0]) cube(1);\n"
+        "}\n",
+    };
+    for (int k = 0; k < 3; k++) {
+        ts_parse_error err = {0};
+        ts_interpret_opts opts = {0};
+        opts.boolean_union = 1;
+        ts_mesh m = ts_interpret_ex(forms[k], &err, &opts);
+        TS_ASSERT_TRUE(err.msg[0] == '\0');
+        /* Three unit cubes spanning x in [0, 2] */
+        TS_ASSERT_NEAR(mesh_signed_volume(&m), 2.0, 1e-6);
+        ts_mesh_free(&m);
+    }
+    TS_PASS();
+}
+
+/* Run source with stderr captured; returns a heap copy of the output */
+static char *eval_capture_stderr(const char *scad, const ts_interpret_opts *opts) {
+    FILE *tmp = tmpfile();
+    if (!tmp) return NULL;
+    fflush(stderr);
+    int saved = dup(fileno(stderr));
+    dup2(fileno(tmp), fileno(stderr));
+
+    ts_parse_error err = {0};
+    ts_mesh m = ts_interpret_ex(scad, &err, opts);
+    ts_mesh_free(&m);
+
+    fflush(stderr);
+    dup2(saved, fileno(stderr));
+    close(saved);
+    long size = ftell(tmp);
+    char *out = (char *)calloc((size_t)(size > 0 ? size : 0) + 1, 1);
+    rewind(tmp);
+    if (out && size > 0 && fread(out, 1, (size_t)size, tmp) != (size_t)size)
+        out[0] = '\0';
+    fclose(tmp);
+    return out;
+}
+
+/* RED: boolean union must not hoist block-level echo ahead of echoes
+ * from earlier operands, serial or pooled */
+static void test_eval_boolean_union_echo_order(void) {
+    const char *scad =
+        "module m() { echo(\"first\"); cube(1); }\n"
+        "union() {\n"
+        "    m();\n"
+        "    echo(\"second\");\n"
+        "    translate([0.5, 0, 0]) cube(1);\n"
+        "    for (i = [0:1]) { echo(\"third\", i); translate([i, 0, 0.5]) cube(1); }\n"
+        "}\n";
+    for (int threads = 0; threads <= 4; threads += 4) {
+        ts_interpret_opts opts = {0};
+        opts.boolean_union = 1;
+        opts.threads = threads;
+        char *out = eval_capture_stderr(scad, &opts);
+        TS_ASSERT_TRUE(out != NULL);
+        const char *a = strstr(out, "\"first\"");
+        const char *b = strstr(out, "\"second\"");
+        const char *c = strstr(out, "\"third\", 0");
+        const char *d = strstr(out, "\"third\", 1");
+        TS_ASSERT_TRUE(a && b && c && d);
+        TS_ASSERT_TRUE(a < b && b < c && c < d);
+        free(out);
+    }
+    TS_PASS();
+}
+
+/* RED: subtrees that print or write the shared scope must stay in order */
+static void test_eval_parallel_red(void) {
+    const char *scad =
+        "module loud() { echo(\"x\"); cube(1); }\n"
+        "module quiet() { a = 2; cube(a); }\n"
+        "echo(1);\n"
+        "x = 1;\n"
+        "loud();\n"
+        "translate([1, 0, 0]) { y = 2; cube(y); }\n"
+        "quiet();\n"
+        "for (i = [0:2]) { z = i; cube(z); }\n";
+    ts_parse_error err = {0};
+    ts_ast *root = ts_parse(scad, &err);
+    TS_ASSERT_TRUE(err.msg[0] == '\0');
+    TS_ASSERT_TRUE(root && root->type == TS_AST_BLOCK && root->child_count == 8);
+
+    ts_env *env = ts_env_new(NULL);
+    for (int i = 0; i < 2; i++) {  /* register loud, quiet */
+        env->mod_names[env->mod_count] = root->children[i]->str_val;
+        env->mod_defs[env->mod_count++] = root->children[i];
+    }
+
+    int unsafe = !ts_eval_par_safe(root->children[2], env, 0, 0) &&  /* echo */
+                 !ts_eval_par_safe(root->children[3], env, 0, 0) &&  /* x = */
+                 !ts_eval_par_safe(root->children[4], env, 0, 0) &&  /* loud */
+                 !ts_eval_par_safe(root->children[5], env, 0, 0);    /* y = */
+    int safe = ts_eval_par_safe(root->children[6], env, 0, 0) &&     /* quiet */
+               ts_eval_par_safe(root->children[7], env, 0, 0);       /* for */
+    ts_env_free(env);
+    ts_ast_free(root);
+    TS_ASSERT_TRUE(unsafe);
+    TS_ASSERT_TRUE(safe);
+    TS_PASS();
+}
+
 /* ================================================================
  * SECTION 8: EXTRUSION TESTS
  * Linear extrude + rotate extrude
@@ -3656,6 +4216,21 @@ static void run_all_tests(void) {
     ts_run_test("csg_intersection_green", test_csg_intersection_green);
     ts_run_test("csg_intersection_red", test_csg_intersection_red);
 
+    ts_section("CSG: union reduction (pairwise tree)", TS_PAR_REDUCIBLE);
+    ts_run_test("csg_union_reduce_green", test_csg_union_reduce_green);
+    ts_run_test("csg_union_reduce_red", test_csg_union_reduce_red);
+    ts_run_test("csg_union_clusters_green", test_csg_union_clusters_green);
+    ts_run_test("csg_union_clusters_red", test_csg_union_clusters_red);
+
+    ts_section("CSG: BSP splitter selection (SAH)", TS_PAR_SEQUENTIAL);
+    ts_run_test("csg_bsp_splitter_green", test_csg_bsp_splitter_green);
+    ts_run_test("csg_bsp_splitter_red", test_csg_bsp_splitter_red);
+    ts_run_test("csg_bsp_deep_tree", test_csg_bsp_deep_tree);
+
+    ts_section("CSG: concurrent booleans (pthreads)", TS_PAR_TRIVIAL);
+    ts_run_test("csg_parallel_green", test_csg_parallel_green);
+    ts_run_test("csg_parallel_red", test_csg_parallel_red);
+
     ts_section("CSG: hull (Quickhull)", TS_PAR_GPU);
     ts_run_test("csg_hull_green", test_csg_hull_green);
     ts_run_test("csg_hull_red", test_csg_hull_red);
@@ -3681,6 +4256,15 @@ static void run_all_tests(void) {
     ts_run_test("mink_interp_cyl_sphere", test_mink_interp_cyl_sphere_green);
     ts_run_test("mink_interp_fidget_pattern", test_mink_interp_fidget_pattern_green);
 
+    ts_section("EVAL: parallel subtrees (task pool)", TS_PAR_TRIVIAL);
+    ts_run_test("eval_parallel_green", test_eval_parallel_green);
+    ts_run_test("eval_parallel_red", test_eval_parallel_red);
+    ts_run_test("eval_difference_balanced", test_eval_difference_balanced_green);
+    ts_run_test("eval_boolean_union_green", test_eval_boolean_union_green);
+    ts_run_test("eval_boolean_union_red", test_eval_boolean_union_red);
+    ts_run_test("eval_boolean_union_for", test_eval_boolean_union_for_green);
+    ts_run_test("eval_boolean_union_echo_order", test_eval_boolean_union_echo_order);
+
     /* --- Extrusion --- */
     ts_section("EXTRUDE: linear_extrude", TS_PAR_GPU);
     ts_run_test("linear_extrude_green", test_linear_extrude_green);
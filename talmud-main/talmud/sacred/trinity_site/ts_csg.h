@@ -15,6 +15,9 @@
  *   Phase 4: Select triangles based on operation (parallel per-tri)
  *   Phase 5: Merge and deduplicate vertices (parallel sort + reduce)
  *
+ * Thread safety: every operation keeps its state in a ts_csg_ctx of its
+ * own, so independent booleans may run concurrently on separate threads.
+ *
  * OpenSCAD equivalents:
  *   union()         — ts_csg_union
  *   difference()    — ts_csg_difference
@@ -33,12 +36,9 @@
 #define TS_CSG_OK               0
 #define TS_CSG_ERROR           -1
 
-/* Adaptive epsilon for plane classification.
- * Default 1e-5. ts_csg_boolean sets this relative to mesh extents
- * at the start of each operation: eps = max_extent * 1e-8, clamped
- * to [1e-10, 1e-4]. Prevents misclassification for both tiny and huge meshes. */
-static double ts_csg_eps_ = 1e-5;
-#define TS_CSG_EPS ts_csg_eps_
+/* Default epsilon for plane classification (quickhull, and the starting
+ * value of a ts_csg_ctx). */
+#define TS_CSG_EPS 1e-5
 
 /* --- CSG operation type enum --- */
 typedef enum {
@@ -188,6 +188,73 @@ static inline void ts_csg_polylist_steal(ts_csg_polylist *dst,
     src->count = src->cap = 0;
 }
 
+/* ================================================================
+ * CSG CONTEXT — per-operation state
+ *
+ * Everything a boolean needs besides its operands: the classification
+ * epsilon, the BSP splitter strategy, build statistics and a scratch
+ * buffer for per-polygon classes, reused across every BSP node of the
+ * operation. ts_csg_boolean keeps one on its own stack and passes it
+ * down through build/clip/split, so booleans on separate threads share
+ * nothing and need no locking.
+ * ================================================================ */
+
+/* BSP splitting plane selection */
+typedef enum {
+    TS_CSG_SPLIT_SAH,    /* best sampled candidate (default) */
+    TS_CSG_SPLIT_FIRST,  /* first polygon's plane, as csg.js */
+} ts_csg_split_t;
+
+/* SAH splitter: up to TS_CSG_SPLIT_CANDIDATES planes are tried, each
+ * scored on up to TS_CSG_SPLIT_SAMPLE polygons as
+ * spanning * TS_CSG_SPLIT_WEIGHT + |front - back|. */
+#define TS_CSG_SPLIT_CANDIDATES 16
+#define TS_CSG_SPLIT_SAMPLE     256
+#define TS_CSG_SPLIT_WEIGHT     8
+
+/* What the BSP builds of one operation produced */
+typedef struct {
+    int  nodes;        /* nodes that received a splitting plane */
+    int  max_depth;    /* deepest node, root = 0 */
+    long splits;       /* spanning polygons cut in two while building */
+    long clip_splits;  /* ... and while clipping against a tree */
+} ts_csg_bsp_stats;
+
+typedef struct {
+    /* Adaptive epsilon. ts_csg_boolean sets it relative to the mesh
+     * extents: eps = max_extent * 1e-8, clamped to [1e-10, 1e-4].
+     * Prevents misclassification for both tiny and huge meshes. */
+    double eps;
+    int *classes;            /* scratch: one class per polygon */
+    int classes_cap;
+    ts_csg_split_t splitter;
+    ts_csg_bsp_stats stats;
+} ts_csg_ctx;
+
+static inline ts_csg_ctx ts_csg_ctx_init(void) {
+    return (ts_csg_ctx){ TS_CSG_EPS, NULL, 0, TS_CSG_SPLIT_SAH, { 0, 0, 0, 0 } };
+}
+
+static inline void ts_csg_ctx_free(ts_csg_ctx *ctx) {
+    free(ctx->classes);
+    ctx->classes = NULL;
+    ctx->classes_cap = 0;
+}
+
+/* Scratch class array of at least n entries, valid until the next call.
+ * Callers finish with it before recursing. */
+static inline int *ts_csg_ctx_classes(ts_csg_ctx *ctx, int n) {
+    if (n > ctx->classes_cap) {
+        int nc = ctx->classes_cap ? ctx->classes_cap : 64;
+        while (nc < n) nc *= 2;
+        int *nb = (int *)realloc(ctx->classes, (size_t)nc * sizeof(int));
+        if (!nb) return NULL;
+        ctx->classes = nb;
+        ctx->classes_cap = nc;
+    }
+    return ctx->classes;
+}
+
 /* ================================================================
  * VERTEX INTERPOLATION
  * ================================================================ */
@@ -220,7 +287,8 @@ static inline ts_csg_vertex ts_csg_vertex_lerp(ts_csg_vertex a,
 #define TS_CSG_BACK     2
 #define TS_CSG_SPANNING 3
 
-static inline void ts_csg_split_polygon(const double plane[4],
+static inline void ts_csg_split_polygon(const ts_csg_ctx *ctx,
+                                         const double plane[4],
                                          const ts_csg_poly *poly,
                                          ts_csg_polylist *coplanar_front,
                                          ts_csg_polylist *coplanar_back,
@@ -239,8 +307,8 @@ static inline void ts_csg_split_polygon(const double plane[4],
         double d = plane[0]*poly->verts[i].x +
                    plane[1]*poly->verts[i].y +
                    plane[2]*poly->verts[i].z - plane[3];
-        int type = (d < -TS_CSG_EPS) ? TS_CSG_BACK :
-                   (d > TS_CSG_EPS)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
+        int type = (d < -ctx->eps) ? TS_CSG_BACK :
+                   (d > ctx->eps)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
         polygon_type |= type;
         types[i] = type;
     }
@@ -314,7 +382,8 @@ static inline void ts_csg_split_polygon(const double plane[4],
  * This eliminates O(N) malloc+memcpy per BSP level for the common case
  * where most polygons are purely FRONT or BACK.
  */
-static inline void ts_csg_split_polygon_move(const double plane[4],
+static inline void ts_csg_split_polygon_move(const ts_csg_ctx *ctx,
+                                              const double plane[4],
                                               ts_csg_poly *poly,
                                               ts_csg_polylist *coplanar_front,
                                               ts_csg_polylist *coplanar_back,
@@ -330,8 +399,8 @@ static inline void ts_csg_split_polygon_move(const double plane[4],
         double d = plane[0]*poly->verts[i].x +
                    plane[1]*poly->verts[i].y +
                    plane[2]*poly->verts[i].z - plane[3];
-        int type = (d < -TS_CSG_EPS) ? TS_CSG_BACK :
-                   (d > TS_CSG_EPS)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
+        int type = (d < -ctx->eps) ? TS_CSG_BACK :
+                   (d > ctx->eps)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
         polygon_type |= type;
         types[i] = type;
     }
@@ -400,7 +469,10 @@ static inline void ts_csg_split_polygon_move(const double plane[4],
 /* ================================================================
  * BSP NODE — recursive binary space partition tree
  *
- * Build: pick splitting plane from first polygon, partition rest.
+ * Build: pick a splitting plane (see ts_csg_split_t), partition the
+ * rest; children are built from an explicit stack, not by recursion.
+ * The walks after it (clip, invert, collect, free) do the same: a
+ * convex input can give a tree as deep as it has facets.
  * GPU plan: tree traversal is sequential, but classification of
  * polygons against planes is parallel per-polygon.
  * ================================================================ */
@@ -419,22 +491,103 @@ static inline ts_csg_bsp *ts_csg_bsp_new(void) {
     return node;
 }
 
+/* Nodes waiting to be visited by a tree walk */
+typedef struct {
+    ts_csg_bsp **items;
+    int count, cap;
+} ts_csg_bsp_stack;
+
+/* Push node unless NULL. Returns -1 on allocation failure. */
+static inline int ts_csg_bsp_stack_push(ts_csg_bsp_stack *s,
+                                        ts_csg_bsp *node) {
+    if (!node) return 0;
+    if (s->count >= s->cap) {
+        int nc = s->cap ? s->cap * 2 : 64;
+        ts_csg_bsp **ni = (ts_csg_bsp **)realloc(s->items,
+            (size_t)nc * sizeof(*ni));
+        if (!ni) return -1;
+        s->items = ni;
+        s->cap = nc;
+    }
+    s->items[s->count++] = node;
+    return 0;
+}
+
+/* Free a tree without a stack: rotate each front subtree up until the
+ * node has none, then free it and continue down the back side. */
 static inline void ts_csg_bsp_free(ts_csg_bsp *node) {
-    if (!node) return;
-    ts_csg_polylist_free(&node->polys);
-    ts_csg_bsp_free(node->front);
-    ts_csg_bsp_free(node->back);
-    free(node);
+    while (node) {
+        ts_csg_bsp *front = node->front;
+        if (front) {
+            node->front = front->back;
+            front->back = node;
+            node = front;
+            continue;
+        }
+        ts_csg_bsp *back = node->back;
+        ts_csg_polylist_free(&node->polys);
+        free(node);
+        node = back;
+    }
 }
 
 /* Forward declarations */
-static void ts_csg_bsp_build(ts_csg_bsp *node, ts_csg_polylist *polys);
-static void ts_csg_bsp_clip_polys(const ts_csg_bsp *bsp, ts_csg_polylist *polys);
-static void ts_csg_bsp_clip_to(ts_csg_bsp *node, const ts_csg_bsp *other);
+static void ts_csg_bsp_clip_polys(ts_csg_ctx *ctx, const ts_csg_bsp *bsp,
+                                  ts_csg_polylist *polys);
+static void ts_csg_bsp_clip_to(ts_csg_ctx *ctx, ts_csg_bsp *node,
+                               const ts_csg_bsp *other);
 static void ts_csg_bsp_invert(ts_csg_bsp *node);
 static void ts_csg_bsp_all_polys(const ts_csg_bsp *node, ts_csg_polylist *out);
 
-/* Build BSP tree from a list of polygons. Consumes the polylist.
+/*
+ * Pick the splitting plane for a new node: index of the polygon whose
+ * plane scores best on a strided sample (SAH), or 0 (FIRST). Few spanning
+ * polygons means few splits; balance keeps the tree shallow. The first
+ * polygon's plane on a tessellated cylinder or sphere cuts almost every
+ * facet and peels off one polygon per level.
+ */
+static inline int ts_csg_bsp_pick_splitter(const ts_csg_ctx *ctx,
+                                           const ts_csg_polylist *polys) {
+    int n = polys->count;
+    if (ctx->splitter == TS_CSG_SPLIT_FIRST || n <= 2) return 0;
+
+    int ncand = n < TS_CSG_SPLIT_CANDIDATES ? n : TS_CSG_SPLIT_CANDIDATES;
+    int cstep = n / ncand;
+    int sstep = n > TS_CSG_SPLIT_SAMPLE ? n / TS_CSG_SPLIT_SAMPLE : 1;
+    int best = 0;
+    long best_score = -1;
+
+    for (int c = 0; c < ncand; c++) {
+        const double *pl = polys->items[c * cstep].plane;
+        /* Zero-area facets (sphere poles) have no plane: every polygon
+         * would be "coplanar" with them */
+        if (pl[0]*pl[0] + pl[1]*pl[1] + pl[2]*pl[2] < 0.5) continue;
+        long front = 0, back = 0, span = 0;
+        for (int i = 0; i < n; i += sstep) {
+            const ts_csg_poly *p = &polys->items[i];
+            int type = 0;
+            for (int k = 0; k < p->count && type != TS_CSG_SPANNING; k++) {
+                double d = pl[0]*p->verts[k].x + pl[1]*p->verts[k].y +
+                           pl[2]*p->verts[k].z - pl[3];
+                type |= (d < -ctx->eps) ? TS_CSG_BACK :
+                        (d > ctx->eps)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
+            }
+            if      (type == TS_CSG_FRONT)    front++;
+            else if (type == TS_CSG_BACK)     back++;
+            else if (type == TS_CSG_SPANNING) span++;
+        }
+        long score = span * TS_CSG_SPLIT_WEIGHT +
+                     (front > back ? front - back : back - front);
+        if (best_score < 0 || score < best_score) {
+            best_score = score;
+            best = c * cstep;
+        }
+    }
+    return best;
+}
+
+/* Partition one node's polygons: coplanar ones stay at the node, the rest
+ * go to *front_out / *back_out for its children. Consumes the polylist.
  *
  * Two-pass algorithm:
  *   Pass 1: Classify all polygons against splitting plane (cache-friendly)
@@ -445,16 +598,22 @@ static void ts_csg_bsp_all_polys(const ts_csg_bsp *node, ts_csg_polylist *out);
  *   - Pre-allocated partition lists: exact sizes known from pass 1
  *   - Batch-friendly: pass 1 can be GPU-accelerated
  */
-static void ts_csg_bsp_build(ts_csg_bsp *node, ts_csg_polylist *polys) {
-    if (!polys || polys->count == 0) return;
-
-    /* Use first polygon's plane as the splitting plane */
+static void ts_csg_bsp_partition(ts_csg_ctx *ctx, ts_csg_bsp *node,
+                                 ts_csg_polylist *polys,
+                                 ts_csg_polylist *front_out,
+                                 ts_csg_polylist *back_out) {
+    *front_out = ts_csg_polylist_init();
+    *back_out = ts_csg_polylist_init();
+
+    /* A fresh node takes its splitting plane from the polygons */
     if (node->polys.count == 0) {
-        memcpy(node->plane, polys->items[0].plane, sizeof(node->plane));
+        int s = ts_csg_bsp_pick_splitter(ctx, polys);
+        memcpy(node->plane, polys->items[s].plane, sizeof(node->plane));
+        ctx->stats.nodes++;
     }
 
     /* Pass 1: Classify all polygons */
-    int *classes = (int *)malloc((size_t)polys->count * sizeof(int));
+    int *classes = ts_csg_ctx_classes(ctx, polys->count);
     if (!classes) return;
     int n_front = 0, n_back = 0;
 
@@ -465,8 +624,8 @@ static void ts_csg_bsp_build(ts_csg_bsp *node, ts_csg_polylist *polys) {
             double d = node->plane[0]*p->verts[k].x +
                        node->plane[1]*p->verts[k].y +
                        node->plane[2]*p->verts[k].z - node->plane[3];
-            int vtype = (d < -TS_CSG_EPS) ? TS_CSG_BACK :
-                        (d > TS_CSG_EPS)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
+            int vtype = (d < -ctx->eps) ? TS_CSG_BACK :
+                        (d > ctx->eps)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
             type |= vtype;
         }
         classes[i] = type;
@@ -511,6 +670,7 @@ static void ts_csg_bsp_build(ts_csg_bsp *node, ts_csg_polylist *polys) {
             break;
         case TS_CSG_SPANNING: {
             /* Split spanning polygon — creates new allocations */
+            ctx->stats.splits++;
             ts_csg_poly f = ts_csg_poly_init();
             ts_csg_poly b = ts_csg_poly_init();
             memcpy(f.plane, p->plane, sizeof(f.plane));
@@ -525,8 +685,8 @@ static void ts_csg_bsp_build(ts_csg_bsp *node, ts_csg_polylist *polys) {
                     double d = node->plane[0]*p->verts[k].x +
                                node->plane[1]*p->verts[k].y +
                                node->plane[2]*p->verts[k].z - node->plane[3];
-                    types[k] = (d < -TS_CSG_EPS) ? TS_CSG_BACK :
-                               (d > TS_CSG_EPS)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
+                    types[k] = (d < -ctx->eps) ? TS_CSG_BACK :
+                               (d > ctx->eps)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
                 }
                 for (int k = 0; k < p->count; k++) {
                     int j = (k + 1) % p->count;
@@ -563,16 +723,6 @@ static void ts_csg_bsp_build(ts_csg_bsp *node, ts_csg_polylist *polys) {
         }
         }
     }
-    free(classes);
-
-    if (front_list.count > 0) {
-        if (!node->front) node->front = ts_csg_bsp_new();
-        ts_csg_bsp_build(node->front, &front_list);
-    }
-    if (back_list.count > 0) {
-        if (!node->back) node->back = ts_csg_bsp_new();
-        ts_csg_bsp_build(node->back, &back_list);
-    }
 
     /* Free remaining polys (moved polys have verts=NULL, free(NULL) is safe) */
     for (int i = 0; i < polys->count; i++)
@@ -581,23 +731,73 @@ static void ts_csg_bsp_build(ts_csg_bsp *node, ts_csg_polylist *polys) {
     polys->items = NULL;
     polys->count = polys->cap = 0;
 
-    /* Free the partition lists' arrays (polys moved into children) */
-    free(front_list.items);
-    free(back_list.items);
+    *front_out = front_list;
+    *back_out = back_list;
+}
+
+/* Pending subtree of an iterative build */
+typedef struct {
+    ts_csg_bsp *node;
+    ts_csg_polylist polys;
+    int depth;
+} ts_csg_bsp_job;
+
+/* Build BSP tree from a list of polygons. Consumes the polylist.
+ * Subtrees wait on an explicit stack, so a degenerate (deep) tree
+ * costs heap, not call stack. Existing nodes keep their planes, which
+ * makes this also the way to add polygons to a built tree. */
+static void ts_csg_bsp_build(ts_csg_ctx *ctx, ts_csg_bsp *node,
+                             ts_csg_polylist *polys) {
+    if (!polys || polys->count == 0) return;
+
+    int cap = 64, top = 0;
+    ts_csg_bsp_job *stack = (ts_csg_bsp_job *)malloc((size_t)cap * sizeof(*stack));
+    if (!stack) return;
+    stack[top++] = (ts_csg_bsp_job){ node, *polys, 0 };
+    *polys = ts_csg_polylist_init();
+
+    while (top > 0) {
+        ts_csg_bsp_job job = stack[--top];
+        if (job.depth > ctx->stats.max_depth) ctx->stats.max_depth = job.depth;
+
+        ts_csg_polylist side[2];
+        ts_csg_bsp_partition(ctx, job.node, &job.polys, &side[0], &side[1]);
+        ts_csg_polylist_free(&job.polys);  /* no-op unless partition failed */
+
+        /* Push back before front so front is built first, as before */
+        for (int k = 1; k >= 0; k--) {
+            if (side[k].count == 0) {
+                free(side[k].items);
+                continue;
+            }
+            ts_csg_bsp **child = k ? &job.node->back : &job.node->front;
+            if (!*child) *child = ts_csg_bsp_new();
+            if (top == cap) {
+                ts_csg_bsp_job *ns = (ts_csg_bsp_job *)realloc(stack,
+                    (size_t)cap * 2 * sizeof(*stack));
+                if (ns) { stack = ns; cap *= 2; }
+            }
+            if (!*child || top == cap) {
+                ts_csg_polylist_free(&side[k]);
+                continue;
+            }
+            stack[top++] = (ts_csg_bsp_job){ *child, side[k], job.depth + 1 };
+        }
+    }
+    free(stack);
 }
 
 /*
- * Clip a list of polygons against this BSP tree.
- * Removes polygons on the back side of every splitting plane.
- * Result replaces the input polylist.
+ * Sort polys to the two sides of one node's plane, for clipping.
+ * Consumes polys. Returns -1 (polys untouched) if out of memory.
  */
-static void ts_csg_bsp_clip_polys(const ts_csg_bsp *bsp,
-                                    ts_csg_polylist *polys) {
-    if (!bsp) return;
-
+static int ts_csg_bsp_clip_split(ts_csg_ctx *ctx, const ts_csg_bsp *bsp,
+                                 ts_csg_polylist *polys,
+                                 ts_csg_polylist *front_out,
+                                 ts_csg_polylist *back_out) {
     /* Two-pass: classify then partition (avoids reallocs) */
-    int *classes = (int *)malloc((size_t)polys->count * sizeof(int));
-    if (!classes) return;
+    int *classes = ts_csg_ctx_classes(ctx, polys->count);
+    if (!classes) return -1;
     int n_front = 0, n_back = 0;
 
     for (int i = 0; i < polys->count; i++) {
@@ -607,8 +807,8 @@ static void ts_csg_bsp_clip_polys(const ts_csg_bsp *bsp,
             double d = bsp->plane[0]*p->verts[k].x +
                        bsp->plane[1]*p->verts[k].y +
                        bsp->plane[2]*p->verts[k].z - bsp->plane[3];
-            int vtype = (d < -TS_CSG_EPS) ? TS_CSG_BACK :
-                        (d > TS_CSG_EPS)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
+            int vtype = (d < -ctx->eps) ? TS_CSG_BACK :
+                        (d > ctx->eps)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
             type |= vtype;
         }
         classes[i] = type;
@@ -656,6 +856,7 @@ static void ts_csg_bsp_clip_polys(const ts_csg_bsp *bsp,
             p->verts = NULL; p->count = p->cap = 0;
             break;
         case TS_CSG_SPANNING: {
+            ctx->stats.clip_splits++;
             ts_csg_poly f = ts_csg_poly_init();
             ts_csg_poly b = ts_csg_poly_init();
             memcpy(f.plane, p->plane, sizeof(f.plane));
@@ -668,8 +869,8 @@ static void ts_csg_bsp_clip_polys(const ts_csg_bsp *bsp,
                     double d = bsp->plane[0]*p->verts[k].x +
                                bsp->plane[1]*p->verts[k].y +
                                bsp->plane[2]*p->verts[k].z - bsp->plane[3];
-                    types[k] = (d < -TS_CSG_EPS) ? TS_CSG_BACK :
-                               (d > TS_CSG_EPS)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
+                    types[k] = (d < -ctx->eps) ? TS_CSG_BACK :
+                               (d > ctx->eps)  ? TS_CSG_FRONT : TS_CSG_COPLANAR;
                 }
                 for (int k = 0; k < p->count; k++) {
                     int j = (k + 1) % p->count;
@@ -699,7 +900,6 @@ static void ts_csg_bsp_clip_polys(const ts_csg_bsp *bsp,
         }
         }
     }
-    free(classes);
 
     /* Free remaining (moved polys have verts=NULL, free(NULL) is safe) */
     for (int i = 0; i < polys->count; i++)
@@ -708,61 +908,125 @@ static void ts_csg_bsp_clip_polys(const ts_csg_bsp *bsp,
     polys->items = NULL;
     polys->count = polys->cap = 0;
 
-    /* Recursively clip front and back */
-    if (bsp->front)
-        ts_csg_bsp_clip_polys(bsp->front, &front_list);
-    if (bsp->back)
-        ts_csg_bsp_clip_polys(bsp->back, &back_list);
-    else {
-        /* No back node = everything behind this plane is removed */
-        for (int i = 0; i < back_list.count; i++)
-            ts_csg_poly_free(&back_list.items[i]);
-        back_list.count = 0;
-    }
-
-    /* Merge results back into polys */
-    *polys = front_list;
-    ts_csg_polylist_steal(polys, &back_list);
+    *front_out = front_list;
+    *back_out = back_list;
+    return 0;
+}
+
+/* Pending subtree of an iterative clip */
+typedef struct {
+    const ts_csg_bsp *node;
+    ts_csg_polylist polys;
+} ts_csg_clip_job;
+
+/*
+ * Clip a list of polygons against this BSP tree.
+ * Removes polygons on the back side of every splitting plane.
+ * Result replaces the input polylist, in the order a front-first
+ * recursion would produce; subtrees wait on an explicit stack.
+ */
+static void ts_csg_bsp_clip_polys(ts_csg_ctx *ctx, const ts_csg_bsp *bsp,
+                                    ts_csg_polylist *polys) {
+    if (!bsp || polys->count == 0) return;
+
+    int cap = 64, top = 0;
+    ts_csg_clip_job *stack = (ts_csg_clip_job *)malloc((size_t)cap * sizeof(*stack));
+    if (!stack) return;
+    stack[top++] = (ts_csg_clip_job){ bsp, *polys };
+    ts_csg_polylist out = ts_csg_polylist_init();
+
+    while (top > 0) {
+        ts_csg_clip_job job = stack[--top];
+        ts_csg_polylist side[2];
+        if (ts_csg_bsp_clip_split(ctx, job.node, &job.polys,
+                                  &side[0], &side[1]) != 0) {
+            ts_csg_polylist_steal(&out, &job.polys);
+            continue;
+        }
+
+        /* Push back before front so front results come out first */
+        for (int k = 1; k >= 0; k--) {
+            const ts_csg_bsp *child = k ? job.node->back : job.node->front;
+            if (side[k].count == 0 || !child) {
+                /* No front node = kept; no back node = removed */
+                if (k) ts_csg_polylist_free(&side[k]);
+                else   ts_csg_polylist_steal(&out, &side[k]);
+                continue;
+            }
+            if (top == cap) {
+                ts_csg_clip_job *ns = (ts_csg_clip_job *)realloc(stack,
+                    (size_t)cap * 2 * sizeof(*stack));
+                if (ns) { stack = ns; cap *= 2; }
+            }
+            if (top == cap) {
+                ts_csg_polylist_free(&side[k]);
+                continue;
+            }
+            stack[top++] = (ts_csg_clip_job){ child, side[k] };
+        }
+    }
+    free(stack);
+    *polys = out;
 }
 
 /* Clip all polygons in this BSP tree against another BSP tree */
-static void ts_csg_bsp_clip_to(ts_csg_bsp *node, const ts_csg_bsp *other) {
-    if (!node) return;
-    ts_csg_bsp_clip_polys(other, &node->polys);
-    ts_csg_bsp_clip_to(node->front, other);
-    ts_csg_bsp_clip_to(node->back, other);
+static void ts_csg_bsp_clip_to(ts_csg_ctx *ctx, ts_csg_bsp *node,
+                               const ts_csg_bsp *other) {
+    ts_csg_bsp_stack st = { NULL, 0, 0 };
+    ts_csg_bsp_stack_push(&st, node);
+    while (st.count > 0) {
+        ts_csg_bsp *n = st.items[--st.count];
+        ts_csg_bsp_clip_polys(ctx, other, &n->polys);
+        if (ts_csg_bsp_stack_push(&st, n->back) != 0 ||
+            ts_csg_bsp_stack_push(&st, n->front) != 0)
+            break;
+    }
+    free(st.items);
 }
 
 /* Invert the BSP tree (swap inside/outside) */
 static void ts_csg_bsp_invert(ts_csg_bsp *node) {
-    if (!node) return;
-    for (int i = 0; i < node->polys.count; i++)
-        ts_csg_poly_flip(&node->polys.items[i]);
-    node->plane[0] = -node->plane[0];
-    node->plane[1] = -node->plane[1];
-    node->plane[2] = -node->plane[2];
-    node->plane[3] = -node->plane[3];
-    ts_csg_bsp_invert(node->front);
-    ts_csg_bsp_invert(node->back);
-    /* Swap front and back subtrees */
-    ts_csg_bsp *tmp = node->front;
-    node->front = node->back;
-    node->back = tmp;
+    ts_csg_bsp_stack st = { NULL, 0, 0 };
+    ts_csg_bsp_stack_push(&st, node);
+    while (st.count > 0) {
+        ts_csg_bsp *n = st.items[--st.count];
+        for (int i = 0; i < n->polys.count; i++)
+            ts_csg_poly_flip(&n->polys.items[i]);
+        n->plane[0] = -n->plane[0];
+        n->plane[1] = -n->plane[1];
+        n->plane[2] = -n->plane[2];
+        n->plane[3] = -n->plane[3];
+        /* Swap front and back subtrees */
+        ts_csg_bsp *tmp = n->front;
+        n->front = n->back;
+        n->back = tmp;
+        if (ts_csg_bsp_stack_push(&st, n->front) != 0 ||
+            ts_csg_bsp_stack_push(&st, n->back) != 0)
+            break;
+    }
+    free(st.items);
 }
 
-/* Collect all polygons from the BSP tree */
+/* Collect all polygons from the BSP tree, node before front before back */
 static void ts_csg_bsp_all_polys(const ts_csg_bsp *node,
                                    ts_csg_polylist *out) {
-    if (!node) return;
-    for (int i = 0; i < node->polys.count; i++)
-        ts_csg_polylist_push(out, ts_csg_poly_clone(&node->polys.items[i]));
-    ts_csg_bsp_all_polys(node->front, out);
-    ts_csg_bsp_all_polys(node->back, out);
+    ts_csg_bsp_stack st = { NULL, 0, 0 };
+    ts_csg_bsp_stack_push(&st, (ts_csg_bsp *)node);
+    while (st.count > 0) {
+        const ts_csg_bsp *n = st.items[--st.count];
+        for (int i = 0; i < n->polys.count; i++)
+            ts_csg_polylist_push(out, ts_csg_poly_clone(&n->polys.items[i]));
+        if (ts_csg_bsp_stack_push(&st, n->back) != 0 ||
+            ts_csg_bsp_stack_push(&st, n->front) != 0)
+            break;
+    }
+    free(st.items);
 }
 
 /* Add polygons to an existing BSP tree */
-static void ts_csg_bsp_add_polys(ts_csg_bsp *node, ts_csg_polylist *polys) {
-    ts_csg_bsp_build(node, polys);
+static void ts_csg_bsp_add_polys(ts_csg_ctx *ctx, ts_csg_bsp *node,
+                                 ts_csg_polylist *polys) {
+    ts_csg_bsp_build(ctx, node, polys);
 }
 
 /* ================================================================
@@ -890,8 +1154,16 @@ static inline int ts_csg_aabb_overlap(const double a_mn[3], const double a_mx[3]
            a_mn[2] <= b_mx[2] && a_mx[2] >= b_mn[2];
 }
 
-static inline int ts_csg_boolean(const ts_mesh *a, const ts_mesh *b,
-                                  ts_csg_op_t op, ts_mesh *out) {
+/*
+ * Boolean with an explicit BSP splitter; *stats (if non-NULL) receives
+ * what the tree builds produced — depth, nodes, polygon splits — so
+ * strategies can be compared on the same operands.
+ */
+static inline int ts_csg_boolean_ex(const ts_mesh *a, const ts_mesh *b,
+                                     ts_csg_op_t op, ts_mesh *out,
+                                     ts_csg_split_t splitter,
+                                     ts_csg_bsp_stats *stats) {
+    if (stats) memset(stats, 0, sizeof(*stats));
     if (!a || !b || !out) return TS_CSG_ERROR;
     if (a->tri_count == 0 && b->tri_count == 0) return TS_CSG_OK;
 
@@ -906,6 +1178,9 @@ static inline int ts_csg_boolean(const ts_mesh *a, const ts_mesh *b,
     ts_csg_polylist_aabb(&polys_a, a_mn, a_mx);
     ts_csg_polylist_aabb(&polys_b, b_mn, b_mx);
 
+    ts_csg_ctx ctx = ts_csg_ctx_init();
+    ctx.splitter = splitter;
+
     /* Adaptive epsilon: scale relative to mesh extents.
      * For tiny meshes (mm scale), use smaller eps to avoid erasing features.
      * For huge meshes (1000+ units), use larger eps for numerical stability. */
@@ -920,7 +1195,7 @@ static inline int ts_csg_boolean(const ts_mesh *a, const ts_mesh *b,
         double eps = extent * 1e-8;
         if (eps < 1e-10) eps = 1e-10;
         if (eps > 1e-4) eps = 1e-4;
-        ts_csg_eps_ = eps;
+        ctx.eps = eps;
     }
 
     if (!ts_csg_aabb_overlap(a_mn, a_mx, b_mn, b_mx)) {
@@ -967,48 +1242,48 @@ static inline int ts_csg_boolean(const ts_mesh *a, const ts_mesh *b,
         return TS_CSG_ERROR;
     }
 
-    ts_csg_bsp_build(bsp_a, &polys_a);
-    ts_csg_bsp_build(bsp_b, &polys_b);
+    ts_csg_bsp_build(&ctx, bsp_a, &polys_a);
+    ts_csg_bsp_build(&ctx, bsp_b, &polys_b);
 
     switch (op) {
     case TS_CSG_OP_UNION:
-        ts_csg_bsp_clip_to(bsp_a, bsp_b);
-        ts_csg_bsp_clip_to(bsp_b, bsp_a);
+        ts_csg_bsp_clip_to(&ctx, bsp_a, bsp_b);
+        ts_csg_bsp_clip_to(&ctx, bsp_b, bsp_a);
         ts_csg_bsp_invert(bsp_b);
-        ts_csg_bsp_clip_to(bsp_b, bsp_a);
+        ts_csg_bsp_clip_to(&ctx, bsp_b, bsp_a);
         ts_csg_bsp_invert(bsp_b);
         {
             ts_csg_polylist b_polys = ts_csg_polylist_init();
             ts_csg_bsp_all_polys(bsp_b, &b_polys);
-            ts_csg_bsp_add_polys(bsp_a, &b_polys);
+            ts_csg_bsp_add_polys(&ctx, bsp_a, &b_polys);
         }
         break;
 
     case TS_CSG_OP_DIFFERENCE:
         ts_csg_bsp_invert(bsp_a);
-        ts_csg_bsp_clip_to(bsp_a, bsp_b);
-        ts_csg_bsp_clip_to(bsp_b, bsp_a);
+        ts_csg_bsp_clip_to(&ctx, bsp_a, bsp_b);
+        ts_csg_bsp_clip_to(&ctx, bsp_b, bsp_a);
         ts_csg_bsp_invert(bsp_b);
-        ts_csg_bsp_clip_to(bsp_b, bsp_a);
+        ts_csg_bsp_clip_to(&ctx, bsp_b, bsp_a);
         ts_csg_bsp_invert(bsp_b);
         {
             ts_csg_polylist b_polys = ts_csg_polylist_init();
             ts_csg_bsp_all_polys(bsp_b, &b_polys);
-            ts_csg_bsp_add_polys(bsp_a, &b_polys);
+            ts_csg_bsp_add_polys(&ctx, bsp_a, &b_polys);
         }
         ts_csg_bsp_invert(bsp_a);
         break;
 
     case TS_CSG_OP_INTERSECTION:
         ts_csg_bsp_invert(bsp_a);
-        ts_csg_bsp_clip_to(bsp_b, bsp_a);
+        ts_csg_bsp_clip_to(&ctx, bsp_b, bsp_a);
         ts_csg_bsp_invert(bsp_b);
-        ts_csg_bsp_clip_to(bsp_a, bsp_b);
-        ts_csg_bsp_clip_to(bsp_b, bsp_a);
+        ts_csg_bsp_clip_to(&ctx, bsp_a, bsp_b);
+        ts_csg_bsp_clip_to(&ctx, bsp_b, bsp_a);
         {
             ts_csg_polylist b_polys = ts_csg_polylist_init();
             ts_csg_bsp_all_polys(bsp_b, &b_polys);
-            ts_csg_bsp_add_polys(bsp_a, &b_polys);
+            ts_csg_bsp_add_polys(&ctx, bsp_a, &b_polys);
         }
         ts_csg_bsp_invert(bsp_a);
         break;
@@ -1020,13 +1295,20 @@ static inline int ts_csg_boolean(const ts_mesh *a, const ts_mesh *b,
     ts_csg_polys_to_mesh(&result, out);
 
     /* Cleanup */
+    if (stats) *stats = ctx.stats;
     ts_csg_polylist_free(&result);
+    ts_csg_ctx_free(&ctx);
     ts_csg_bsp_free(bsp_a);
     ts_csg_bsp_free(bsp_b);
 
     return TS_CSG_OK;
 }
 
+static inline int ts_csg_boolean(const ts_mesh *a, const ts_mesh *b,
+                                  ts_csg_op_t op, ts_mesh *out) {
+    return ts_csg_boolean_ex(a, b, op, out, TS_CSG_SPLIT_SAH, NULL);
+}
+
 /* Convenience wrappers */
 static inline int ts_csg_union(const ts_mesh *a, const ts_mesh *b,
                                 ts_mesh *out) {
@@ -1043,6 +1325,151 @@ static inline int ts_csg_intersection(const ts_mesh *a, const ts_mesh *b,
     return ts_csg_boolean(a, b, TS_CSG_OP_INTERSECTION, out);
 }
 
+/*
+ * Union of n meshes by pairwise reduction. Each round unions neighbours
+ * (0,1), (2,3), ... so every input takes part in O(log n) booleans and
+ * the two operands of each stay comparable in size, instead of one
+ * accumulator that every step rebuilds a BSP tree from. A pair whose
+ * AABBs are disjoint is concatenated without a boolean.
+ *
+ * Consumes meshes[0..n): each is freed or moved into the result.
+ */
+static inline ts_mesh ts_csg_union_reduce(ts_mesh *meshes, int n) {
+    if (n <= 0) return ts_mesh_init();
+    double (*bb)[6] = (double (*)[6])malloc((size_t)n * sizeof(*bb));
+    if (!bb) {
+        /* No room to reduce: fold sequentially */
+        for (int i = 1; i < n; i++) {
+            ts_mesh u = ts_mesh_init();
+            ts_csg_union(&meshes[0], &meshes[i], &u);
+            ts_mesh_free(&meshes[0]);
+            ts_mesh_free(&meshes[i]);
+            meshes[0] = u;
+        }
+        return meshes[0];
+    }
+    for (int i = 0; i < n; i++)
+        ts_mesh_bounds(&meshes[i], bb[i], bb[i] + 3);
+
+    for (int live = n; live > 1; live = (live + 1) / 2) {
+        for (int i = 0; i < live / 2; i++) {
+            ts_mesh *a = &meshes[2*i], *b = &meshes[2*i + 1];
+            double *ba = bb[2*i], *bbx = bb[2*i + 1];
+            ts_mesh u;
+            if (b->tri_count == 0) {
+                u = *a;
+                *a = ts_mesh_init();
+            } else if (a->tri_count == 0) {
+                u = *b;
+                *b = ts_mesh_init();
+                memcpy(ba, bbx, sizeof(bb[0]));
+            } else {
+                if (!ts_csg_aabb_overlap(ba, ba + 3, bbx, bbx + 3)) {
+                    u = *a;
+                    *a = ts_mesh_init();
+                    ts_mesh_append(&u, b);
+                } else {
+                    u = ts_mesh_init();
+                    ts_csg_union(a, b, &u);
+                }
+                for (int k = 0; k < 3; k++) {
+                    if (bbx[k] < ba[k])         ba[k] = bbx[k];
+                    if (bbx[k + 3] > ba[k + 3]) ba[k + 3] = bbx[k + 3];
+                }
+            }
+            ts_mesh_free(a);
+            ts_mesh_free(b);
+            meshes[i] = u;
+            memmove(bb[i], ba, sizeof(bb[0]));
+        }
+        if (live & 1) {
+            meshes[live / 2] = meshes[live - 1];
+            memcpy(bb[live / 2], bb[live - 1], sizeof(bb[0]));
+        }
+    }
+    free(bb);
+    return meshes[0];
+}
+
+/* Internal: union-find root with path halving */
+static inline int ts_csg_uf_find(int *parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+/*
+ * Union of n meshes, grouped by AABB overlap. Meshes whose boxes touch
+ * (directly or through a chain of others) form a cluster that is unioned
+ * with ts_csg_union_reduce; clusters are then concatenated, since their
+ * boxes are disjoint and no boolean can change them. Children that do
+ * not overlap at all never reach the BSP.
+ *
+ * Output order follows the lowest input index of each cluster.
+ * Consumes meshes[0..n).
+ */
+static inline ts_mesh ts_csg_union_clusters(ts_mesh *meshes, int n) {
+    ts_mesh result = ts_mesh_init();
+    if (n <= 0) return result;
+    if (n == 1) return meshes[0];
+
+    double (*bb)[6] = (double (*)[6])malloc((size_t)n * sizeof(*bb));
+    int *parent = (int *)malloc((size_t)n * sizeof(int));
+    int *order  = (int *)malloc((size_t)n * sizeof(int));
+    ts_mesh *group = (ts_mesh *)malloc((size_t)n * sizeof(ts_mesh));
+    if (!bb || !parent || !order || !group) {
+        free(bb); free(parent); free(order); free(group);
+        return ts_csg_union_reduce(meshes, n);
+    }
+
+    for (int i = 0; i < n; i++) {
+        ts_mesh_bounds(&meshes[i], bb[i], bb[i] + 3);
+        parent[i] = i;
+        order[i] = i;
+    }
+
+    /* Sweep along x: sort by min x (insertion sort — child counts are
+     * small and inputs are often already ordered), then only test pairs
+     * whose x intervals overlap */
+    for (int i = 1; i < n; i++) {
+        int k = order[i], j = i - 1;
+        while (j >= 0 && bb[order[j]][0] > bb[k][0]) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = k;
+    }
+    for (int i = 0; i < n; i++) {
+        int a = order[i];
+        if (meshes[a].tri_count == 0) continue;
+        for (int j = i + 1; j < n && bb[order[j]][0] <= bb[a][3]; j++) {
+            int b = order[j];
+            if (meshes[b].tri_count == 0) continue;
+            if (!ts_csg_aabb_overlap(bb[a], bb[a] + 3, bb[b], bb[b] + 3))
+                continue;
+            int ra = ts_csg_uf_find(parent, a), rb = ts_csg_uf_find(parent, b);
+            /* Lower index is the root, so clusters come out in input order */
+            if (ra < rb) parent[rb] = ra;
+            else if (rb < ra) parent[ra] = rb;
+        }
+    }
+
+    for (int r = 0; r < n; r++) {
+        if (ts_csg_uf_find(parent, r) != r) continue;
+        int count = 0;
+        for (int i = r; i < n; i++)
+            if (ts_csg_uf_find(parent, i) == r) group[count++] = meshes[i];
+        ts_mesh u = count == 1 ? group[0] : ts_csg_union_reduce(group, count);
+        ts_mesh_append(&result, &u);
+        ts_mesh_free(&u);
+    }
+
+    free(bb); free(parent); free(order); free(group);
+    return result;
+}
+
 /* ================================================================
  * CONVEX HULL — Quickhull algorithm
  *
@@ -8,6 +8,9 @@
  * Scope model: lexical scoping with dynamic $-variable inheritance.
  * Geometry model: transforms compose via matrix stack, implicit union
  * for multiple children in a block.
+ * Parallel model: with ts_interpret_opts.threads > 1, independent
+ * children of blocks, difference() and intersection() run as tasks on
+ * a thread pool; results are joined in source order.
  */
 #ifndef TS_EVAL_H
 #define TS_EVAL_H
@@ -26,6 +29,7 @@
 
 #include <stdio.h>
 #include <math.h>
+#include <pthread.h>
 
 /* ================================================================
  * VALUE SYSTEM
@@ -125,6 +129,7 @@ static inline double ts_val_vec_get(ts_val v, int idx) {
 #define TS_ENV_MAX 256
 
 typedef struct ts_env ts_env;
+typedef struct ts_eval_pool ts_eval_pool;
 /* Shared progress tracking — written by worker thread, read by UI thread */
 typedef struct {
     volatile int done;      /* statements completed so far */
@@ -135,6 +140,7 @@ struct ts_env {
     ts_env *parent;
     volatile int *cancel;   /* cooperative cancellation flag */
     ts_progress  *progress; /* shared progress (root env only, inherited) */
+    ts_eval_pool *pool;     /* task pool for independent subtrees, inherited */
     char   *names[TS_ENV_MAX];
     ts_val  values[TS_ENV_MAX];
     int     count;
@@ -153,6 +159,10 @@ struct ts_env {
     double  force_fa;   /* >0 = override any $fa from source */
     double  force_fs;   /* >0 = override any $fs from source */
 
+    /* CSG strategy (inherited) */
+    int     seq_difference; /* difference(): subtract tools one at a time */
+    int     bool_union;     /* union(): boolean union instead of concatenation */
+
     /* children() support: caller's geometry children */
     ts_ast **caller_children;
     int      caller_child_count;
@@ -174,11 +184,14 @@ static inline ts_env *ts_env_new(ts_env *parent) {
     e->parent = parent;
     e->cancel = parent ? parent->cancel : NULL;
     e->progress = parent ? parent->progress : NULL;
+    e->pool = parent ? parent->pool : NULL;
     /* Inherit forced quality overrides */
     if (parent) {
         e->force_fn = parent->force_fn;
         e->force_fa = parent->force_fa;
         e->force_fs = parent->force_fs;
+        e->seq_difference = parent->seq_difference;
+        e->bool_union = parent->bool_union;
     }
     return e;
 }
@@ -681,6 +694,236 @@ static ts_val ts_eval_expr(ts_ast *node, ts_env *env) {
  * ================================================================ */
 static ts_mesh ts_eval_geometry(ts_ast *node, ts_env *env, ts_mat4 xform);
 
+/* ================================================================
+ * TASK POOL — parallel evaluation of independent subtrees
+ *
+ * A group of sibling subtrees is queued as tasks; idle workers take the
+ * oldest queued task. The thread that queued a group runs its own tasks
+ * that are still queued, newest first, then waits only for the ones a
+ * worker already took. Every joiner makes progress on its own group, so
+ * nested groups cannot deadlock however many workers are busy.
+ *
+ * Tasks share the caller's env read-only, so a group is only queued when
+ * ts_eval_par_safe holds for every member.
+ * ================================================================ */
+
+#define TS_TASK_QUEUED  0
+#define TS_TASK_RUNNING 1
+#define TS_TASK_DONE    2
+
+/* Module calls followed by ts_eval_par_safe before giving up */
+#define TS_EVAL_PAR_DEPTH 16
+
+typedef struct ts_eval_task ts_eval_task;
+struct ts_eval_task {
+    ts_ast       *node;
+    ts_env       *env;
+    ts_mat4       xform;
+    ts_mesh       result;
+    ts_progress  *progress;     /* if non-NULL, done++ when finished */
+    int           state;        /* TS_TASK_*, under pool lock */
+    ts_eval_task *prev, *next;  /* queue links while queued */
+};
+
+struct ts_eval_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t  work;       /* task queued, or shutdown */
+    pthread_cond_t  finished;   /* a task reached TS_TASK_DONE */
+    ts_eval_task   *head, *tail;
+    pthread_t      *threads;
+    int             nthreads;   /* workers, not counting callers */
+    int             shutdown;
+};
+
+/* Caller holds the lock */
+static inline void ts_eval_pool_unlink(ts_eval_pool *p, ts_eval_task *t) {
+    if (t->prev) t->prev->next = t->next; else p->head = t->next;
+    if (t->next) t->next->prev = t->prev; else p->tail = t->prev;
+    t->prev = t->next = NULL;
+}
+
+/* Evaluate a claimed task and mark it done */
+static inline void ts_eval_task_run(ts_eval_pool *p, ts_eval_task *t) {
+    t->result = ts_eval_geometry(t->node, t->env, t->xform);
+    pthread_mutex_lock(&p->lock);
+    t->state = TS_TASK_DONE;
+    if (t->progress) t->progress->done++;
+    pthread_cond_broadcast(&p->finished);
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void *ts_eval_pool_worker(void *arg) {
+    ts_eval_pool *p = (ts_eval_pool *)arg;
+    pthread_mutex_lock(&p->lock);
+    for (;;) {
+        while (!p->head && !p->shutdown)
+            pthread_cond_wait(&p->work, &p->lock);
+        if (p->shutdown) break;
+        ts_eval_task *t = p->head;
+        ts_eval_pool_unlink(p, t);
+        t->state = TS_TASK_RUNNING;
+        pthread_mutex_unlock(&p->lock);
+        ts_eval_task_run(p, t);
+        pthread_mutex_lock(&p->lock);
+    }
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+/* Start a pool for nthreads-way evaluation (the calling thread counts as
+ * one). Returns NULL if nthreads < 2 or no worker could be started. */
+static inline ts_eval_pool *ts_eval_pool_new(int nthreads) {
+    if (nthreads < 2) return NULL;
+    ts_eval_pool *p = (ts_eval_pool *)calloc(1, sizeof(ts_eval_pool));
+    if (!p) return NULL;
+    p->threads = (pthread_t *)malloc((size_t)(nthreads - 1) * sizeof(pthread_t));
+    if (!p->threads) { free(p); return NULL; }
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->work, NULL);
+    pthread_cond_init(&p->finished, NULL);
+    for (int i = 0; i < nthreads - 1; i++) {
+        if (pthread_create(&p->threads[i], NULL, ts_eval_pool_worker, p) != 0)
+            break;
+        p->nthreads++;
+    }
+    if (p->nthreads == 0) {
+        pthread_cond_destroy(&p->finished);
+        pthread_cond_destroy(&p->work);
+        pthread_mutex_destroy(&p->lock);
+        free(p->threads);
+        free(p);
+        return NULL;
+    }
+    return p;
+}
+
+/* Stop the workers. Every group must have been joined. NULL is a no-op. */
+static inline void ts_eval_pool_free(ts_eval_pool *p) {
+    if (!p) return;
+    pthread_mutex_lock(&p->lock);
+    p->shutdown = 1;
+    pthread_cond_broadcast(&p->work);
+    pthread_mutex_unlock(&p->lock);
+    for (int i = 0; i < p->nthreads; i++)
+        pthread_join(p->threads[i], NULL);
+    pthread_cond_destroy(&p->finished);
+    pthread_cond_destroy(&p->work);
+    pthread_mutex_destroy(&p->lock);
+    free(p->threads);
+    free(p);
+}
+
+/*
+ * Whether node can be evaluated concurrently with its siblings against a
+ * shared env without the difference being observable: it must not print
+ * (echo, assert) and must not write to that env (assignments, definitions
+ * and include/use outside a scope of its own). scoped is nonzero inside a
+ * module call, let or for, whose envs are private to the task. User
+ * module bodies are followed up to TS_EVAL_PAR_DEPTH calls deep; deeper
+ * recursion is evaluated in order.
+ */
+static inline int ts_eval_par_safe(ts_ast *node, ts_env *env,
+                                    int scoped, int depth) {
+    if (!node) return 1;
+    switch (node->type) {
+    case TS_AST_ECHO:
+    case TS_AST_ASSERT:
+    case TS_AST_INCLUDE:
+    case TS_AST_USE:
+        return 0;
+    case TS_AST_ASSIGN:
+    case TS_AST_FUNCTION_DEF:
+        return scoped;
+    case TS_AST_MODULE_DEF:
+        /* Nested definitions are not in env yet: check the body here */
+        return scoped && depth < TS_EVAL_PAR_DEPTH &&
+               ts_eval_par_safe(node->def_body, env, 1, depth + 1);
+    case TS_AST_BLOCK:
+        for (int i = 0; i < node->child_count; i++)
+            if (!ts_eval_par_safe(node->children[i], env, scoped, depth))
+                return 0;
+        return 1;
+    case TS_AST_IF:
+        return ts_eval_par_safe(node->then_body, env, scoped, depth) &&
+               ts_eval_par_safe(node->else_body, env, scoped, depth);
+    case TS_AST_LET:
+    case TS_AST_FOR:
+        return ts_eval_par_safe(node->body, env, 1, depth);
+    case TS_AST_MODULE_INST: {
+        if (node->modifier == '*') return 1;
+        for (int i = 0; i < node->child_count; i++)
+            if (!ts_eval_par_safe(node->children[i], env, scoped, depth))
+                return 0;
+        ts_ast *mdef = node->str_val ? ts_env_get_module(env, node->str_val)
+                                     : NULL;
+        if (!mdef) return 1;
+        return depth < TS_EVAL_PAR_DEPTH &&
+               ts_eval_par_safe(mdef->def_body, env, 1, depth + 1);
+    }
+    default:
+        return 1;
+    }
+}
+
+/*
+ * Evaluate nodes[0..n) as pool tasks and return their meshes in order
+ * (caller frees the array and each mesh). Each finished task bumps
+ * progress->done if progress is non-NULL. Returns NULL, having evaluated
+ * nothing, when env has no pool, n < 2, or some node is not
+ * ts_eval_par_safe — the caller then evaluates in order itself.
+ */
+static inline ts_mesh *ts_eval_geometry_par(ts_ast **nodes, int n,
+                                             ts_env *env, ts_mat4 xform,
+                                             ts_progress *progress) {
+    ts_eval_pool *p = env->pool;
+    if (!p || n < 2) return NULL;
+    for (int i = 0; i < n; i++)
+        if (!ts_eval_par_safe(nodes[i], env, 0, 0)) return NULL;
+
+    ts_eval_task *tasks = (ts_eval_task *)calloc((size_t)n, sizeof(ts_eval_task));
+    ts_mesh *out = (ts_mesh *)malloc((size_t)n * sizeof(ts_mesh));
+    if (!tasks || !out) { free(tasks); free(out); return NULL; }
+
+    pthread_mutex_lock(&p->lock);
+    for (int i = 0; i < n; i++) {
+        ts_eval_task *t = &tasks[i];
+        t->node = nodes[i];
+        t->env = env;
+        t->xform = xform;
+        t->progress = progress;
+        t->state = TS_TASK_QUEUED;
+        t->prev = p->tail;
+        if (p->tail) p->tail->next = t; else p->head = t;
+        p->tail = t;
+    }
+    pthread_cond_broadcast(&p->work);
+    pthread_mutex_unlock(&p->lock);
+
+    /* Run our own tasks nobody has taken yet, newest first */
+    for (int i = n - 1; i >= 0; i--) {
+        ts_eval_task *t = &tasks[i];
+        pthread_mutex_lock(&p->lock);
+        int mine = (t->state == TS_TASK_QUEUED);
+        if (mine) {
+            ts_eval_pool_unlink(p, t);
+            t->state = TS_TASK_RUNNING;
+        }
+        pthread_mutex_unlock(&p->lock);
+        if (mine) ts_eval_task_run(p, t);
+    }
+
+    /* Wait for the ones workers took */
+    pthread_mutex_lock(&p->lock);
+    for (int i = 0; i < n; i++)
+        while (tasks[i].state != TS_TASK_DONE)
+            pthread_cond_wait(&p->finished, &p->lock);
+    pthread_mutex_unlock(&p->lock);
+
+    for (int i = 0; i < n; i++) out[i] = tasks[i].result;
+    free(tasks);
+    return out;
+}
+
 /* Evaluate children and combine (implicit union = mesh concatenation) */
 static inline ts_mesh ts_eval_children(ts_ast *node, ts_env *env,
                                         ts_mat4 xform) {
@@ -811,6 +1054,151 @@ static inline ts_mesh ts_load_include(const char *path, ts_env *env,
     return result;
 }
 
+/* First pass of a block: register definitions and assignments in env,
+ * load include/use. Included geometry is appended to *inc_geo. */
+static inline void ts_eval_block_defs(ts_ast *block, ts_env *env,
+                                      ts_mat4 xform, ts_mesh *inc_geo) {
+    for (int i = 0; i < block->child_count; i++) {
+        ts_ast *c = block->children[i];
+        if (c->type == TS_AST_ASSIGN) {
+            ts_val v = ts_eval_expr(c->left, env);
+            ts_env_set(env, c->str_val, v);
+        } else if (c->type == TS_AST_MODULE_DEF) {
+            if (env->mod_count < TS_ENV_MAX) {
+                env->mod_names[env->mod_count] = c->str_val;
+                env->mod_defs[env->mod_count] = c;
+                env->mod_count++;
+            }
+        } else if (c->type == TS_AST_FUNCTION_DEF) {
+            if (env->func_count < TS_ENV_MAX) {
+                env->func_names[env->func_count] = c->str_val;
+                env->func_defs[env->func_count] = c;
+                env->func_count++;
+            }
+        } else if (c->type == TS_AST_INCLUDE || c->type == TS_AST_USE) {
+            /* Load include/use: import definitions (+ geometry for include) */
+            int use_only = (c->type == TS_AST_USE);
+            ts_mesh sub = ts_load_include(c->path, env, xform, use_only);
+            if (!use_only) {
+                ts_mesh_append(inc_geo, &sub);
+            }
+            ts_mesh_free(&sub);
+        }
+    }
+}
+
+/* Statements handled by ts_eval_block_defs, not by the geometry pass */
+static inline int ts_eval_is_def(const ts_ast *c) {
+    return c->type == TS_AST_ASSIGN || c->type == TS_AST_MODULE_DEF ||
+           c->type == TS_AST_FUNCTION_DEF || c->type == TS_AST_INCLUDE ||
+           c->type == TS_AST_USE;
+}
+
+/* ================================================================
+ * UNION OPERANDS
+ *
+ * Boolean union() needs one mesh per geometry instance: blocks, for,
+ * let and if are expanded so that every loop iteration is an operand
+ * of its own rather than one concatenated, self-overlapping mesh.
+ * Statements run in source order, so echo output is the same as with
+ * plain evaluation.
+ * ================================================================ */
+
+typedef struct {
+    ts_mesh *items;
+    int      count;
+    int      cap;
+} ts_eval_operands;
+
+/* Takes ownership of m; empty meshes are dropped */
+static inline void ts_eval_operands_push(ts_eval_operands *ops, ts_mesh m) {
+    if (m.tri_count == 0) {
+        ts_mesh_free(&m);
+        return;
+    }
+    if (ops->count == ops->cap) {
+        int nc = ops->cap ? ops->cap * 2 : 16;
+        ts_mesh *ni = (ts_mesh *)realloc(ops->items, (size_t)nc * sizeof(ts_mesh));
+        if (!ni) {
+            /* Out of memory: keep the geometry, lose only the boolean */
+            if (ops->count > 0) ts_mesh_append(&ops->items[ops->count - 1], &m);
+            ts_mesh_free(&m);
+            return;
+        }
+        ops->items = ni;
+        ops->cap = nc;
+    }
+    ops->items[ops->count++] = m;
+}
+
+static void ts_eval_union_operands(ts_ast *node, ts_env *env, ts_mat4 xform,
+                                   ts_eval_operands *ops) {
+    if (!node || ts_env_cancelled(env)) return;
+
+    switch (node->type) {
+    case TS_AST_BLOCK: {
+        ts_mesh inc = ts_mesh_init();
+        ts_eval_block_defs(node, env, xform, &inc);
+        ts_eval_operands_push(ops, inc);
+        for (int i = 0; i < node->child_count; i++)
+            if (!ts_eval_is_def(node->children[i]))
+                ts_eval_union_operands(node->children[i], env, xform, ops);
+        return;
+    }
+
+    case TS_AST_IF: {
+        ts_val cond = ts_eval_expr(node->cond, env);
+        ts_eval_union_operands(ts_val_is_true(cond) ? node->then_body
+                                                    : node->else_body,
+                               env, xform, ops);
+        return;
+    }
+
+    case TS_AST_LET: {
+        ts_env *lenv = ts_env_new(env);
+        for (int i = 0; i < node->child_count; i++) {
+            ts_ast *assign = node->children[i];
+            ts_val v = ts_eval_expr(assign->left, lenv);
+            ts_env_set(lenv, assign->str_val, v);
+        }
+        ts_eval_union_operands(node->body, lenv, xform, ops);
+        ts_env_free(lenv);
+        return;
+    }
+
+    case TS_AST_FOR: {
+        /* Same iteration as TS_AST_FOR in ts_eval_geometry */
+        ts_val range = ts_eval_expr(node->iter_expr, env);
+        ts_env *loop_env = ts_env_new(env);
+        if (range.type == TS_VAL_RANGE) {
+            double step = range.range_step != 0 ? range.range_step : 1;
+            for (double i = range.range_start;
+                 step > 0 ? i <= range.range_end + 1e-10
+                          : i >= range.range_end - 1e-10;
+                 i += step) {
+                if (ts_env_cancelled(env)) break;
+                ts_env_set(loop_env, node->iter_var, ts_val_num(i));
+                ts_eval_union_operands(node->body, loop_env, xform, ops);
+            }
+        } else if (range.type == TS_VAL_VECTOR) {
+            for (int i = 0; i < range.count; i++) {
+                if (ts_env_cancelled(env)) break;
+                ts_env_set(loop_env, node->iter_var, ts_val_clone(range.items[i]));
+                ts_eval_union_operands(node->body, loop_env, xform, ops);
+            }
+        }
+        ts_val_free(&range);
+        ts_env_free(loop_env);
+        return;
+    }
+
+    default:
+        /* Echo/assert print here, in order, and yield no geometry */
+        ts_eval_operands_push(ops, ts_eval_geometry(node, env, xform));
+        return;
+    }
+}
+
 static ts_mesh ts_eval_geometry(ts_ast *node, ts_env *env, ts_mat4 xform) {
     ts_mesh result = ts_mesh_init();
     if (!node) return result;
@@ -821,33 +1209,7 @@ static ts_mesh ts_eval_geometry(ts_ast *node, ts_env *env, ts_mat4 xform) {
     /* ---- Block / implicit union ---- */
     case TS_AST_BLOCK: {
         /* First pass: collect definitions, assignments, and includes */
-        for (int i = 0; i < node->child_count; i++) {
-            ts_ast *c = node->children[i];
-            if (c->type == TS_AST_ASSIGN) {
-                ts_val v = ts_eval_expr(c->left, env);
-                ts_env_set(env, c->str_val, v);
-            } else if (c->type == TS_AST_MODULE_DEF) {
-                if (env->mod_count < TS_ENV_MAX) {
-                    env->mod_names[env->mod_count] = c->str_val;
-                    env->mod_defs[env->mod_count] = c;
-                    env->mod_count++;
-                }
-            } else if (c->type == TS_AST_FUNCTION_DEF) {
-                if (env->func_count < TS_ENV_MAX) {
-                    env->func_names[env->func_count] = c->str_val;
-                    env->func_defs[env->func_count] = c;
-                    env->func_count++;
-                }
-            } else if (c->type == TS_AST_INCLUDE || c->type == TS_AST_USE) {
-                /* Load include/use: import definitions (+ geometry for include) */
-                int use_only = (c->type == TS_AST_USE);
-                ts_mesh inc_geo = ts_load_include(c->path, env, xform, use_only);
-                if (!use_only) {
-                    ts_mesh_append(&result, &inc_geo);
-                }
-                ts_mesh_free(&inc_geo);
-            }
-        }
+        ts_eval_block_defs(node, env, xform, &result);
         /* Second pass: evaluate geometry */
         /* Count geometry statements for progress (root block only) */
         int is_root = (env->progress && env->progress->total == 0);
@@ -864,6 +1226,39 @@ static ts_mesh ts_eval_geometry(ts_ast *node, ts_env *env, ts_mat4 xform) {
             env->progress->total = geo_count;
             env->progress->done = 0;
         }
+        /* Independent geometry statements: echo/assert in order here,
+         * geometry as one task group joined in order */
+        if (env->pool && node->child_count >= 2) {
+            ts_ast **geo = (ts_ast **)calloc((size_t)node->child_count,
+                                             sizeof(ts_ast *));
+            int ngeo = 0;
+            for (int i = 0; geo && i < node->child_count; i++) {
+                ts_ast *c = node->children[i];
+                if (c->type != TS_AST_ASSIGN && c->type != TS_AST_MODULE_DEF &&
+                    c->type != TS_AST_FUNCTION_DEF && c->type != TS_AST_INCLUDE &&
+                    c->type != TS_AST_USE && c->type != TS_AST_ECHO &&
+                    c->type != TS_AST_ASSERT)
+                    geo[ngeo++] = c;
+            }
+            ts_mesh *parts = geo ? ts_eval_geometry_par(geo, ngeo, env, xform,
+                                       is_root ? env->progress : NULL) : NULL;
+            free(geo);
+            if (parts) {
+                for (int i = 0; i < node->child_count; i++) {
+                    ts_ast *c = node->children[i];
+                    if (c->type == TS_AST_ECHO || c->type == TS_AST_ASSERT) {
+                        ts_mesh dummy = ts_eval_geometry(c, env, xform);
+                        ts_mesh_free(&dummy);
+                    }
+                }
+                for (int i = 0; i < ngeo; i++) {
+                    ts_mesh_append(&result, &parts[i]);
+                    ts_mesh_free(&parts[i]);
+                }
+                free(parts);
+                return result;
+            }
+        }
         for (int i = 0; i < node->child_count; i++) {
             ts_ast *c = node->children[i];
             if (c->type == TS_AST_ASSIGN || c->type == TS_AST_MODULE_DEF ||
@@ -1274,8 +1669,74 @@ static ts_mesh ts_eval_geometry(ts_ast *node, ts_env *env, ts_mat4 xform) {
 
         /* --- CSG operations --- */
         if (strcmp(name, "union") == 0) {
-            /* Explicit union: concatenate children */
-            return ts_eval_children(node, env, xform);
+            if (!env->bool_union || node->child_count == 0)
+                /* Explicit union: concatenate children */
+                return ts_eval_children(node, env, xform);
+
+            /* Boolean union: one operand per geometry instance; only
+             * operands whose AABBs overlap are unioned, disjoint clusters
+             * are concatenated as before */
+            ts_env *scope = ts_env_new(env);
+            scope->module_name = env->module_name;
+            scope->caller_children = env->caller_children;
+            scope->caller_child_count = env->caller_child_count;
+            ts_eval_operands ops = { NULL, 0, 0 };
+
+            ts_ast *body = node->children[0];
+            if (node->child_count == 1 && body->type == TS_AST_BLOCK) {
+                ts_mesh inc = ts_mesh_init();
+                ts_eval_block_defs(body, scope, xform, &inc);
+                ts_eval_operands_push(&ops, inc);
+
+                /* Pool fast path: module calls only, and only if all are
+                 * par-safe — then none of them can echo, and the block's
+                 * own echo/assert may run ahead of the geometry */
+                ts_ast **geo = NULL;
+                int ngeo = 0;
+                if (env->pool)
+                    geo = (ts_ast **)calloc((size_t)body->child_count,
+                                            sizeof(ts_ast *));
+                for (int i = 0; geo && i < body->child_count; i++) {
+                    ts_ast *c = body->children[i];
+                    if (ts_eval_is_def(c) || c->type == TS_AST_ECHO ||
+                        c->type == TS_AST_ASSERT)
+                        continue;
+                    if (c->type != TS_AST_MODULE_INST) {
+                        free(geo);
+                        geo = NULL;
+                        break;
+                    }
+                    geo[ngeo++] = c;
+                }
+                ts_mesh *parts = geo ? ts_eval_geometry_par(geo, ngeo, scope,
+                                                            xform, NULL) : NULL;
+                free(geo);
+                if (parts) {
+                    for (int i = 0; i < body->child_count; i++) {
+                        ts_ast *c = body->children[i];
+                        if (c->type == TS_AST_ECHO || c->type == TS_AST_ASSERT) {
+                            ts_mesh dummy = ts_eval_geometry(c, scope, xform);
+                            ts_mesh_free(&dummy);
+                        }
+                    }
+                    for (int i = 0; i < ngeo; i++)
+                        ts_eval_operands_push(&ops, parts[i]);
+                    free(parts);
+                } else {
+                    for (int i = 0; i < body->child_count; i++)
+                        if (!ts_eval_is_def(body->children[i]))
+                            ts_eval_union_operands(body->children[i], scope,
+                                                   xform, &ops);
+                }
+            } else {
+                for (int i = 0; i < node->child_count; i++)
+                    ts_eval_union_operands(node->children[i], scope, xform, &ops);
+            }
+
+            result = ts_csg_union_clusters(ops.items, ops.count);
+            free(ops.items);
+            ts_env_free(scope);
+            return result;
         }
 
         if (strcmp(name, "difference") == 0) {
@@ -1295,9 +1756,36 @@ static ts_mesh ts_eval_geometry(ts_ast *node, ts_env *env, ts_mat4 xform) {
                 nchildren = node->child_count;
             }
 
-            base = ts_eval_geometry(children[0], env, xform);
+            ts_mesh *parts = ts_eval_geometry_par(children, nchildren,
+                                                  env, xform, NULL);
+            base = parts ? parts[0] : ts_eval_geometry(children[0], env, xform);
+
+            /* Several tools: union them by pairwise reduction (free when
+             * disjoint, e.g. a hole pattern), then subtract once — not
+             * one full boolean against an ever more fragmented base per tool */
+            ts_mesh *tools = parts ? parts + 1 : NULL;
+            if (nchildren > 2 && !env->seq_difference && !tools) {
+                tools = (ts_mesh *)malloc((size_t)(nchildren - 1) * sizeof(ts_mesh));
+                for (int i = 1; tools && i < nchildren; i++)
+                    tools[i - 1] = ts_eval_geometry(children[i], env, xform);
+            }
+            if (nchildren > 2 && !env->seq_difference && tools) {
+                ts_mesh tool = ts_csg_union_reduce(tools, nchildren - 1);
+                if (tool.tri_count > 0 && base.tri_count > 0) {
+                    ts_mesh diff = ts_mesh_init();
+                    ts_csg_boolean(&base, &tool, TS_CSG_OP_DIFFERENCE, &diff);
+                    ts_mesh_free(&base);
+                    base = diff;
+                }
+                ts_mesh_free(&tool);
+                if (!parts) free(tools);
+                free(parts);
+                return base;
+            }
+
             for (int i = 1; i < nchildren; i++) {
-                ts_mesh tool = ts_eval_geometry(children[i], env, xform);
+                ts_mesh tool = parts ? parts[i] :
+                               ts_eval_geometry(children[i], env, xform);
                 if (tool.tri_count > 0 && base.tri_count > 0) {
                     ts_mesh diff = ts_mesh_init();
                     ts_csg_boolean(&base, &tool, TS_CSG_OP_DIFFERENCE, &diff);
@@ -1306,6 +1794,7 @@ static ts_mesh ts_eval_geometry(ts_ast *node, ts_env *env, ts_mat4 xform) {
                 }
                 ts_mesh_free(&tool);
             }
+            free(parts);
             return base;
         }
 
@@ -1314,33 +1803,33 @@ static ts_mesh ts_eval_geometry(ts_ast *node, ts_env *env, ts_mat4 xform) {
             /* Handle block child containing multiple geometry */
             ts_ast *first_child = node->children[0];
             ts_mesh base;
+            int nchildren;
+            ts_ast **children;
 
             if (first_child->type == TS_AST_BLOCK && first_child->child_count >= 2) {
                 /* Block with multiple children: intersect them all */
-                base = ts_eval_geometry(first_child->children[0], env, xform);
-                for (int i = 1; i < first_child->child_count; i++) {
-                    ts_mesh tool = ts_eval_geometry(first_child->children[i], env, xform);
-                    if (tool.tri_count > 0 && base.tri_count > 0) {
-                        ts_mesh inter = ts_mesh_init();
-                        ts_csg_boolean(&base, &tool, TS_CSG_OP_INTERSECTION, &inter);
-                        ts_mesh_free(&base);
-                        base = inter;
-                    }
-                    ts_mesh_free(&tool);
-                }
+                children = first_child->children;
+                nchildren = first_child->child_count;
             } else {
-                base = ts_eval_geometry(first_child, env, xform);
-                for (int i = 1; i < node->child_count; i++) {
-                    ts_mesh tool = ts_eval_geometry(node->children[i], env, xform);
-                    if (tool.tri_count > 0 && base.tri_count > 0) {
-                        ts_mesh inter = ts_mesh_init();
-                        ts_csg_boolean(&base, &tool, TS_CSG_OP_INTERSECTION, &inter);
-                        ts_mesh_free(&base);
-                        base = inter;
-                    }
-                    ts_mesh_free(&tool);
+                children = node->children;
+                nchildren = node->child_count;
+            }
+
+            ts_mesh *parts = ts_eval_geometry_par(children, nchildren,
+                                                  env, xform, NULL);
+            base = parts ? parts[0] : ts_eval_geometry(children[0], env, xform);
+            for (int i = 1; i < nchildren; i++) {
+                ts_mesh tool = parts ? parts[i] :
+                               ts_eval_geometry(children[i], env, xform);
+                if (tool.tri_count > 0 && base.tri_count > 0) {
+                    ts_mesh inter = ts_mesh_init();
+                    ts_csg_boolean(&base, &tool, TS_CSG_OP_INTERSECTION, &inter);
+                    ts_mesh_free(&base);
+                    base = inter;
                 }
+                ts_mesh_free(&tool);
             }
+            free(parts);
             return base;
         }
 
@@ -1625,6 +2114,15 @@ typedef struct {
     volatile int *cancel;  /* if non-NULL, checked for cooperative abort */
     ts_progress  *progress; /* if non-NULL, updated with statement progress */
     const char   *base_dir; /* directory for resolving include/use paths */
+    int           threads;  /* >1 = evaluate independent subtrees on this
+                             * many threads (see TASK POOL); result and
+                             * echo order are the same as sequential */
+    int           sequential_difference; /* subtract difference() tools one
+                                          * at a time instead of once as
+                                          * their union (for comparison) */
+    int           boolean_union; /* union() produces a manifold boolean
+                                  * union; default concatenates children,
+                                  * which may self-intersect */
 } ts_interpret_opts;
 
 /* Interpret source code with options, produce mesh */
@@ -1653,10 +2151,14 @@ static inline ts_mesh ts_interpret_ex(const char *source,
     if (opts && opts->cancel) env->cancel = opts->cancel;
     if (opts && opts->progress) env->progress = opts->progress;
     if (opts && opts->base_dir) env->base_dir = strdup(opts->base_dir);
+    if (opts && opts->threads > 1) env->pool = ts_eval_pool_new(opts->threads);
+    if (opts && opts->sequential_difference) env->seq_difference = 1;
+    if (opts && opts->boolean_union) env->bool_union = 1;
 
     ts_mat4 identity = ts_mat4_identity();
     ts_mesh result = ts_eval_geometry(root, env, identity);
 
+    ts_eval_pool_free(env->pool);
     ts_env_free(env);
     ts_ast_free(root);
     return result;
@@ -135,6 +135,7 @@ typedef struct {
  * Returns number of points. left/right set to glyph bounds. */
 static inline int ts_hershey_decode(const char *g, ts_stroke_pt *out,
                                      int max_pts, double *left, double *right) {
+    *left = *right = 0.0;  /* empty or truncated glyph: zero advance */
     if (!g || !*g) return 0;
 
     /* Parse vertex count */
@@ -150,6 +150,140 @@ static void test_voxel_sdf_signs(void) {
     PASS();
 }
 
+static void test_many_patch_sheet(void) {
+    TEST("8x8 patch sheet: distance equals height");
+
+    /* Flat sheet split into 64 patches. Every voxel has to find the one
+     * patch under it through the patch buckets. */
+    ts_bezier_mesh m = ts_bezier_mesh_new(8, 8);
+    ts_bezier_mesh_init_flat(&m, -4.0, -4.0, 4.0, 4.0, 0.0);
+
+    DC_Error err = {0};
+    DC_VoxelGrid *grid = dc_voxelize_bezier(&m, 32, 2, 15, &err);
+    CHECK(grid != NULL, "NULL grid");
+
+    int sx = dc_voxel_grid_size_x(grid);
+    int sy = dc_voxel_grid_size_y(grid);
+    int sz = dc_voxel_grid_size_z(grid);
+    float cs = dc_voxel_grid_cell_size(grid);
+    float ox, oy, oz;
+    dc_voxel_grid_get_origin(grid, &ox, &oy, &oz);
+
+    /* Away from the sheet's rim, sample the layers 1.5 cells above and
+     * below it. Smoothing bleeds a little of the kink at the sheet into
+     * them, hence the tolerance. */
+    int bad = 0;
+    for (int iz = 0; iz < sz; iz++) {
+        float z = oz + ((float)iz + 0.5f) * cs;
+        if (fabsf(fabsf(z) - 1.5f * cs) > 0.01f * cs) continue;
+        for (int iy = 4; iy < sy - 4; iy++)
+            for (int ix = 4; ix < sx - 4; ix++) {
+                const DC_Voxel *v = dc_voxel_grid_get_const(grid, ix, iy, iz);
+                if (fabsf(fabsf(v->distance) - fabsf(z)) > 0.05f * cs) bad++;
+            }
+    }
+    CHECK(bad == 0, "distance off the sheet does not match height");
+
+    dc_voxel_grid_free(grid);
+    ts_bezier_mesh_free(&m);
+    PASS();
+}
+
+static void test_seeded_matches_unseeded(void) {
+    TEST("coarse seed: refined grid unchanged");
+
+    ts_bezier_mesh m = ts_bezier_mesh_new(2, 2);
+    ts_bezier_mesh_init_flat(&m, -3.0, -3.0, 3.0, 3.0, 0.0);
+
+    for (int r = 0; r < m.cp_rows; r++) {
+        for (int c = 0; c < m.cp_cols; c++) {
+            ts_vec3 cp = ts_bezier_mesh_get_cp(&m, r, c);
+            double dx = cp.v[0], dy = cp.v[1];
+            double t = sqrt(dx*dx + dy*dy) / sqrt(18.0);
+            cp.v[2] = 5.0 * (1.0 - t*t);
+            ts_bezier_mesh_set_cp(&m, r, c, cp);
+        }
+    }
+    ts_bezier_mesh_enforce_c1(&m);
+
+    /* Same passes as dc_voxelize_async: 16 -> 32 -> 64 */
+    DC_Error err = {0};
+    DC_VoxelGrid *g16 = dc_voxelize_bezier(&m, 16, 2, 15, &err);
+    DC_VoxelGrid *g32 = dc_voxelize_bezier_seeded(&m, 32, 2, 15, g16, &err);
+    DC_VoxelGrid *g64 = dc_voxelize_bezier_seeded(&m, 64, 2, 15, g32, &err);
+    DC_VoxelGrid *ref = dc_voxelize_bezier(&m, 64, 2, 15, &err);
+    CHECK(g16 && g32 && g64 && ref, "NULL grid");
+
+    int sx = dc_voxel_grid_size_x(ref);
+    int sy = dc_voxel_grid_size_y(ref);
+    int sz = dc_voxel_grid_size_z(ref);
+    CHECK(dc_voxel_grid_size_x(g64) == sx && dc_voxel_grid_size_y(g64) == sy &&
+          dc_voxel_grid_size_z(g64) == sz, "grid size differs");
+
+    int diff = 0;
+    for (int iz = 0; iz < sz; iz++)
+        for (int iy = 0; iy < sy; iy++)
+            for (int ix = 0; ix < sx; ix++) {
+                const DC_Voxel *a = dc_voxel_grid_get_const(ref, ix, iy, iz);
+                const DC_Voxel *b = dc_voxel_grid_get_const(g64, ix, iy, iz);
+                if (a->active != b->active || a->distance != b->distance) diff++;
+            }
+    CHECK(diff == 0, "seeded grid differs from unseeded");
+
+    dc_voxel_grid_free(g16);
+    dc_voxel_grid_free(g32);
+    dc_voxel_grid_free(g64);
+    dc_voxel_grid_free(ref);
+    ts_bezier_mesh_free(&m);
+    PASS();
+}
+
+static void test_threads_and_cancel(void) {
+    TEST("pool: serial == parallel, cancel stops");
+
+    ts_bezier_mesh m = ts_bezier_mesh_new(3, 3);
+    ts_bezier_mesh_init_flat(&m, -3.0, -3.0, 3.0, 3.0, 0.0);
+    for (int r = 0; r < m.cp_rows; r++) {
+        for (int c = 0; c < m.cp_cols; c++) {
+            ts_vec3 cp = ts_bezier_mesh_get_cp(&m, r, c);
+            cp.v[2] = 1.5 * sin(cp.v[0]) * cos(cp.v[1]);
+            ts_bezier_mesh_set_cp(&m, r, c, cp);
+        }
+    }
+
+    DC_Error err = {0};
+    DC_VoxelizeBezierOpts serial = { .threads = 1 };
+    DC_VoxelizeBezierOpts par = { .threads = 0 };
+    DC_VoxelGrid *a = dc_voxelize_bezier_ex(&m, 40, 2, 15, &serial, &err);
+    DC_VoxelGrid *b = dc_voxelize_bezier_ex(&m, 40, 2, 15, &par, &err);
+    CHECK(a && b, "NULL grid");
+
+    int sx = dc_voxel_grid_size_x(a);
+    int sy = dc_voxel_grid_size_y(a);
+    int sz = dc_voxel_grid_size_z(a);
+    int diff = 0;
+    for (int iz = 0; iz < sz; iz++)
+        for (int iy = 0; iy < sy; iy++)
+            for (int ix = 0; ix < sx; ix++) {
+                const DC_Voxel *va = dc_voxel_grid_get_const(a, ix, iy, iz);
+                const DC_Voxel *vb = dc_voxel_grid_get_const(b, ix, iy, iz);
+                if (va->active != vb->active || va->distance != vb->distance) diff++;
+            }
+    CHECK(diff == 0, "thread count changed the grid");
+
+    volatile int stop = 1;
+    DC_VoxelizeBezierOpts cancelled = { .cancel = &stop };
+    DC_Error cerr = {0};
+    DC_VoxelGrid *c = dc_voxelize_bezier_ex(&m, 40, 2, 15, &cancelled, &cerr);
+    CHECK(c == NULL, "cancelled voxelize returned a grid");
+    CHECK(cerr.code == DC_OK, "cancel reported as an error");
+
+    dc_voxel_grid_free(a);
+    dc_voxel_grid_free(b);
+    ts_bezier_mesh_free(&m);
+    PASS();
+}
+
 static DC_VoxelGrid *create_demo_grid(void) {
     /* Create the cathedral dome for visualization */
     ts_bezier_mesh m = ts_bezier_mesh_new(2, 2);
@@ -183,6 +317,9 @@ int main(void) {
     test_dome_voxelizes();
     test_saddle_voxelizes();
     test_voxel_sdf_signs();
+    test_many_patch_sheet();
+    test_seeded_matches_unseeded();
+    test_threads_and_cancel();
 
     printf("\n--- Demo: cathedral dome at resolution 64 ---\n");
     DC_VoxelGrid *demo = create_demo_grid();
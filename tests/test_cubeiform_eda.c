@@ -5,6 +5,7 @@
 #include "eda/eda_schematic.h"
 #include "eda/eda_pcb.h"
 #include "core/error.h"
+#include "../talmud-main/talmud/sacred/trinity_site/ts_mesh.h"
 
 #include <assert.h>
 #include <stdio.h>
@@ -571,6 +572,282 @@ TEST(test_voxel_for_loop)
     dc_voxel_grid_free(grid);
 }
 
+TEST(test_voxel_long_csg_chain)
+{
+    DC_Error err = {0};
+    /* 20 holes: each chain term nests one group deeper */
+    char src[2048];
+    int len = snprintf(src, sizeof(src), "cube(40)");
+    for (int i = 0; i < 20; i++)
+        len += snprintf(src + len, sizeof(src) - (size_t)len,
+                        " - sphere(r=1.5) >> move(%d, 20, 20)", 1 + i * 2);
+    snprintf(src + len, sizeof(src) - (size_t)len, ";");
+
+    DC_VoxelGrid *solid = NULL, *grid = NULL;
+    ASSERT(dc_cubeiform_execute_full("cube(40);", NULL, NULL, &solid,
+                                     NULL, NULL, &err) == 0);
+    int rc = dc_cubeiform_execute_full(src, NULL, NULL, &grid, NULL, NULL, &err);
+    ASSERT(rc == 0);
+    ASSERT(solid != NULL && grid != NULL);
+
+    /* Every hole is cut, however deep the chain */
+    size_t full = dc_voxel_grid_active_count(solid);
+    size_t cut = dc_voxel_grid_active_count(grid);
+    ASSERT(cut > 0);
+    ASSERT(cut + 20 * 10 < full);
+
+    dc_voxel_grid_free(solid);
+    dc_voxel_grid_free(grid);
+}
+
+TEST(test_voxel_modifiers)
+{
+    DC_Error err = {0};
+
+    /* Modifiers wrap the shape piped so far; later transforms wrap both */
+    DC_CubeiformEda *eda = dc_cubeiform_parse_eda(
+        "cube(10) >> round(1) >> move(5, 0, 0);", &err);
+    ASSERT(eda != NULL);
+    static const DC_VoxOpType expect[] = {
+        DC_VOX_OP_TRANSLATE, DC_VOX_OP_MODIFY_BEGIN, DC_VOX_OP_BOX,
+        DC_VOX_OP_ROUND, DC_VOX_OP_POP_TRANSFORM,
+    };
+    ASSERT(dc_cubeiform_eda_vox_op_count(eda) == 5);
+    for (size_t i = 0; i < 5; i++)
+        ASSERT(dc_cubeiform_eda_get_vox_op(eda, i)->type == expect[i]);
+    ASSERT(dc_cubeiform_eda_get_vox_op(eda, 3)->radius == 1.0);
+    dc_cubeiform_eda_free(eda);
+
+    /* blend(k) rides on the CSG op joining its operand */
+    eda = dc_cubeiform_parse_eda("sphere(5) - sphere(3) >> blend(2);", &err);
+    ASSERT(eda != NULL);
+    int found = 0;
+    for (size_t i = 0; i < dc_cubeiform_eda_vox_op_count(eda); i++) {
+        const DC_VoxOp *op = dc_cubeiform_eda_get_vox_op(eda, i);
+        if (op->type == DC_VOX_OP_SUBTRACT && op->radius == 2.0) found = 1;
+    }
+    ASSERT(found);
+    dc_cubeiform_eda_free(eda);
+
+    DC_VoxelGrid *plain = NULL, *grid = NULL;
+    ASSERT(dc_cubeiform_execute_full("sphere(5) + sphere(5) >> move(8, 0, 0);",
+                                     NULL, NULL, &plain, NULL, NULL, &err) == 0);
+    ASSERT(dc_cubeiform_execute_full("sphere(5) + sphere(5) >> move(8, 0, 0) >> blend(3);",
+                                     NULL, NULL, &grid, NULL, NULL, &err) == 0);
+    ASSERT(plain != NULL && grid != NULL);
+    /* The fillet only adds material */
+    ASSERT(dc_voxel_grid_active_count(grid) > dc_voxel_grid_active_count(plain));
+    dc_voxel_grid_free(plain);
+    dc_voxel_grid_free(grid);
+
+    ASSERT(dc_cubeiform_execute_full("cube(20);", NULL, NULL, &plain,
+                                     NULL, NULL, &err) == 0);
+    ASSERT(dc_cubeiform_execute_full("cube(20) >> shell(2);", NULL, NULL, &grid,
+                                     NULL, NULL, &err) == 0);
+    ASSERT(plain != NULL && grid != NULL);
+    size_t solid = dc_voxel_grid_active_count(plain);
+    size_t wall = dc_voxel_grid_active_count(grid);
+    ASSERT(wall > 0);
+    ASSERT(wall < solid / 2);
+    dc_voxel_grid_free(plain);
+    dc_voxel_grid_free(grid);
+}
+
+TEST(test_voxel_repeat_matches_copies)
+{
+    DC_Error err = {0};
+    /* A 7x7 vent grid as one repeated hole, and as 49 holes */
+    const char *rep =
+        "cube(40, 40, 4) - cylinder(h=6, d=2) >> move(-15, -15, 0)"
+        " >> repeat(5, 5, 0, 7, 7);";
+    char src[8192];
+    int len = snprintf(src, sizeof(src), "cube(40, 40, 4)");
+    for (int j = 0; j < 7; j++)
+    for (int i = 0; i < 7; i++)
+        len += snprintf(src + len, sizeof(src) - (size_t)len,
+                        " - cylinder(h=6, d=2) >> move(%d, %d, 0)",
+                        -15 + 5 * i, -15 + 5 * j);
+    snprintf(src + len, sizeof(src) - (size_t)len, ";");
+
+    DC_VoxelGrid *solid = NULL, *a = NULL, *b = NULL;
+    ASSERT(dc_cubeiform_execute_full("cube(40, 40, 4);", NULL, NULL, &solid,
+                                     NULL, NULL, &err) == 0);
+    ASSERT(dc_cubeiform_execute_full(rep, NULL, NULL, &a, NULL, NULL, &err) == 0);
+    ASSERT(dc_cubeiform_execute_full(src, NULL, NULL, &b, NULL, NULL, &err) == 0);
+    ASSERT(solid != NULL && a != NULL && b != NULL);
+    ASSERT(dc_voxel_grid_size_x(a) == dc_voxel_grid_size_x(b));
+    ASSERT(dc_voxel_grid_size_z(a) == dc_voxel_grid_size_z(b));
+
+    size_t full = dc_voxel_grid_active_count(solid);
+    size_t na = dc_voxel_grid_active_count(a);
+    size_t nb = dc_voxel_grid_active_count(b);
+    ASSERT(na + 49 * 4 < full);
+    ASSERT(na <= nb + 8 && nb <= na + 8);
+
+    dc_voxel_grid_free(solid);
+    dc_voxel_grid_free(a);
+    dc_voxel_grid_free(b);
+}
+
+/* Patch the grid of src_a to src_b and compare with a full build of
+ * src_b; *box_cells receives the size of the patched box */
+static int
+patch_matches_build(const char *src_a, const char *src_b, size_t *box_cells)
+{
+    DC_Error err = {0};
+    DC_CubeiformEda *a = dc_cubeiform_parse_eda(src_a, &err);
+    DC_CubeiformEda *b = dc_cubeiform_parse_eda(src_b, &err);
+    DC_VoxelGrid *grid = a ? dc_cubeiform_eda_apply_voxel(a, &err) : NULL;
+    DC_VoxelGrid *want = b ? dc_cubeiform_eda_apply_voxel(b, &err) : NULL;
+    int lo[3], hi[3], ok = 0;
+    if (grid && want &&
+        dc_cubeiform_eda_patch_voxel(b, a, grid, lo, hi, &err) == 1) {
+        *box_cells = (size_t)(hi[0] - lo[0]) * (size_t)(hi[1] - lo[1]) *
+                     (size_t)(hi[2] - lo[2]);
+        ok = 1;
+        int sx = dc_voxel_grid_size_x(want), sy = dc_voxel_grid_size_y(want);
+        int sz = dc_voxel_grid_size_z(want);
+        for (int iz = 0; iz < sz && ok; iz++)
+        for (int iy = 0; iy < sy && ok; iy++)
+        for (int ix = 0; ix < sx && ok; ix++) {
+            DC_Voxel u, v;
+            dc_voxel_grid_load(grid, ix, iy, iz, &u);
+            dc_voxel_grid_load(want, ix, iy, iz, &v);
+            ok = u.distance == v.distance && u.active == v.active &&
+                 u.r == v.r;
+        }
+    }
+    dc_voxel_grid_free(grid);
+    dc_voxel_grid_free(want);
+    dc_cubeiform_eda_free(a);
+    dc_cubeiform_eda_free(b);
+    return ok;
+}
+
+TEST(test_voxel_patch)
+{
+    const char *two_holes =
+        "cube(40, 40, 4) - cylinder(h=6, d=4) >> move(-10, 0, 0)"
+        " - cylinder(h=6, d=4) >> move(10, 5, 0);";
+    const char *wider =
+        "cube(40, 40, 4) - cylinder(h=6, d=4) >> move(-10, 0, 0)"
+        " - cylinder(h=6, d=7) >> move(10, 5, 0);";
+    const char *moved =
+        "cube(40, 40, 4) - cylinder(h=6, d=4) >> move(-10, 0, 0)"
+        " - cylinder(h=6, d=4) >> move(12, -3, 0);";
+
+    /* Resizing or moving one hole rewrites a small box around it, and
+     * the grid ends up as a full build would leave it */
+    DC_Error err = {0};
+    DC_CubeiformEda *eda = dc_cubeiform_parse_eda(two_holes, &err);
+    DC_VoxelGrid *grid = eda ? dc_cubeiform_eda_apply_voxel(eda, &err) : NULL;
+    ASSERT(grid != NULL);
+    size_t cells = (size_t)dc_voxel_grid_size_x(grid) *
+                   (size_t)dc_voxel_grid_size_y(grid) *
+                   (size_t)dc_voxel_grid_size_z(grid);
+    size_t box = 0;
+    ASSERT(patch_matches_build(two_holes, wider, &box));
+    ASSERT(box > 0 && box < cells / 4);
+    ASSERT(patch_matches_build(two_holes, moved, &box));
+    ASSERT(box > 0 && box < cells / 3);
+
+    /* Nothing changed: an empty box */
+    int lo[3], hi[3];
+    ASSERT(dc_cubeiform_eda_patch_voxel(eda, eda, grid, lo, hi, &err) == 1);
+    ASSERT(hi[0] == lo[0]);
+
+    /* Blends, and shapes inside a repeat (every copy changes) */
+    ASSERT(patch_matches_build(
+        "sphere(5) + sphere(5) >> move(8, 0, 0) >> blend(2);",
+        "sphere(5) + sphere(5) >> move(8, 0, 0) >> blend(3);", &box));
+    ASSERT(patch_matches_build(
+        "cube(40, 40, 4) - cylinder(h=6, d=2) >> move(-15, -15, 0)"
+        " >> repeat(5, 5, 0, 7, 7);",
+        "cube(40, 40, 4) - cylinder(h=6, d=3) >> move(-15, -15, 0)"
+        " >> repeat(5, 5, 0, 7, 7);", &box));
+
+    /* Adding a hole or changing the resolution needs a full build */
+    DC_CubeiformEda *more = dc_cubeiform_parse_eda(
+        "cube(40, 40, 4) - cylinder(h=6, d=4) >> move(-10, 0, 0)"
+        " - cylinder(h=6, d=4) >> move(10, 5, 0)"
+        " - cylinder(h=6, d=4) >> move(0, -10, 0);", &err);
+    ASSERT(more != NULL);
+    ASSERT(dc_cubeiform_eda_patch_voxel(more, eda, grid, lo, hi, &err) == 0);
+    DC_CubeiformEda *grown = dc_cubeiform_parse_eda(
+        "cube(60, 40, 4) - cylinder(h=6, d=4) >> move(-10, 0, 0)"
+        " - cylinder(h=6, d=4) >> move(10, 5, 0);", &err);
+    ASSERT(grown != NULL);
+    ASSERT(dc_cubeiform_eda_patch_voxel(grown, eda, grid, lo, hi, &err) == 0);
+
+    dc_cubeiform_eda_free(more);
+    dc_cubeiform_eda_free(grown);
+    dc_cubeiform_eda_free(eda);
+    dc_voxel_grid_free(grid);
+}
+
+/* Byte-compare two files */
+static int same_file(const char *a, const char *b)
+{
+    FILE *fa = fopen(a, "rb"), *fb = fopen(b, "rb");
+    int same = fa && fb;
+    while (same) {
+        int ca = fgetc(fa), cb = fgetc(fb);
+        if (ca != cb) same = 0;
+        if (ca == EOF || cb == EOF) break;
+    }
+    if (fa) fclose(fa);
+    if (fb) fclose(fb);
+    return same;
+}
+
+TEST(test_voxel_export_stl)
+{
+    const char *src =
+        "cube(40, 40, 4) - cylinder(h=6, d=4) >> move(-10, 0, 0)"
+        " + sphere(6) >> move(10, 5, 2) >> blend(2);";
+    const char *ref = "/tmp/test_cubeiform_eda_ref.stl";
+    const char *out = "/tmp/test_cubeiform_eda_stream.stl";
+
+    /* Reference: marching cubes on the in-memory grid, in world space */
+    DC_Error err = {0};
+    DC_CubeiformEda *eda = dc_cubeiform_parse_eda(src, &err);
+    ASSERT(eda != NULL);
+    DC_VoxelGrid *grid = dc_cubeiform_eda_apply_voxel(eda, &err);
+    ASSERT(grid != NULL);
+    float o[3];
+    dc_voxel_grid_get_origin(grid, &o[0], &o[1], &o[2]);
+    ts_mesh mesh = ts_mesh_init();
+    ASSERT(dc_marching_cubes(grid, 0.0f, &mesh) == 0);
+    for (int i = 0; i < mesh.vert_count; i++)
+        for (int a = 0; a < 3; a++) mesh.verts[i].pos[a] += o[a];
+    ASSERT(mesh.tri_count > 0);
+    ASSERT(ts_mesh_write_stl(&mesh, ref) == 0);
+
+    /* Streaming the same ops gives the same file */
+    size_t ntri = 0;
+    ASSERT(dc_cubeiform_eda_export_stl(eda, out, NULL, &ntri, &err) == 0);
+    ASSERT(ntri == (size_t)mesh.tri_count);
+    ASSERT(same_file(ref, out));
+
+    /* Errors: no path, no voxel ops, unwritable file */
+    ASSERT(dc_cubeiform_eda_export_stl(eda, NULL, NULL, &ntri, &err) == -1);
+    ASSERT(err.code == DC_ERROR_INVALID_ARG);
+    DC_CubeiformEda *none = dc_cubeiform_parse_eda("", &err);
+    ASSERT(none != NULL);
+    ASSERT(dc_cubeiform_eda_export_stl(none, out, NULL, &ntri, &err) == -1);
+    ASSERT(err.code == DC_ERROR_INVALID_ARG && ntri == 0);
+    ASSERT(dc_cubeiform_eda_export_stl(eda, "/nonexistent/dir/x.stl", NULL,
+                                       &ntri, &err) == -1);
+    ASSERT(err.code == DC_ERROR_IO);
+
+    remove(ref);
+    remove(out);
+    ts_mesh_free(&mesh);
+    dc_voxel_grid_free(grid);
+    dc_cubeiform_eda_free(none);
+    dc_cubeiform_eda_free(eda);
+}
+
 /* =========================================================================
  * Tests — Mixed 3D + EDA (EDA blocks coexist with shape blocks)
  * ========================================================================= */
@@ -639,6 +916,11 @@ int main(void)
     RUN(test_voxel_variable);
     RUN(test_voxel_named_params);
     RUN(test_voxel_for_loop);
+    RUN(test_voxel_long_csg_chain);
+    RUN(test_voxel_modifiers);
+    RUN(test_voxel_repeat_matches_copies);
+    RUN(test_voxel_patch);
+    RUN(test_voxel_export_stl);
 
     /* Mixed */
     RUN(test_mixed_3d_eda);
@@ -5,11 +5,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 #include <assert.h>
 
 #include "voxel/voxel.h"
 #include "voxel/sdf.h"
+#include "voxel/sdf_program.h"
 #include "voxel/marching_cubes.h"
+#include "voxel/dual_contour.h"
 #include "../talmud-main/talmud/sacred/trinity_site/ts_mesh.h"
 
 static int tests_passed = 0;
@@ -184,6 +187,434 @@ done:
     dc_voxel_grid_free(grid);
 }
 
+/* =========================================================================
+ * Test: sparse and SoA grids extract the same surface as dense
+ * ========================================================================= */
+static void test_mc_sparse(void) {
+    TEST(sparse_and_soa_match_dense);
+
+    int res = 40;
+    float cs = 0.25f;
+    DC_VoxelGrid *dense = dc_voxel_grid_new(res, res, res, cs);
+    DC_VoxelGrid *sparse = dc_voxel_grid_new_sparse(res, res, res, cs, 3.0f * cs);
+    assert(dense && sparse);
+
+    DC_VoxelGrid *soa = dc_voxel_grid_new_soa(res, res, res, cs);
+    assert(soa);
+
+    dc_sdf_sphere(dense, 5.0f, 5.0f, 5.0f, 3.0f);
+    dc_sdf_sphere(sparse, 5.0f, 5.0f, 5.0f, 3.0f);
+    dc_sdf_sphere(soa, 5.0f, 5.0f, 5.0f, 3.0f);
+
+    ts_mesh md = ts_mesh_init(), ms = ts_mesh_init(), mp = ts_mesh_init();
+    dc_marching_cubes(dense, 0.0f, &md);
+    dc_marching_cubes(sparse, 0.0f, &ms);
+    dc_marching_cubes(soa, 0.0f, &mp);
+
+    /* Same triangles, possibly in another order: compare counts and
+     * vertex sums */
+    double cd[3] = {0, 0, 0}, csum[3] = {0, 0, 0};
+    for (int i = 0; i < md.vert_count; i++)
+        for (int a = 0; a < 3; a++) cd[a] += md.verts[i].pos[a];
+    for (int i = 0; i < ms.vert_count; i++)
+        for (int a = 0; a < 3; a++) csum[a] += ms.verts[i].pos[a];
+
+    if (md.tri_count == 0 || ms.tri_count != md.tri_count) {
+        FAIL("triangle counts differ");
+    } else if (mp.vert_count != md.vert_count ||
+               memcmp(mp.verts, md.verts,
+                      (size_t)md.vert_count * sizeof(md.verts[0])) != 0) {
+        FAIL("SoA mesh differs from dense");
+    } else if (fabs(cd[0] - csum[0]) > 1e-3 || fabs(cd[1] - csum[1]) > 1e-3 ||
+               fabs(cd[2] - csum[2]) > 1e-3) {
+        FAIL("vertex positions differ");
+    } else {
+        printf("[%d tris, %zu bricks] ", ms.tri_count,
+               dc_voxel_grid_brick_count(sparse));
+        PASS();
+    }
+
+    ts_mesh_free(&md);
+    ts_mesh_free(&ms);
+    ts_mesh_free(&mp);
+    dc_voxel_grid_free(dense);
+    dc_voxel_grid_free(sparse);
+    dc_voxel_grid_free(soa);
+}
+
+/* =========================================================================
+ * Dual contouring
+ * ========================================================================= */
+
+typedef struct { int a, b; } MeshEdge;
+
+static int cmp_edge(const void *x, const void *y) {
+    const MeshEdge *p = x, *q = y;
+    if (p->a != q->a) return p->a < q->a ? -1 : 1;
+    return (p->b > q->b) - (p->b < q->b);
+}
+
+/* Edges not shared by exactly two triangles (0 for a closed manifold) */
+static int open_edges(const ts_mesh *m) {
+    int n = m->tri_count * 3, bad = 0;
+    MeshEdge *e = malloc(sizeof(MeshEdge) * (size_t)(n ? n : 1));
+    for (int t = 0; t < m->tri_count; t++) {
+        for (int j = 0; j < 3; j++) {
+            int a = m->tris[t].idx[j], b = m->tris[t].idx[(j + 1) % 3];
+            e[t*3 + j].a = a < b ? a : b;
+            e[t*3 + j].b = a < b ? b : a;
+        }
+    }
+    qsort(e, (size_t)n, sizeof(MeshEdge), cmp_edge);
+    for (int i = 0; i < n; ) {
+        int j = i;
+        while (j < n && e[j].a == e[i].a && e[j].b == e[i].b) j++;
+        if (j - i != 2) bad++;
+        i = j;
+    }
+    free(e);
+    return bad;
+}
+
+/* Triangles whose winding faces towards c (should face away) */
+static int inward_tris(const ts_mesh *m, const double c[3]) {
+    int bad = 0;
+    for (int t = 0; t < m->tri_count; t++) {
+        const double *p0 = m->verts[m->tris[t].idx[0]].pos;
+        const double *p1 = m->verts[m->tris[t].idx[1]].pos;
+        const double *p2 = m->verts[m->tris[t].idx[2]].pos;
+        double u[3], v[3], d = 0;
+        for (int a = 0; a < 3; a++) { u[a] = p1[a] - p0[a]; v[a] = p2[a] - p0[a]; }
+        double n[3] = { u[1]*v[2] - u[2]*v[1], u[2]*v[0] - u[0]*v[2],
+                        u[0]*v[1] - u[1]*v[0] };
+        for (int a = 0; a < 3; a++)
+            d += n[a] * ((p0[a] + p1[a] + p2[a]) / 3.0 - c[a]);
+        if (d < 0) bad++;
+    }
+    return bad;
+}
+
+static void test_dc_box(void) {
+    TEST(dc_box_fewer_tris_sharp_corners);
+
+    int res = 48;
+    float cs = 0.25f;
+    DC_VoxelGrid *grid = dc_voxel_grid_new(res, res, res, cs);
+    assert(grid);
+
+    /* Corners off the sample lattice */
+    double c[3] = { 6.1, 5.93, 6.07 }, h[3] = { 3.3, 2.7, 3.1 };
+    dc_sdf_box(grid, (float)(c[0] - h[0]), (float)(c[1] - h[1]),
+               (float)(c[2] - h[2]), (float)(c[0] + h[0]),
+               (float)(c[1] + h[1]), (float)(c[2] + h[2]));
+
+    ts_mesh mc = ts_mesh_init(), dc = ts_mesh_init(), uni = ts_mesh_init();
+    DC_DualContourOpts uniform = { -1.0f };
+    dc_marching_cubes(grid, 0.0f, &mc);
+    int rc = dc_dual_contour(grid, 0.0f, NULL, &dc);
+    dc_dual_contour(grid, 0.0f, &uniform, &uni);
+
+    double surf_err = 0, corner_err = 0;
+    for (int i = 0; i < dc.vert_count; i++) {
+        const double *p = dc.verts[i].pos;
+        double d = fmax(fabs(p[0] - c[0]) - h[0],
+                   fmax(fabs(p[1] - c[1]) - h[1], fabs(p[2] - c[2]) - h[2]));
+        if (fabs(d) > surf_err) surf_err = fabs(d);
+    }
+    for (int k = 0; k < 8; k++) {
+        double best = 1e9;
+        for (int i = 0; i < dc.vert_count; i++) {
+            double d2 = 0;
+            for (int a = 0; a < 3; a++) {
+                double q = c[a] + (((k >> a) & 1) ? h[a] : -h[a]);
+                d2 += (dc.verts[i].pos[a] - q) * (dc.verts[i].pos[a] - q);
+            }
+            if (d2 < best) best = d2;
+        }
+        if (sqrt(best) > corner_err) corner_err = sqrt(best);
+    }
+
+    char msg[160];
+    if (rc != 0 || dc.tri_count == 0) {
+        FAIL("dc_dual_contour produced nothing");
+    } else if (dc.tri_count * 4 > mc.tri_count ||
+               dc.tri_count * 4 > uni.tri_count) {
+        snprintf(msg, sizeof(msg), "%d tris vs %d MC, %d uniform",
+                 dc.tri_count, mc.tri_count, uni.tri_count);
+        FAIL(msg);
+    } else if (open_edges(&dc) != 0 || open_edges(&uni) != 0) {
+        FAIL("mesh is not closed and manifold");
+    } else if (inward_tris(&dc, c) != 0) {
+        FAIL("triangles wound inward");
+    } else if (surf_err > 0.25 * cs || corner_err > 0.5 * cs) {
+        snprintf(msg, sizeof(msg), "surface err %.4f, corner err %.4f",
+                 surf_err, corner_err);
+        FAIL(msg);
+    } else {
+        printf("[%d tris vs %d MC, corner err %.3f] ", dc.tri_count,
+               mc.tri_count, corner_err);
+        PASS();
+    }
+
+    ts_mesh_free(&mc);
+    ts_mesh_free(&dc);
+    ts_mesh_free(&uni);
+    dc_voxel_grid_free(grid);
+}
+
+static void test_dc_sphere(void) {
+    TEST(dc_sphere_welded_on_surface);
+
+    int res = 40;
+    float cs = 0.25f;
+    DC_VoxelGrid *dense = dc_voxel_grid_new(res, res, res, cs);
+    DC_VoxelGrid *sparse = dc_voxel_grid_new_sparse(res, res, res, cs, 3.0f * cs);
+    DC_VoxelGrid *soa = dc_voxel_grid_new_soa(res, res, res, cs);
+    assert(dense && sparse && soa);
+    double c[3] = { 5.0, 5.0, 5.0 };
+    dc_sdf_sphere(dense, 5.0f, 5.0f, 5.0f, 3.7f);
+    dc_sdf_sphere(sparse, 5.0f, 5.0f, 5.0f, 3.7f);
+    dc_sdf_sphere(soa, 5.0f, 5.0f, 5.0f, 3.7f);
+
+    ts_mesh md = ts_mesh_init(), ms = ts_mesh_init(), mp = ts_mesh_init();
+    dc_dual_contour(dense, 0.0f, NULL, &md);
+    dc_dual_contour(sparse, 0.0f, NULL, &ms);
+    dc_dual_contour(soa, 0.0f, NULL, &mp);
+
+    double max_err = 0;
+    for (int i = 0; i < md.vert_count; i++) {
+        double d2 = 0;
+        for (int a = 0; a < 3; a++)
+            d2 += (md.verts[i].pos[a] - c[a]) * (md.verts[i].pos[a] - c[a]);
+        if (fabs(sqrt(d2) - 3.7) > max_err) max_err = fabs(sqrt(d2) - 3.7);
+    }
+
+    char msg[160];
+    if (md.tri_count == 0 || md.vert_count * 2 > md.tri_count + 4) {
+        snprintf(msg, sizeof(msg), "%d verts for %d tris: not welded",
+                 md.vert_count, md.tri_count);
+        FAIL(msg);
+    } else if (open_edges(&md) != 0 || inward_tris(&md, c) != 0) {
+        FAIL("mesh is not closed and outward");
+    } else if (max_err > 0.25 * cs) {
+        snprintf(msg, sizeof(msg), "max err %.4f", max_err);
+        FAIL(msg);
+    } else if (ms.tri_count != md.tri_count || open_edges(&ms) != 0) {
+        FAIL("sparse grid gives a different mesh");
+    } else if (mp.vert_count != md.vert_count ||
+               memcmp(mp.verts, md.verts,
+                      (size_t)md.vert_count * sizeof(md.verts[0])) != 0) {
+        FAIL("SoA mesh differs from dense");
+    } else {
+        printf("[%d verts, %d tris, max_err=%.4f] ", md.vert_count,
+               md.tri_count, max_err);
+        PASS();
+    }
+
+    ts_mesh_free(&md);
+    ts_mesh_free(&ms);
+    ts_mesh_free(&mp);
+    dc_voxel_grid_free(dense);
+    dc_voxel_grid_free(sparse);
+    dc_voxel_grid_free(soa);
+}
+
+/* =========================================================================
+ * Test: marching cubes shares vertices between neighbouring cubes
+ * ========================================================================= */
+static void test_mc_welded(void) {
+    TEST(mc_sphere_welded_and_closed);
+
+    int res = 40;
+    float cs = 0.25f;
+    DC_VoxelGrid *dense = dc_voxel_grid_new(res, res, res, cs);
+    DC_VoxelGrid *sparse = dc_voxel_grid_new_sparse(res, res, res, cs, 3.0f * cs);
+    assert(dense && sparse);
+    dc_sdf_sphere(dense, 5.0f, 5.0f, 5.0f, 3.7f);
+    dc_sdf_sphere(sparse, 5.0f, 5.0f, 5.0f, 3.7f);
+
+    ts_mesh md = ts_mesh_init(), ms = ts_mesh_init();
+    dc_marching_cubes(dense, 0.0f, &md);
+    dc_marching_cubes(sparse, 0.0f, &ms);
+
+    /* Euler: a closed genus-0 triangle mesh has V = T/2 + 2 */
+    char msg[160];
+    if (md.tri_count == 0 || md.vert_count != md.tri_count / 2 + 2) {
+        snprintf(msg, sizeof(msg), "%d verts for %d tris",
+                 md.vert_count, md.tri_count);
+        FAIL(msg);
+    } else if (open_edges(&md) != 0) {
+        FAIL("dense mesh is not closed");
+    } else if (ms.vert_count != md.vert_count || open_edges(&ms) != 0) {
+        FAIL("sparse mesh is not welded like dense");
+    } else {
+        printf("[%d verts, %d tris] ", md.vert_count, md.tri_count);
+        PASS();
+    }
+
+    ts_mesh_free(&md);
+    ts_mesh_free(&ms);
+    dc_voxel_grid_free(dense);
+    dc_voxel_grid_free(sparse);
+}
+
+/* =========================================================================
+ * Test: parallel slabs match the serial walk; cancel and progress
+ * ========================================================================= */
+static int same_mesh(const ts_mesh *a, const ts_mesh *b) {
+    return a->vert_count == b->vert_count && a->tri_count == b->tri_count &&
+           memcmp(a->verts, b->verts,
+                  (size_t)a->vert_count * sizeof(a->verts[0])) == 0 &&
+           memcmp(a->tris, b->tris,
+                  (size_t)a->tri_count * sizeof(a->tris[0])) == 0;
+}
+
+static void test_mc_parallel(void) {
+    TEST(mc_parallel_matches_serial);
+
+    int res = 53;  /* partial last tile */
+    float cs = 0.25f;
+    DC_VoxelGrid *dense = dc_voxel_grid_new(res, res, res, cs);
+    DC_VoxelGrid *sparse = dc_voxel_grid_new_sparse(res, res, res, cs, 3.0f * cs);
+    assert(dense && sparse);
+    dc_sdf_sphere(dense, 6.6f, 6.6f, 6.6f, 5.1f);
+    dc_sdf_sphere(sparse, 6.6f, 6.6f, 6.6f, 5.1f);
+
+    DC_MarchingCubesOpts serial = {0}, parallel = {0};
+    serial.threads = 1;
+    parallel.threads = 4;
+    volatile int done = -1, total = -1;
+    parallel.progress_done = &done;
+    parallel.progress_total = &total;
+
+    ts_mesh m1 = ts_mesh_init(), m4 = ts_mesh_init();
+    ts_mesh s1 = ts_mesh_init(), s4 = ts_mesh_init();
+    int rc = dc_marching_cubes_ex(dense, 0.0f, &serial, &m1);
+    rc |= dc_marching_cubes_ex(dense, 0.0f, &parallel, &m4);
+    rc |= dc_marching_cubes_ex(sparse, 0.0f, &serial, &s1);
+    rc |= dc_marching_cubes_ex(sparse, 0.0f, &parallel, &s4);
+
+    if (rc != 0 || m1.tri_count == 0) {
+        FAIL("dc_marching_cubes_ex failed");
+    } else if (!same_mesh(&m1, &m4) || !same_mesh(&s1, &s4)) {
+        FAIL("parallel mesh differs from serial");
+    } else if (open_edges(&m4) != 0 || open_edges(&s4) != 0) {
+        FAIL("slab seams not welded");
+    } else if (total != 7 || done != total) {
+        FAIL("progress not reported per slab");
+    } else {
+        printf("[%d verts, %d slabs] ", m4.vert_count, total);
+        PASS();
+    }
+
+    TEST(mc_cancel_leaves_mesh_untouched);
+    volatile int cancel = 1;
+    parallel.cancel = &cancel;
+    rc = dc_marching_cubes_ex(dense, 0.0f, &parallel, &m4);
+    if (rc != 1) { FAIL("cancelled extraction should return 1"); }
+    else if (!same_mesh(&m1, &m4)) { FAIL("cancelled extraction changed mesh"); }
+    else { PASS(); }
+
+    ts_mesh_free(&m1);
+    ts_mesh_free(&m4);
+    ts_mesh_free(&s1);
+    ts_mesh_free(&s4);
+    dc_voxel_grid_free(dense);
+    dc_voxel_grid_free(sparse);
+}
+
+/* =========================================================================
+ * Test: streaming Z-slabs to STL writes exactly the in-memory mesh
+ * ========================================================================= */
+static const float STREAM_BAND = 0.75f;
+
+static int stream_fill(void *ctx, DC_VoxelGrid *slab, int z0) {
+    dc_voxel_grid_set_band(slab, STREAM_BAND);
+    if (dc_sdf_program_eval_slab(ctx, slab, z0) != 0) return -1;
+    dc_sdf_clamp(slab, STREAM_BAND);
+    return 0;
+}
+
+static int same_file(const char *a, const char *b) {
+    FILE *fa = fopen(a, "rb"), *fb = fopen(b, "rb");
+    int same = fa && fb;
+    while (same) {
+        int ca = fgetc(fa), cb = fgetc(fb);
+        if (ca != cb) same = 0;
+        if (ca == EOF || cb == EOF) break;
+    }
+    if (fa) fclose(fa);
+    if (fb) fclose(fb);
+    return same;
+}
+
+static void test_mc_stream(void) {
+    TEST(mc_stream_stl_matches_full_grid);
+
+    int sx = 30, sy = 26, sz = 45;
+    float cs = 0.25f;
+    DC_SdfProgram *prog = dc_sdf_program_new();
+    assert(prog);
+    dc_sdf_program_box(prog, 1.1f, 1.3f, 1.2f, 6.2f, 5.1f, 9.7f, NULL);
+    dc_sdf_program_sphere(prog, 3.6f, 3.2f, 5.3f, 2.9f, NULL);
+    dc_sdf_program_smooth_subtract(prog, 0.5f);
+
+    DC_VoxelGrid *full = dc_voxel_grid_new_soa(sx, sy, sz, cs);
+    assert(full);
+    dc_voxel_grid_set_band(full, STREAM_BAND);
+    dc_sdf_program_eval(prog, full);
+    dc_sdf_clamp(full, STREAM_BAND);
+
+    ts_mesh mesh = ts_mesh_init();
+    dc_marching_cubes(full, 0.0f, &mesh);
+    float origin[3] = { -4.25f, 10.5f, 0.125f };
+    for (int i = 0; i < mesh.vert_count; i++)
+        for (int a = 0; a < 3; a++) mesh.verts[i].pos[a] += origin[a];
+    const char *ref = "/tmp/test_mc_stream_ref.stl";
+    const char *out = "/tmp/test_mc_stream.stl";
+    ts_mesh_write_stl(&mesh, ref);
+
+    /* 44 cube slices in slabs of 9: five slabs, seams off tile borders */
+    DC_McSource src = {
+        .size = { sx, sy, sz }, .cell_size = cs,
+        .origin = { origin[0], origin[1], origin[2] },
+        .slab_slices = 9, .fill = stream_fill, .ctx = prog,
+    };
+    volatile int done = 0, total = 0;
+    DC_MarchingCubesOpts opts = { .progress_done = &done,
+                                  .progress_total = &total };
+    size_t ntri = 0;
+    int rc = dc_marching_cubes_stream_stl(&src, 0.0f, &opts, out, &ntri);
+
+    if (rc != 0) {
+        FAIL("dc_marching_cubes_stream_stl failed");
+    } else if (mesh.tri_count == 0 || ntri != (size_t)mesh.tri_count) {
+        FAIL("triangle count differs");
+    } else if (total != 5 || done != 5) {
+        FAIL("progress not reported per slab");
+    } else if (!same_file(ref, out)) {
+        FAIL("streamed STL differs from the full-grid mesh");
+    } else {
+        printf("[%zu tris, %d slabs] ", ntri, total);
+        PASS();
+    }
+
+    TEST(mc_stream_cancel_removes_file);
+    volatile int cancel = 1;
+    opts.cancel = &cancel;
+    rc = dc_marching_cubes_stream_stl(&src, 0.0f, &opts, out, &ntri);
+    FILE *fp = fopen(out, "rb");
+    if (rc != 1) { FAIL("cancelled export should return 1"); }
+    else if (fp) { FAIL("cancelled export left a file"); }
+    else { PASS(); }
+    if (fp) fclose(fp);
+
+    remove(ref);
+    ts_mesh_free(&mesh);
+    dc_voxel_grid_free(full);
+    dc_sdf_program_free(prog);
+}
+
 /* =========================================================================
  * Test: null/empty grid handling
  * ========================================================================= */
@@ -193,6 +624,12 @@ static void test_mc_null(void) {
     int rc = dc_marching_cubes(NULL, 0.0f, &mesh);
     if (rc != -1) { FAIL("should return -1 for NULL grid"); }
     else { PASS(); }
+    TEST(dc_null_grid_returns_error);
+    if (dc_dual_contour(NULL, 0.0f, NULL, &mesh) != -1) {
+        FAIL("should return -1 for NULL grid");
+    } else {
+        PASS();
+    }
     ts_mesh_free(&mesh);
 }
 
@@ -205,6 +642,12 @@ int main(void) {
     test_mc_sphere();
     test_mc_box();
     test_mc_stl_export();
+    test_mc_sparse();
+    test_mc_welded();
+    test_mc_parallel();
+    test_mc_stream();
+    test_dc_box();
+    test_dc_sphere();
     test_mc_null();
 
     printf("\n--- Results: %d passed, %d failed ---\n\n",
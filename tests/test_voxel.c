@@ -1,3 +1,4 @@
+#define _POSIX_C_SOURCE 200809L
 /*
  * test_voxel.c — Tests for voxel grid + SDF operations.
  * No GTK dependency — links only dc_core.
@@ -5,10 +6,21 @@
 
 #include "voxel/voxel.h"
 #include "voxel/sdf.h"
-
+#include "voxel/sdf_program.h"
+#include "voxel/sdf_sweep.h"
+#include "voxel/tri_bvh.h"
+#include "voxel/voxel_cache.h"
+#include "voxel/voxel_pool.h"
+#include "voxel/voxelize_stl.h"
+
+#include <fcntl.h>
 #include <math.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /* ---- Minimal test framework ---- */
 static int g_pass = 0;
@@ -112,6 +124,734 @@ test_coord_conversion(void)
     return 0;
 }
 
+static int
+test_grid_copy_sample(void)
+{
+    DC_VoxelGrid *g = dc_voxel_grid_new(6, 5, 4, 0.5f);
+    ASSERT(g != NULL);
+    dc_voxel_grid_set_origin(g, -1.0f, 2.0f, 0.0f);
+
+    /* Linear field over cell centres: trilinear sampling is exact */
+    for (int iz = 0; iz < 4; iz++)
+        for (int iy = 0; iy < 5; iy++)
+            for (int ix = 0; ix < 6; ix++) {
+                DC_Voxel *v = dc_voxel_grid_get(g, ix, iy, iz);
+                v->distance = (float)ix + 2.0f * (float)iy - (float)iz;
+            }
+
+    DC_VoxelGrid *c = dc_voxel_grid_copy(g);
+    ASSERT(c != NULL);
+    dc_voxel_grid_free(g);
+
+    float ox, oy, oz;
+    dc_voxel_grid_get_origin(c, &ox, &oy, &oz);
+    ASSERT(ox == -1.0f && oy == 2.0f && oz == 0.0f);
+    ASSERT(dc_voxel_grid_cell_size(c) == 0.5f);
+
+    /* Centre of cell (2,1,3), then a quarter of the way to (3,2,2) */
+    ASSERT(fabsf(dc_voxel_grid_sample(c, 0.25f, 2.75f, 1.75f) - 1.0f) < 1e-5f);
+    ASSERT(fabsf(dc_voxel_grid_sample(c, 0.375f, 2.875f, 1.625f) - 2.0f) < 1e-5f);
+
+    /* Outside the grid clamps to the border cell */
+    ASSERT(fabsf(dc_voxel_grid_sample(c, -9.0f, 2.25f, 0.25f) - 0.0f) < 1e-5f);
+    ASSERT(fabsf(dc_voxel_grid_sample(c, 9.0f, 9.0f, 9.0f) - 10.0f) < 1e-5f);
+
+    dc_voxel_grid_free(c);
+    ASSERT(dc_voxel_grid_sample(NULL, 0.0f, 0.0f, 0.0f) == HUGE_VALF);
+    return 0;
+}
+
+static int
+test_sparse_tiles(void)
+{
+    DC_VoxelGrid *g = dc_voxel_grid_new_sparse(20, 9, 8, 1.0f, 3.0f);
+    ASSERT(g != NULL);
+    ASSERT(dc_voxel_grid_is_sparse(g));
+    ASSERT(dc_voxel_grid_band(g) == 3.0f);
+
+    int tx, ty, tz;
+    dc_voxel_grid_tile_dims(g, &tx, &ty, &tz);
+    ASSERT(tx == 3 && ty == 2 && tz == 1);
+    ASSERT(dc_voxel_grid_brick_count(g) == 0);
+
+    const DC_Voxel *c = dc_voxel_grid_get_const(g, 19, 8, 7);
+    ASSERT(c && c->active == 0 && c->distance == HUGE_VALF);
+    ASSERT(dc_voxel_grid_brick_count(g) == 0);
+
+    /* Mutable access materializes one brick */
+    DC_Voxel v = { 1, 10, 20, 30, -0.5f };
+    ASSERT(dc_voxel_grid_set(g, 9, 1, 2, v) == 0);
+    ASSERT(dc_voxel_grid_brick_count(g) == 1);
+    ASSERT(!dc_voxel_grid_tile_constant(g, 1, 0, 0, NULL));
+    ASSERT(dc_voxel_grid_get_const(g, 9, 1, 2)->distance == -0.5f);
+    ASSERT(dc_voxel_grid_get_const(g, 8, 1, 2)->distance == HUGE_VALF);
+    ASSERT(dc_voxel_grid_active_count(g) == 1);
+
+    DC_VoxelGrid *cp = dc_voxel_grid_copy(g);
+    ASSERT(cp && dc_voxel_grid_is_sparse(cp));
+    ASSERT(dc_voxel_grid_brick_count(cp) == 1);
+    ASSERT(dc_voxel_grid_get_const(cp, 9, 1, 2)->r == 10);
+    dc_voxel_grid_free(cp);
+
+    /* Constant active tile on the clipped edge: 4 x 1 x 8 cells */
+    DC_Voxel in = { 1, 0, 0, 0, -5.0f };
+    ASSERT(dc_voxel_grid_tile_fill(g, 2, 1, 0, in) == 0);
+    ASSERT(dc_voxel_grid_tile_fill(g, 3, 0, 0, in) == -1);
+    ASSERT(dc_voxel_grid_active_count(g) == 1 + 4 * 1 * 8);
+
+    DC_Voxel got;
+    ASSERT(dc_voxel_grid_tile_constant(g, 2, 1, 0, &got));
+    ASSERT(got.distance == -5.0f);
+
+    /* Prune keeps the surface brick, collapses a far one */
+    DC_Voxel *far = dc_voxel_grid_get(g, 1, 1, 1);
+    far->distance = 7.0f;
+    ASSERT(dc_voxel_grid_brick_count(g) == 2);
+    ASSERT(dc_voxel_grid_prune(g) == 1);
+    ASSERT(dc_voxel_grid_tile_constant(g, 0, 0, 0, &got));
+    ASSERT(got.distance == 7.0f);
+    ASSERT(dc_voxel_grid_brick_count(g) == 1);
+
+    size_t bytes = dc_voxel_grid_memory_bytes(g);
+    ASSERT(bytes < 20 * 9 * 8 * sizeof(DC_Voxel));
+
+    dc_voxel_grid_fill_color(g, 1, 2, 3);
+    ASSERT(dc_voxel_grid_get_const(g, 0, 0, 0)->g == 2);
+    ASSERT(dc_voxel_grid_get_const(g, 9, 1, 2)->b == 3);
+
+    dc_voxel_grid_clear(g);
+    ASSERT(dc_voxel_grid_brick_count(g) == 0);
+    ASSERT(dc_voxel_grid_active_count(g) == 0);
+
+    /* Dense grids report every tile as allocated */
+    DC_VoxelGrid *d = dc_voxel_grid_new(4, 4, 4, 1.0f);
+    ASSERT(!dc_voxel_grid_is_sparse(d));
+    ASSERT(!dc_voxel_grid_tile_constant(d, 0, 0, 0, NULL));
+    ASSERT(dc_voxel_grid_tile_fill(d, 0, 0, 0, in) == 0);
+    ASSERT(dc_voxel_grid_active_count(d) == 64);
+    dc_voxel_grid_free(d);
+
+    dc_voxel_grid_free(g);
+    return 0;
+}
+
+/* Build the same scene into g: rotated box minus a sphere, unioned with
+ * a torus, then activated. */
+static void
+sparse_scene(DC_VoxelGrid *g, DC_VoxelGrid *a, DC_VoxelGrid *b)
+{
+    DC_SdfTransform t;
+    dc_sdf_transform_identity(&t);
+    dc_sdf_transform_translate(&t, 5.0f, 5.0f, 5.0f);
+    dc_sdf_transform_rotate(&t, 0.0f, 0.0f, 1.0f, 30.0f);
+    dc_sdf_box_t(a, -3.0f, -2.0f, -2.5f, 3.0f, 2.0f, 2.5f, &t);
+    dc_sdf_sphere(b, 7.0f, 5.0f, 5.0f, 2.0f);
+    dc_sdf_subtract(a, b, g);
+    dc_sdf_torus(g, 5.0f, 5.0f, 8.0f, 2.5f, 0.5f);
+    dc_sdf_activate(g);
+}
+
+static int
+test_sparse_matches_dense(void)
+{
+    int n = 48;
+    float cs = 0.25f, band = DC_SDF_BAND_CELLS * cs;
+    DC_VoxelGrid *d = dc_voxel_grid_new(n, n, n, cs);
+    DC_VoxelGrid *da = dc_voxel_grid_new(n, n, n, cs);
+    DC_VoxelGrid *db = dc_voxel_grid_new(n, n, n, cs);
+    DC_VoxelGrid *s = dc_voxel_grid_new_sparse(n, n, n, cs, band);
+    DC_VoxelGrid *sa = dc_voxel_grid_new_sparse(n, n, n, cs, band);
+    DC_VoxelGrid *sb = dc_voxel_grid_new_sparse(n, n, n, cs, band);
+    ASSERT(d && da && db && s && sa && sb);
+
+    sparse_scene(d, da, db);
+    sparse_scene(s, sa, sb);
+
+    /* Band cells are exact; the rest keep sign and stay beyond the band */
+    for (int iz = 0; iz < n; iz++)
+    for (int iy = 0; iy < n; iy++)
+    for (int ix = 0; ix < n; ix++) {
+        const DC_Voxel *vd = dc_voxel_grid_get_const(d, ix, iy, iz);
+        const DC_Voxel *vs = dc_voxel_grid_get_const(s, ix, iy, iz);
+        ASSERT(vd->active == vs->active);
+        if (fabsf(vd->distance) < band) {
+            ASSERT(vs->distance == vd->distance);
+        } else {
+            ASSERT((vs->distance < 0.0f) == (vd->distance < 0.0f));
+            ASSERT(fabsf(vs->distance) >= band);
+        }
+    }
+    ASSERT(dc_voxel_grid_active_count(s) == dc_voxel_grid_active_count(d));
+
+    int tx, ty, tz;
+    dc_voxel_grid_tile_dims(s, &tx, &ty, &tz);
+    size_t bricks = dc_voxel_grid_brick_count(s);
+    ASSERT(bricks > 0 && bricks < (size_t)(tx * ty * tz));
+    ASSERT(dc_voxel_grid_memory_bytes(s) < dc_voxel_grid_memory_bytes(d));
+
+    /* Pruning must not change what the surface sees */
+    dc_voxel_grid_prune(s);
+    ASSERT(dc_voxel_grid_brick_count(s) <= bricks);
+    ASSERT(dc_voxel_grid_active_count(s) == dc_voxel_grid_active_count(d));
+
+    dc_voxel_grid_free(d);
+    dc_voxel_grid_free(da);
+    dc_voxel_grid_free(db);
+    dc_voxel_grid_free(s);
+    dc_voxel_grid_free(sa);
+    dc_voxel_grid_free(sb);
+    return 0;
+}
+
+static int
+test_soa_planes(void)
+{
+    DC_VoxelGrid *g = dc_voxel_grid_new_soa(5, 4, 3, 1.0f);
+    ASSERT(g != NULL);
+    ASSERT(dc_voxel_grid_is_soa(g));
+    ASSERT(!dc_voxel_grid_is_sparse(g));
+    ASSERT(dc_voxel_grid_get(g, 0, 0, 0) == NULL);
+
+    /* Only the distance plane exists up front */
+    const float *d = dc_voxel_grid_distances_const(g);
+    ASSERT(d != NULL && d[59] == HUGE_VALF);
+    ASSERT(dc_voxel_grid_active_plane_const(g) == NULL);
+    ASSERT(dc_voxel_grid_color_plane_const(g) == NULL);
+    ASSERT(dc_voxel_grid_memory_bytes(g) == 60 * sizeof(float));
+
+    /* A distance-only write leaves the other planes unallocated */
+    DC_Voxel v = { 0, 0, 0, 0, -1.5f };
+    ASSERT(dc_voxel_grid_set(g, 1, 2, 0, v) == 0);
+    ASSERT(d[1 + 2*5] == -1.5f);
+    ASSERT(dc_voxel_grid_active_plane_const(g) == NULL);
+
+    DC_Voxel c = { 1, 7, 8, 9, 2.0f };
+    ASSERT(dc_voxel_grid_set(g, 4, 3, 2, c) == 0);
+    ASSERT(dc_voxel_grid_set(g, 5, 0, 0, c) == -1);
+    const uint8_t *rgb = dc_voxel_grid_color_plane_const(g);
+    ASSERT(rgb != NULL && rgb[59*3+1] == 8);
+    ASSERT(dc_voxel_grid_active_count(g) == 1);
+
+    DC_Voxel out;
+    ASSERT(dc_voxel_grid_load(g, 4, 3, 2, &out) == 0);
+    ASSERT(out.active == 1 && out.b == 9 && out.distance == 2.0f);
+    ASSERT(dc_voxel_grid_distance(g, 1, 2, 0) == -1.5f);
+    ASSERT(dc_voxel_grid_distance(g, -1, 0, 0) == HUGE_VALF);
+
+    DC_VoxelGrid *cp = dc_voxel_grid_copy(g);
+    ASSERT(cp && dc_voxel_grid_is_soa(cp));
+    ASSERT(dc_voxel_grid_load(cp, 4, 3, 2, &out) == 0 && out.r == 7);
+    dc_voxel_grid_free(cp);
+
+    dc_voxel_grid_clear(g);
+    ASSERT(dc_voxel_grid_active_plane_const(g) == NULL);
+    ASSERT(dc_voxel_grid_color_plane_const(g) == NULL);
+    ASSERT(dc_voxel_grid_distance(g, 1, 2, 0) == HUGE_VALF);
+
+    /* AoS grids expose no planes */
+    DC_VoxelGrid *a = dc_voxel_grid_new(2, 2, 2, 1.0f);
+    ASSERT(dc_voxel_grid_distances(a) == NULL);
+    ASSERT(dc_voxel_grid_color_plane(a) == NULL);
+    dc_voxel_grid_free(a);
+
+    dc_voxel_grid_free(g);
+    return 0;
+}
+
+static int
+test_soa_matches_aos(void)
+{
+    int n = 40;
+    float cs = 0.25f;
+    DC_VoxelGrid *d = dc_voxel_grid_new(n, n, n, cs);
+    DC_VoxelGrid *da = dc_voxel_grid_new(n, n, n, cs);
+    DC_VoxelGrid *db = dc_voxel_grid_new(n, n, n, cs);
+    DC_VoxelGrid *s = dc_voxel_grid_new_soa(n, n, n, cs);
+    DC_VoxelGrid *sa = dc_voxel_grid_new_soa(n, n, n, cs);
+    DC_VoxelGrid *sb = dc_voxel_grid_new_soa(n, n, n, cs);
+    ASSERT(d && da && db && s && sa && sb);
+
+    sparse_scene(d, da, db);
+    sparse_scene(s, sa, sb);
+    dc_sdf_color_by_normal(d);
+    dc_sdf_color_by_normal(s);
+
+    for (int iz = 0; iz < n; iz++)
+    for (int iy = 0; iy < n; iy++)
+    for (int ix = 0; ix < n; ix++) {
+        const DC_Voxel *vd = dc_voxel_grid_get_const(d, ix, iy, iz);
+        DC_Voxel vs;
+        ASSERT(dc_voxel_grid_load(s, ix, iy, iz, &vs) == 0);
+        ASSERT(vs.distance == vd->distance);
+        ASSERT(vs.active == vd->active);
+        ASSERT(vs.r == vd->r && vs.g == vd->g && vs.b == vd->b);
+    }
+    ASSERT(dc_voxel_grid_active_count(s) == dc_voxel_grid_active_count(d));
+    ASSERT(fabsf(dc_voxel_grid_sample(s, 5.1f, 4.9f, 5.3f) -
+                 dc_voxel_grid_sample(d, 5.1f, 4.9f, 5.3f)) < 1e-6f);
+
+    /* Operands never colored carry only their distance plane */
+    ASSERT(dc_voxel_grid_memory_bytes(sa) == (size_t)n * n * n * sizeof(float));
+
+    dc_voxel_grid_free(d);
+    dc_voxel_grid_free(da);
+    dc_voxel_grid_free(db);
+    dc_voxel_grid_free(s);
+    dc_voxel_grid_free(sa);
+    dc_voxel_grid_free(sb);
+    return 0;
+}
+
+/* Every primitive on an odd-sized grid, rotated and scaled, then CSG. */
+static void
+simd_scene(DC_VoxelGrid *g, DC_VoxelGrid *tmp)
+{
+    DC_SdfTransform t;
+    dc_sdf_transform_identity(&t);
+    dc_sdf_transform_translate(&t, 2.5f, 1.5f, 1.25f);
+    dc_sdf_transform_rotate(&t, 1.0f, 2.0f, 0.5f, 37.0f);
+    dc_sdf_transform_scale(&t, 1.5f, 1.5f, 1.5f);
+    dc_sdf_sphere_t(g, 0.3f, 0.0f, 0.0f, 0.8f, &t);
+    dc_sdf_box_t(g, -0.5f, -0.4f, -0.3f, 0.5f, 0.4f, 0.3f, &t);
+    dc_sdf_cylinder(g, 1.0f, 1.0f, 0.4f, 0.2f, 2.0f);
+    dc_sdf_torus_t(tmp, 0.0f, 0.0f, 0.0f, 0.9f, 0.2f, &t);
+    dc_sdf_subtract(g, tmp, g);
+}
+
+static int
+test_sdf_simd_levels(void)
+{
+    DC_SdfSimd levels[] = { DC_SDF_SIMD_SSE2, DC_SDF_SIMD_AVX2 };
+    int sx = 21, sy = 13, sz = 11;
+    float cs = 0.23f;
+    size_t total = (size_t)sx * sy * sz;
+
+    ASSERT(dc_sdf_simd_select(DC_SDF_SIMD_SCALAR) == DC_SDF_SIMD_SCALAR);
+    DC_VoxelGrid *ref = dc_voxel_grid_new(sx, sy, sz, cs);
+    DC_VoxelGrid *rtmp = dc_voxel_grid_new(sx, sy, sz, cs);
+    ASSERT(ref && rtmp);
+    simd_scene(ref, rtmp);
+
+    /* Scalar rows agree with the closed form at a sample cell */
+    float wx, wy, wz;
+    dc_voxel_grid_cell_center(ref, 7, 3, 2, &wx, &wy, &wz);
+    DC_VoxelGrid *one = dc_voxel_grid_new(sx, sy, sz, cs);
+    dc_sdf_cylinder(one, 1.0f, 1.0f, 0.4f, 0.2f, 2.0f);
+    float radial = sqrtf((wx-1.0f)*(wx-1.0f) + (wy-1.0f)*(wy-1.0f)) - 0.4f;
+    float expect = fmaxf(radial, fmaxf(0.2f - wz, wz - 2.0f));
+    ASSERT(fabsf(dc_voxel_grid_distance(one, 7, 3, 2) - expect) < 1e-5f);
+    dc_voxel_grid_free(one);
+
+    for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        dc_sdf_simd_select(levels[l]);
+
+        DC_VoxelGrid *g = dc_voxel_grid_new_soa(sx, sy, sz, cs);
+        DC_VoxelGrid *tmp = dc_voxel_grid_new_soa(sx, sy, sz, cs);
+        ASSERT(g && tmp);
+        simd_scene(g, tmp);
+
+        /* Bit-identical to the scalar kernels, tails included */
+        for (int iz = 0; iz < sz; iz++)
+        for (int iy = 0; iy < sy; iy++)
+        for (int ix = 0; ix < sx; ix++)
+            ASSERT(dc_voxel_grid_distance(g, ix, iy, iz) ==
+                   dc_voxel_grid_distance(ref, ix, iy, iz));
+
+        const float *d = dc_voxel_grid_distances_const(g);
+        ASSERT(d[total - 1] == dc_voxel_grid_distance(ref, sx-1, sy-1, sz-1));
+
+        dc_voxel_grid_free(g);
+        dc_voxel_grid_free(tmp);
+    }
+
+    dc_sdf_simd_select(DC_SDF_SIMD_AUTO);
+    ASSERT(dc_sdf_simd_level() != DC_SDF_SIMD_AUTO);
+    dc_voxel_grid_free(ref);
+    dc_voxel_grid_free(rtmp);
+    return 0;
+}
+
+/* Banded grid agrees with the full evaluation (to within tol) inside the
+ * band and keeps the sign beyond it */
+static int
+band_matches(const DC_VoxelGrid *g, const DC_VoxelGrid *full, float band,
+             float tol)
+{
+    for (int iz = 0; iz < dc_voxel_grid_size_z(full); iz++)
+    for (int iy = 0; iy < dc_voxel_grid_size_y(full); iy++)
+    for (int ix = 0; ix < dc_voxel_grid_size_x(full); ix++) {
+        float f = dc_voxel_grid_distance(full, ix, iy, iz);
+        float d = dc_voxel_grid_distance(g, ix, iy, iz);
+        if (fabsf(f) < band) {
+            if (fabsf(d - f) > tol) return 0;
+        } else if ((d < 0.0f) != (f < 0.0f) || fabsf(d) < band * 0.999f) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void
+bounded_scene(DC_VoxelGrid *g)
+{
+    DC_SdfTransform t;
+    dc_sdf_transform_identity(&t);
+    dc_sdf_transform_translate(&t, 6.0f, 3.0f, 2.0f);
+    dc_sdf_transform_rotate(&t, 0.0f, 1.0f, 1.0f, 30.0f);
+    dc_sdf_sphere(g, 1.0f, 1.0f, 1.0f, 0.5f);
+    dc_sdf_box_t(g, -0.5f, -0.3f, -0.2f, 0.5f, 0.3f, 0.2f, &t);
+    dc_sdf_cylinder(g, 3.0f, 3.5f, 0.3f, 0.5f, 1.5f);
+    dc_sdf_torus_t(g, 0.0f, 0.0f, 1.0f, 0.6f, 0.15f, &t);
+}
+
+static int
+test_sdf_bounded_band(void)
+{
+    int sx = 40, sy = 24, sz = 20;
+    float cs = 0.2f, band = 3.0f * cs;
+
+    DC_VoxelGrid *full = dc_voxel_grid_new(sx, sy, sz, cs);
+    DC_VoxelGrid *soa = dc_voxel_grid_new_soa(sx, sy, sz, cs);
+    DC_VoxelGrid *sp = dc_voxel_grid_new_sparse(sx, sy, sz, cs, band);
+    ASSERT(full && soa && sp);
+    ASSERT(dc_voxel_grid_band(soa) == 0.0f);
+    ASSERT(dc_voxel_grid_set_band(soa, band) == 0);
+    ASSERT(dc_voxel_grid_set_band(sp, band) == -1);
+    ASSERT(dc_voxel_grid_set_band(soa, -1.0f) == -1);
+    ASSERT(dc_voxel_grid_band(soa) == band);
+
+    bounded_scene(full);
+    bounded_scene(soa);
+    bounded_scene(sp);
+    ASSERT(band_matches(soa, full, band, 0.0f));
+    ASSERT(band_matches(sp, full, band, 0.0f));
+
+    /* Most of the grid is far from every primitive and never visited */
+    size_t untouched = 0, total = (size_t)sx * sy * sz;
+    const float *d = dc_voxel_grid_distances_const(soa);
+    for (size_t i = 0; i < total; i++)
+        if (d[i] == HUGE_VALF) untouched++;
+    ASSERT(untouched > total / 2);
+
+    /* Clamping keeps the band valid and makes every value finite */
+    dc_sdf_clamp(soa, band);
+    ASSERT(band_matches(soa, full, band, 0.0f));
+    for (size_t i = 0; i < total; i++)
+        ASSERT(isfinite(d[i]));
+
+    dc_voxel_grid_free(full);
+    dc_voxel_grid_free(soa);
+    dc_voxel_grid_free(sp);
+    return 0;
+}
+
+static int
+test_sdf_offset_csg(void)
+{
+    int sx = 32, sy = 20, sz = 16;
+    float cs = 0.2f, band = 3.0f * cs;
+    int zero[3] = { 0, 0, 0 }, off[3] = { 5, 4, 2 };
+
+    /* b covers a 12^3 region; bfull is the same sphere on the whole lattice */
+    DC_VoxelGrid *a = dc_voxel_grid_new(sx, sy, sz, cs);
+    DC_VoxelGrid *b = dc_voxel_grid_new_soa(12, 12, 12, cs);
+    DC_VoxelGrid *bfull = dc_voxel_grid_new(sx, sy, sz, cs);
+    ASSERT(a && b && bfull);
+    dc_sdf_box(a, 1.0f, 1.0f, 0.6f, 2.6f, 2.4f, 1.8f);
+    dc_sdf_sphere(b, 1.2f, 1.2f, 1.2f, 0.4f);
+    dc_sdf_sphere(bfull, 1.2f + 5 * cs, 1.2f + 4 * cs, 1.2f + 2 * cs, 0.4f);
+
+    int (*at[3])(const DC_VoxelGrid *, const int *, const DC_VoxelGrid *,
+                 const int *, DC_VoxelGrid *, const int *) = {
+        dc_sdf_union_at, dc_sdf_subtract_at, dc_sdf_intersect_at,
+    };
+    int (*ref[3])(const DC_VoxelGrid *, const DC_VoxelGrid *, DC_VoxelGrid *) = {
+        dc_sdf_union, dc_sdf_subtract, dc_sdf_intersect,
+    };
+    for (int k = 0; k < 3; k++) {
+        DC_VoxelGrid *expect = dc_voxel_grid_new(sx, sy, sz, cs);
+        ASSERT(expect);
+        ASSERT(ref[k](a, bfull, expect) == 0);
+
+        /* In place on a copy of a, and into a separate SoA output */
+        DC_VoxelGrid *inplace = dc_voxel_grid_copy(a);
+        DC_VoxelGrid *out = dc_voxel_grid_new_soa(sx, sy, sz, cs);
+        ASSERT(inplace && out);
+        ASSERT(at[k](inplace, zero, b, off, inplace, zero) == 0);
+        ASSERT(at[k](a, zero, b, off, out, zero) == 0);
+        ASSERT(band_matches(inplace, expect, band, 1e-4f));
+        ASSERT(band_matches(out, expect, band, 1e-4f));
+
+        dc_voxel_grid_free(expect);
+        dc_voxel_grid_free(inplace);
+        dc_voxel_grid_free(out);
+    }
+
+    /* Output aliasing an operand must share its offset */
+    ASSERT(dc_sdf_union_at(a, zero, b, off, b, zero) == -1);
+
+    dc_voxel_grid_free(a);
+    dc_voxel_grid_free(b);
+    dc_voxel_grid_free(bfull);
+    return 0;
+}
+
+static int
+test_sdf_program(void)
+{
+    int sx = 40, sy = 24, sz = 20;
+    float cs = 0.2f, band = 3.0f * cs;
+    DC_SdfTransform t;
+    dc_sdf_transform_identity(&t);
+    dc_sdf_transform_translate(&t, 3.5f, 2.2f, 1.5f);
+    dc_sdf_transform_rotate(&t, 1.0f, 0.0f, 1.0f, 40.0f);
+
+    /* ((box + sphere) - cylinder) + (torus & sphere), one grid per term */
+    DC_VoxelGrid *expect = dc_voxel_grid_new(sx, sy, sz, cs);
+    DC_VoxelGrid *cut = dc_voxel_grid_new(sx, sy, sz, cs);
+    DC_VoxelGrid *ring = dc_voxel_grid_new(sx, sy, sz, cs);
+    DC_VoxelGrid *ball = dc_voxel_grid_new(sx, sy, sz, cs);
+    ASSERT(expect && cut && ring && ball);
+    dc_sdf_box(expect, 1.0f, 1.0f, 0.6f, 3.6f, 3.4f, 2.4f);
+    dc_sdf_sphere_t(expect, 0.0f, 0.0f, 0.0f, 0.7f, &t);
+    dc_sdf_cylinder(cut, 2.2f, 2.2f, 0.5f, 0.0f, 4.0f);
+    dc_sdf_torus(ring, 6.0f, 2.4f, 2.0f, 1.0f, 0.3f);
+    dc_sdf_sphere(ball, 6.8f, 2.4f, 2.0f, 0.8f);
+    ASSERT(dc_sdf_subtract(expect, cut, expect) == 0);
+    ASSERT(dc_sdf_intersect(ring, ball, ring) == 0);
+    ASSERT(dc_sdf_union(expect, ring, expect) == 0);
+
+    DC_SdfProgram *prog = dc_sdf_program_new();
+    ASSERT(prog);
+    ASSERT(dc_sdf_program_union(prog) == -1);
+    ASSERT(dc_sdf_program_box(prog, 1.0f, 1.0f, 0.6f, 3.6f, 3.4f, 2.4f, NULL) == 0);
+    ASSERT(dc_sdf_program_sphere(prog, 0.0f, 0.0f, 0.0f, 0.7f, &t) == 0);
+    ASSERT(dc_sdf_program_union(prog) == 0);
+    ASSERT(dc_sdf_program_cylinder(prog, 2.2f, 2.2f, 0.5f, 0.0f, 4.0f, NULL) == 0);
+    ASSERT(dc_sdf_program_subtract(prog) == 0);
+    ASSERT(dc_sdf_program_torus(prog, 6.0f, 2.4f, 2.0f, 1.0f, 0.3f, NULL) == 0);
+    ASSERT(dc_sdf_program_sphere(prog, 6.8f, 2.4f, 2.0f, 0.8f, NULL) == 0);
+    ASSERT(dc_sdf_program_intersect(prog) == 0);
+    ASSERT(dc_sdf_program_values(prog) == 2);
+
+    DC_VoxelGrid *aos = dc_voxel_grid_new(sx, sy, sz, cs);
+    DC_VoxelGrid *soa = dc_voxel_grid_new_soa(sx, sy, sz, cs);
+    DC_VoxelGrid *sp = dc_voxel_grid_new_sparse(sx, sy, sz, cs, band);
+    ASSERT(aos && soa && sp);
+    ASSERT(dc_sdf_program_eval(prog, aos) == -1);
+    ASSERT(dc_sdf_program_union(prog) == 0);
+    ASSERT(dc_sdf_program_length(prog) == 9);
+
+    /* Unbanded: every node runs everywhere, bit-identical to the grids */
+    ASSERT(dc_sdf_program_eval(prog, aos) == 0);
+    for (int iz = 0; iz < sz; iz++)
+    for (int iy = 0; iy < sy; iy++)
+    for (int ix = 0; ix < sx; ix++)
+        ASSERT(dc_voxel_grid_distance(aos, ix, iy, iz) ==
+               dc_voxel_grid_distance(expect, ix, iy, iz));
+
+    /* Banded: culled nodes leave every in-band cell exact */
+    ASSERT(dc_voxel_grid_set_band(soa, band) == 0);
+    ASSERT(dc_sdf_program_eval(prog, soa) == 0);
+    ASSERT(dc_sdf_program_eval(prog, sp) == 0);
+    ASSERT(band_matches(soa, expect, band, 0.0f));
+    ASSERT(band_matches(sp, expect, band, 0.0f));
+    /* Tiles that stay far from the surface are never allocated */
+    int tx, ty, tz;
+    dc_voxel_grid_tile_dims(sp, &tx, &ty, &tz);
+    ASSERT(dc_voxel_grid_brick_count(sp) < (size_t)(tx * ty * tz));
+
+    /* Slabs of a taller grid (not tile-aligned) match it in the band */
+    for (int z0 = 0; z0 < sz; z0 += 7) {
+        int n = sz - z0 < 7 ? sz - z0 : 7;
+        DC_VoxelGrid *slab = dc_voxel_grid_new_soa(sx, sy, n, cs);
+        ASSERT(slab && dc_voxel_grid_set_band(slab, band) == 0);
+        ASSERT(dc_sdf_program_eval_slab(prog, slab, z0) == 0);
+        for (int iz = 0; iz < n; iz++)
+        for (int iy = 0; iy < sy; iy++)
+        for (int ix = 0; ix < sx; ix++) {
+            float want = dc_voxel_grid_distance(soa, ix, iy, z0 + iz);
+            if (fabsf(want) <= band)
+                ASSERT(dc_voxel_grid_distance(slab, ix, iy, iz) == want);
+        }
+        dc_voxel_grid_free(slab);
+    }
+
+    /* So do boxes starting on a tile column */
+    int off[3] = { DC_VOXEL_BRICK, 3, 5 }, bn[3] = { 11, 9, sz - 4 };
+    DC_VoxelGrid *box = dc_voxel_grid_new_soa(bn[0], bn[1], bn[2], cs);
+    ASSERT(box && dc_voxel_grid_set_band(box, band) == 0);
+    ASSERT(dc_sdf_program_eval_region(prog, box, off) == 0);
+    int checked = 0;
+    for (int iz = 0; iz < bn[2]; iz++)
+    for (int iy = 0; iy < bn[1]; iy++)
+    for (int ix = 0; ix < bn[0]; ix++) {
+        float want = dc_voxel_grid_distance(soa, off[0] + ix, off[1] + iy,
+                                            off[2] + iz);
+        if (fabsf(want) > band) continue;
+        ASSERT(dc_voxel_grid_distance(box, ix, iy, iz) == want);
+        checked++;
+    }
+    ASSERT(checked > 0);
+    dc_voxel_grid_free(box);
+
+    dc_sdf_program_free(prog);
+    dc_voxel_grid_free(expect);
+    dc_voxel_grid_free(cut);
+    dc_voxel_grid_free(ring);
+    dc_voxel_grid_free(ball);
+    dc_voxel_grid_free(aos);
+    dc_voxel_grid_free(soa);
+    dc_voxel_grid_free(sp);
+    return 0;
+}
+
+/* Unbanded, banded SoA and sparse evaluations of prog agree in the band */
+static int
+program_bands_agree(const DC_SdfProgram *prog, int sx, int sy, int sz,
+                    float cs, float band, DC_VoxelGrid *aos)
+{
+    DC_VoxelGrid *soa = dc_voxel_grid_new_soa(sx, sy, sz, cs);
+    DC_VoxelGrid *sp = dc_voxel_grid_new_sparse(sx, sy, sz, cs, band);
+    ASSERT(soa && sp);
+    ASSERT(dc_voxel_grid_set_band(soa, band) == 0);
+    ASSERT(dc_sdf_program_eval(prog, aos) == 0);
+    ASSERT(dc_sdf_program_eval(prog, soa) == 0);
+    ASSERT(dc_sdf_program_eval(prog, sp) == 0);
+    ASSERT(band_matches(soa, aos, band, 0.0f));
+    ASSERT(band_matches(sp, aos, band, 0.0f));
+    dc_voxel_grid_free(soa);
+    dc_voxel_grid_free(sp);
+    return 0;
+}
+
+static int
+test_sdf_program_blend(void)
+{
+    int sx = 40, sy = 24, sz = 20;
+    float cs = 0.2f, band = 3.0f * cs, k = 2.4f;
+
+    /* ((sphere ~+ sphere) ~- cylinder) rounded, + a shelled box; hard has
+     * a plain union in place of the smooth one */
+    DC_SdfProgram *progs[2] = { dc_sdf_program_new(), dc_sdf_program_new() };
+    for (int h = 0; h < 2; h++) {
+        DC_SdfProgram *prog = progs[h];
+        ASSERT(prog);
+        ASSERT(dc_sdf_program_round(prog, 0.1f) == -1);
+        ASSERT(dc_sdf_program_sphere(prog, 2.1f, 2.5f, 2.1f, 1.0f, NULL) == 0);
+        ASSERT(dc_sdf_program_sphere(prog, 3.7f, 2.5f, 2.1f, 1.0f, NULL) == 0);
+        ASSERT(dc_sdf_program_smooth_union(prog, h ? 0.0f : k) == 0);
+        ASSERT(dc_sdf_program_cylinder(prog, 2.9f, 0.6f, 0.5f, 0.0f, 4.0f, NULL) == 0);
+        ASSERT(dc_sdf_program_smooth_subtract(prog, 0.3f) == 0);
+        ASSERT(dc_sdf_program_round(prog, 0.1f) == 0);
+        ASSERT(dc_sdf_program_box(prog, 5.0f, 1.0f, 1.0f, 7.0f, 3.6f, 3.0f, NULL) == 0);
+        ASSERT(dc_sdf_program_shell(prog, 0.4f) == 0);
+        ASSERT(dc_sdf_program_union(prog) == 0);
+        ASSERT(dc_sdf_program_length(prog) == 9);
+    }
+
+    DC_VoxelGrid *aos = dc_voxel_grid_new(sx, sy, sz, cs);
+    DC_VoxelGrid *ref = dc_voxel_grid_new(sx, sy, sz, cs);
+    ASSERT(aos && ref);
+    ASSERT(program_bands_agree(progs[0], sx, sy, sz, cs, band, aos) == 0);
+    ASSERT(program_bands_agree(progs[1], sx, sy, sz, cs, band, ref) == 0);
+
+    /* The blend only adds material, at most k/4 deep */
+    for (int iz = 0; iz < sz; iz++)
+    for (int iy = 0; iy < sy; iy++)
+    for (int ix = 0; ix < sx; ix++) {
+        float d = dc_voxel_grid_distance(aos, ix, iy, iz);
+        float h = dc_voxel_grid_distance(ref, ix, iy, iz);
+        ASSERT(d <= h + 1e-5f);
+        ASSERT(d >= h - 0.25f * k - 1e-5f);
+    }
+    /* Midway between the spheres, 0.2 inside both: smin = -0.2 - k/4,
+     * then rounded by 0.1 */
+    ASSERT(fabsf(dc_voxel_grid_distance(aos, 14, 12, 10) -
+                 (-0.2f - 0.25f * k - 0.1f)) < 1e-4f);
+    /* The shell is hollow: the box centre lies outside the wall */
+    ASSERT(fabsf(dc_voxel_grid_distance(aos, 30, 11, 9) - (0.9f - 0.2f)) < 1e-4f);
+    ASSERT(dc_voxel_grid_distance(aos, 34, 11, 9) < 0.0f);
+
+    dc_sdf_program_free(progs[0]);
+    dc_sdf_program_free(progs[1]);
+    dc_voxel_grid_free(aos);
+    dc_voxel_grid_free(ref);
+    return 0;
+}
+
+static int
+test_sdf_program_repeat(void)
+{
+    int sx = 60, sy = 50, sz = 12;
+    float cs = 0.1f, band = 3.0f * cs;
+    DC_SdfTransform t;
+    dc_sdf_transform_identity(&t);
+    dc_sdf_transform_translate(&t, 1.5f, 0.8f, 0.0f);
+    dc_sdf_transform_rotate(&t, 0.0f, 0.0f, 1.0f, 20.0f);
+
+    /* 5x4 spheres on the grid axes, 3x3 on a rotated lattice: one
+     * primitive each, against the same copies placed one by one */
+    float period[3] = { 1.0f, 1.0f, 0.0f }, tilted[3] = { 1.2f, 1.1f, 0.0f };
+    int count[3] = { 5, 4, 1 }, three[3] = { 3, 3, 1 };
+    DC_SdfProgram *prog = dc_sdf_program_new();
+    DC_SdfProgram *each = dc_sdf_program_new();
+    ASSERT(prog && each);
+    ASSERT(dc_sdf_program_sphere(prog, 1.0f, 1.0f, 0.6f, 0.3f, NULL) == 0);
+    ASSERT(dc_sdf_program_repeat(prog, period, count, NULL) == 0);
+    ASSERT(dc_sdf_program_sphere(prog, 0.0f, 0.0f, 0.6f, 0.25f, &t) == 0);
+    ASSERT(dc_sdf_program_repeat(prog, tilted, three, &t) == 0);
+    ASSERT(dc_sdf_program_union(prog) == 0);
+    ASSERT(dc_sdf_program_length(prog) == 3);
+
+    for (int j = 0; j < 4; j++)
+    for (int i = 0; i < 5; i++) {
+        ASSERT(dc_sdf_program_sphere(each, 1.0f + (float)i, 1.0f + (float)j,
+                                     0.6f, 0.3f, NULL) == 0);
+        if (i || j) ASSERT(dc_sdf_program_union(each) == 0);
+    }
+    for (int j = 0; j < 3; j++)
+    for (int i = 0; i < 3; i++) {
+        ASSERT(dc_sdf_program_sphere(each, 1.2f * (float)i, 1.1f * (float)j,
+                                     0.6f, 0.25f, &t) == 0);
+        ASSERT(dc_sdf_program_union(each) == 0);
+    }
+
+    DC_VoxelGrid *aos = dc_voxel_grid_new(sx, sy, sz, cs);
+    DC_VoxelGrid *ref = dc_voxel_grid_new(sx, sy, sz, cs);
+    ASSERT(aos && ref);
+    ASSERT(program_bands_agree(prog, sx, sy, sz, cs, band, aos) == 0);
+    ASSERT(dc_sdf_program_eval(each, ref) == 0);
+    ASSERT(band_matches(aos, ref, 1e9f, 1e-4f));
+
+    /* Nested repeats fold like one over both axes */
+    float px[3] = { 1.0f, 0.0f, 0.0f }, py[3] = { 0.0f, 1.0f, 0.0f };
+    int nx[3] = { 5, 1, 1 }, ny[3] = { 1, 4, 1 };
+    DC_SdfProgram *nest = dc_sdf_program_new();
+    ASSERT(nest);
+    ASSERT(dc_sdf_program_sphere(nest, 1.0f, 1.0f, 0.6f, 0.3f, NULL) == 0);
+    ASSERT(dc_sdf_program_repeat(nest, px, nx, NULL) == 0);
+    ASSERT(dc_sdf_program_repeat(nest, py, ny, NULL) == 0);
+    ASSERT(dc_sdf_program_length(nest) == 1);
+    dc_voxel_grid_clear(aos);
+    dc_voxel_grid_clear(ref);
+    dc_sdf_program_free(each);
+    each = dc_sdf_program_new();
+    ASSERT(each);
+    ASSERT(dc_sdf_program_sphere(each, 1.0f, 1.0f, 0.6f, 0.3f, NULL) == 0);
+    ASSERT(dc_sdf_program_repeat(each, period, count, NULL) == 0);
+    ASSERT(dc_sdf_program_eval(nest, aos) == 0);
+    ASSERT(dc_sdf_program_eval(each, ref) == 0);
+    ASSERT(band_matches(aos, ref, 1e9f, 0.0f));
+
+    dc_sdf_program_free(prog);
+    dc_sdf_program_free(each);
+    dc_sdf_program_free(nest);
+    dc_voxel_grid_free(aos);
+    dc_voxel_grid_free(ref);
+    return 0;
+}
+
 static int
 test_fill_sphere(void)
 {
@@ -542,6 +1282,725 @@ test_transform_torus_t(void)
     return 0;
 }
 
+/* ---- STL voxelizer tests ---- */
+
+/* UV sphere as an STL-style triangle soup (12 floats per triangle).
+ * Returns malloc'd data; *out_count receives the triangle count. */
+static float *
+make_sphere_tris(float cx, float cy, float cz, float r,
+                 int rings, int sectors, int *out_count)
+{
+    int n = rings * sectors * 2;
+    float *data = calloc((size_t)n * 12, sizeof(float));
+    if (!data) return NULL;
+
+    int t = 0;
+    for (int i = 0; i < rings; i++) {
+        float p0 = 3.14159265f * (float)i / (float)rings;
+        float p1 = 3.14159265f * (float)(i + 1) / (float)rings;
+        for (int j = 0; j < sectors; j++) {
+            float a0 = 6.28318531f * (float)j / (float)sectors;
+            float a1 = 6.28318531f * (float)(j + 1) / (float)sectors;
+            float q[4][3] = {
+                { sinf(p0)*cosf(a0), sinf(p0)*sinf(a0), cosf(p0) },
+                { sinf(p1)*cosf(a0), sinf(p1)*sinf(a0), cosf(p1) },
+                { sinf(p1)*cosf(a1), sinf(p1)*sinf(a1), cosf(p1) },
+                { sinf(p0)*cosf(a1), sinf(p0)*sinf(a1), cosf(p0) },
+            };
+            int quad[2][3] = { {0, 1, 2}, {0, 2, 3} };
+            for (int k = 0; k < 2; k++) {
+                float *tri = data + t * 12;
+                for (int v = 0; v < 3; v++) {
+                    const float *u = q[quad[k][v]];
+                    tri[3 + v*3 + 0] = cx + r * u[0];
+                    tri[3 + v*3 + 1] = cy + r * u[1];
+                    tri[3 + v*3 + 2] = cz + r * u[2];
+                }
+                t++;
+            }
+        }
+    }
+    *out_count = n;
+    return data;
+}
+
+static int
+test_tri_bvh_matches_brute(void)
+{
+    int n = 0;
+    float *data = make_sphere_tris(1.0f, -2.0f, 0.5f, 3.0f, 12, 24, &n);
+    ASSERT(data != NULL);
+
+    DC_TriBvh *bvh = dc_tri_bvh_build(data, n);
+    ASSERT(bvh != NULL);
+    ASSERT(dc_tri_bvh_node_count(bvh) > 1);
+
+    /* Query points on a lattice through and around the sphere */
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            for (int k = 0; k < 9; k++) {
+                float p[3] = { -4.1f + 1.1f * (float)i,
+                               -7.3f + 1.2f * (float)j,
+                               -4.4f + 1.3f * (float)k };
+                float best = 1e18f;
+                int crossings = 0;
+                for (int t = 0; t < n; t++) {
+                    const float *tri = data + t * 12;
+                    float d = dc_tri_point_dist(p, tri+3, tri+6, tri+9);
+                    if (d < best) best = d;
+                    crossings += dc_tri_ray_x_hit(p, tri+3, tri+6, tri+9);
+                }
+                ASSERT(dc_tri_bvh_closest(bvh, p) == best);
+                ASSERT(dc_tri_bvh_ray_x_crossings(bvh, p) == crossings);
+            }
+        }
+    }
+
+    dc_tri_bvh_free(bvh);
+    free(data);
+    return 0;
+}
+
+static int
+test_voxelize_triangles_bvh_identical(void)
+{
+    int n = 0;
+    float *data = make_sphere_tris(0.0f, 0.0f, 0.0f, 5.0f, 10, 20, &n);
+    ASSERT(data != NULL);
+
+    DC_VoxelizeStlOpts brute = { .accel = DC_VOXELIZE_ACCEL_NONE };
+    DC_VoxelGrid *a = dc_voxelize_triangles_ex(data, n, 24, &brute, NULL);
+    DC_VoxelGrid *b = dc_voxelize_triangles_ex(data, n, 24, NULL, NULL);
+    ASSERT(a != NULL && b != NULL);
+
+    int sx = dc_voxel_grid_size_x(a);
+    int sy = dc_voxel_grid_size_y(a);
+    int sz = dc_voxel_grid_size_z(a);
+    ASSERT(sx == dc_voxel_grid_size_x(b));
+    ASSERT(sy == dc_voxel_grid_size_y(b));
+    ASSERT(sz == dc_voxel_grid_size_z(b));
+
+    for (int iz = 0; iz < sz; iz++)
+        for (int iy = 0; iy < sy; iy++)
+            for (int ix = 0; ix < sx; ix++) {
+                const DC_Voxel *va = dc_voxel_grid_get_const(a, ix, iy, iz);
+                const DC_Voxel *vb = dc_voxel_grid_get_const(b, ix, iy, iz);
+                ASSERT(memcmp(va, vb, sizeof(DC_Voxel)) == 0);
+            }
+
+    /* Sanity: center inside, corner outside */
+    const DC_Voxel *c = dc_voxel_grid_get_const(b, sx / 2, sy / 2, sz / 2);
+    ASSERT(c && c->active == 1 && c->distance < 0.0f);
+    const DC_Voxel *corner = dc_voxel_grid_get_const(b, 0, 0, 0);
+    ASSERT(corner && corner->active == 0 && corner->distance > 0.0f);
+
+    dc_voxel_grid_free(a);
+    dc_voxel_grid_free(b);
+    free(data);
+    return 0;
+}
+
+static int
+test_voxelize_triangles_threads_identical(void)
+{
+    int n = 0;
+    float *data = make_sphere_tris(0.5f, 0.0f, -1.0f, 4.0f, 10, 20, &n);
+    ASSERT(data != NULL);
+
+    DC_VoxelizeStlOpts serial = { .threads = 1 };
+    volatile int done = 0, total = 0;
+    DC_VoxelizeStlOpts par = { .threads = 4,
+                               .progress_done = &done,
+                               .progress_total = &total };
+
+    DC_VoxelGrid *a = dc_voxelize_triangles_ex(data, n, 28, &serial, NULL);
+    DC_VoxelGrid *b = dc_voxelize_triangles_ex(data, n, 28, &par, NULL);
+    ASSERT(a != NULL && b != NULL);
+    ASSERT(total > 1);
+    ASSERT(done == total);
+
+    int sx = dc_voxel_grid_size_x(a);
+    int sy = dc_voxel_grid_size_y(a);
+    int sz = dc_voxel_grid_size_z(a);
+    for (int iz = 0; iz < sz; iz++)
+        for (int iy = 0; iy < sy; iy++)
+            for (int ix = 0; ix < sx; ix++) {
+                const DC_Voxel *va = dc_voxel_grid_get_const(a, ix, iy, iz);
+                const DC_Voxel *vb = dc_voxel_grid_get_const(b, ix, iy, iz);
+                ASSERT(memcmp(va, vb, sizeof(DC_Voxel)) == 0);
+            }
+
+    dc_voxel_grid_free(a);
+    dc_voxel_grid_free(b);
+    free(data);
+    return 0;
+}
+
+/* Pool job: count each item once; item 0 of the outer job runs a
+ * nested job to check callers inside a worker make progress. */
+typedef struct {
+    atomic_int   hits[64];
+    atomic_int   nested;
+    int          cancel_at;
+    volatile int cancel;
+} PoolTestCtx;
+
+static void
+pool_nested_item(void *data, int item)
+{
+    PoolTestCtx *c = data;
+    (void)item;
+    atomic_fetch_add(&c->nested, 1);
+}
+
+static void
+pool_test_item(void *data, int item)
+{
+    PoolTestCtx *c = data;
+    atomic_fetch_add(&c->hits[item], 1);
+    if (item == 0)
+        dc_voxel_pool_run(pool_nested_item, c, 16, 0, NULL);
+    if (c->cancel_at >= 0 && item == c->cancel_at)
+        c->cancel = 1;
+}
+
+static int
+test_voxel_pool_run(void)
+{
+    ASSERT(dc_voxel_pool_threads() >= 1);
+
+    PoolTestCtx c = { .cancel_at = -1 };
+    ASSERT(dc_voxel_pool_run(pool_test_item, &c, 64, 0, NULL) == 0);
+    for (int i = 0; i < 64; i++)
+        ASSERT(c.hits[i] == 1);
+    ASSERT(c.nested == 16);
+
+    /* Serial: claims items in order, so cancelling at 10 stops at 10 */
+    PoolTestCtx s = { .cancel_at = 10 };
+    ASSERT(dc_voxel_pool_run(pool_test_item, &s, 64, 1, &s.cancel) == 1);
+    for (int i = 0; i < 64; i++)
+        ASSERT(s.hits[i] == (i <= 10));
+
+    /* Nothing to do */
+    ASSERT(dc_voxel_pool_run(pool_test_item, &c, 0, 0, NULL) == 0);
+    return 0;
+}
+
+static int
+test_tri_bvh_winding_number(void)
+{
+    int n = 0;
+    float *data = make_sphere_tris(1.0f, -2.0f, 0.5f, 3.0f, 12, 24, &n);
+    ASSERT(data != NULL);
+
+    DC_TriBvh *bvh = dc_tri_bvh_build(data, n);
+    ASSERT(bvh != NULL);
+
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            for (int k = 0; k < 9; k++) {
+                float p[3] = { -4.1f + 1.1f * (float)i,
+                               -7.3f + 1.2f * (float)j,
+                               -4.4f + 1.3f * (float)k };
+                double omega = 0.0;
+                for (int t = 0; t < n; t++) {
+                    const float *tri = data + t * 12;
+                    omega += dc_tri_solid_angle(p, tri+3, tri+6, tri+9);
+                }
+                float exact = (float)(omega / (4.0 * 3.14159265358979));
+                float approx = dc_tri_bvh_winding_number(bvh, p, 0.0f);
+                ASSERT(fabsf(approx - exact) < 0.02f);
+
+                /* Closed mesh: +-1 inside, 0 outside */
+                float dx = p[0] - 1.0f, dy = p[1] + 2.0f, dz = p[2] - 0.5f;
+                float r = sqrtf(dx*dx + dy*dy + dz*dz);
+                if (r < 2.5f) ASSERT(fabsf(fabsf(exact) - 1.0f) < 1e-3f);
+                if (r > 3.5f) ASSERT(fabsf(exact) < 1e-3f);
+            }
+        }
+    }
+
+    dc_tri_bvh_free(bvh);
+    free(data);
+    return 0;
+}
+
+static int
+test_voxelize_triangles_winding_holes(void)
+{
+    int n = 0;
+    float *data = make_sphere_tris(0.0f, 0.0f, 0.0f, 5.0f, 10, 20, &n);
+    ASSERT(data != NULL);
+
+    /* Punch a hole at the +X equator: drop the two quads (four triangles)
+     * straddling the equator in sector 0. Rays cast in +X from inside the
+     * sphere near the axis then escape through it. */
+    int kept = 0;
+    for (int t = 0; t < n; t++) {
+        int quad = t / 2;
+        int ring = quad / 20, sector = quad % 20;
+        if ((ring == 4 || ring == 5) && sector == 0) continue;
+        memmove(data + kept * 12, data + t * 12, 12 * sizeof(float));
+        kept++;
+    }
+    ASSERT(kept == n - 4);
+
+    DC_VoxelizeStlOpts parity = {0};
+    DC_VoxelizeStlOpts winding = { .sign = DC_VOXELIZE_SIGN_WINDING };
+    DC_VoxelizeStlOpts exact = { .sign = DC_VOXELIZE_SIGN_WINDING,
+                                 .accel = DC_VOXELIZE_ACCEL_NONE };
+    DC_VoxelGrid *gp = dc_voxelize_triangles_ex(data, kept, 24, &parity, NULL);
+    DC_VoxelGrid *gw = dc_voxelize_triangles_ex(data, kept, 24, &winding, NULL);
+    DC_VoxelGrid *ge = dc_voxelize_triangles_ex(data, kept, 24, &exact, NULL);
+    ASSERT(gp != NULL && gw != NULL && ge != NULL);
+
+    /* The voxelizer centres the padded bbox on the grid; reconstruct the
+     * world position of each voxel from the same rules. */
+    float cs = dc_voxel_grid_cell_size(gw);
+    float bmin = -5.0f - 10.0f * 0.05f;
+    int sx = dc_voxel_grid_size_x(gw);
+    int sy = dc_voxel_grid_size_y(gw);
+    int sz = dc_voxel_grid_size_z(gw);
+
+    int parity_wrong = 0, winding_wrong = 0, disagree = 0;
+    for (int iz = 0; iz < sz; iz++)
+        for (int iy = 0; iy < sy; iy++)
+            for (int ix = 0; ix < sx; ix++) {
+                float x = bmin + ((float)ix + 0.5f) * cs;
+                float y = bmin + ((float)iy + 0.5f) * cs;
+                float z = bmin + ((float)iz + 0.5f) * cs;
+                float r = sqrtf(x*x + y*y + z*z);
+                const DC_Voxel *vp = dc_voxel_grid_get_const(gp, ix, iy, iz);
+                const DC_Voxel *vw = dc_voxel_grid_get_const(gw, ix, iy, iz);
+                const DC_Voxel *ve = dc_voxel_grid_get_const(ge, ix, iy, iz);
+                if (vw->active != ve->active) disagree++;
+
+                /* Only judge voxels well clear of the surface */
+                int want;
+                if (r < 5.0f - 2.0f * cs) want = 1;
+                else if (r > 5.0f + 2.0f * cs) want = 0;
+                else continue;
+                if (vp->active != want) parity_wrong++;
+                if (vw->active != want) winding_wrong++;
+            }
+
+    ASSERT(parity_wrong > 0);   /* the hole really does break parity */
+    ASSERT(winding_wrong == 0);
+    ASSERT(disagree <= sx);     /* approximation only moves the 0.5 level */
+
+    dc_voxel_grid_free(gp);
+    dc_voxel_grid_free(gw);
+    dc_voxel_grid_free(ge);
+    free(data);
+    return 0;
+}
+
+static int
+test_sdf_sweep_point_source(void)
+{
+    /* Freeze the 8 cells around a point; the sweep should rebuild the
+     * Euclidean distance to it everywhere else. */
+    DC_VoxelGrid *g = dc_voxel_grid_new(24, 24, 24, 1.0f);
+    ASSERT(g != NULL);
+    uint8_t *mask = calloc(24 * 24 * 24, 1);
+    ASSERT(mask != NULL);
+
+    float c = 12.0f; /* a cell corner: centres sit at i + 0.5 */
+    for (int iz = 11; iz <= 12; iz++)
+        for (int iy = 11; iy <= 12; iy++)
+            for (int ix = 11; ix <= 12; ix++) {
+                DC_Voxel *v = dc_voxel_grid_get(g, ix, iy, iz);
+                v->distance = sqrtf(3.0f) * 0.5f;
+                mask[ix + iy * 24 + iz * 576] = DC_SDF_FROZEN;
+            }
+
+    int rounds = dc_sdf_sweep(g, mask, 0);
+    ASSERT(rounds >= 1);
+
+    float max_err = 0.0f;
+    for (int iz = 0; iz < 24; iz++)
+        for (int iy = 0; iy < 24; iy++)
+            for (int ix = 0; ix < 24; ix++) {
+                float dx = ix + 0.5f - c, dy = iy + 0.5f - c, dz = iz + 0.5f - c;
+                float want = sqrtf(dx*dx + dy*dy + dz*dz);
+                const DC_Voxel *v = dc_voxel_grid_get_const(g, ix, iy, iz);
+                ASSERT(v->distance >= 0.0f);
+                float e = fabsf(v->distance - want);
+                if (e > max_err) max_err = e;
+            }
+    /* First-order scheme: error grows slowly (~log r) with distance */
+    ASSERT(max_err < 1.5f);
+
+    free(mask);
+    dc_voxel_grid_free(g);
+    return 0;
+}
+
+static int
+test_sdf_sign_fill_components(void)
+{
+    /* A frozen shell (inside-negative) splits the grid into an interior
+     * and exterior region; both should be signed from it. */
+    DC_VoxelGrid *g = dc_voxel_grid_new(16, 16, 16, 1.0f);
+    ASSERT(g != NULL);
+    uint8_t *mask = calloc(16 * 16 * 16, 1);
+    ASSERT(mask != NULL);
+
+    for (int iz = 0; iz < 16; iz++)
+        for (int iy = 0; iy < 16; iy++)
+            for (int ix = 0; ix < 16; ix++) {
+                int m = abs(ix - 8);
+                if (abs(iy - 8) > m) m = abs(iy - 8);
+                if (abs(iz - 8) > m) m = abs(iz - 8);
+                if (m != 4 && m != 5) continue;
+                DC_Voxel *v = dc_voxel_grid_get(g, ix, iy, iz);
+                v->distance = m == 4 ? -0.5f : 0.5f;
+                mask[ix + iy * 16 + iz * 256] = DC_SDF_FROZEN;
+            }
+
+    ASSERT(dc_sdf_sweep(g, mask, 0) >= 1);
+    ASSERT(dc_sdf_sign_fill(g, mask) == 0);
+    ASSERT(dc_voxel_grid_get_const(g, 8, 8, 8)->distance < -2.0f);
+    ASSERT(dc_voxel_grid_get_const(g, 0, 0, 0)->distance > 2.0f);
+    ASSERT(mask[8 + 8 * 16 + 8 * 256] == DC_SDF_FAR);
+
+    /* Knock a hole through both layers: interior and exterior merge and
+     * border both signs, so the region is left for per-cell signing. */
+    for (int ix = 12; ix <= 13; ix++) {
+        mask[ix + 8 * 16 + 8 * 256] = DC_SDF_FAR;
+        dc_voxel_grid_get(g, ix, 8, 8)->distance = 0.5f;
+    }
+    long n = dc_sdf_sign_fill(g, mask);
+    ASSERT(n > 0);
+    ASSERT(mask[8 + 8 * 16 + 8 * 256] == DC_SDF_UNSIGNED);
+    ASSERT(mask[0] == DC_SDF_UNSIGNED);
+
+    free(mask);
+    dc_voxel_grid_free(g);
+    return 0;
+}
+
+static int
+test_voxelize_triangles_band_matches_exact(void)
+{
+    int n = 0;
+    float *data = make_sphere_tris(0.0f, 0.0f, 0.0f, 5.0f, 16, 32, &n);
+    ASSERT(data != NULL);
+
+    DC_VoxelizeStlOpts exact = { .band_cells = -1 };
+    DC_VoxelGrid *a = dc_voxelize_triangles_ex(data, n, 40, &exact, NULL);
+    DC_VoxelGrid *b = dc_voxelize_triangles_ex(data, n, 40, NULL, NULL);
+    ASSERT(a != NULL && b != NULL);
+
+    float cs = dc_voxel_grid_cell_size(a);
+    int sx = dc_voxel_grid_size_x(a);
+    int sy = dc_voxel_grid_size_y(a);
+    int sz = dc_voxel_grid_size_z(a);
+    for (int iz = 0; iz < sz; iz++)
+        for (int iy = 0; iy < sy; iy++)
+            for (int ix = 0; ix < sx; ix++) {
+                const DC_Voxel *va = dc_voxel_grid_get_const(a, ix, iy, iz);
+                const DC_Voxel *vb = dc_voxel_grid_get_const(b, ix, iy, iz);
+                ASSERT(va->active == vb->active);
+                if (fabsf(va->distance) <= DC_SDF_BAND_CELLS * cs)
+                    ASSERT(va->distance == vb->distance);
+                else /* first order; worst where fronts meet at the centre */
+                    ASSERT(fabsf(va->distance - vb->distance) < 1.5f * cs);
+            }
+
+    dc_voxel_grid_free(a);
+    dc_voxel_grid_free(b);
+    free(data);
+    return 0;
+}
+
+/* Cache files: f32 maps bit-exact, quantized encodings stay within
+ * their error bound, stale hashes and broken files are rejected. */
+static int
+test_voxel_cache(void)
+{
+    const char *path = "/tmp/test_voxel_cache.dcvox";
+    int sx = 20, sy = 18, sz = 22;
+    float cs = 0.5f, band = 3 * cs;
+    size_t n = (size_t)sx * sy * sz;
+    DC_VoxelGrid *g = dc_voxel_grid_new_soa(sx, sy, sz, cs);
+    ASSERT(g);
+    dc_voxel_grid_set_band(g, band);
+    dc_voxel_grid_set_origin(g, -3.0f, 1.5f, 7.25f);
+    dc_sdf_sphere(g, 5.0f, 4.5f, 5.5f, 3.2f);
+    dc_sdf_clamp(g, band);
+    dc_sdf_activate(g);
+    dc_sdf_color_by_normal(g);
+    const float *d0 = dc_voxel_grid_distances_const(g);
+
+    uint64_t hash = dc_voxel_cache_hash("sphere(3.2);", 12);
+    ASSERT(hash != 0 && hash != dc_voxel_cache_hash("sphere(3.3);", 12));
+    DC_Error err = {0};
+    ASSERT(dc_voxel_cache_save(g, path, hash, NULL, &err) == 0);
+
+    DC_VoxelCacheInfo info;
+    ASSERT(dc_voxel_cache_info(path, &info) == 0);
+    ASSERT(info.size[0] == sx && info.size[1] == sy && info.size[2] == sz);
+    ASSERT(info.source_hash == hash && info.band == band);
+    ASSERT(info.has_active && info.has_color);
+
+    DC_VoxelGrid *m = dc_voxel_cache_load(path, hash, &err);
+    ASSERT(m && dc_voxel_grid_is_wrapped(m) && dc_voxel_grid_is_soa(m));
+    float ox, oy, oz;
+    dc_voxel_grid_get_origin(m, &ox, &oy, &oz);
+    ASSERT(ox == -3.0f && oy == 1.5f && oz == 7.25f);
+    ASSERT(dc_voxel_grid_band(m) == band);
+    ASSERT(memcmp(dc_voxel_grid_distances_const(m), d0, n * 4) == 0);
+    ASSERT(memcmp(dc_voxel_grid_active_plane_const(m),
+                  dc_voxel_grid_active_plane_const(g), n) == 0);
+    ASSERT(memcmp(dc_voxel_grid_color_plane_const(m),
+                  dc_voxel_grid_color_plane_const(g), n * 3) == 0);
+
+    /* Edits stay private to the mapping */
+    dc_voxel_grid_distances(m)[0] = -42.0f;
+    dc_voxel_grid_clear(m);
+    dc_voxel_grid_free(m);
+    m = dc_voxel_cache_load(path, 0, NULL);
+    ASSERT(m && dc_voxel_grid_distances_const(m)[0] == d0[0]);
+    dc_voxel_grid_free(m);
+
+    err.code = DC_OK;
+    ASSERT(!dc_voxel_cache_load(path, hash + 1, &err));
+    ASSERT(err.code == DC_ERROR_NOT_FOUND);
+
+    /* float16 keeps 11 significant bits; int8 steps band/127 and
+     * saturates at the band with the right sign */
+    DC_VoxelCacheOpts opts = { .encoding = DC_VOXEL_DIST_F16 };
+    ASSERT(dc_voxel_cache_save(g, path, hash, &opts, NULL) == 0);
+    m = dc_voxel_cache_load(path, hash, NULL);
+    ASSERT(m && dc_voxel_grid_dist_format(m) == DC_VOXEL_DIST_F16);
+    for (size_t i = 0; i < n; i++) {
+        float d = dc_voxel_grid_distance(m, (int)(i % sx),
+                                         (int)(i / sx % sy), (int)(i / sx / sy));
+        ASSERT(fabsf(d - d0[i]) <= fabsf(d0[i]) * (1.0f / 2048.0f));
+    }
+    ASSERT(memcmp(dc_voxel_grid_active_plane_const(m),
+                  dc_voxel_grid_active_plane_const(g), n) == 0);
+    dc_voxel_grid_free(m);
+
+    opts.encoding = DC_VOXEL_DIST_I8;
+    opts.no_color = 1;
+    ASSERT(dc_voxel_cache_save(g, path, hash, &opts, NULL) == 0);
+    m = dc_voxel_cache_load(path, hash, NULL);
+    ASSERT(m && dc_voxel_grid_dist_format(m) == DC_VOXEL_DIST_I8);
+    ASSERT(!dc_voxel_grid_color_plane_const(m));
+    for (size_t i = 0; i < n; i++) {
+        float d = dc_voxel_grid_distance(m, (int)(i % sx),
+                                         (int)(i / sx % sy), (int)(i / sx / sy));
+        ASSERT(fabsf(d - d0[i]) <= band / 254.0f * 1.001f);
+        ASSERT((d < 0) == (d0[i] < 0));
+    }
+    dc_voxel_grid_free(m);
+
+    /* int8 needs a band to normalize to; sparse grids load as SoA */
+    DC_VoxelGrid *sp = dc_voxel_grid_new_sparse(sx, sy, sz, cs, band);
+    DC_VoxelGrid *aos = dc_voxel_grid_new(sx, sy, sz, cs);
+    ASSERT(sp && aos);
+    ASSERT(dc_voxel_cache_save(aos, path, 0, &opts, NULL) == -1);
+    dc_sdf_sphere(sp, 5.0f, 4.5f, 5.5f, 3.2f);
+    dc_sdf_activate(sp);
+    ASSERT(dc_voxel_cache_save(sp, path, 0, NULL, NULL) == 0);
+    m = dc_voxel_cache_load(path, 0, NULL);
+    ASSERT(m && dc_voxel_grid_is_soa(m));
+    for (int iz = 0; iz < sz; iz++)
+        for (int iy = 0; iy < sy; iy++)
+            for (int ix = 0; ix < sx; ix++) {
+                DC_Voxel a, b;
+                dc_voxel_grid_load(sp, ix, iy, iz, &a);
+                dc_voxel_grid_load(m, ix, iy, iz, &b);
+                ASSERT(a.distance == b.distance && a.active == b.active);
+            }
+    dc_voxel_grid_free(m);
+
+    /* A truncated file is not a cache */
+    char head[1000];
+    FILE *fp = fopen(path, "rb");
+    ASSERT(fp && fread(head, 1, sizeof(head), fp) == sizeof(head));
+    fclose(fp);
+    fp = fopen(path, "wb");
+    ASSERT(fp && fwrite(head, 1, sizeof(head), fp) == sizeof(head));
+    fclose(fp);
+    err.code = DC_OK;
+    ASSERT(!dc_voxel_cache_load(path, 0, &err) && err.code == DC_ERROR_IO);
+    ASSERT(dc_voxel_cache_info(path, &info) == -1);
+
+    /* Nor is one whose cell count wraps: 2^30 x 16 x 2^30 cells is 2^64,
+     * 0 in 64 bits, in a (sparse) 16 GiB file. size[] is at byte 16 of
+     * the header, file_bytes at byte 88. */
+    ASSERT(dc_voxel_cache_save(g, path, hash, NULL, NULL) == 0);
+    int fd = open(path, O_RDWR);
+    ASSERT(fd >= 0);
+    int32_t size[3] = { 1 << 30, 16, 1 << 30 };
+    uint64_t file_bytes = (uint64_t)1 << 34;
+    ASSERT(pwrite(fd, size, sizeof(size), 16) == (ssize_t)sizeof(size));
+    ASSERT(pwrite(fd, &file_bytes, 8, 88) == 8);
+    int sparse = ftruncate(fd, (off_t)file_bytes) == 0;
+    close(fd);
+    if (sparse) {
+        err.code = DC_OK;
+        ASSERT(!dc_voxel_cache_load(path, 0, &err) && err.code == DC_ERROR_IO);
+        ASSERT(dc_voxel_cache_info(path, &info) == -1);
+    }
+
+    remove(path);
+    dc_voxel_grid_free(sp);
+    dc_voxel_grid_free(aos);
+    dc_voxel_grid_free(g);
+    return 0;
+}
+
+/* Eviction trims a cache dir oldest-first to its byte cap; a load counts
+ * as a use, the kept file survives, foreign files are left alone. */
+static int
+test_voxel_cache_evict(void)
+{
+    char dir[] = "/tmp/test_voxel_evict.XXXXXX";
+    ASSERT(mkdtemp(dir));
+    DC_VoxelGrid *g = dc_voxel_grid_new_soa(16, 16, 16, 0.5f);
+    ASSERT(g);
+    dc_sdf_sphere(g, 4.0f, 4.0f, 4.0f, 2.5f);
+
+    char path[4][96];
+    struct stat st;
+    for (int i = 0; i < 4; i++) {
+        snprintf(path[i], sizeof(path[i]), "%s/%d" DC_VOXEL_CACHE_EXT, dir, i);
+        ASSERT(dc_voxel_cache_save(g, path[i], (uint64_t)i + 1, NULL, NULL) == 0);
+        /* File i was last used i*100 s after the epoch */
+        struct timespec t[2] = { { (time_t)i * 100, 0 }, { (time_t)i * 100, 0 } };
+        ASSERT(utimensat(AT_FDCWD, path[i], t, 0) == 0);
+    }
+    ASSERT(stat(path[0], &st) == 0);
+    uint64_t one = (uint64_t)st.st_size;
+
+    char other[96];
+    snprintf(other, sizeof(other), "%s/notes.txt", dir);
+    FILE *fp = fopen(other, "wb");
+    ASSERT(fp);
+    fclose(fp);
+
+    /* Loading file 0 makes it the newest */
+    DC_VoxelGrid *m = dc_voxel_cache_load(path[0], 1, NULL);
+    ASSERT(m);
+
+    /* Room for two: 1 and 2 are the least recently used */
+    ASSERT(dc_voxel_cache_evict(dir, 2 * one, NULL) == 2);
+    ASSERT(stat(path[0], &st) == 0);
+    ASSERT(stat(path[1], &st) != 0);
+    ASSERT(stat(path[2], &st) != 0);
+    ASSERT(stat(path[3], &st) == 0);
+    ASSERT(stat(other, &st) == 0);
+    /* The mapped grid outlives its file */
+    ASSERT(fabsf(dc_voxel_grid_distance(m, 8, 8, 8) -
+                 dc_voxel_grid_distance(g, 8, 8, 8)) < 1e-6f);
+
+    /* keep is never removed, even when over the cap */
+    ASSERT(dc_voxel_cache_evict(dir, 0, path[3]) == 1);
+    ASSERT(stat(path[3], &st) == 0);
+    ASSERT(stat(path[0], &st) != 0);
+    ASSERT(dc_voxel_cache_evict(dir, 0, NULL) == 1);
+    ASSERT(dc_voxel_cache_evict("/nonexistent/dcvox", 0, NULL) == -1);
+
+    dc_voxel_grid_free(m);
+    dc_voxel_grid_free(g);
+    remove(other);
+    ASSERT(rmdir(dir) == 0);
+    return 0;
+}
+
+static int
+test_voxel_quantize(void)
+{
+    int sx = 16, sy = 14, sz = 18;
+    float cs = 0.5f, band = 3 * cs;
+    size_t n = (size_t)sx * sy * sz;
+    DC_VoxelGrid *g = dc_voxel_grid_new_soa(sx, sy, sz, cs);
+    ASSERT(g);
+    dc_voxel_grid_set_band(g, band);
+    dc_sdf_sphere(g, 4.0f, 3.5f, 4.5f, 2.6f);
+    dc_sdf_clamp(g, band);
+    dc_sdf_activate(g);
+    size_t active = dc_voxel_grid_active_count(g);
+    size_t bytes = dc_voxel_grid_memory_bytes(g);
+    float *d0 = malloc(n * sizeof(float));
+    ASSERT(d0);
+    memcpy(d0, dc_voxel_grid_distances_const(g), n * sizeof(float));
+
+    /* float16: relative error 2^-11, half the distance bytes */
+    DC_VoxelGrid *h = dc_voxel_grid_copy(g);
+    ASSERT(h && dc_voxel_grid_quantize(h, DC_VOXEL_DIST_F16) == 0);
+    ASSERT(dc_voxel_grid_dist_format(h) == DC_VOXEL_DIST_F16);
+    ASSERT(!dc_voxel_grid_distances_const(h));
+    ASSERT(dc_voxel_grid_memory_bytes(h) == bytes - n * 2);
+    float range = -1.0f;
+    ASSERT(dc_voxel_grid_dist_plane(h, &range) && range == 0.0f);
+    for (size_t i = 0; i < n; i++) {
+        float d = dc_voxel_grid_distance(h, (int)(i % sx),
+                                         (int)(i / sx % sy), (int)(i / sx / sy));
+        ASSERT(fabsf(d - d0[i]) <= fabsf(d0[i]) * (1.0f / 2048.0f));
+    }
+
+    /* int8: absolute error band/254, signs kept, a quarter of the bytes */
+    DC_VoxelGrid *q = dc_voxel_grid_copy(g);
+    ASSERT(q && dc_voxel_grid_quantize(q, DC_VOXEL_DIST_I8) == 0);
+    ASSERT(dc_voxel_grid_memory_bytes(q) == bytes - n * 3);
+    ASSERT(dc_voxel_grid_dist_plane(q, &range) && range == band);
+    for (size_t i = 0; i < n; i++) {
+        float d = dc_voxel_grid_distance(q, (int)(i % sx),
+                                         (int)(i / sx % sy), (int)(i / sx / sy));
+        ASSERT(fabsf(d - d0[i]) <= band / 254.0f * 1.001f);
+        ASSERT((d < 0) == (d0[i] < 0));
+    }
+
+    /* Copies stay quantized; activation works on encoded distances */
+    DC_VoxelGrid *c = dc_voxel_grid_copy(q);
+    ASSERT(c && dc_voxel_grid_dist_format(c) == DC_VOXEL_DIST_I8);
+    ASSERT(memcmp(dc_voxel_grid_dist_plane(c, NULL),
+                  dc_voxel_grid_dist_plane(q, NULL), n) == 0);
+    memset(dc_voxel_grid_active_plane(c), 0, n);
+    ASSERT(dc_voxel_grid_active_count(c) == 0);
+    dc_sdf_activate(c);
+    ASSERT(dc_voxel_grid_active_count(c) == active);
+    ASSERT(dc_voxel_grid_dist_format(c) == DC_VOXEL_DIST_I8);
+
+    /* The first write decodes back to float32 */
+    *dc_voxel_grid_distance_ref(q, 0, 0, 0) = -0.25f;
+    ASSERT(dc_voxel_grid_dist_format(q) == DC_VOXEL_DIST_F32);
+    ASSERT(dc_voxel_grid_memory_bytes(q) == bytes);
+    ASSERT(dc_voxel_grid_distance(q, 0, 0, 0) == -0.25f);
+    ASSERT(fabsf(dc_voxel_grid_distance(q, 5, 6, 7) - d0[5 + sx * (6 + sy * 7)])
+           <= band / 254.0f * 1.001f);
+    ASSERT(dc_voxel_grid_quantize(h, DC_VOXEL_DIST_F32) == 0);
+    ASSERT(dc_voxel_grid_distances_const(h));
+
+    /* int8 needs a band; AoS grids have no plane to pack */
+    DC_VoxelGrid *nb = dc_voxel_grid_new_soa(sx, sy, sz, cs);
+    DC_VoxelGrid *aos = dc_voxel_grid_new(sx, sy, sz, cs);
+    ASSERT(nb && aos);
+    ASSERT(dc_voxel_grid_quantize(nb, DC_VOXEL_DIST_I8) == -1);
+    ASSERT(dc_voxel_grid_quantize(nb, DC_VOXEL_DIST_F16) == 0);
+    ASSERT(dc_voxel_grid_quantize(aos, DC_VOXEL_DIST_F16) == -1);
+
+    /* Codec edge cases */
+    ASSERT(dc_voxel_half_to_float(dc_voxel_half_from_float(1e30f)) == INFINITY);
+    ASSERT(dc_voxel_half_to_float(dc_voxel_half_from_float(-2.5f)) == -2.5f);
+    ASSERT(dc_voxel_i8_from_float(1e30f, band) == 127);
+    ASSERT(dc_voxel_i8_from_float(-1e30f, band) == -127);
+
+    free(d0);
+    dc_voxel_grid_free(nb);
+    dc_voxel_grid_free(aos);
+    dc_voxel_grid_free(c);
+    dc_voxel_grid_free(q);
+    dc_voxel_grid_free(h);
+    dc_voxel_grid_free(g);
+    return 0;
+}
+
 /* ---- main ---- */
 int
 main(void)
@@ -552,6 +2011,20 @@ main(void)
     RUN_TEST(test_grid_set_get);
     RUN_TEST(test_grid_bounds);
     RUN_TEST(test_coord_conversion);
+    RUN_TEST(test_grid_copy_sample);
+    RUN_TEST(test_sparse_tiles);
+    RUN_TEST(test_sparse_matches_dense);
+    RUN_TEST(test_soa_planes);
+    RUN_TEST(test_soa_matches_aos);
+    RUN_TEST(test_voxel_cache);
+    RUN_TEST(test_voxel_cache_evict);
+    RUN_TEST(test_voxel_quantize);
+    RUN_TEST(test_sdf_simd_levels);
+    RUN_TEST(test_sdf_bounded_band);
+    RUN_TEST(test_sdf_offset_csg);
+    RUN_TEST(test_sdf_program);
+    RUN_TEST(test_sdf_program_blend);
+    RUN_TEST(test_sdf_program_repeat);
     RUN_TEST(test_fill_sphere);
     RUN_TEST(test_fill_box);
     RUN_TEST(test_sdf_sphere);
@@ -571,6 +2044,17 @@ main(void)
     RUN_TEST(test_transform_cylinder_t);
     RUN_TEST(test_transform_torus_t);
 
+    /* STL voxelizer */
+    RUN_TEST(test_tri_bvh_matches_brute);
+    RUN_TEST(test_voxelize_triangles_bvh_identical);
+    RUN_TEST(test_voxel_pool_run);
+    RUN_TEST(test_voxelize_triangles_threads_identical);
+    RUN_TEST(test_tri_bvh_winding_number);
+    RUN_TEST(test_voxelize_triangles_winding_holes);
+    RUN_TEST(test_sdf_sweep_point_source);
+    RUN_TEST(test_sdf_sign_fill_components);
+    RUN_TEST(test_voxelize_triangles_band_matches_exact);
+
     fprintf(stderr, "=== %d passed, %d failed ===\n", g_pass, g_fail);
     return g_fail > 0 ? 1 : 0;
 }
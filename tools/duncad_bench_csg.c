@@ -0,0 +1,170 @@
+#define _POSIX_C_SOURCE 200809L
+/*
+ * duncad_bench_csg.c — Benchmark multi-tool difference() strategies.
+ *
+ * Interprets the same .scad twice with the Trinity Site evaluator: once
+ * subtracting difference() tools one at a time, once subtracting their
+ * pairwise-reduced union in a single boolean. Reports wall time and
+ * triangle count for each and checks that the two solids have the same
+ * volume.
+ *
+ * Then compares BSP splitter selection (first polygon vs SAH) on a
+ * tessellated rod with a cross hole: tree depth, nodes, polygon splits.
+ *
+ * Usage:
+ *   duncad-bench-csg [file.scad] [threads]
+ *
+ * Without a file, tests/data/perforated_plate.scad is used.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ts_eval.h"
+
+static double
+now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
+
+/* Signed volume via the divergence theorem. */
+static double
+mesh_volume(const ts_mesh *m)
+{
+    double vol = 0.0;
+    for (int i = 0; i < m->tri_count; i++) {
+        const double *a = m->verts[m->tris[i].idx[0]].pos;
+        const double *b = m->verts[m->tris[i].idx[1]].pos;
+        const double *c = m->verts[m->tris[i].idx[2]].pos;
+        vol += a[0] * (b[1]*c[2] - b[2]*c[1])
+             + a[1] * (b[2]*c[0] - b[0]*c[2])
+             + a[2] * (b[0]*c[1] - b[1]*c[0]);
+    }
+    return vol / 6.0;
+}
+
+static char *
+read_file(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *buf = size >= 0 ? malloc((size_t)size + 1) : NULL;
+    if (buf) buf[fread(buf, 1, (size_t)size, fp)] = '\0';
+    fclose(fp);
+    return buf;
+}
+
+static int
+run(const char *label, const char *src, const char *base_dir, int threads,
+    int sequential, double *out_vol)
+{
+    ts_interpret_opts opts = {0};
+    opts.base_dir = base_dir;
+    opts.threads = threads;
+    opts.sequential_difference = sequential;
+    ts_parse_error err = {0};
+
+    double t0 = now_ms();
+    ts_mesh m = ts_interpret_ex(src, &err, &opts);
+    double ms = now_ms() - t0;
+
+    if (err.msg[0]) {
+        fprintf(stderr, "%s: parse error at line %d: %s\n",
+                label, err.line, err.msg);
+        return -1;
+    }
+    *out_vol = mesh_volume(&m);
+    printf("  %-12s %10.1f ms  (%d triangles, volume %.4f)\n",
+           label, ms, m.tri_count, *out_vol);
+    ts_mesh_free(&m);
+    return 0;
+}
+
+static int
+run_splitter(const char *label, ts_csg_split_t splitter, int fn, double *out_vol)
+{
+    ts_mesh a = ts_mesh_init(), b = ts_mesh_init(), out = ts_mesh_init();
+    ts_gen_cylinder(40.0, 10.0, 10.0, fn, &a);
+    for (int i = 0; i < a.vert_count; i++) a.verts[i].pos[2] -= 20.0;
+    /* Cross hole along x: rotate (x,y,z) -> (y,z,x), keeps the winding */
+    ts_gen_cylinder(30.0, 4.0, 4.0, fn, &b);
+    for (int i = 0; i < b.vert_count; i++) {
+        double *p = b.verts[i].pos;
+        double x = p[0], y = p[1], z = p[2] - 15.0;
+        p[0] = y; p[1] = z; p[2] = x;
+    }
+
+    ts_csg_bsp_stats st;
+    double t0 = now_ms();
+    int rc = ts_csg_boolean_ex(&a, &b, TS_CSG_OP_DIFFERENCE, &out, splitter, &st);
+    double ms = now_ms() - t0;
+
+    *out_vol = mesh_volume(&out);
+    printf("  %-12s %10.1f ms  depth %5d  nodes %7d  splits %6ld + %7ld clip"
+           "  (%d triangles)\n", label, ms, st.max_depth, st.nodes, st.splits,
+           st.clip_splits, out.tri_count);
+    ts_mesh_free(&a);
+    ts_mesh_free(&b);
+    ts_mesh_free(&out);
+    return rc == TS_CSG_OK ? 0 : -1;
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *path = DC_TEST_DATA_DIR "/perforated_plate.scad";
+    int threads = 0;
+
+    if (argc > 1 && strcmp(argv[1], "--help") == 0) {
+        fprintf(stderr, "Usage: duncad-bench-csg [file.scad] [threads]\n");
+        return 0;
+    }
+    if (argc > 1) path = argv[1];
+    if (argc > 2) threads = atoi(argv[2]);
+
+    char *src = read_file(path);
+    if (!src) {
+        fprintf(stderr, "cannot read %s\n", path);
+        return 1;
+    }
+    char *dir = strdup(path);
+    char *slash = dir ? strrchr(dir, '/') : NULL;
+    if (slash) *slash = '\0';
+    printf("%s, %d thread(s)\n", path, threads > 1 ? threads : 1);
+
+    double v_seq = 0, v_bal = 0;
+    int rc = 0;
+    if (run("sequential", src, slash ? dir : NULL, threads, 1, &v_seq) != 0 ||
+        run("balanced", src, slash ? dir : NULL, threads, 0, &v_bal) != 0) {
+        rc = 1;
+    } else {
+        double rel = fabs(v_seq - v_bal) / (fabs(v_seq) > 1e-12 ? fabs(v_seq) : 1.0);
+        printf("  volume diff  %10.2e (relative)\n", rel);
+        rc = rel > 1e-6 ? 1 : 0;
+    }
+
+    const int fn = 128;
+    double v_first = 0, v_sah = 0;
+    printf("cylinder(10) - cross cylinder(4), $fn=%d: BSP splitter\n", fn);
+    if (run_splitter("first", TS_CSG_SPLIT_FIRST, fn, &v_first) != 0 ||
+        run_splitter("sah", TS_CSG_SPLIT_SAH, fn, &v_sah) != 0) {
+        rc = 1;
+    } else {
+        double rel = fabs(v_first - v_sah) / (fabs(v_first) > 1e-12 ? fabs(v_first) : 1.0);
+        printf("  volume diff  %10.2e (relative)\n", rel);
+        if (rel > 1e-6) rc = 1;
+    }
+
+    free(dir);
+    free(src);
+    return rc;
+}
@@ -718,6 +718,8 @@ static const char HELP_INSPECT_CMD_VOXEL[] =
 "  voxel_clear               Remove voxels from viewport\n"
 "  voxel_state               Get voxel grid info (size, active count)\n"
 "  voxel_resolution [n]      Get/set voxel resolution\n"
+"  voxel_threads [n]         Get/set STL voxelizer threads (0 = auto)\n"
+"  voxel_sign [mode]         Get/set STL sign test (parity|winding)\n"
 "\n"
 "MESH EXPORT:\n"
 "  marching_cubes [path]     Extract isosurface -> STL\n"